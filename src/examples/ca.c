@@ -93,7 +93,8 @@ int main(int argc, char * argv[]) {
     CCLEvent * evt_comm;
     CCLEvent * evt_exec;
     /* Other variables. */
-    CCLEventWaitList ewl = NULL;
+    CCLEventWaitListBuf ewl_buf;
+    CCLEventWaitList ewl = ccl_event_wait_list_init(&ewl_buf);
     /* Profiler object. */
     CCLProf * prof;
     /* Output images filename. */
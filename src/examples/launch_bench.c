@@ -0,0 +1,201 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Microbenchmark which compares the host-side cost of launching a kernel
+ * with ::ccl_program_enqueue_kernel() and with a ::CCLLaunch* handle.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+/*
+ * Description
+ * -----------
+ *
+ * Microbenchmark which launches the same small kernel many times, first
+ * with ::ccl_program_enqueue_kernel() and then with a ::CCLLaunch* handle,
+ * changing one scalar argument in each launch. The command queue is
+ * event-less, so that the measured times are dominated by the host-side
+ * cost of setting arguments and enqueuing the kernel.
+ *
+ * Optional command-line arguments:
+ *
+ * 1. Device index
+ * 2. Number of launches
+ *
+ * */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <cf4ocl2.h>
+
+/* Kernel name. */
+#define KERNEL_NAME "inc"
+
+/* Kernel source. */
+#define KERNEL_SRC \
+    "__kernel void " KERNEL_NAME "(__global uint * buf, uint inc) {\n" \
+    "    buf[get_global_id(0)] += inc;\n" \
+    "}\n"
+
+/* Default number of launches. */
+#define DEF_LAUNCHES 100000
+
+/* Number of elements in buffer. */
+#define BUF_N 64
+
+/* Error handling macros. */
+#define ERROR_MSG_AND_EXIT(msg) \
+    do { fprintf(stderr, "\n%s\n", msg); exit(EXIT_FAILURE); } while(0)
+
+#define HANDLE_ERROR(err) \
+    if (err != NULL) { ERROR_MSG_AND_EXIT(err->message); }
+
+/**
+ * Launch handle microbenchmark main function.
+ * */
+int main(int argc, char * argv[]) {
+
+    /* Number of launches. */
+    cl_uint num_launches = DEF_LAUNCHES;
+
+    /* Device selected specified in the command line. */
+    int dev_idx = -1;
+
+    /* Check if a device was specified in the command line. */
+    if (argc >= 2) {
+        dev_idx = atoi(argv[1]);
+        if (dev_idx < 0) ERROR_MSG_AND_EXIT("Device ID must be >= 0");
+    }
+
+    /* Check if the number of launches was specified in the command line. */
+    if (argc >= 3) {
+        if (atoi(argv[2]) < 1)
+            ERROR_MSG_AND_EXIT("Number of launches must be > 0");
+        num_launches = atoi(argv[2]);
+    }
+
+    /* Wrappers. */
+    CCLContext * ctx = NULL;
+    CCLProgram * prg = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * queue = NULL;
+    CCLBuffer * buf = NULL;
+    CCLLaunch * lnc = NULL;
+
+    /* Global worksize. */
+    size_t gws = BUF_N;
+
+    /* Timer and measured times, in seconds. */
+    GTimer * timer = NULL;
+    double t_enqueue, t_launch;
+
+    /* Error reporting object. */
+    CCLErr * err = NULL;
+
+    /* Create a context with device selected from menu. */
+    ctx = ccl_context_new_from_menu_full(&dev_idx, &err);
+    HANDLE_ERROR(err);
+
+    /* Get the selected device. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    HANDLE_ERROR(err);
+
+    /* Create and build program. */
+    prg = ccl_program_new_from_source(ctx, KERNEL_SRC, &err);
+    HANDLE_ERROR(err);
+    ccl_program_build(prg, NULL, &err);
+    HANDLE_ERROR(err);
+
+    /* Create an event-less command queue. */
+    queue = ccl_queue_new(ctx, dev, 0, &err);
+    HANDLE_ERROR(err);
+    ccl_queue_set_event_less(queue, CL_TRUE);
+
+    /* Create device buffer. */
+    buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE,
+        BUF_N * sizeof(cl_uint), NULL, &err);
+    HANDLE_ERROR(err);
+
+    /* Create launch handle. */
+    lnc = ccl_launch_new(prg, KERNEL_NAME, queue, 1, NULL, &gws, NULL, &err);
+    HANDLE_ERROR(err);
+    ccl_launch_set_arg(lnc, 0, buf);
+
+    /* Warm up both paths. */
+    ccl_program_enqueue_kernel(prg, KERNEL_NAME, queue, 1, NULL, &gws, NULL,
+        NULL, &err, buf, ccl_arg_priv(num_launches, cl_uint), NULL);
+    HANDLE_ERROR(err);
+    ccl_launch_fire(lnc, NULL, &err);
+    HANDLE_ERROR(err);
+    ccl_queue_finish(queue, &err);
+    HANDLE_ERROR(err);
+
+    timer = g_timer_new();
+
+    /* Time launches through the program wrapper. */
+    g_timer_start(timer);
+    for (cl_uint i = 0; i < num_launches; ++i) {
+        ccl_program_enqueue_kernel(prg, KERNEL_NAME, queue, 1, NULL, &gws,
+            NULL, NULL, &err, buf, ccl_arg_priv(i, cl_uint), NULL);
+        HANDLE_ERROR(err);
+    }
+    ccl_queue_finish(queue, &err);
+    HANDLE_ERROR(err);
+    t_enqueue = g_timer_elapsed(timer, NULL);
+
+    /* Time launches through the launch handle. */
+    g_timer_start(timer);
+    for (cl_uint i = 0; i < num_launches; ++i) {
+        ccl_launch_set_arg_value(lnc, 1, sizeof(cl_uint), &i, &err);
+        HANDLE_ERROR(err);
+        ccl_launch_fire(lnc, NULL, &err);
+        HANDLE_ERROR(err);
+    }
+    ccl_queue_finish(queue, &err);
+    HANDLE_ERROR(err);
+    t_launch = g_timer_elapsed(timer, NULL);
+
+    g_timer_destroy(timer);
+
+    /* Show results. */
+    printf("\n");
+    printf(" * Launches                    : %u\n", num_launches);
+    printf(" * ccl_program_enqueue_kernel(): %.3f s (%.3f us/launch)\n",
+        t_enqueue, 1e6 * t_enqueue / num_launches);
+    printf(" * ccl_launch_fire()           : %.3f s (%.3f us/launch)\n",
+        t_launch, 1e6 * t_launch / num_launches);
+    printf(" * Speedup                     : %.2fx\n", t_enqueue / t_launch);
+    printf("\n");
+
+    /* Destroy wrappers. */
+    ccl_launch_destroy(lnc);
+    ccl_buffer_destroy(buf);
+    ccl_queue_destroy(queue);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    assert(ccl_wrapper_memcheck());
+
+    /* Bye. */
+    return EXIT_SUCCESS;
+}
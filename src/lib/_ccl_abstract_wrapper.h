@@ -178,4 +178,28 @@ CCLWrapperInfo * ccl_wrapper_info_new(size_t size);
 /* Destroy a ::CCLWrapperInfo object. */
 void ccl_wrapper_info_destroy(CCLWrapperInfo * info);
 
+/* Get the number of information requests of a given type served without
+ * locking, served from the cache with locking, and which required querying
+ * the OpenCL object. */
+void ccl_wrapper_get_info_counters(CCLInfo info_type, guint64 * fast_hits,
+    guint64 * locked_hits, guint64 * queries);
+
+/* Get cached immutable information without querying the OpenCL object. */
+CCLWrapperInfo * ccl_wrapper_lookup_info_immutable(CCLWrapper * wrapper,
+    cl_uint param_name, CCLInfo info_type);
+
+/* Place immutable information in the cache of a wrapper object. */
+cl_bool ccl_wrapper_add_info_immutable(CCLWrapper * wrapper,
+    cl_uint param_name, CCLInfo info_type, const void * value, size_t size);
+
+/* Get the thread-local cache which an owner object keeps for the calling
+ * thread. */
+GHashTable * ccl_wrapper_thread_cache(volatile gint * owner_id,
+    GHashFunc hash_func, GEqualFunc key_equal_func,
+    GDestroyNotify key_destroy_func);
+
+/* Release the thread-local caches of an owner object which is being
+ * destroyed. */
+void ccl_wrapper_thread_cache_release(volatile gint * owner_id);
+
 #endif
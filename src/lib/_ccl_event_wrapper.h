@@ -0,0 +1,44 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * This header provides the prototypes of the ccl_event_wait_list_add_clevent()
+ * and ccl_event_then_pool_free() functions. This header is not part of the
+ * _cf4ocl_ public API.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef __CCL_EVENT_WRAPPER_H_
+#define __CCL_EVENT_WRAPPER_H_
+
+#include "ccl_event_wrapper.h"
+
+/* Add an OpenCL event to an event wait list, unless it's already there. */
+void ccl_event_wait_list_add_clevent(
+    CCLEventWaitList * evt_wait_lst, cl_event event);
+
+/* Free the worker pool of ccl_event_then(), unless tasks are pending. */
+void ccl_event_then_pool_free();
+
+#endif /* __CCL_EVENT_WRAPPER_H_ */
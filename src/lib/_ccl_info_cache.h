@@ -0,0 +1,41 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * This header provides the prototype of the ccl_info_cache_load_platform()
+ * function. This header is not part of the _cf4ocl_ public API.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef __CCL_INFO_CACHE_H_
+#define __CCL_INFO_CACHE_H_
+
+#include "ccl_platform_wrapper.h"
+
+/* Pre-populate platform and device wrappers with cached information, or
+ * cache their information if not yet cached. */
+void ccl_info_cache_load_platform(CCLPlatform * platf,
+    CCLDevice * const * devices, cl_uint num_devices);
+
+#endif /* __CCL_INFO_CACHE_H_ */
@@ -20,8 +20,9 @@
  * @internal
  *
  * @file
- * This header provides the prototype of the ccl_kernel_get_arg_info_adapter()
- * function. This header is not part of the _cf4ocl_ public API.
+ * This header provides the prototypes of the ccl_kernel_get_arg_info_adapter()
+ * and ccl_kernel_forget_arg() functions. This header is not part of the
+ * _cf4ocl_ public API.
  *
  * @author Nuno Fachada
  * @date 2019
@@ -32,6 +33,10 @@
 #define __CCL_KERNEL_WRAPPER_H_
 
 #include "ccl_oclversions.h"
+#include "ccl_kernel_wrapper.h"
+
+/* Forget the argument last passed to the OpenCL kernel at the given index. */
+void ccl_kernel_forget_arg(CCLKernel * krnl, cl_uint arg_index);
 
 #ifdef CL_VERSION_1_2
 
@@ -50,6 +50,12 @@ struct ccl_memobj {
      * */
     CCLWrapper base;
 
+    /**
+     * OpenCL version of the associated platform, or 0 if not yet
+     * determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
 };
 
 #endif
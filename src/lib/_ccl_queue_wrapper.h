@@ -0,0 +1,80 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * This header provides the prototypes of protected command queue wrapper
+ * functions, used by other wrappers and by the profiler. This header is not
+ * part of the _cf4ocl_ public API.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef __CCL_QUEUE_WRAPPER_H_
+#define __CCL_QUEUE_WRAPPER_H_
+
+#include "ccl_queue_wrapper.h"
+#include "ccl_profiler.h"
+
+/* Attach a profiler to a command queue, such that completed events can be
+ * handed to it before being released. */
+void ccl_queue_attach_profiler(
+    CCLQueue * cq, CCLProf * prof, const char * cq_name);
+
+/* Detach a profiler from a command queue, if it's attached. */
+void ccl_queue_detach_profiler(CCLQueue * cq, CCLProf * prof);
+
+/* Get the location where enqueue functions should place the OpenCL event
+ * produced by a command. */
+cl_event * ccl_queue_event_ptr(CCLQueue * cq, cl_event * event);
+
+/* Notify the command queue that commands were enqueued, flushing it if
+ * required by its flush policy. */
+void ccl_queue_submitted(CCLQueue * cq, cl_uint num_cmds);
+
+/**
+ * @internal
+ *
+ * @brief Access of a command to a memory object, for hazard tracking.
+ * */
+typedef struct ccl_queue_access {
+
+    /** Memory object accessed by the command. */
+    cl_mem mem;
+
+    /** Does the command write to the memory object? */
+    cl_bool write;
+
+} CCLQueueAccess;
+
+/* Add the events of previous commands whose accesses conflict with the
+ * given ones to the event wait list, if the queue tracks hazards. */
+CCLEventWaitList * ccl_queue_hazards_wait(CCLQueue * cq,
+    CCLEventWaitList * evt_wait_lst, CCLEventWaitList * hz_lst,
+    const CCLQueueAccess * acc, cl_uint num_acc);
+
+/* Record the accesses of an enqueued command, if the queue tracks
+ * hazards. */
+void ccl_queue_hazards_record(CCLQueue * cq, cl_event event,
+    const CCLQueueAccess * acc, cl_uint num_acc);
+
+#endif /* __CCL_QUEUE_WRAPPER_H_ */
@@ -0,0 +1,43 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * This header provides the prototypes of the ccl_tuning_db_lookup() and
+ * ccl_tuning_db_store() functions. This header is not part of the _cf4ocl_
+ * public API.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef __CCL_TUNING_DB_H_
+#define __CCL_TUNING_DB_H_
+
+#include "ccl_common.h"
+
+/* Get tuned local work size from the tuning database. */
+cl_bool ccl_tuning_db_lookup(const char * key, cl_uint dims, size_t * lws);
+
+/* Keep tuned local work size in the tuning database. */
+void ccl_tuning_db_store(const char * key, cl_uint dims, const size_t * lws);
+
+#endif /* __CCL_TUNING_DB_H_ */
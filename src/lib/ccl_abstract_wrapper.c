@@ -29,15 +29,59 @@
 #include "ccl_abstract_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
 #include "_ccl_kernel_wrapper.h"
+#include "_ccl_event_wrapper.h"
 #include "_ccl_defs.h"
 
 /* Generic function pointer for OpenCL clget**Info() functions. */
 typedef cl_int (*ccl_wrapper_info_fp)(void);
 
-/* Table of all existing wrappers. */
-static GHashTable * wrappers = NULL;
-/* Define lock for synchronizing access to table of all existing wrappers. */
-G_LOCK_DEFINE(wrappers);
+/* Number of shards in the registry of existing wrappers. Must be a power of
+ * two. */
+#define CCL_WRAPPER_NUM_SHARDS 64
+
+/* Registry shard index for a given OpenCL object. OpenCL objects are heap
+ * allocated by the implementation, so the lower bits are discarded and some
+ * of the higher bits are folded in before masking. */
+#define ccl_wrapper_shard_index(cl_object) \
+    ((guint) ((((guintptr) (cl_object)) >> 4) \
+        ^ (((guintptr) (cl_object)) >> 12)) & (CCL_WRAPPER_NUM_SHARDS - 1))
+
+/**
+ * Shard of the registry of existing wrappers. Each shard keeps the wrappers
+ * whose OpenCL object maps to it, such that threads wrapping or releasing
+ * different OpenCL objects seldom contend for the same lock.
+ * */
+struct ccl_wrapper_shard {
+
+    /**
+     * Mutex which guards access to this shard.
+     * @private
+     * */
+    GMutex mutex;
+
+    /**
+     * Table of existing wrappers in this shard, created on demand. It's
+     * kept when it becomes empty, so that wrapping and releasing objects
+     * in a loop doesn't recreate it every time, and is only destroyed by
+     * ::ccl_wrapper_memcheck() once no wrappers exist.
+     * @private
+     * */
+    GHashTable * table;
+
+    /**
+     * Padding which keeps shards in separate cache lines.
+     * @private
+     * */
+    char pad[64 - sizeof(GMutex) - sizeof(GHashTable *)];
+
+};
+
+/* Sharded registry of all existing wrappers. Statically allocated mutexes do
+ * not need to be initialized. */
+static struct ccl_wrapper_shard wrappers[CCL_WRAPPER_NUM_SHARDS];
+
+/* Number of existing wrappers in all shards. */
+static volatile gint wrappers_count = 0;
 
 /* Wrapper names ordered by their enum type. */
 static const char * ccl_class_names[] = {"Buffer", "Context", "Device", "Event",
@@ -74,33 +118,1440 @@ static const ccl_wrapper_info_fp info_funs[] = {
 #else
     NULL,
 #endif
-};
+};
+
+/* Number of information values which can be kept inline in the info
+ * table of a wrapper. */
+#define CCL_WRAPPER_INFO_NUM_INLINE 4
+
+/* Maximum size in bytes of information values which can be kept inline
+ * in the info table of a wrapper. Enough for any OpenCL scalar type. */
+#define CCL_WRAPPER_INFO_INLINE_SIZE 16
+
+/* Number of slots in the first table of immutable information which can
+ * be read without locking. Must be a power of two. Each further table has
+ * twice the slots of the previous one. */
+#define CCL_WRAPPER_INFO_NUM_FAST 64
+
+/* Maximum number of entries in a table of immutable information with the
+ * given number of slots. Tables are never filled up, so that probing for
+ * information which isn't there stops early at a free slot. */
+#define ccl_wrapper_info_fast_max(num_slots) ((num_slots) / 4 * 3)
+
+/* Maximum number of recycled wrappers of each class kept by each
+ * thread. */
+#define CCL_WRAPPER_POOL_SIZE 64
+
+/**
+ * Information value kept inline in the information table, avoiding
+ * separate allocations for small scalar values.
+ * */
+struct ccl_wrapper_info_inline {
+
+    /**
+     * Name of parameter which refers to this information.
+     * @private
+     * */
+    cl_uint param_name;
+
+    /**
+     * Is this slot in use?
+     * @private
+     * */
+    gboolean used;
+
+    /**
+     * Does this slot keep a replaced value which clients may still hold?
+     * Retired slots are only reused after
+     * ::ccl_wrapper_release_old_info() is called.
+     * @private
+     * */
+    gboolean retired;
+
+    /**
+     * Information object, with `value` pointing to `storage`.
+     * @private
+     * */
+    CCLWrapperInfo info;
+
+    /**
+     * Storage for the information value.
+     * @private
+     * */
+    guint64 storage[CCL_WRAPPER_INFO_INLINE_SIZE / sizeof(guint64)];
+
+};
+
+/**
+ * Immutable information, published once and never modified until the
+ * wrapper is destroyed, such that it can be read without locking. The
+ * information value is stored right after this structure.
+ * */
+struct ccl_wrapper_info_fast {
+
+    /**
+     * Type of information query which produced this information.
+     * @private
+     * */
+    CCLInfo info_type;
+
+    /**
+     * Name of parameter which refers to this information.
+     * @private
+     * */
+    cl_uint param_name;
+
+    /**
+     * Second OpenCL object involved in the query, or `NULL`.
+     * @private
+     * */
+    void * cl_object2;
+
+    /**
+     * Information object.
+     * @private
+     * */
+    CCLWrapperInfo info;
+
+};
+
+/**
+ * Open addressing table of pointers to immutable information. Slots are
+ * atomically published and never change afterwards. When a table reaches
+ * its maximum number of entries, further entries go to the next table,
+ * which is twice as large, so entries never move.
+ * */
+struct ccl_wrapper_info_fast_table {
+
+    /**
+     * Number of slots, a power of two.
+     * @private
+     * */
+    guint num_slots;
+
+    /**
+     * Number of slots reserved for entries.
+     * @private
+     * */
+    volatile gint num_reserved;
+
+    /**
+     * Next table, or `NULL`.
+     * @private
+     * */
+    struct ccl_wrapper_info_fast_table * next;
+
+    /**
+     * Slots, each pointing to a ::ccl_wrapper_info_fast object or
+     * `NULL`.
+     * @private
+     * */
+    gpointer slots[];
+
+};
+
+/**
+ * Information about wrapped OpenCL objects.
+ * */
+struct ccl_wrapper_info_table {
+
+    /**
+     * Table containing information about the wrapped OpenCL object.
+     * @private
+     * */
+    GHashTable * table;
+
+    /**
+     * Replaced information about the wrapped OpenCL object, kept until
+     * the wrapper is destroyed or ::ccl_wrapper_release_old_info() is
+     * called.
+     * @private
+     * */
+    GSList * old_info;
+
+    /**
+     * Mutex for controlling thread access to the OpenCL object
+     * information table.
+     * @private
+     * */
+    GMutex mutex;
+
+    /**
+     * Number of inline slots which have been taken, either in use,
+     * retired or released for reuse.
+     * @private
+     * */
+    guint num_inline;
+
+    /**
+     * Small information values kept inline.
+     * @private
+     * */
+    struct ccl_wrapper_info_inline inl[CCL_WRAPPER_INFO_NUM_INLINE];
+
+    /**
+     * First table of immutable information, with
+     * ::CCL_WRAPPER_INFO_NUM_FAST slots, created on demand.
+     * @private
+     * */
+    struct ccl_wrapper_info_fast_table * fast;
+
+};
+
+/**
+ * Per-thread pool of recycled wrappers, organized by class. Recycled
+ * wrappers are chained through their `cl_object` field and keep their
+ * size in the `ref_count` field. They also keep their (cleared)
+ * information table, if one was created.
+ * */
+struct ccl_wrapper_pool {
+
+    /**
+     * Head of the list of recycled wrappers for each class.
+     * @private
+     * */
+    CCLWrapper * free[CCL_NONE + 1];
+
+    /**
+     * Number of recycled wrappers for each class.
+     * @private
+     * */
+    guint count[CCL_NONE + 1];
+
+};
+
+/* Destroy the wrapper pool of a thread, called on thread exit. */
+static void ccl_wrapper_pool_destroy(gpointer data);
+
+/* Number of information requests served without locking, per info type. */
+static guint64 info_fast_hits[CCL_INFO_END];
+
+/* Number of information requests served from the cache with locking, per
+ * info type. */
+static guint64 info_locked_hits[CCL_INFO_END];
+
+/* Number of information requests which queried the OpenCL object, per
+ * info type. */
+static guint64 info_queries[CCL_INFO_END];
+
+/* Number of calls to OpenCL clGet*Info() functions, per info type. */
+static guint64 info_calls[CCL_INFO_END];
+
+/* Number of calls to OpenCL clRelease*() functions. */
+static guint64 release_calls = 0;
+
+/* Number of live wrappers, per class. */
+static volatile gint wrappers_live[CCL_NONE + 1];
+
+/* Bytes held by live wrappers, per class. */
+static volatile gssize wrappers_bytes[CCL_NONE + 1];
+
+/* Time in microseconds spent waiting on registry locks, and number of
+ * times a registry lock was contended. */
+static guint64 registry_wait = 0;
+static guint64 registry_contended = 0;
+
+/* Time in microseconds spent waiting on info table locks, and number of
+ * times an info table lock was contended. */
+static guint64 info_wait = 0;
+static guint64 info_contended = 0;
+
+/* Protects the lock wait statistics. GLib has no 64-bit atomic operations,
+ * and pointer-sized counters would wrap in long runs on 32-bit platforms.
+ * It's only taken after waiting for a contended lock. */
+static GMutex lock_stats_mutex;
+
+/* Are lock-free 64-bit atomic operations available for counters which are
+ * updated in hot paths, such as the information request counters? */
+#if defined(__ATOMIC_RELAXED) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+#define CCL_WRAPPER_ATOMIC_COUNTERS 1
+#endif
+
+/* Protects 64-bit counters updated in hot paths when lock-free 64-bit
+ * atomic operations are not available. */
+#ifndef CCL_WRAPPER_ATOMIC_COUNTERS
+static GMutex counters_mutex;
+#endif
+
+/**
+ * @internal
+ *
+ * @brief Atomically increment a 64-bit statistics counter.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in,out] counter Counter to increment.
+ * */
+static inline void ccl_wrapper_counter_inc(guint64 * counter) {
+
+#ifdef CCL_WRAPPER_ATOMIC_COUNTERS
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+#else
+    g_mutex_lock(&counters_mutex);
+    (*counter)++;
+    g_mutex_unlock(&counters_mutex);
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Atomically read a 64-bit statistics counter.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] counter Counter to read.
+ * @return The value of the counter.
+ * */
+static inline guint64 ccl_wrapper_counter_get(guint64 * counter) {
+
+#ifdef CCL_WRAPPER_ATOMIC_COUNTERS
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#else
+    guint64 value;
+    g_mutex_lock(&counters_mutex);
+    value = *counter;
+    g_mutex_unlock(&counters_mutex);
+    return value;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Lock a mutex, accounting for the time spent waiting if the mutex
+ * is contended. Uncontended locking doesn't read the clock.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] mutex Mutex to lock.
+ * @param[in,out] wait Time in microseconds spent waiting on this kind of
+ * mutex, protected by ::lock_stats_mutex.
+ * @param[in,out] contended Number of times this kind of mutex was
+ * contended, protected by ::lock_stats_mutex.
+ * */
+static void ccl_wrapper_mutex_lock(GMutex * mutex, guint64 * wait,
+    guint64 * contended) {
+
+    gint64 start, waited;
+
+    if (g_mutex_trylock(mutex)) return;
+
+    start = g_get_monotonic_time();
+    g_mutex_lock(mutex);
+    waited = g_get_monotonic_time() - start;
+
+    g_mutex_lock(&lock_stats_mutex);
+    *wait += (guint64) waited;
+    (*contended)++;
+    g_mutex_unlock(&lock_stats_mutex);
+}
+
+/**
+ * Information queried during a prefetch, waiting to be kept in the
+ * information table.
+ * */
+struct ccl_wrapper_info_pending {
+
+    /**
+     * Parameter name.
+     * @private
+     * */
+    cl_uint param_name;
+
+    /**
+     * Information object for large values, or `NULL`.
+     * @private
+     * */
+    CCLWrapperInfo * info;
+
+    /**
+     * Size in bytes of information value.
+     * @private
+     * */
+    size_t size;
+
+    /**
+     * Storage for small information values.
+     * @private
+     * */
+    guint64 value[CCL_WRAPPER_INFO_INLINE_SIZE / sizeof(guint64)];
+
+};
+
+/* Thread-local wrapper pool. */
+static GPrivate wrapper_pool = G_PRIVATE_INIT(ccl_wrapper_pool_destroy);
+
+/**
+ * @internal
+ *
+ * @brief Thread-local caches of objects owned by other objects.
+ * */
+typedef struct ccl_wrapper_thread_caches {
+
+    /** Caches of the calling thread (::GHashTable*), keyed by owner ID. */
+    GHashTable * caches;
+    /** Value of ::thread_cache_retired when retired caches were last
+     * removed. */
+    gint retired_seen;
+
+} CCLWrapperThreadCaches;
+
+/**
+ * @internal
+ *
+ * @brief Registry entry of an owner of thread-local caches.
+ * */
+typedef struct ccl_wrapper_thread_cache_owner {
+
+    /** Number of threads which keep a cache for the owner. */
+    guint num_caches;
+    /** Was the owner destroyed? */
+    gboolean retired;
+
+} CCLWrapperThreadCacheOwner;
+
+/* Release the thread-local caches of a thread which is exiting. */
+static void ccl_wrapper_thread_caches_destroy(gpointer data);
+
+/* Thread-local caches of objects owned by other objects. */
+static GPrivate thread_caches =
+    G_PRIVATE_INIT(ccl_wrapper_thread_caches_destroy);
+
+/* Last owner ID given to an owner of thread-local caches. */
+static volatile gint thread_cache_last_id = 0;
+
+/* Owners of thread-local caches (::CCLWrapperThreadCacheOwner*), keyed by
+ * owner ID. */
+static GHashTable * thread_cache_owners = NULL;
+
+/* Lock which protects the registry of owners of thread-local caches. */
+static GMutex thread_cache_mutex;
+
+/* Incremented whenever an owner whose caches are kept by other threads is
+ * destroyed. */
+static volatile gint thread_cache_retired = 0;
+
+/* Number of existing thread-local caches. */
+static volatile gint thread_caches_live = 0;
+
+/**
+ * @internal
+ *
+ * @brief Release the information kept in a wrapper information table,
+ * leaving it ready for reuse.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info Information table to clear.
+ * */
+static void ccl_wrapper_info_table_clear(CCLWrapperInfoTable * info) {
+
+    if (info->table != NULL) {
+        g_hash_table_destroy(info->table);
+        info->table = NULL;
+    }
+    if (info->old_info != NULL) {
+        g_slist_free_full(info->old_info,
+            (GDestroyNotify) ccl_wrapper_info_destroy);
+        info->old_info = NULL;
+    }
+    memset(info->inl, 0, sizeof(info->inl));
+    info->num_inline = 0;
+    while (info->fast != NULL) {
+        struct ccl_wrapper_info_fast_table * fast = info->fast;
+        for (guint i = 0; i < fast->num_slots; ++i) {
+            struct ccl_wrapper_info_fast * entry = fast->slots[i];
+            if (entry != NULL)
+                g_slice_free1(sizeof(struct ccl_wrapper_info_fast)
+                    + entry->info.size, entry);
+        }
+        info->fast = fast->next;
+        g_slice_free1(sizeof(struct ccl_wrapper_info_fast_table)
+            + fast->num_slots * sizeof(gpointer), fast);
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Destroy a wrapper information table.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info Information table to destroy.
+ * */
+static void ccl_wrapper_info_table_destroy(CCLWrapperInfoTable * info) {
+
+    ccl_wrapper_info_table_clear(info);
+    g_mutex_clear(&info->mutex);
+    g_slice_free(CCLWrapperInfoTable, info);
+}
+
+/**
+ * @internal
+ *
+ * @brief Get the information table of the given wrapper, creating it if
+ * it doesn't exist yet. Information tables are only created when
+ * information about the wrapped object is first cached.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper Wrapper object.
+ * @return The wrapper information table.
+ * */
+static CCLWrapperInfoTable * ccl_wrapper_get_info_table(
+    CCLWrapper * wrapper) {
+
+    CCLWrapperInfoTable * info = g_atomic_pointer_get(&wrapper->info);
+
+    if (info == NULL) {
+
+        /* Create table... */
+        info = g_slice_new0(CCLWrapperInfoTable);
+        g_mutex_init(&info->mutex);
+
+        /* ...and install it, unless another thread did so first. */
+        if (!g_atomic_pointer_compare_and_exchange(
+            &wrapper->info, NULL, info)) {
+
+            ccl_wrapper_info_table_destroy(info);
+            info = g_atomic_pointer_get(&wrapper->info);
+        }
+    }
+
+    return info;
+}
+
+/**
+ * @internal
+ *
+ * @brief Find the inline slot which keeps the given parameter. Must be
+ * called with the information table locked.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info Information table.
+ * @param[in] param_name Parameter name.
+ * @return The inline slot which keeps the parameter, or `NULL` if the
+ * parameter is not kept inline.
+ * */
+static struct ccl_wrapper_info_inline * ccl_wrapper_info_table_find_inline(
+    CCLWrapperInfoTable * info, cl_uint param_name) {
+
+    for (guint i = 0; i < info->num_inline; ++i) {
+        if ((info->inl[i].used) && (info->inl[i].param_name == param_name))
+            return &info->inl[i];
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Lookup cached information in the wrapper information table.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper Wrapper object.
+ * @param[in] param_name Parameter name.
+ * @return The cached information, or `NULL` if not found.
+ * */
+static CCLWrapperInfo * ccl_wrapper_lookup_info(
+    CCLWrapper * wrapper, cl_uint param_name) {
+
+    CCLWrapperInfoTable * info = g_atomic_pointer_get(&wrapper->info);
+    struct ccl_wrapper_info_inline * slot;
+    CCLWrapperInfo * found = NULL;
+
+    /* No table means no cached information. */
+    if (info == NULL) return NULL;
+
+    ccl_wrapper_mutex_lock(&info->mutex, &info_wait, &info_contended);
+    slot = ccl_wrapper_info_table_find_inline(info, param_name);
+    if (slot != NULL)
+        found = &slot->info;
+    else if (info->table != NULL)
+        found = g_hash_table_lookup(info->table, GUINT_TO_POINTER(param_name));
+    g_mutex_unlock(&info->mutex);
+
+    return found;
+}
+
+/**
+ * @internal
+ *
+ * @brief Keep a small information value in an inline slot of the
+ * information table. Slots which were handed out are never modified: a
+ * slot keeping a previous value of the same parameter is retired, and
+ * the new value is kept in a free slot. Retired slots are only reused
+ * after ::ccl_wrapper_release_old_info() is called, so previously returned
+ * pointers keep pointing to the value they were returned with. Must be
+ * called with the information table locked.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info Information table.
+ * @param[in] param_name Parameter name.
+ * @param[in] value Information value, or `NULL` for an all-zeros value.
+ * @param[in] size Size in bytes of information value, which must not be
+ * larger than ::CCL_WRAPPER_INFO_INLINE_SIZE.
+ * @return The kept information, or `NULL` if no inline slot was
+ * available, in which case the caller should use
+ * ccl_wrapper_info_table_add() instead.
+ * */
+static CCLWrapperInfo * ccl_wrapper_info_table_add_inline(
+    CCLWrapperInfoTable * info, cl_uint param_name, const void * value,
+    size_t size) {
+
+    struct ccl_wrapper_info_inline * slot;
+
+    g_assert(size <= CCL_WRAPPER_INFO_INLINE_SIZE);
+
+    /* Retire slot with the previous value of this parameter, if any. */
+    slot = ccl_wrapper_info_table_find_inline(info, param_name);
+    if (slot != NULL) {
+        slot->used = FALSE;
+        slot->retired = TRUE;
+    }
+
+    /* Values of parameters already kept in the hash table stay there. */
+    if ((info->table != NULL) && (g_hash_table_contains(
+            info->table, GUINT_TO_POINTER(param_name))))
+        return NULL;
+
+    /* Take a released slot, or a new one if there is none. */
+    slot = NULL;
+    for (guint i = 0; i < info->num_inline; ++i) {
+        if (!info->inl[i].used && !info->inl[i].retired) {
+            slot = &info->inl[i];
+            break;
+        }
+    }
+    if (slot == NULL) {
+        if (info->num_inline == CCL_WRAPPER_INFO_NUM_INLINE) return NULL;
+        slot = &info->inl[info->num_inline++];
+    }
+
+    /* Keep value in slot. */
+    slot->param_name = param_name;
+    slot->used = TRUE;
+    slot->info.value = slot->storage;
+    slot->info.size = size;
+    if (value != NULL)
+        memcpy(slot->storage, value, size);
+    else
+        memset(slot->storage, 0, size);
+
+    return &slot->info;
+}
+
+/**
+ * @internal
+ *
+ * @brief Add a ::CCLWrapperInfo object to the given information table.
+ * Must be called with the information table locked.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info_table Information table.
+ * @param[in] param_name Name of parameter which will refer to this
+ * info.
+ * @param[in] info Info object to add.
+ * */
+static void ccl_wrapper_info_table_add(CCLWrapperInfoTable * info_table,
+    cl_uint param_name, CCLWrapperInfo * info) {
+
+    /* Inline slot keeping the same parameter, if any. */
+    struct ccl_wrapper_info_inline * slot;
+
+    /* If information table is not yet initialized, then
+     * initialize it. */
+    if (info_table->table == NULL) {
+        info_table->table = g_hash_table_new_full(
+            g_direct_hash, g_direct_equal,
+            NULL, (GDestroyNotify) ccl_wrapper_info_destroy);
+    }
+
+    /* If information with the same key is kept inline, retire the slot.
+     * Its memory remains valid until the wrapper is destroyed. */
+    slot = ccl_wrapper_info_table_find_inline(info_table, param_name);
+    if (slot != NULL) {
+        slot->used = FALSE;
+        slot->retired = TRUE;
+    }
+
+    /* Check if information with same key as already present in
+     * table... */
+    if (g_hash_table_contains(
+            info_table->table, GUINT_TO_POINTER(param_name))) {
+
+        /* ...if so, move this information to the old information
+         * table. */
+
+        /* Get existing information... */
+        CCLWrapperInfo * info_old =
+            (CCLWrapperInfo *) g_hash_table_lookup(
+                info_table->table, GUINT_TO_POINTER(param_name));
+
+        /* ...and keep it in the old information list, as clients may
+         * still hold it. */
+        info_table->old_info = g_slist_prepend(
+            info_table->old_info, info_old);
+
+        /* Remove old info from info table without destroying it. */
+        g_hash_table_steal(
+            info_table->table, GUINT_TO_POINTER(param_name));
+
+    }
+
+    /* Keep new information in information table. */
+    g_hash_table_insert(info_table->table,
+        GUINT_TO_POINTER(param_name), info);
+}
+
+/**
+ * @internal
+ *
+ * @brief Is the given information immutable, i.e., will it never change
+ * during the lifetime of the OpenCL object?
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] info_type Type of information query.
+ * @param[in] param_name Parameter name.
+ * @return `TRUE` if information is immutable, `FALSE` otherwise.
+ * */
+static gboolean ccl_wrapper_info_is_immutable(
+    CCLInfo info_type, cl_uint param_name) {
+
+    switch (info_type) {
+        case CCL_INFO_DEVICE:
+            return (param_name != CL_DEVICE_AVAILABLE)
+#ifdef CL_VERSION_1_2
+                && (param_name != CL_DEVICE_REFERENCE_COUNT)
+#endif
+                ;
+        case CCL_INFO_CONTEXT:
+            return (param_name == CL_CONTEXT_DEVICES)
+                || (param_name == CL_CONTEXT_PROPERTIES)
+#ifdef CL_VERSION_1_1
+                || (param_name == CL_CONTEXT_NUM_DEVICES)
+#endif
+                ;
+        case CCL_INFO_EVENT:
+            return (param_name == CL_EVENT_COMMAND_QUEUE)
+                || (param_name == CL_EVENT_COMMAND_TYPE)
+#ifdef CL_VERSION_1_1
+                || (param_name == CL_EVENT_CONTEXT)
+#endif
+                ;
+        case CCL_INFO_KERNEL:
+            return (param_name == CL_KERNEL_FUNCTION_NAME)
+                || (param_name == CL_KERNEL_NUM_ARGS)
+                || (param_name == CL_KERNEL_CONTEXT)
+                || (param_name == CL_KERNEL_PROGRAM)
+#ifdef CL_VERSION_1_2
+                || (param_name == CL_KERNEL_ATTRIBUTES)
+#endif
+                ;
+        case CCL_INFO_MEMOBJ:
+            return (param_name != CL_MEM_REFERENCE_COUNT)
+                && (param_name != CL_MEM_MAP_COUNT);
+        case CCL_INFO_PROGRAM:
+            return (param_name == CL_PROGRAM_CONTEXT)
+                || (param_name == CL_PROGRAM_NUM_DEVICES)
+                || (param_name == CL_PROGRAM_DEVICES);
+        case CCL_INFO_SAMPLER:
+            return param_name != CL_SAMPLER_REFERENCE_COUNT;
+        case CCL_INFO_QUEUE:
+            return (param_name == CL_QUEUE_CONTEXT)
+                || (param_name == CL_QUEUE_DEVICE)
+                || (param_name == CL_QUEUE_PROPERTIES);
+        case CCL_INFO_KERNEL_WORKGROUP:
+            /* Local memory use and the maximum work-group size depend on
+             * the sizes of local memory arguments. */
+            return (param_name == CL_KERNEL_COMPILE_WORK_GROUP_SIZE)
+#ifdef CL_VERSION_1_1
+                || (param_name == CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE)
+#endif
+#ifdef CL_VERSION_1_2
+                || (param_name == CL_KERNEL_GLOBAL_WORK_SIZE)
+#endif
+                ;
+        case CCL_INFO_EVENT_PROFILING:
+        case CCL_INFO_IMAGE:
+        case CCL_INFO_KERNEL_ARG:
+        case CCL_INFO_PLATFORM:
+        case CCL_INFO_PIPE:
+            /* Event profiling information is also immutable, since it
+             * only becomes available (and is thus cached) after the
+             * command completes. */
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Get the size of information which is known to have a fixed size,
+ * such that it can be fetched with a single call to the OpenCL
+ * implementation.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] info_type Type of information query.
+ * @param[in] param_name Parameter name.
+ * @return The size in bytes of the information value, or zero if the
+ * information doesn't have a known fixed size (e.g. strings and arrays).
+ * */
+static size_t ccl_wrapper_info_fixed_size(
+    CCLInfo info_type, cl_uint param_name) {
+
+    switch (info_type) {
+
+        case CCL_INFO_EVENT_PROFILING:
+            /* All profiling information are cl_ulong timestamps. */
+            return sizeof(cl_ulong);
+
+        case CCL_INFO_EVENT:
+            switch (param_name) {
+                case CL_EVENT_COMMAND_QUEUE:
+                    return sizeof(cl_command_queue);
+#ifdef CL_VERSION_1_1
+                case CL_EVENT_CONTEXT:
+                    return sizeof(cl_context);
+#endif
+                case CL_EVENT_COMMAND_TYPE:
+                    return sizeof(cl_command_type);
+                case CL_EVENT_COMMAND_EXECUTION_STATUS:
+                    return sizeof(cl_int);
+                case CL_EVENT_REFERENCE_COUNT:
+                    return sizeof(cl_uint);
+            }
+            break;
+
+        case CCL_INFO_DEVICE:
+            switch (param_name) {
+                case CL_DEVICE_TYPE:
+                    return sizeof(cl_device_type);
+                case CL_DEVICE_VENDOR_ID:
+                case CL_DEVICE_MAX_COMPUTE_UNITS:
+                case CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT:
+                case CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE:
+                case CL_DEVICE_MAX_CLOCK_FREQUENCY:
+                case CL_DEVICE_ADDRESS_BITS:
+                case CL_DEVICE_MAX_READ_IMAGE_ARGS:
+                case CL_DEVICE_MAX_WRITE_IMAGE_ARGS:
+                case CL_DEVICE_MAX_SAMPLERS:
+                case CL_DEVICE_MEM_BASE_ADDR_ALIGN:
+                case CL_DEVICE_MIN_DATA_TYPE_ALIGN_SIZE:
+                case CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE:
+                case CL_DEVICE_MAX_CONSTANT_ARGS:
+                    return sizeof(cl_uint);
+                case CL_DEVICE_IMAGE_SUPPORT:
+                case CL_DEVICE_ERROR_CORRECTION_SUPPORT:
+                case CL_DEVICE_ENDIAN_LITTLE:
+                case CL_DEVICE_AVAILABLE:
+                case CL_DEVICE_COMPILER_AVAILABLE:
+                    return sizeof(cl_bool);
+                case CL_DEVICE_MAX_WORK_GROUP_SIZE:
+                case CL_DEVICE_IMAGE2D_MAX_WIDTH:
+                case CL_DEVICE_IMAGE2D_MAX_HEIGHT:
+                case CL_DEVICE_IMAGE3D_MAX_WIDTH:
+                case CL_DEVICE_IMAGE3D_MAX_HEIGHT:
+                case CL_DEVICE_IMAGE3D_MAX_DEPTH:
+                case CL_DEVICE_MAX_PARAMETER_SIZE:
+                case CL_DEVICE_PROFILING_TIMER_RESOLUTION:
+                    return sizeof(size_t);
+                case CL_DEVICE_MAX_MEM_ALLOC_SIZE:
+                case CL_DEVICE_GLOBAL_MEM_CACHE_SIZE:
+                case CL_DEVICE_GLOBAL_MEM_SIZE:
+                case CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE:
+                case CL_DEVICE_LOCAL_MEM_SIZE:
+                    return sizeof(cl_ulong);
+                case CL_DEVICE_SINGLE_FP_CONFIG:
+                    return sizeof(cl_device_fp_config);
+                case CL_DEVICE_GLOBAL_MEM_CACHE_TYPE:
+                    return sizeof(cl_device_mem_cache_type);
+                case CL_DEVICE_LOCAL_MEM_TYPE:
+                    return sizeof(cl_device_local_mem_type);
+                case CL_DEVICE_EXECUTION_CAPABILITIES:
+                    return sizeof(cl_device_exec_capabilities);
+                case CL_DEVICE_QUEUE_PROPERTIES:
+                    return sizeof(cl_command_queue_properties);
+                case CL_DEVICE_PLATFORM:
+                    return sizeof(cl_platform_id);
+            }
+            break;
+
+        case CCL_INFO_KERNEL_WORKGROUP:
+            switch (param_name) {
+                case CL_KERNEL_WORK_GROUP_SIZE:
+#ifdef CL_VERSION_1_1
+                case CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE:
+#endif
+                    return sizeof(size_t);
+                case CL_KERNEL_LOCAL_MEM_SIZE:
+#ifdef CL_VERSION_1_1
+                case CL_KERNEL_PRIVATE_MEM_SIZE:
+#endif
+                    return sizeof(cl_ulong);
+            }
+            break;
+
+        case CCL_INFO_KERNEL:
+            switch (param_name) {
+                case CL_KERNEL_NUM_ARGS:
+                case CL_KERNEL_REFERENCE_COUNT:
+                    return sizeof(cl_uint);
+                case CL_KERNEL_CONTEXT:
+                    return sizeof(cl_context);
+                case CL_KERNEL_PROGRAM:
+                    return sizeof(cl_program);
+            }
+            break;
+
+        case CCL_INFO_MEMOBJ:
+            switch (param_name) {
+                case CL_MEM_TYPE:
+                    return sizeof(cl_mem_object_type);
+                case CL_MEM_FLAGS:
+                    return sizeof(cl_mem_flags);
+                case CL_MEM_SIZE:
+                    return sizeof(size_t);
+                case CL_MEM_HOST_PTR:
+                    return sizeof(void *);
+                case CL_MEM_MAP_COUNT:
+                case CL_MEM_REFERENCE_COUNT:
+                    return sizeof(cl_uint);
+                case CL_MEM_CONTEXT:
+                    return sizeof(cl_context);
+            }
+            break;
+
+        case CCL_INFO_QUEUE:
+            switch (param_name) {
+                case CL_QUEUE_CONTEXT:
+                    return sizeof(cl_context);
+                case CL_QUEUE_DEVICE:
+                    return sizeof(cl_device_id);
+                case CL_QUEUE_REFERENCE_COUNT:
+                    return sizeof(cl_uint);
+                case CL_QUEUE_PROPERTIES:
+                    return sizeof(cl_command_queue_properties);
+            }
+            break;
+
+        case CCL_INFO_CONTEXT:
+            switch (param_name) {
+                case CL_CONTEXT_REFERENCE_COUNT:
+#ifdef CL_VERSION_1_1
+                case CL_CONTEXT_NUM_DEVICES:
+#endif
+                    return sizeof(cl_uint);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* Size is unknown or variable. */
+    return 0;
+}
+
+/* Hash of the key of immutable information, from which the initial slot
+ * in a table of immutable information is determined. */
+#define ccl_wrapper_info_fast_hash(info_type, param_name, cl_object2) \
+    ((guint) (param_name) ^ ((guint) (info_type) << 8) \
+        ^ (guint) (((guintptr) (cl_object2)) >> 4))
+
+/**
+ * @internal
+ *
+ * @brief Get the table of immutable information which follows the given
+ * one, creating it if required.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] next Location of the pointer to the next table, i.e. the
+ * `fast` field of the information table for the first table.
+ * @param[in] num_slots Number of slots of the next table, if created.
+ * @return The next table.
+ * */
+static struct ccl_wrapper_info_fast_table * ccl_wrapper_info_fast_next(
+    struct ccl_wrapper_info_fast_table ** next, guint num_slots) {
+
+    struct ccl_wrapper_info_fast_table * fast = g_atomic_pointer_get(next);
+    gsize fast_size;
+
+    if (fast == NULL) {
+
+        /* Create table... */
+        fast_size = sizeof(struct ccl_wrapper_info_fast_table)
+            + num_slots * sizeof(gpointer);
+        fast = g_slice_alloc0(fast_size);
+        fast->num_slots = num_slots;
+
+        /* ...and install it, unless another thread did so first. */
+        if (!g_atomic_pointer_compare_and_exchange(next, NULL, fast)) {
+            g_slice_free1(fast_size, fast);
+            fast = g_atomic_pointer_get(next);
+        }
+    }
+
+    return fast;
+}
+
+/**
+ * @internal
+ *
+ * @brief Lookup immutable information without locking.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 Wrapper object.
+ * @param[in] wrapper2 Second wrapper object involved in query, or `NULL`.
+ * @param[in] param_name Parameter name.
+ * @param[in] info_type Type of information query.
+ * @return The cached immutable information, or `NULL` if not found.
+ * */
+static CCLWrapperInfo * ccl_wrapper_lookup_info_fast(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, cl_uint param_name, CCLInfo info_type) {
+
+    CCLWrapperInfoTable * info = g_atomic_pointer_get(&wrapper1->info);
+    void * cl_object2 = wrapper2 != NULL ? wrapper2->cl_object : NULL;
+    guint hash = ccl_wrapper_info_fast_hash(info_type, param_name, cl_object2);
+    struct ccl_wrapper_info_fast_table * fast;
+    struct ccl_wrapper_info_fast * entry;
+    guint idx;
+
+    /* No tables means no cached information. */
+    if (info == NULL) return NULL;
+
+    /* Probe each table until key or free slot is found. Tables always
+     * have free slots. */
+    for (fast = g_atomic_pointer_get(&info->fast); fast != NULL;
+        fast = g_atomic_pointer_get(&fast->next)) {
+
+        idx = hash & (fast->num_slots - 1);
+        while ((entry = g_atomic_pointer_get(&fast->slots[idx])) != NULL) {
+            if ((entry->param_name == param_name)
+                && (entry->info_type == info_type)
+                && (entry->cl_object2 == cl_object2))
+                return &entry->info;
+            idx = (idx + 1) & (fast->num_slots - 1);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Publish immutable information such that it can be read without
+ * locking.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 Wrapper object.
+ * @param[in] wrapper2 Second wrapper object involved in query, or `NULL`.
+ * @param[in] param_name Parameter name.
+ * @param[in] info_type Type of information query.
+ * @param[in] value Information value, which is copied.
+ * @param[in] size Size in bytes of information value.
+ * @return The published information.
+ * */
+static CCLWrapperInfo * ccl_wrapper_add_info_fast(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, cl_uint param_name, CCLInfo info_type,
+    const void * value, size_t size) {
+
+    CCLWrapperInfoTable * info = ccl_wrapper_get_info_table(wrapper1);
+    void * cl_object2 = wrapper2 != NULL ? wrapper2->cl_object : NULL;
+    guint hash = ccl_wrapper_info_fast_hash(info_type, param_name, cl_object2);
+    struct ccl_wrapper_info_fast_table * fast;
+    struct ccl_wrapper_info_fast * entry, * other;
+    guint idx;
+
+    /* Create new entry, with the value right after it. */
+    entry = g_slice_alloc(sizeof(struct ccl_wrapper_info_fast) + size);
+    entry->info_type = info_type;
+    entry->param_name = param_name;
+    entry->cl_object2 = cl_object2;
+    entry->info.value = (void *) (entry + 1);
+    entry->info.size = size;
+    memcpy(entry->info.value, value, size);
+
+    /* Find a table with room for the entry, creating tables as
+     * required. */
+    fast = ccl_wrapper_info_fast_next(
+        &info->fast, CCL_WRAPPER_INFO_NUM_FAST);
+    while (g_atomic_int_add(&fast->num_reserved, 1)
+        >= (gint) ccl_wrapper_info_fast_max(fast->num_slots)) {
+
+        fast = ccl_wrapper_info_fast_next(&fast->next, 2 * fast->num_slots);
+    }
+
+    /* Publish entry in the first free slot, which exists since a slot was
+     * reserved. */
+    idx = hash & (fast->num_slots - 1);
+    while (!g_atomic_pointer_compare_and_exchange(
+        &fast->slots[idx], NULL, entry)) {
+
+        /* If another thread published the same information, use it. */
+        other = g_atomic_pointer_get(&fast->slots[idx]);
+        if ((other->param_name == param_name)
+            && (other->info_type == info_type)
+            && (other->cl_object2 == cl_object2)) {
+            g_slice_free1(sizeof(struct ccl_wrapper_info_fast) + size, entry);
+            return &other->info;
+        }
+        idx = (idx + 1) & (fast->num_slots - 1);
+    }
+
+    return &entry->info;
+}
+
+/**
+ * @internal
+ *
+ * @brief Query an OpenCL object for information.
+ *
+ * Fixed-size information is speculatively fetched with a single call,
+ * otherwise the size of information is queried first and then the
+ * information itself.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 The wrapper object to query.
+ * @param[in] wrapper2 A second wrapper object, required in some queries.
+ * @param[in] param_name Name of information/parameter to get.
+ * @param[in] info_type Type of information query to perform.
+ * @param[out] value Storage of ::CCL_WRAPPER_INFO_INLINE_SIZE bytes where
+ * small information values are placed.
+ * @param[out] info Location where to place a new information object with
+ * the information value if it is too large for `value`, or `NULL`
+ * otherwise.
+ * @param[out] size Location where to place the size of information.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if query was successful, `CL_FALSE` otherwise.
+ * */
+static cl_bool ccl_wrapper_query_info(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, cl_uint param_name, CCLInfo info_type,
+    void * value, CCLWrapperInfo ** info, size_t * size, CCLErr ** err) {
+
+    /* OpenCL function status. */
+    cl_int ocl_status;
+    /* Size of information in bytes. */
+    size_t size_ret = 0;
+    /* Is the information value small enough to be kept in value? */
+    gboolean small;
+    /* Information function to use. */
+    ccl_wrapper_info_fp info_fun = info_funs[info_type];
+    /* Size of information if it's known to have a fixed size, zero
+     * otherwise. */
+    size_t fixed_size = ccl_wrapper_info_fixed_size(info_type, param_name);
+
+    /* Count query. */
+    ccl_wrapper_counter_inc(&info_queries[info_type]);
+
+    *info = NULL;
+
+    /* Fixed-size information is speculatively fetched with a single
+     * call. */
+    if (fixed_size > 0) {
+
+        ccl_wrapper_counter_inc(&info_calls[info_type]);
+        ocl_status = (wrapper2 == NULL)
+            ? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
+                param_name, fixed_size, value, &size_ret)
+            : ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
+                wrapper2->cl_object, param_name, fixed_size, value,
+                &size_ret);
+
+        if ((ocl_status == CL_INVALID_VALUE) || (size_ret > fixed_size)) {
+
+            /* The implementation disagrees about the size, so fall
+             * back to querying the size first. */
+            fixed_size = 0;
+            size_ret = 0;
+
+        } else {
+
+            ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+                CL_SUCCESS != ocl_status, ocl_status, error_handler,
+                "%s: get info [info] (OpenCL error %d: %s).",
+                CCL_STRD, ocl_status, ccl_err(ocl_status));
+            ccl_if_err_create_goto(*err, CCL_ERROR, size_ret == 0,
+                CCL_ERROR_INFO_UNAVAILABLE_OCL, error_handler,
+                "%s: the requested info is unavailable (info size is 0).",
+                CCL_STRD);
+
+        }
+    }
+
+    /* Otherwise get the size of information and then the information
+     * itself. */
+    if (fixed_size == 0) {
+
+        /* Get size of information. */
+        ccl_wrapper_counter_inc(&info_calls[info_type]);
+        ocl_status = (wrapper2 == NULL)
+            ? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
+                param_name, 0, NULL, &size_ret)
+            : ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
+                wrapper2->cl_object, param_name, 0, NULL, &size_ret);
+
+        /* Avoid bug in Apple OpenCL implementation. */
+#if defined(__APPLE__) || defined(__MACOSX)
+        if ((ocl_status == CL_INVALID_VALUE)
+            && (info_fun == (ccl_wrapper_info_fp) clGetEventProfilingInfo))
+            ocl_status = CL_SUCCESS;
+#endif
+
+        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+            CL_SUCCESS != ocl_status, ocl_status, error_handler,
+            "%s: get info [size] (OpenCL error %d: %s).",
+            CCL_STRD, ocl_status, ccl_err(ocl_status));
+        ccl_if_err_create_goto(*err, CCL_ERROR, size_ret == 0,
+            CCL_ERROR_INFO_UNAVAILABLE_OCL, error_handler,
+            "%s: the requested info is unavailable (info size is 0).",
+            CCL_STRD);
+
+        /* Small values are queried into local storage, larger ones
+         * require an information object. */
+        small = (size_ret <= CCL_WRAPPER_INFO_INLINE_SIZE);
+        if (!small) *info = ccl_wrapper_info_new(size_ret);
+
+        /* Get information. */
+        ccl_wrapper_counter_inc(&info_calls[info_type]);
+        ocl_status = (wrapper2 == NULL)
+            ? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
+                param_name, size_ret, small ? value : (*info)->value, NULL)
+            : ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
+                wrapper2->cl_object, param_name, size_ret,
+                small ? value : (*info)->value, NULL);
+        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+            CL_SUCCESS != ocl_status, ocl_status, error_handler,
+            "%s: get info [info] (OpenCL error %d: %s).",
+            CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    *size = size_ret;
+    return CL_TRUE;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    if (*info != NULL) {
+        ccl_wrapper_info_destroy(*info);
+        *info = NULL;
+    }
+    *size = 0;
+    return CL_FALSE;
+}
 
 /**
- * Information about wrapped OpenCL objects.
+ * @internal
+ *
+ * @brief Keep queried information in the given information table. Must
+ * be called with the information table locked.
+ *
+ * @private @memberof ccl_wrapper_info_table
+ *
+ * @param[in] info_table Information table.
+ * @param[in] param_name Parameter name.
+ * @param[in] value Small information value to be copied, or `NULL` if
+ * `info` is given.
+ * @param[in] info Information object to keep, or `NULL` if `value` is
+ * given.
+ * @param[in] size Size in bytes of information value.
+ * @return The kept information.
  * */
-struct ccl_wrapper_info_table {
+static CCLWrapperInfo * ccl_wrapper_info_table_keep(
+    CCLWrapperInfoTable * info_table, cl_uint param_name,
+    const void * value, CCLWrapperInfo * info, size_t size) {
 
-    /**
-     * Table containing information about the wrapped OpenCL object.
-     * @private
-     * */
-    GHashTable * table;
+    if (value != NULL) {
 
-    /**
-     * List of replaced information about the wrapped OpenCL object.
-     * @private
-     * */
-    GSList * old_info;
+        /* Keep small value inline if possible... */
+        info = ccl_wrapper_info_table_add_inline(
+            info_table, param_name, value, size);
 
-    /**
-     * Mutex for controlling thread access to the OpenCL object
-     * information table.
-     * @private
-     * */
-    GMutex mutex;
+        /* ...otherwise wrap it in an information object. */
+        if (info == NULL) {
+            info = ccl_wrapper_info_new(size);
+            memcpy(info->value, value, size);
+            ccl_wrapper_info_table_add(info_table, param_name, info);
+        }
 
-};
+    } else {
+
+        ccl_wrapper_info_table_add(info_table, param_name, info);
+
+    }
+
+    return info;
+}
+
+/**
+ * @internal
+ *
+ * @brief Keep queried information in the information tables of the given
+ * wrapper: immutable information is kept such that it can be read
+ * without locking, other information is kept in the (locked) table.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 The queried wrapper object.
+ * @param[in] wrapper2 A second wrapper object involved in the query, or
+ * `NULL`.
+ * @param[in] param_name Parameter name.
+ * @param[in] info_type Type of information query.
+ * @param[in] value Small information value to be copied, or `NULL` if
+ * `info` is given.
+ * @param[in] info Information object to keep, or `NULL` if `value` is
+ * given. Ownership is transferred to the wrapper.
+ * @param[in] size Size in bytes of information value.
+ * @return The kept information.
+ * */
+static CCLWrapperInfo * ccl_wrapper_keep_info(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, cl_uint param_name, CCLInfo info_type,
+    const void * value, CCLWrapperInfo * info, size_t size) {
+
+    CCLWrapperInfoTable * info_table;
+    CCLWrapperInfo * info_kept = NULL;
+
+    if (ccl_wrapper_info_is_immutable(info_type, param_name)) {
+
+        /* Publish immutable information. */
+        info_kept = ccl_wrapper_add_info_fast(wrapper1, wrapper2,
+            param_name, info_type, value != NULL ? value : info->value,
+            size);
+        if (info != NULL) ccl_wrapper_info_destroy(info);
+
+    } else {
+
+        /* Keep other information in the locked table. */
+        info_table = ccl_wrapper_get_info_table(wrapper1);
+        ccl_wrapper_mutex_lock(
+            &info_table->mutex, &info_wait, &info_contended);
+        info_kept = ccl_wrapper_info_table_keep(
+            info_table, param_name, value, info, size);
+        g_mutex_unlock(&info_table->mutex);
+
+    }
+
+    return info_kept;
+}
+
+/**
+ * @internal
+ *
+ * @brief Allocate memory for a wrapper, recycling a previously released
+ * wrapper of the same class if possible.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] class Class or type of wrapper.
+ * @param[in] size Size in bytes of wrapper.
+ * @return Zeroed memory for a wrapper of the given class.
+ * */
+static CCLWrapper * ccl_wrapper_alloc(CCLClass class, size_t size) {
+
+    struct ccl_wrapper_pool * pool = g_private_get(&wrapper_pool);
+    CCLWrapper * w = pool != NULL ? pool->free[class] : NULL;
+    CCLWrapperInfoTable * info;
+
+    if ((w != NULL) && ((size_t) w->ref_count == size)) {
+
+        /* Take wrapper from pool, keeping its information table. */
+        pool->free[class] = (CCLWrapper *) w->cl_object;
+        pool->count[class]--;
+        info = w->info;
+        memset(w, 0, size);
+        w->info = info;
+
+    } else {
+
+        /* Pool is empty, allocate new wrapper. */
+        w = (CCLWrapper *) g_slice_alloc0(size);
+
+    }
+
+    return w;
+}
+
+/**
+ * @internal
+ *
+ * @brief Release the memory of a wrapper, keeping it in the pool of the
+ * calling thread for reuse if possible.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper Wrapper to release.
+ * @param[in] size Size in bytes of wrapper.
+ * */
+static void ccl_wrapper_free(CCLWrapper * wrapper, size_t size) {
+
+    struct ccl_wrapper_pool * pool = g_private_get(&wrapper_pool);
+    CCLClass class = wrapper->class;
+
+    /* Create pool for this thread if it doesn't exist yet. */
+    if (pool == NULL) {
+        pool = g_slice_new0(struct ccl_wrapper_pool);
+        g_private_set(&wrapper_pool, pool);
+    }
+
+    if ((pool->count[class] < CCL_WRAPPER_POOL_SIZE)
+        && (size <= G_MAXINT)) {
+
+        /* Keep wrapper in pool. */
+        wrapper->cl_object = pool->free[class];
+        wrapper->ref_count = (int) size;
+        pool->free[class] = wrapper;
+        pool->count[class]++;
+
+    } else {
+
+        /* Pool is full, release wrapper. */
+        if (wrapper->info != NULL)
+            ccl_wrapper_info_table_destroy(wrapper->info);
+        g_slice_free1(size, wrapper);
+
+    }
+}
+
+/* Destroy the wrapper pool of a thread, called on thread exit and by
+ * ccl_wrapper_memcheck() for the calling thread. */
+static void ccl_wrapper_pool_destroy(gpointer data) {
+
+    struct ccl_wrapper_pool * pool = (struct ccl_wrapper_pool *) data;
+    CCLWrapper * w;
+
+    for (guint i = 0; i <= CCL_NONE; ++i) {
+        while ((w = pool->free[i]) != NULL) {
+            pool->free[i] = (CCLWrapper *) w->cl_object;
+            if (w->info != NULL)
+                ccl_wrapper_info_table_destroy(w->info);
+            g_slice_free1((gsize) w->ref_count, w);
+        }
+    }
+    g_slice_free(struct ccl_wrapper_pool, pool);
+}
 
 /* ********************************* */
 /* ****** Protected methods ******** */
@@ -125,41 +1576,44 @@ CCLWrapper * ccl_wrapper_new(CCLClass class, void * cl_object, size_t size) {
     /* The new wrapper object. */
     CCLWrapper * w;
 
-    /* Lock access to table of all existing wrappers. */
-    G_LOCK(wrappers);
+    /* Registry shard where the wrapper is kept. */
+    struct ccl_wrapper_shard * shard =
+        &wrappers[ccl_wrapper_shard_index(cl_object)];
 
-    /* If table of all existing wrappers is not yet initialized,
-     * initialize it. */
-    if (wrappers == NULL) {
-        wrappers = g_hash_table_new_full(
+    /* Lock access to registry shard. */
+    ccl_wrapper_mutex_lock(
+        &shard->mutex, &registry_wait, &registry_contended);
+
+    /* If shard table is not yet initialized, initialize it. */
+    if (shard->table == NULL) {
+        shard->table = g_hash_table_new_full(
             g_direct_hash, g_direct_equal, NULL, NULL);
     }
 
     /* Check if requested wrapper already exists, and get it if so. */
-    w = g_hash_table_lookup(wrappers, cl_object);
+    w = g_hash_table_lookup(shard->table, cl_object);
 
     if (w == NULL) {
 
-        /* Wrapper doesn't yet exist, create it. */
-        w = (CCLWrapper *) g_slice_alloc0(size);
+        /* Wrapper doesn't yet exist, create it. The information table
+         * is only created when required. */
+        w = ccl_wrapper_alloc(class, size);
         w->class = class;
         w->cl_object = cl_object;
 
-        /* Initialize info table. */
-        w->info = g_slice_new0(struct ccl_wrapper_info_table);
-        g_mutex_init(&w->info->mutex);
-
-        /* Insert newly created wrapper in table of all existing
-         * wrappers. */
-        g_hash_table_insert(wrappers, cl_object, w);
+        /* Insert newly created wrapper in registry shard. */
+        g_hash_table_insert(shard->table, cl_object, w);
+        g_atomic_int_inc(&wrappers_count);
+        g_atomic_int_inc(&wrappers_live[class]);
+        g_atomic_pointer_add(&wrappers_bytes[class], (gssize) size);
 
     }
 
     /* Increase reference count of wrapper. */
     ccl_wrapper_ref(w);
 
-    /* Unlock access to table of all existing wrappers. */
-    G_UNLOCK(wrappers);
+    /* Unlock access to registry shard. */
+    g_mutex_unlock(&shard->mutex);
 
     /* Return requested wrapper. */
     return w;
@@ -209,14 +1663,43 @@ cl_bool ccl_wrapper_unref(CCLWrapper * wrapper, size_t size,
 
 #endif
 
-    /* Decrement reference count and check if it reaches 0. */
-    if (g_atomic_int_dec_and_test(&wrapper->ref_count)) {
+    /* Reference count before decrement. */
+    gint ref_count;
+
+    /* Registry shard where the wrapper is kept. */
+    struct ccl_wrapper_shard * shard;
+
+    /* Decrement the reference count without locking while it stays above
+     * zero. */
+    do {
+        ref_count = g_atomic_int_get(&wrapper->ref_count);
+    } while ((ref_count > 1) && (!g_atomic_int_compare_and_exchange(
+        &wrapper->ref_count, ref_count, ref_count - 1)));
+
+    /* If this looks like the last reference, decrement it with the registry
+     * shard locked, so that the wrapper can't be concurrently revived by
+     * ccl_wrapper_new() before it is removed from the registry. */
+    if (ref_count <= 1) {
+        shard = &wrappers[ccl_wrapper_shard_index(wrapper->cl_object)];
+        ccl_wrapper_mutex_lock(
+            &shard->mutex, &registry_wait, &registry_contended);
+        if (g_atomic_int_dec_and_test(&wrapper->ref_count)) {
+            g_hash_table_remove(shard->table, wrapper->cl_object);
+            g_atomic_int_add(&wrappers_count, -1);
+            g_atomic_int_add(&wrappers_live[wrapper->class], -1);
+            g_atomic_pointer_add(
+                &wrappers_bytes[wrapper->class], -(gssize) size);
+            destroyed = CL_TRUE;
+        }
+        g_mutex_unlock(&shard->mutex);
+    }
 
-        /* Ref. count reached 0, so wrapper will be destroyed. */
-        destroyed = CL_TRUE;
+    /* Was the last reference released? */
+    if (destroyed) {
 
         /* Release the OpenCL wrapped object. */
         if (rel_cl_fun != NULL) {
+            ccl_wrapper_counter_inc(&release_calls);
             ocl_status = rel_cl_fun(wrapper->cl_object);
             if (ocl_status != CL_SUCCESS) {
                 g_set_error(err, CCL_OCL_ERROR, ocl_status,
@@ -226,33 +1709,16 @@ cl_bool ccl_wrapper_unref(CCLWrapper * wrapper, size_t size,
             }
         }
 
-        /* Destroy table containing wrapped object information. */
-        if (wrapper->info->table != NULL) {
-            g_hash_table_destroy(wrapper->info->table);
-        }
-        if (wrapper->info->old_info != NULL) {
-            g_slist_free_full(wrapper->info->old_info,
-                (GDestroyNotify) ccl_wrapper_info_destroy);
-        }
-        g_mutex_clear(&wrapper->info->mutex);
-        g_slice_free(struct ccl_wrapper_info_table, wrapper->info);
-
-        /* Remove wrapper from static table, release static table if
-         * empty. */
-        G_LOCK(wrappers);
-        g_hash_table_remove(wrappers, wrapper->cl_object);
-        if (g_hash_table_size(wrappers) == 0) {
-            g_hash_table_destroy(wrappers);
-            wrappers = NULL;
-        }
-        G_UNLOCK(wrappers);
+        /* Clear table containing wrapped object information. */
+        if (wrapper->info != NULL)
+            ccl_wrapper_info_table_clear(wrapper->info);
 
         /* Destroy remaining wrapper fields. */
         if (rel_fields_fun != NULL)
             rel_fields_fun(wrapper);
 
-        /* Destroy wrapper. */
-        g_slice_free1(size, wrapper);
+        /* Destroy wrapper, or keep it for reuse. */
+        ccl_wrapper_free(wrapper, size);
 
     }
 
@@ -280,46 +1746,18 @@ void ccl_wrapper_add_info(CCLWrapper * wrapper, cl_uint param_name,
     /* Make sure info is not NULL. */
     g_return_if_fail(info != NULL);
 
-    /* Lock access to info table. */
-    g_mutex_lock(&wrapper->info->mutex);
-
-    /* If information table is not yet initialized, then
-     * initialize it. */
-    if (wrapper->info->table == NULL) {
-        wrapper->info->table = g_hash_table_new_full(
-            g_direct_hash, g_direct_equal,
-            NULL, (GDestroyNotify) ccl_wrapper_info_destroy);
-    }
-
-    /* Check if information with same key as already present in
-     * table... */
-    if (g_hash_table_contains(
-            wrapper->info->table, GUINT_TO_POINTER(param_name))) {
-
-        /* ...if so, move this information to the old information
-         * table. */
-
-        /* Get existing information... */
-        CCLWrapperInfo * info_old =
-            (CCLWrapperInfo *) g_hash_table_lookup(
-                wrapper->info->table, GUINT_TO_POINTER(param_name));
-
-        /* ...and put it in table of old information. */
-        wrapper->info->old_info =
-            g_slist_prepend(wrapper->info->old_info, info_old);
+    /* Information table, created if required. */
+    CCLWrapperInfoTable * info_table = ccl_wrapper_get_info_table(wrapper);
 
-        /* Remove old info from info table without destroying it. */
-        g_hash_table_steal(
-            wrapper->info->table, GUINT_TO_POINTER(param_name));
-
-    }
+    /* Lock access to info table. */
+    ccl_wrapper_mutex_lock(
+        &info_table->mutex, &info_wait, &info_contended);
 
-    /* Keep new information in information table. */
-    g_hash_table_insert(wrapper->info->table,
-        GUINT_TO_POINTER(param_name), info);
+    /* Add information. */
+    ccl_wrapper_info_table_add(info_table, param_name, info);
 
     /* Unlock access to info table. */
-    g_mutex_unlock(&wrapper->info->mutex);
+    g_mutex_unlock(&info_table->mutex);
 }
 
 /**
@@ -434,141 +1872,236 @@ void * ccl_wrapper_unwrap(CCLWrapper * wrapper) {
 }
 
 /**
- * Get information about any wrapped OpenCL object.
+ * Get information about any wrapped OpenCL object.
+ *
+ * This function should not be directly invoked in most circumstances. Use the
+ * `ccl_*_get_info_*()` macros instead.
+ *
+ * @public @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 The wrapper object to query.
+ * @param[in] wrapper2 A second wrapper object, required in some
+ * queries.
+ * @param[in] param_name Name of information/parameter to get.
+ * @param[in] min_size Minimum size of returned information object in
+ * case of error.
+ * @param[in] info_type Type of information query to perform.
+ * @param[in] use_cache `CL_TRUE` if cached information is to be used,
+ * `CL_FALSE` to force a new query even if information is in cache.
+ * Information which can't change during the lifetime of the OpenCL object
+ * (e.g. device limits, event profiling timestamps) is always taken from
+ * the cache, without locking, if available.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The requested information object. This object will
+ * be automatically freed when the respective wrapper object is
+ * destroyed, or, once replaced by a newer query of the same information,
+ * when ccl_wrapper_release_old_info() is called. If an error occurs,
+ * either `NULL` (if `min_size == 0`), or a `min_size`d information object
+ * is returned (if `min_size > 0`).
+ * */
+CCL_EXPORT
+CCLWrapperInfo * ccl_wrapper_get_info(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, cl_uint param_name, size_t min_size,
+    CCLInfo info_type, cl_bool use_cache, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+
+    /* Make sure wrapper1 is not NULL. */
+    g_return_val_if_fail(wrapper1 != NULL, NULL);
+
+    /* Make sure info_type has a valid value. */
+    g_return_val_if_fail((info_type >= 0) && (info_type < CCL_INFO_END), NULL);
+
+    /* Information object. */
+    CCLWrapperInfo * info = NULL;
+
+    /* Is the requested information immutable? */
+    gboolean immutable = ccl_wrapper_info_is_immutable(info_type, param_name);
+
+    /* Immutable information is always taken from the cache if available,
+     * without locking. Otherwise check if info table cache contains
+     * requested information, if it is to be used. */
+    if (immutable) {
+        info = ccl_wrapper_lookup_info_fast(
+            wrapper1, wrapper2, param_name, info_type);
+        if (info != NULL) ccl_wrapper_counter_inc(&info_fast_hits[info_type]);
+    } else if (use_cache) {
+        info = ccl_wrapper_lookup_info(wrapper1, param_name);
+        if (info != NULL)
+            ccl_wrapper_counter_inc(&info_locked_hits[info_type]);
+    }
+
+    /* Check if it is required to query OpenCL object, i.e. if info
+     * table cache is not to be used or info table cache does not
+     * contain requested info.  */
+    if (info == NULL) {
+
+        /* Storage for small information values. */
+        guint64 value[CCL_WRAPPER_INFO_INLINE_SIZE / sizeof(guint64)];
+        /* Size of information in bytes. */
+        size_t size_ret;
+        /* Internal error object. */
+        CCLErr * err_internal = NULL;
+
+        /* Query OpenCL object. */
+        ccl_wrapper_query_info(wrapper1, wrapper2, param_name, info_type,
+            value, &info, &size_ret, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        /* Keep information in the information tables. */
+        info = ccl_wrapper_keep_info(wrapper1, wrapper2, param_name,
+            info_type, info == NULL ? value : NULL, info, size_ret);
+
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    /* In case of error, return an all-zeros info if min_size is > 0. */
+    info = NULL;
+    if (min_size > 0) {
+        CCLWrapperInfoTable * info_table =
+            ccl_wrapper_get_info_table(wrapper1);
+        ccl_wrapper_mutex_lock(
+            &info_table->mutex, &info_wait, &info_contended);
+        if (min_size <= CCL_WRAPPER_INFO_INLINE_SIZE)
+            info = ccl_wrapper_info_table_add_inline(
+                info_table, param_name, NULL, min_size);
+        if (info == NULL) {
+            info = ccl_wrapper_info_new(min_size);
+            ccl_wrapper_info_table_add(info_table, param_name, info);
+        }
+        g_mutex_unlock(&info_table->mutex);
+    }
+
+finish:
+
+    /* Return the requested information. */
+    return info;
+}
+
+/**
+ * Fill the information cache of a wrapper object with the given
+ * parameters in one pass, e.g. at startup, such that subsequent
+ * `ccl_*_get_info_*()` calls don't need to query the OpenCL object.
  *
- * This function should not be directly invoked in most circumstances. Use the
- * `ccl_*_get_info_*()` macros instead.
+ * Information which can't change during the lifetime of the OpenCL object
+ * is published without locking. Other information is kept under a single
+ * acquisition of the information table lock, and is only used by
+ * queries which explicitly request cached information. Parameters which
+ * are already cached are skipped, and parameters which can't be queried
+ * (e.g. because they're not supported by the OpenCL implementation) are
+ * silently ignored; the respective error will be reported when they're
+ * explicitly requested.
+ *
+ * This function should not be directly invoked in most circumstances.
+ * Use the `ccl_*_prefetch_info()` macros instead.
  *
  * @public @memberof ccl_wrapper
  *
  * @param[in] wrapper1 The wrapper object to query.
  * @param[in] wrapper2 A second wrapper object, required in some
  * queries.
- * @param[in] param_name Name of information/parameter to get.
- * @param[in] min_size Minimum size of returned information object in
- * case of error.
+ * @param[in] param_names Array of names of information/parameters to
+ * prefetch.
+ * @param[in] num_params Number of parameters in `param_names`.
  * @param[in] info_type Type of information query to perform.
- * @param[in] use_cache `CL_TRUE` if cached information is to be used,
- * `CL_FALSE` to force a new query even if information is in cache.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The requested information object. This object will
- * be automatically freed when the respective wrapper object is
- * destroyed. If an error occurs, either `NULL` (if `min_size == 0`), or
- * a `min_size`d information object is returned (if `min_size > 0`).
+ * @return Number of parameters whose information is now cached.
  * */
 CCL_EXPORT
-CCLWrapperInfo * ccl_wrapper_get_info(CCLWrapper * wrapper1,
-    CCLWrapper * wrapper2, cl_uint param_name, size_t min_size,
-    CCLInfo info_type, cl_bool use_cache, CCLErr ** err) {
-
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+cl_uint ccl_wrapper_prefetch_info(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, const cl_uint * param_names, cl_uint num_params,
+    CCLInfo info_type) {
 
     /* Make sure wrapper1 is not NULL. */
-    g_return_val_if_fail(wrapper1 != NULL, NULL);
-
-    /* Make sure info_type has a valid value. */
-    g_return_val_if_fail((info_type >= 0) && (info_type < CCL_INFO_END), NULL);
-
-    /* Information object. */
-    CCLWrapperInfo * info = NULL;
+    g_return_val_if_fail(wrapper1 != NULL, 0);
 
-    /* Does info table cache contain requested information? */
-    gboolean contains;
+    /* Make sure param_names is not NULL if parameters are given. */
+    g_return_val_if_fail((param_names != NULL) || (num_params == 0), 0);
 
-    /* Information function to use. */
-    ccl_wrapper_info_fp info_fun = info_funs[info_type];
+    /* Make sure info_type has a valid value. */
+    g_return_val_if_fail((info_type >= 0) && (info_type < CCL_INFO_END), 0);
 
-    /* Check if info table cache contains requested information. */
-    g_mutex_lock(&wrapper1->info->mutex);
-    contains = wrapper1->info->table != NULL
-        ? g_hash_table_contains(
-            wrapper1->info->table, GUINT_TO_POINTER(param_name))
-        : FALSE;
-    g_mutex_unlock(&wrapper1->info->mutex);
+    /* Information waiting to be kept in the locked table. */
+    struct ccl_wrapper_info_pending * pending;
+    struct ccl_wrapper_info_pending * p;
+    cl_uint num_pending = 0;
 
-    /* Check if it is required to query OpenCL object, i.e. if info
-     * table cache is not to be used or info table cache does not
-     * contain requested info.  */
-    if ((!use_cache) || (!contains)) {
+    /* Number of cached parameters. */
+    cl_uint num_cached = 0;
 
-        /* Let's query OpenCL object.*/
-        cl_int ocl_status;
-        /* Size of device information in bytes. */
-        size_t size_ret = 0;
+    /* Information table. */
+    CCLWrapperInfoTable * info_table;
 
-        /* Get size of information. */
-        ocl_status = (wrapper2 == NULL)
-            ? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
-                param_name, 0, NULL, &size_ret)
-            : ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
-                wrapper2->cl_object, param_name, 0, NULL, &size_ret);
+    /* Is current information immutable? */
+    gboolean immutable;
 
-        /* Avoid bug in Apple OpenCL implementation. */
-#if defined(__APPLE__) || defined(__MACOSX)
-        if ((ocl_status == CL_INVALID_VALUE)
-            && (info_fun == (ccl_wrapper_info_fp) clGetEventProfilingInfo))
-            ocl_status = CL_SUCCESS;
-#endif
+    /* Nothing to do if no parameters were given. */
+    if (num_params == 0) return 0;
 
-        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
-            CL_SUCCESS != ocl_status, ocl_status, error_handler,
-            "%s: get info [size] (OpenCL error %d: %s).",
-            CCL_STRD, ocl_status, ccl_err(ocl_status));
-        ccl_if_err_create_goto(*err, CCL_ERROR, size_ret == 0,
-            CCL_ERROR_INFO_UNAVAILABLE_OCL, error_handler,
-            "%s: the requested info is unavailable (info size is 0).",
-            CCL_STRD);
+    pending = g_new(struct ccl_wrapper_info_pending, num_params);
 
-        /* Allocate memory for information. */
-        info = ccl_wrapper_info_new(size_ret);
+    /* Query all parameters which are not yet cached, publishing
+     * immutable information right away. */
+    for (cl_uint i = 0; i < num_params; ++i) {
 
-        /* Get information. */
-        ocl_status = (wrapper2 == NULL)
-            ? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
-                param_name, size_ret, info->value, NULL)
-            : ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
-                wrapper2->cl_object, param_name, size_ret, info->value,
-                NULL);
-        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
-            CL_SUCCESS != ocl_status, ocl_status, error_handler,
-            "%s: get context info [info] (OpenCL error %d: %s).",
-            CCL_STRD, ocl_status, ccl_err(ocl_status));
+        immutable = ccl_wrapper_info_is_immutable(info_type, param_names[i]);
 
-        /* Keep information in information table. */
-        ccl_wrapper_add_info(wrapper1, param_name, info);
+        /* Skip immutable information which is already cached. */
+        if (immutable && (ccl_wrapper_lookup_info_fast(
+            wrapper1, wrapper2, param_names[i], info_type) != NULL)) {
 
-    } else {
+            num_cached++;
+            continue;
+        }
 
-        /* Requested info is already present in the info table,
-         * retrieve it from there. */
-        g_mutex_lock(&wrapper1->info->mutex);
-        info = g_hash_table_lookup(
-            wrapper1->info->table, GUINT_TO_POINTER(param_name));
-        g_mutex_unlock(&wrapper1->info->mutex);
+        /* Query OpenCL object, ignore parameters which can't be
+         * queried. */
+        p = &pending[num_pending];
+        if (!ccl_wrapper_query_info(wrapper1, wrapper2, param_names[i],
+            info_type, p->value, &p->info, &p->size, NULL)) continue;
+
+        /* Publish immutable information. */
+        if (immutable) {
+            ccl_wrapper_add_info_fast(wrapper1, wrapper2, param_names[i],
+                info_type, p->info != NULL ? p->info->value : p->value,
+                p->size);
+            if (p->info != NULL) ccl_wrapper_info_destroy(p->info);
+            num_cached++;
+            continue;
+        }
 
+        /* Keep remaining information for later. */
+        p->param_name = param_names[i];
+        num_pending++;
     }
 
-    /* If we got here, everything is OK. */
-    g_assert(err == NULL || *err == NULL);
-    goto finish;
-
-error_handler:
-    /* If we got here there was an error, verify that it is so. */
-    g_assert(err == NULL || *err != NULL);
-
-    /* In case of error, return an all-zeros info if min_size is > 0. */
-    if (min_size > 0) {
-        if (info != NULL) ccl_wrapper_info_destroy(info);
-        info = ccl_wrapper_info_new(min_size);
-        ccl_wrapper_add_info(wrapper1, param_name, info);
+    /* Keep remaining information in the locked table, under a single
+     * lock acquisition. */
+    if (num_pending > 0) {
+
+        info_table = ccl_wrapper_get_info_table(wrapper1);
+        ccl_wrapper_mutex_lock(
+            &info_table->mutex, &info_wait, &info_contended);
+        for (cl_uint i = 0; i < num_pending; ++i) {
+            p = &pending[i];
+            ccl_wrapper_info_table_keep(info_table, p->param_name,
+                p->info == NULL ? p->value : NULL, p->info, p->size);
+        }
+        g_mutex_unlock(&info_table->mutex);
+        num_cached += num_pending;
     }
 
-finish:
+    g_free(pending);
 
-    /* Return the requested information. */
-    return info;
+    return num_cached;
 }
 
 /**
@@ -658,6 +2191,444 @@ size_t ccl_wrapper_get_info_size(CCLWrapper * wrapper1,
     return diw != NULL ? diw->size : 0;
 }
 
+/**
+ * Release information of the given wrapper which has been replaced by
+ * newer queries of the same information. By default, replaced
+ * information is kept until the wrapper is destroyed, since clients may
+ * still hold it; this function allows long-lived wrappers which are
+ * continuously re-queried (e.g. for reference counts or mutable program
+ * information) to bound their memory usage.
+ *
+ * @public @memberof ccl_wrapper
+ *
+ * @attention The caller must guarantee that no thread is still using
+ * information previously returned for this wrapper which has since been
+ * replaced. The current (most recently returned) information of each
+ * parameter remains valid.
+ *
+ * @param[in] wrapper The wrapper object.
+ * */
+CCL_EXPORT
+void ccl_wrapper_release_old_info(CCLWrapper * wrapper) {
+
+    /* Make sure wrapper is not NULL. */
+    g_return_if_fail(wrapper != NULL);
+
+    CCLWrapperInfoTable * info = g_atomic_pointer_get(&wrapper->info);
+
+    /* No table means no replaced information. */
+    if (info == NULL) return;
+
+    ccl_wrapper_mutex_lock(&info->mutex, &info_wait, &info_contended);
+
+    /* Release replaced information kept in the heap... */
+    g_slist_free_full(
+        info->old_info, (GDestroyNotify) ccl_wrapper_info_destroy);
+    info->old_info = NULL;
+
+    /* ...and allow retired inline slots to be reused. */
+    for (guint i = 0; i < info->num_inline; ++i)
+        info->inl[i].retired = FALSE;
+
+    g_mutex_unlock(&info->mutex);
+}
+
+/**
+ * @internal
+ *
+ * @brief Get the number of information requests of a given type served
+ * without locking, served from the cache with locking, and which required
+ * querying the OpenCL object.
+ *
+ * @protected @memberof ccl_wrapper
+ *
+ * @param[in] info_type Type of information query.
+ * @param[out] fast_hits Location where to put the number of requests
+ * served without locking, or `NULL`.
+ * @param[out] locked_hits Location where to put the number of requests
+ * served from the cache with locking, or `NULL`.
+ * @param[out] queries Location where to put the number of requests which
+ * queried the OpenCL object, or `NULL`.
+ * */
+void ccl_wrapper_get_info_counters(CCLInfo info_type, guint64 * fast_hits,
+    guint64 * locked_hits, guint64 * queries) {
+
+    /* Make sure info_type has a valid value. */
+    g_return_if_fail((info_type >= 0) && (info_type < CCL_INFO_END));
+
+    if (fast_hits != NULL)
+        *fast_hits = ccl_wrapper_counter_get(&info_fast_hits[info_type]);
+    if (locked_hits != NULL)
+        *locked_hits = ccl_wrapper_counter_get(&info_locked_hits[info_type]);
+    if (queries != NULL)
+        *queries = ccl_wrapper_counter_get(&info_queries[info_type]);
+}
+
+/**
+ * @internal
+ *
+ * @brief Get cached immutable information without querying the OpenCL
+ * object.
+ *
+ * @protected @memberof ccl_wrapper
+ *
+ * @param[in] wrapper The wrapper object.
+ * @param[in] param_name Parameter name.
+ * @param[in] info_type Type of information query.
+ * @return The cached information, or `NULL` if the information isn't
+ * immutable or isn't cached.
+ * */
+CCLWrapperInfo * ccl_wrapper_lookup_info_immutable(CCLWrapper * wrapper,
+    cl_uint param_name, CCLInfo info_type) {
+
+    /* Make sure wrapper is not NULL. */
+    g_return_val_if_fail(wrapper != NULL, NULL);
+
+    /* Make sure info_type has a valid value. */
+    g_return_val_if_fail((info_type >= 0) && (info_type < CCL_INFO_END), NULL);
+
+    if (!ccl_wrapper_info_is_immutable(info_type, param_name)) return NULL;
+
+    return ccl_wrapper_lookup_info_fast(wrapper, NULL, param_name, info_type);
+}
+
+/**
+ * @internal
+ *
+ * @brief Place immutable information in the cache of a wrapper object, such
+ * that subsequent requests don't need to query the OpenCL object.
+ *
+ * @protected @memberof ccl_wrapper
+ *
+ * @param[in] wrapper The wrapper object.
+ * @param[in] param_name Parameter name.
+ * @param[in] info_type Type of information query.
+ * @param[in] value Information value, which is copied.
+ * @param[in] size Size in bytes of information value.
+ * @return `CL_TRUE` if information is now cached, `CL_FALSE` if the
+ * information isn't immutable.
+ * */
+cl_bool ccl_wrapper_add_info_immutable(CCLWrapper * wrapper,
+    cl_uint param_name, CCLInfo info_type, const void * value, size_t size) {
+
+    /* Make sure wrapper is not NULL. */
+    g_return_val_if_fail(wrapper != NULL, CL_FALSE);
+
+    /* Make sure info_type has a valid value. */
+    g_return_val_if_fail(
+        (info_type >= 0) && (info_type < CCL_INFO_END), CL_FALSE);
+
+    /* Make sure value is not NULL if size is given. */
+    g_return_val_if_fail((value != NULL) || (size == 0), CL_FALSE);
+
+    if (!ccl_wrapper_info_is_immutable(info_type, param_name))
+        return CL_FALSE;
+
+    ccl_wrapper_add_info_fast(wrapper, NULL, param_name, info_type,
+        value, size);
+    return CL_TRUE;
+}
+
+/**
+ * @internal
+ *
+ * @brief Remove the cache of an owner from the thread-local caches of the
+ * calling thread. Must be called with ::thread_cache_mutex held.
+ *
+ * @param[in] caches Hash table of thread-local caches.
+ * @param[in] id Owner ID.
+ * @param[in] steal Remove the cache from the hash table (`FALSE` if it
+ * is removed by the caller).
+ * */
+static void ccl_wrapper_thread_cache_drop(
+    GHashTable * caches, gint id, gboolean steal) {
+
+    CCLWrapperThreadCacheOwner * owner;
+
+    owner = g_hash_table_lookup(thread_cache_owners, GINT_TO_POINTER(id));
+    g_assert(owner != NULL && owner->num_caches > 0);
+
+    if (steal) g_hash_table_remove(caches, GINT_TO_POINTER(id));
+    g_atomic_int_add(&thread_caches_live, -1);
+
+    /* Forget retired owners which are no longer cached by any thread. */
+    owner->num_caches--;
+    if (owner->retired && (owner->num_caches == 0))
+        g_hash_table_remove(thread_cache_owners, GINT_TO_POINTER(id));
+}
+
+/**
+ * @internal
+ *
+ * @brief Remove the caches of destroyed owners from the thread-local
+ * caches of the calling thread.
+ *
+ * @param[in] tc Thread-local caches of the calling thread.
+ * */
+static void ccl_wrapper_thread_caches_purge(CCLWrapperThreadCaches * tc) {
+
+    GHashTableIter iter;
+    gpointer id;
+    CCLWrapperThreadCacheOwner * owner;
+
+    g_mutex_lock(&thread_cache_mutex);
+
+    tc->retired_seen = g_atomic_int_get(&thread_cache_retired);
+    g_hash_table_iter_init(&iter, tc->caches);
+    while (g_hash_table_iter_next(&iter, &id, NULL)) {
+        owner = g_hash_table_lookup(thread_cache_owners, id);
+        if (owner->retired) {
+            g_hash_table_iter_remove(&iter);
+            ccl_wrapper_thread_cache_drop(
+                tc->caches, GPOINTER_TO_INT(id), FALSE);
+        }
+    }
+
+    g_mutex_unlock(&thread_cache_mutex);
+}
+
+/**
+ * @internal
+ *
+ * @brief Release the thread-local caches of a thread which is exiting.
+ *
+ * @param[in] data A ::CCLWrapperThreadCaches object.
+ * */
+static void ccl_wrapper_thread_caches_destroy(gpointer data) {
+
+    CCLWrapperThreadCaches * tc = (CCLWrapperThreadCaches *) data;
+    GHashTableIter iter;
+    gpointer id;
+
+    g_mutex_lock(&thread_cache_mutex);
+    g_hash_table_iter_init(&iter, tc->caches);
+    while (g_hash_table_iter_next(&iter, &id, NULL))
+        ccl_wrapper_thread_cache_drop(
+            tc->caches, GPOINTER_TO_INT(id), FALSE);
+    g_mutex_unlock(&thread_cache_mutex);
+
+    g_hash_table_destroy(tc->caches);
+    g_slice_free(CCLWrapperThreadCaches, tc);
+}
+
+/**
+ * @internal
+ *
+ * @brief Get the thread-local cache which a given owner object keeps for
+ * the calling thread, creating it if required.
+ *
+ * Owners are identified by an ID, assigned on first use, and never reused,
+ * so a cache is never confused with the cache of a destroyed owner. The
+ * cache is a hash table which is only ever accessed by the calling thread.
+ * Objects referenced by the cache should be owned (and eventually
+ * released) by the owner object, which must call
+ * ::ccl_wrapper_thread_cache_release() when destroyed. The cache is then
+ * removed immediately if it belongs to the thread destroying the owner,
+ * or otherwise the next time its thread requests a thread-local cache, or
+ * when its thread exits.
+ *
+ * @protected @memberof ccl_wrapper
+ *
+ * @param[in,out] owner_id Location of the ID of the owner object, which
+ * should be initialized to 0.
+ * @param[in] hash_func Hash function for the keys of the cache.
+ * @param[in] key_equal_func Equality function for the keys of the cache.
+ * @param[in] key_destroy_func Destroy function for the keys of the cache,
+ * or `NULL`.
+ * @return The thread-local cache of the owner object.
+ * */
+GHashTable * ccl_wrapper_thread_cache(volatile gint * owner_id,
+    GHashFunc hash_func, GEqualFunc key_equal_func,
+    GDestroyNotify key_destroy_func) {
+
+    CCLWrapperThreadCaches * tc = g_private_get(&thread_caches);
+    CCLWrapperThreadCacheOwner * owner;
+    GHashTable * cache;
+    gint id = g_atomic_int_get(owner_id);
+
+    /* Give an ID to the owner if it doesn't have one yet. */
+    if (id == 0) {
+        id = g_atomic_int_add(&thread_cache_last_id, 1) + 1;
+        if (!g_atomic_int_compare_and_exchange(owner_id, 0, id))
+            id = g_atomic_int_get(owner_id);
+    }
+
+    /* Get the caches of the calling thread. */
+    if (tc == NULL) {
+        tc = g_slice_new(CCLWrapperThreadCaches);
+        tc->caches = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, (GDestroyNotify) g_hash_table_destroy);
+        tc->retired_seen = g_atomic_int_get(&thread_cache_retired);
+        g_private_set(&thread_caches, tc);
+    }
+
+    /* Remove caches of owners destroyed by other threads. */
+    if (tc->retired_seen != g_atomic_int_get(&thread_cache_retired))
+        ccl_wrapper_thread_caches_purge(tc);
+
+    /* Get the cache of the owner. */
+    cache = g_hash_table_lookup(tc->caches, GINT_TO_POINTER(id));
+    if (cache == NULL) {
+
+        cache = g_hash_table_new_full(
+            hash_func, key_equal_func, key_destroy_func, NULL);
+        g_hash_table_insert(tc->caches, GINT_TO_POINTER(id), cache);
+
+        /* Register the cache with the owner. */
+        g_mutex_lock(&thread_cache_mutex);
+        if (thread_cache_owners == NULL)
+            thread_cache_owners = g_hash_table_new_full(
+                g_direct_hash, g_direct_equal, NULL, g_free);
+        owner = g_hash_table_lookup(
+            thread_cache_owners, GINT_TO_POINTER(id));
+        if (owner == NULL) {
+            owner = g_new0(CCLWrapperThreadCacheOwner, 1);
+            g_hash_table_insert(
+                thread_cache_owners, GINT_TO_POINTER(id), owner);
+        }
+        owner->num_caches++;
+        g_atomic_int_inc(&thread_caches_live);
+        g_mutex_unlock(&thread_cache_mutex);
+    }
+
+    return cache;
+}
+
+/**
+ * @internal
+ *
+ * @brief Release the thread-local caches of an owner object which is
+ * being destroyed.
+ *
+ * The cache of the calling thread is removed immediately. Caches kept by
+ * other threads are removed by those threads, as described in
+ * ::ccl_wrapper_thread_cache().
+ *
+ * @protected @memberof ccl_wrapper
+ *
+ * @param[in] owner_id Location of the ID of the owner object.
+ * */
+void ccl_wrapper_thread_cache_release(volatile gint * owner_id) {
+
+    CCLWrapperThreadCaches * tc;
+    CCLWrapperThreadCacheOwner * owner;
+    gint id = g_atomic_int_get(owner_id);
+
+    /* Nothing to do if the owner never kept a cache. */
+    if (id == 0) return;
+
+    tc = g_private_get(&thread_caches);
+
+    g_mutex_lock(&thread_cache_mutex);
+
+    /* Remove the cache of the calling thread. */
+    if ((tc != NULL)
+        && (g_hash_table_lookup(tc->caches, GINT_TO_POINTER(id)) != NULL))
+        ccl_wrapper_thread_cache_drop(tc->caches, id, TRUE);
+
+    /* Retire the owner, letting other threads know if they still keep a
+     * cache for it. */
+    owner = (thread_cache_owners != NULL)
+        ? g_hash_table_lookup(thread_cache_owners, GINT_TO_POINTER(id))
+        : NULL;
+    if (owner != NULL) {
+        if (owner->num_caches == 0) {
+            g_hash_table_remove(thread_cache_owners, GINT_TO_POINTER(id));
+        } else {
+            owner->retired = TRUE;
+            g_atomic_int_inc(&thread_cache_retired);
+        }
+    }
+
+    g_mutex_unlock(&thread_cache_mutex);
+}
+
+/**
+ * Get runtime statistics of wrapper objects, namely the number of live
+ * wrappers and the memory they hold, how information requests were
+ * served, how many times the OpenCL implementation was called and how much
+ * time was spent waiting on internal locks.
+ *
+ * Statistics are always collected, at the cost of a few atomic
+ * increments per operation. The clock is only read when a lock is
+ * contended. Counters are cumulative since the program started, so
+ * clients interested in the overhead of a specific operation should take
+ * the difference between statistics obtained before and after it.
+ *
+ * @public @memberof ccl_wrapper
+ *
+ * @param[out] stats Location where to place the statistics.
+ * */
+CCL_EXPORT
+void ccl_wrapper_stats(CCLWrapperStats * stats) {
+
+    /* Make sure stats is not NULL. */
+    g_return_if_fail(stats != NULL);
+
+    for (guint i = 0; i <= CCL_NONE; ++i) {
+        stats->live[i] = (guint) g_atomic_int_get(&wrappers_live[i]);
+        stats->bytes[i] = (gsize) g_atomic_pointer_get(&wrappers_bytes[i]);
+    }
+
+    for (guint i = 0; i < CCL_INFO_END; ++i) {
+        stats->info_hits[i] = ccl_wrapper_counter_get(&info_fast_hits[i])
+            + ccl_wrapper_counter_get(&info_locked_hits[i]);
+        stats->info_misses[i] = ccl_wrapper_counter_get(&info_queries[i]);
+        stats->info_calls[i] = ccl_wrapper_counter_get(&info_calls[i]);
+    }
+
+    stats->release_calls = ccl_wrapper_counter_get(&release_calls);
+
+    g_mutex_lock(&lock_stats_mutex);
+    stats->registry_wait = registry_wait;
+    stats->registry_contended = registry_contended;
+    stats->info_wait = info_wait;
+    stats->info_contended = info_contended;
+    g_mutex_unlock(&lock_stats_mutex);
+
+    stats->thread_caches = (guint) g_atomic_int_get(&thread_caches_live);
+}
+
+/**
+ * @internal
+ *
+ * @brief Destroy the registry shard tables which are empty, the wrapper
+ * pool of the calling thread and the worker pool of ::ccl_event_then().
+ * Called by ::ccl_wrapper_memcheck() once no wrappers exist. The wrapper
+ * pools of other threads are destroyed when they exit, but the main
+ * thread's pool would otherwise never be.
+ *
+ * @private @memberof ccl_wrapper
+ * */
+static void ccl_wrapper_release_unused() {
+
+    /* Wrapper pool of the calling thread. */
+    struct ccl_wrapper_pool * pool = g_private_get(&wrapper_pool);
+
+    if (pool != NULL) {
+        g_private_set(&wrapper_pool, NULL);
+        ccl_wrapper_pool_destroy(pool);
+    }
+
+    for (guint i = 0; i < CCL_WRAPPER_NUM_SHARDS; ++i) {
+
+        g_mutex_lock(&wrappers[i].mutex);
+
+        /* Another thread may have wrapped an object in the meantime. */
+        if ((wrappers[i].table != NULL)
+            && (g_hash_table_size(wrappers[i].table) == 0)) {
+
+            g_hash_table_destroy(wrappers[i].table);
+            wrappers[i].table = NULL;
+        }
+
+        g_mutex_unlock(&wrappers[i].mutex);
+    }
+
+    /* Free worker pool of ccl_event_then(). */
+    ccl_event_then_pool_free();
+}
+
 /**
  * Debug function which checks if memory allocated by wrappers has been
  * properly freed.
@@ -665,7 +2636,10 @@ size_t ccl_wrapper_get_info_size(CCLWrapper * wrapper1,
  * @public @memberof ccl_wrapper
  *
  * This function is merely a debug helper and shouldn't replace proper leak
- * checks with Valgrind or similar tool.
+ * checks with Valgrind or similar tool. If no wrappers exist, memory which
+ * the library keeps around for reuse by new wrappers, such as the tables
+ * of the wrapper registry and the recycled wrappers of the calling thread,
+ * is released.
  *
  * @return `CL_TRUE` if memory allocated by wrappers has been properly freed,
  * `CL_FALSE` otherwise.
@@ -692,39 +2666,51 @@ cl_bool ccl_wrapper_memcheck() {
 
 #endif
 
-    /* Lock access to wrappers variable. */
-    G_LOCK(wrappers);
-
-    /* Check if wrappers variable is set. */
-    check = (wrappers == NULL);
+    /* Check if there are any existing wrappers. */
+    check = (g_atomic_int_get(&wrappers_count) == 0);
 
 #ifndef NDEBUG
 
     /* In debug mode, log existing wrappers. */
     if (check) {
 
-        /* Wrappers table is empty. */
+        /* Wrappers registry is empty. */
         g_debug("Wrappers table is empty");
 
     } else {
 
-        /* Wrappers table is not empty, list them. */
-
-        /* Initialize iterator. */
-        g_hash_table_iter_init(&iter, wrappers);
+        /* Wrappers registry is not empty, list them. */
 
         /* Initialize log string. */
         logstr = g_string_new("");
-        g_string_append_printf(logstr,
-            "There are %u wrappers in table: ", g_hash_table_size(wrappers));
+        g_string_append_printf(logstr, "There are %d wrappers in table: ",
+            g_atomic_int_get(&wrappers_count));
+
+        /* Iterate over registry shards... */
+        for (guint i = 0; i < CCL_WRAPPER_NUM_SHARDS; ++i) {
+
+            /* Lock access to current shard. */
+            g_mutex_lock(&wrappers[i].mutex);
 
-        /* Iterate over existing wrappers... */
-        while(g_hash_table_iter_next(&iter, &addr, (gpointer) &obj)) {
+            /* Skip shard if it's empty. */
+            if (wrappers[i].table != NULL) {
 
-            /*...and add their name and address to log string. */
-            g_string_append_printf(logstr, "\n%s(%p) ",
-                ccl_wrapper_get_class_name(obj), addr);
+                /* Initialize iterator. */
+                g_hash_table_iter_init(&iter, wrappers[i].table);
+
+                /* Iterate over existing wrappers in shard... */
+                while (g_hash_table_iter_next(
+                    &iter, &addr, (gpointer) &obj)) {
+
+                    /*...and add their name and address to log string. */
+                    g_string_append_printf(logstr, "\n%s(%p) ",
+                        ccl_wrapper_get_class_name(obj), addr);
+
+                }
+            }
 
+            /* Unlock access to current shard. */
+            g_mutex_unlock(&wrappers[i].mutex);
         }
 
         /* Log existing wrappers.*/
@@ -737,8 +2723,8 @@ cl_bool ccl_wrapper_memcheck() {
 
 #endif
 
-    /* Unlock access to wrappers variable. */
-    G_UNLOCK(wrappers);
+    /* Release memory kept for reuse if no wrappers exist. */
+    if (check) ccl_wrapper_release_unused();
 
     /* Return check. */
     return check;
@@ -52,6 +52,84 @@ typedef struct ccl_wrapper_info {
 
 } CCLWrapperInfo;
 
+/**
+ * Runtime statistics of wrapper objects, obtained with
+ * ::ccl_wrapper_stats().
+ * */
+typedef struct ccl_wrapper_stats {
+
+    /**
+     * Number of live wrappers, per class.
+     * @public
+     * */
+    guint live[CCL_NONE + 1];
+
+    /**
+     * Bytes held by live wrappers, per class, not including cached
+     * information.
+     * @public
+     * */
+    gsize bytes[CCL_NONE + 1];
+
+    /**
+     * Number of information requests served from the cache, per info
+     * type.
+     * @public
+     * */
+    guint64 info_hits[CCL_INFO_END];
+
+    /**
+     * Number of information requests which queried the OpenCL object,
+     * per info type.
+     * @public
+     * */
+    guint64 info_misses[CCL_INFO_END];
+
+    /**
+     * Number of calls to OpenCL `clGet*Info()` functions, per info type.
+     * @public
+     * */
+    guint64 info_calls[CCL_INFO_END];
+
+    /**
+     * Number of calls to OpenCL `clRelease*()` functions.
+     * @public
+     * */
+    guint64 release_calls;
+
+    /**
+     * Time in microseconds spent waiting on the wrappers registry lock.
+     * @public
+     * */
+    guint64 registry_wait;
+
+    /**
+     * Number of times the wrappers registry lock was contended.
+     * @public
+     * */
+    guint64 registry_contended;
+
+    /**
+     * Time in microseconds spent waiting on wrapper information locks.
+     * @public
+     * */
+    guint64 info_wait;
+
+    /**
+     * Number of times a wrapper information lock was contended.
+     * @public
+     * */
+    guint64 info_contended;
+
+    /**
+     * Number of thread-local caches kept by programs and command queue
+     * pools for the threads which use them.
+     * @public
+     * */
+    guint thread_caches;
+
+} CCLWrapperStats;
+
 /* Increase the reference count of the wrapper object. */
 CCL_EXPORT
 void ccl_wrapper_ref(CCLWrapper * wrapper);
@@ -71,6 +149,13 @@ CCLWrapperInfo * ccl_wrapper_get_info(CCLWrapper * wrapper1,
     CCLWrapper * wrapper2, cl_uint param_name, size_t min_size,
     CCLInfo info_type, cl_bool use_cache, CCLErr ** err);
 
+/* Fill the information cache of a wrapper object with the given
+ * parameters in one pass. */
+CCL_EXPORT
+cl_uint ccl_wrapper_prefetch_info(CCLWrapper * wrapper1,
+    CCLWrapper * wrapper2, const cl_uint * param_names, cl_uint num_params,
+    CCLInfo info_type);
+
 /* Get pointer to information value. */
 CCL_EXPORT
 void * ccl_wrapper_get_info_value(CCLWrapper * wrapper1,
@@ -83,11 +168,20 @@ size_t ccl_wrapper_get_info_size(CCLWrapper * wrapper1,
     CCLWrapper * wrapper2, cl_uint param_name, size_t min_size,
     CCLInfo info_type, cl_bool use_cache, CCLErr ** err);
 
+/* Release information of a wrapper object which has been replaced by
+ * newer queries. */
+CCL_EXPORT
+void ccl_wrapper_release_old_info(CCLWrapper * wrapper);
+
 /* Debug function which checks if memory allocated by wrappers
  * has been properly freed. */
 CCL_EXPORT
 cl_bool ccl_wrapper_memcheck();
 
+/* Get runtime statistics of wrapper objects. */
+CCL_EXPORT
+void ccl_wrapper_stats(CCLWrapperStats * stats);
+
 /* Get wrapper class or type name. */
 CCL_EXPORT
 const char * ccl_wrapper_get_class_name(CCLWrapper * wrapper);
@@ -28,6 +28,7 @@
 #include "ccl_buffer_wrapper.h"
 #include "ccl_image_wrapper.h"
 #include "_ccl_memobj_wrapper.h"
+#include "_ccl_queue_wrapper.h"
 #include "_ccl_defs.h"
 
 /**
@@ -179,21 +180,35 @@ CCLEvent * ccl_buffer_enqueue_read(CCLBuffer * buf, CCLQueue * cq,
 
     cl_int ocl_status;
     cl_event event = NULL;
+    CCLEventWaitList hz_lst = NULL;
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(buf), CL_FALSE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     ocl_status = clEnqueueReadBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), blocking_read, offset, size, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to read buffer (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -253,21 +268,35 @@ CCLEvent * ccl_buffer_enqueue_write(CCLBuffer * buf, CCLQueue * cq,
 
     cl_int ocl_status;
     cl_event event = NULL;
+    CCLEventWaitList hz_lst = NULL;
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     ocl_status = clEnqueueWriteBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), blocking_write, offset, size, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to write buffer (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -331,27 +360,41 @@ void * ccl_buffer_enqueue_map(CCLBuffer * buf, CCLQueue * cq,
 
     cl_int ocl_status;
     cl_event event = NULL;
+    CCLEventWaitList hz_lst = NULL;
     CCLEvent * evt_inner = NULL;
     void * ptr = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(buf), map_flags != CL_MAP_READ } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Perform buffer map. */
     ptr = clEnqueueMapBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), blocking_map, map_flags, offset, size,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
         ccl_event_wait_list_get_clevents(evt_wait_lst),
-        &event, &ocl_status);
+        ccl_queue_event_ptr(cq, &event), &ocl_status);
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to map buffer (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt_inner = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt_inner = ccl_queue_produce_event(cq, event);
     if (evt != NULL)
         *evt = evt_inner;
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -412,22 +455,38 @@ CCLEvent * ccl_buffer_enqueue_copy(CCLBuffer * src_buf,
 
     cl_int ocl_status;
     cl_event event = NULL;
+    CCLEventWaitList hz_lst = NULL;
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(src_buf), CL_FALSE },
+        { ccl_memobj_unwrap(dst_buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     ocl_status = clEnqueueCopyBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(src_buf), ccl_memobj_unwrap(dst_buf),
         src_offset, dst_offset, size,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to write buffer (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -497,24 +556,41 @@ CCLEvent * ccl_buffer_enqueue_copy_to_image(CCLBuffer * src_buf,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(src_buf), CL_FALSE },
+        { ccl_memobj_unwrap(dst_img), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Copy buffer to image. */
     ocl_status = clEnqueueCopyBufferToImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(src_buf), ccl_memobj_unwrap(dst_img),
         src_offset, dst_origin, region,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to copy buffer to image (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -692,6 +768,8 @@ CCLEvent * ccl_buffer_enqueue_read_rect(CCLBuffer * buf, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
     /* OpenCL version of the underlying platform. */
@@ -713,6 +791,7 @@ CCLEvent * ccl_buffer_enqueue_read_rect(CCLBuffer * buf, CCLQueue * cq,
     CCL_UNUSED(evt_wait_lst);
     CCL_UNUSED(ocl_status);
     CCL_UNUSED(event);
+    CCL_UNUSED(hz_lst);
     CCL_UNUSED(evt);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
@@ -738,25 +817,38 @@ CCLEvent * ccl_buffer_enqueue_read_rect(CCLBuffer * buf, CCLQueue * cq,
         "%s: rect. buffer reads require OpenCL version 1.1 or newer.",
         CCL_STRD);
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(buf), CL_FALSE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Read rectangular region of buffer. */
     ocl_status = clEnqueueReadBufferRect(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), blocking_read, buffer_origin,
         host_origin, region, buffer_row_pitch, buffer_slice_pitch,
         host_row_pitch, host_slice_pitch, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue a rectangular buffer read (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -833,6 +925,8 @@ CCLEvent * ccl_buffer_enqueue_write_rect(CCLBuffer * buf, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
     /* OpenCL version of the underlying platform. */
@@ -854,6 +948,7 @@ CCLEvent * ccl_buffer_enqueue_write_rect(CCLBuffer * buf, CCLQueue * cq,
     CCL_UNUSED(evt_wait_lst);
     CCL_UNUSED(ocl_status);
     CCL_UNUSED(event);
+    CCL_UNUSED(hz_lst);
     CCL_UNUSED(evt);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
@@ -878,25 +973,38 @@ CCLEvent * ccl_buffer_enqueue_write_rect(CCLBuffer * buf, CCLQueue * cq,
         "%s: rect. buffer writes require OpenCL version 1.1 or newer.",
         CCL_STRD);
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Write rectangular region of buffer. */
     ocl_status = clEnqueueWriteBufferRect(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), blocking_write, buffer_origin,
         host_origin, region, buffer_row_pitch, buffer_slice_pitch,
         host_row_pitch, host_slice_pitch, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue a rectangular buffer write (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -973,6 +1081,8 @@ CCLEvent * ccl_buffer_enqueue_copy_rect(CCLBuffer * src_buf,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
     /* OpenCL version of the underlying platform. */
@@ -992,6 +1102,7 @@ CCLEvent * ccl_buffer_enqueue_copy_rect(CCLBuffer * src_buf,
     CCL_UNUSED(evt_wait_lst);
     CCL_UNUSED(ocl_status);
     CCL_UNUSED(event);
+    CCL_UNUSED(hz_lst);
     CCL_UNUSED(evt);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
@@ -1017,25 +1128,40 @@ CCLEvent * ccl_buffer_enqueue_copy_rect(CCLBuffer * src_buf,
         "%s: rect. buffer copy requires OpenCL version 1.1 or newer.",
         CCL_STRD);
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(src_buf), CL_FALSE },
+        { ccl_memobj_unwrap(dst_buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Copy rectangular region between buffers. */
     ocl_status = clEnqueueCopyBufferRect(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(src_buf), ccl_memobj_unwrap(dst_buf),
         src_origin, dst_origin, region, src_row_pitch, src_slice_pitch,
         dst_row_pitch, dst_slice_pitch,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue a rectangular buffer copy (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -1095,6 +1221,8 @@ CCLEvent * ccl_buffer_enqueue_fill(CCLBuffer * buf, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
     /* OpenCL version of the underlying platform. */
@@ -1111,6 +1239,7 @@ CCLEvent * ccl_buffer_enqueue_fill(CCLBuffer * buf, CCLQueue * cq,
     CCL_UNUSED(evt_wait_lst);
     CCL_UNUSED(ocl_status);
     CCL_UNUSED(event);
+    CCL_UNUSED(hz_lst);
     CCL_UNUSED(evt);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
@@ -1136,23 +1265,36 @@ CCLEvent * ccl_buffer_enqueue_fill(CCLBuffer * buf, CCLQueue * cq,
         "%s: Buffer fill requires OpenCL version 1.2 or newer.",
         CCL_STRD);
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Fill buffer. */
     ocl_status = clEnqueueFillBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(buf), pattern, pattern_size, offset, size,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue a fill buffer command (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
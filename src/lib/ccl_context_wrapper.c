@@ -48,6 +48,12 @@ struct ccl_context {
      * */
     CCLPlatform * platf;
 
+    /**
+     * OpenCL version of the associated platform, or 0 if not yet
+     * determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
 };
 
 /**
@@ -500,6 +506,10 @@ cl_uint ccl_context_get_opencl_version(CCLContext * ctx, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&ctx->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&ctx->ocl_ver);
+
     CCLPlatform * platf = NULL;
     CCLErr * err_internal = NULL;
     cl_uint ver = 0;
@@ -521,6 +531,10 @@ error_handler:
 
 finish:
 
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ver > 0)
+        g_atomic_int_set(&ctx->ocl_ver, (gint) ver);
+
     return ver;
 }
 
@@ -722,4 +736,118 @@ CCLDevice * const * ccl_context_get_all_devices(
         (CCLDevContainer *) ctx, ccl_context_get_cldevices, err);
 }
 
+/**
+ * @internal
+ *
+ * @brief Data for a device information prefetch thread.
+ * */
+struct ccl_context_prefetch_data {
+
+    /** Device whose information is to be prefetched. */
+    CCLDevice * dev;
+
+    /** Names of information/parameters to prefetch. */
+    const cl_uint * param_names;
+
+    /** Number of parameters in `param_names`. */
+    cl_uint num_params;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief Thread function which prefetches device information.
+ *
+ * @param[in] data A ::ccl_context_prefetch_data object.
+ * @return `NULL`.
+ * */
+static gpointer ccl_context_prefetch_device_info_thread(gpointer data) {
+
+    struct ccl_context_prefetch_data * pd =
+        (struct ccl_context_prefetch_data *) data;
+
+    ccl_device_prefetch_info(pd->dev, pd->param_names, pd->num_params);
+
+    return NULL;
+}
+
+/**
+ * Fill the information cache of all devices in the context with the
+ * given parameters, using one thread per device. This is useful at
+ * startup, when device information would otherwise be serially queried
+ * from the OpenCL implementation. Parameters which can't be queried for
+ * a given device are ignored.
+ *
+ * @public @memberof ccl_context
+ *
+ * @param[in] ctx The context wrapper object.
+ * @param[in] param_names Array of names of device information/parameters
+ * to prefetch.
+ * @param[in] num_params Number of parameters in `param_names`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if the context devices were obtained, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_context_prefetch_device_info(CCLContext * ctx,
+    const cl_uint * param_names, cl_uint num_params, CCLErr ** err) {
+
+    /* Make sure ctx is not NULL. */
+    g_return_val_if_fail(ctx != NULL, CL_FALSE);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    /* Number of devices in context. */
+    cl_uint num_devices;
+
+    /* Devices in context. */
+    CCLDevice * const * devices;
+
+    /* Prefetch data and threads, one per device. */
+    struct ccl_context_prefetch_data * pd = NULL;
+    GThread ** threads = NULL;
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Get devices in context. */
+    num_devices = ccl_context_get_num_devices(ctx, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    devices = ccl_context_get_all_devices(ctx, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Prefetch information of each device in its own thread, except for
+     * the first device, which is handled by the calling thread. */
+    pd = g_new(struct ccl_context_prefetch_data, num_devices);
+    threads = g_new0(GThread *, num_devices);
+    for (cl_uint i = 0; i < num_devices; ++i) {
+        pd[i].dev = devices[i];
+        pd[i].param_names = param_names;
+        pd[i].num_params = num_params;
+        if (i > 0)
+            threads[i] = g_thread_new("ccl_prefetch",
+                ccl_context_prefetch_device_info_thread, &pd[i]);
+    }
+    if (num_devices > 0)
+        ccl_context_prefetch_device_info_thread(&pd[0]);
+
+    /* Wait for all threads to finish. */
+    for (cl_uint i = 1; i < num_devices; ++i)
+        g_thread_join(threads[i]);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    g_free(pd);
+    g_free(threads);
+    return CL_TRUE;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    return CL_FALSE;
+}
+
 /** @}*/
@@ -365,6 +365,12 @@ CCL_EXPORT
 CCLDevice * const * ccl_context_get_all_devices(CCLContext * ctx,
     CCLErr ** err);
 
+/* Fill the information cache of all devices in the context with the
+ * given parameters, in parallel. */
+CCL_EXPORT
+cl_bool ccl_context_prefetch_device_info(CCLContext * ctx,
+    const cl_uint * param_names, cl_uint num_params, CCLErr ** err);
+
 /**
  * Get a ::CCLWrapperInfo context information object.
  *
@@ -52,6 +52,11 @@ struct ccl_device {
     GSList * subdev_arrays;
 #endif
 
+    /**
+     * OpenCL version supported by the device, or 0 if not yet determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
 };
 
 #ifdef CL_VERSION_1_2
@@ -197,6 +202,10 @@ cl_uint ccl_device_get_opencl_version(CCLDevice * dev, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&dev->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&dev->ocl_ver);
+
     char * ver_str = NULL;
     cl_uint ver = 0;
 
@@ -208,6 +217,10 @@ cl_uint ccl_device_get_opencl_version(CCLDevice * dev, CCLErr ** err) {
             atoi(ver_str + 7) * 100 + /* Major version. */
             atoi(ver_str + 9) * 10; /* Minor version. */
     }
+
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ver > 0)
+        g_atomic_int_set(&dev->ocl_ver, (gint) ver);
     return ver;
 }
 
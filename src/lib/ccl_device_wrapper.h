@@ -57,6 +57,10 @@
  * * ::ccl_device_get_info_array()
  * * ::ccl_device_get_info()
  *
+ * Information about several devices can be fetched in advance, e.g. at
+ * startup, with ::ccl_device_prefetch_info() or, for all the devices in
+ * a context, in parallel with ::ccl_context_prefetch_device_info().
+ *
  * _Example: getting the first device in a context_
  *
  * ```c
@@ -159,6 +163,24 @@ CCLDevice * const * ccl_device_create_subdevices(CCLDevice * dev,
         NULL, param_name, sizeof(param_type), \
         CCL_INFO_DEVICE, CL_FALSE, err)
 
+/**
+ * Fill the information cache of a device wrapper with the given
+ * parameters in one pass, such that subsequent device info queries for
+ * these parameters don't need to query the OpenCL device. Parameters
+ * which can't be queried are ignored.
+ *
+ * @relates ccl_device
+ *
+ * @param[in] dev The device wrapper object.
+ * @param[in] param_names Array of names of information/parameters to
+ * prefetch.
+ * @param[in] num_params Number of parameters in `param_names`.
+ * @return Number of parameters whose information is now cached.
+ * */
+#define ccl_device_prefetch_info(dev, param_names, num_params) \
+    ccl_wrapper_prefetch_info((CCLWrapper *) dev, NULL, param_names, \
+        num_params, CCL_INFO_DEVICE)
+
 /**
  * Increase the reference count of the device wrapper object.
  *
@@ -0,0 +1,928 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for submitting commands to a single
+ * command queue from several host threads.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_dispatcher.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ *
+ * @brief Type of submitted command.
+ * */
+typedef enum ccl_submission_type {
+
+    /** Kernel execution. */
+    CCL_SUBMISSION_NDRANGE,
+    /** Buffer write. */
+    CCL_SUBMISSION_WRITE,
+    /** Buffer read. */
+    CCL_SUBMISSION_READ,
+    /** User function. */
+    CCL_SUBMISSION_FUNC,
+    /** Stop the dispatcher thread. */
+    CCL_SUBMISSION_STOP
+
+} CCLSubmissionType;
+
+/**
+ * Submitted command, which is also the handle returned to the producer.
+ * */
+struct ccl_submission {
+
+    /**
+     * Type of command.
+     * @private
+     * */
+    CCLSubmissionType type;
+
+    /**
+     * Reference count, one for the producer and one for the dispatcher.
+     * @private
+     * */
+    volatile gint ref_count;
+
+    /**
+     * Was the command dispatched?
+     * @private
+     * */
+    volatile gint dispatched;
+
+    /**
+     * Dispatcher to which the command was submitted.
+     * @private
+     * */
+    CCLDispatcher * dsp;
+
+    /**
+     * Kernel wrapper (kernel executions only).
+     * @private
+     * */
+    CCLKernel * krnl;
+
+    /**
+     * Number of work dimensions (kernel executions only).
+     * @private
+     * */
+    cl_uint work_dim;
+
+    /**
+     * Global work offset, global work size and local work size.
+     * @private
+     * */
+    size_t gwo[3], gws[3], lws[3];
+
+    /**
+     * Were the global work offset and local work size given?
+     * @private
+     * */
+    cl_bool has_gwo, has_lws;
+
+    /**
+     * `NULL`-terminated array of kernel arguments, or `NULL`.
+     * @private
+     * */
+    void ** args;
+
+    /**
+     * Buffer wrapper (reads and writes only).
+     * @private
+     * */
+    CCLBuffer * buf;
+
+    /**
+     * Offset and size of transfer (reads and writes only).
+     * @private
+     * */
+    size_t offset, size;
+
+    /**
+     * Host pointer (reads and writes), or user data (functions).
+     * @private
+     * */
+    void * ptr;
+
+    /**
+     * User function (functions only).
+     * @private
+     * */
+    ccl_dispatcher_func func;
+
+    /**
+     * OpenCL event of the command, or `NULL`.
+     * @private
+     * */
+    cl_event event;
+
+    /**
+     * Error which occurred when the command was enqueued, or `NULL`.
+     * @private
+     * */
+    CCLErr * err;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief A slot in the command ring.
+ * */
+typedef struct ccl_dispatcher_slot {
+
+    /** Sequence number which determines the state of the slot. */
+    volatile gint seq;
+    /** Submitted command. */
+    CCLSubmission * sub;
+
+} CCLDispatcherSlot;
+
+/**
+ * Dispatcher class.
+ * */
+struct ccl_dispatcher {
+
+    /**
+     * Command queue to which commands are dispatched.
+     * @private
+     * */
+    CCLQueue * cq;
+
+    /**
+     * Command ring.
+     * @private
+     * */
+    CCLDispatcherSlot * slots;
+
+    /**
+     * Number of slots minus one (the number of slots is a power of two).
+     * @private
+     * */
+    guint mask;
+
+    /**
+     * Position where the next command will be submitted.
+     * @private
+     * */
+    volatile gint tail;
+
+    /**
+     * Position of the next command to dispatch (dispatcher thread only).
+     * @private
+     * */
+    guint head;
+
+    /**
+     * Is the dispatcher thread sleeping, or about to sleep?
+     * @private
+     * */
+    volatile gint sleeping;
+
+    /**
+     * Number of producers waiting for commands to be dispatched.
+     * @private
+     * */
+    volatile gint waiters;
+
+    /**
+     * Synchronizes the sleeping dispatcher thread and waiting producers.
+     * @private
+     * */
+    GMutex mutex;
+
+    /**
+     * Wakes the sleeping dispatcher thread.
+     * @private
+     * */
+    GCond wake_cond;
+
+    /**
+     * Wakes producers waiting for commands to be dispatched.
+     * @private
+     * */
+    GCond done_cond;
+
+    /**
+     * Dispatcher thread.
+     * @private
+     * */
+    GThread * thread;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief Create a submission with references for the producer and for the
+ * dispatcher.
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] type Type of command.
+ * @return A new submission.
+ * */
+static CCLSubmission * ccl_submission_new(
+    CCLDispatcher * dsp, CCLSubmissionType type) {
+
+    CCLSubmission * sub = g_slice_new0(CCLSubmission);
+
+    sub->type = type;
+    sub->ref_count = 2;
+    sub->dsp = dsp;
+
+    return sub;
+}
+
+/**
+ * @internal
+ *
+ * @brief Release a reference to a submission, destroying it if no
+ * references are left.
+ *
+ * @param[in] sub Submission.
+ * */
+static void ccl_submission_unref(CCLSubmission * sub) {
+
+    if (!g_atomic_int_dec_and_test(&sub->ref_count)) return;
+
+    if (sub->event != NULL) clReleaseEvent(sub->event);
+    if (sub->err != NULL) g_error_free(sub->err);
+    if (sub->args != NULL) {
+        guint num_args = 0;
+        while (sub->args[num_args] != NULL) num_args++;
+        g_slice_free1((num_args + 1) * sizeof(void *), sub->args);
+    }
+    g_slice_free(CCLSubmission, sub);
+}
+
+/**
+ * @internal
+ *
+ * @brief Put a command in the ring, waking the dispatcher thread if it's
+ * sleeping. If the ring is full, wait until there is room.
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] sub Command to submit.
+ * */
+static void ccl_dispatcher_push(CCLDispatcher * dsp, CCLSubmission * sub) {
+
+    CCLDispatcherSlot * slot;
+    guint pos = (guint) g_atomic_int_get(&dsp->tail);
+
+    /* Claim a free slot. */
+    while (TRUE) {
+
+        gint dif;
+
+        slot = &dsp->slots[pos & dsp->mask];
+        dif = (gint) ((guint) g_atomic_int_get(&slot->seq) - pos);
+
+        if (dif == 0) {
+            /* Slot is free, try to claim it. */
+            if (g_atomic_int_compare_and_exchange(
+                    &dsp->tail, (gint) pos, (gint) (pos + 1)))
+                break;
+        } else if (dif < 0) {
+            /* Ring is full, let the dispatcher make room. */
+            g_thread_yield();
+        }
+        pos = (guint) g_atomic_int_get(&dsp->tail);
+    }
+
+    /* Publish command. */
+    slot->sub = sub;
+    g_atomic_int_set(&slot->seq, (gint) (pos + 1));
+
+    /* Wake the dispatcher thread if required. */
+    if (g_atomic_int_get(&dsp->sleeping)) {
+        g_mutex_lock(&dsp->mutex);
+        g_cond_signal(&dsp->wake_cond);
+        g_mutex_unlock(&dsp->mutex);
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Take the next command from the ring (dispatcher thread only).
+ *
+ * @param[in] dsp Dispatcher.
+ * @return The next command, or `NULL` if the ring is empty.
+ * */
+static CCLSubmission * ccl_dispatcher_pop(CCLDispatcher * dsp) {
+
+    CCLDispatcherSlot * slot = &dsp->slots[dsp->head & dsp->mask];
+    CCLSubmission * sub;
+
+    if ((guint) g_atomic_int_get(&slot->seq) != dsp->head + 1)
+        return NULL;
+
+    /* Release slot for a later round. */
+    sub = slot->sub;
+    g_atomic_int_set(&slot->seq, (gint) (dsp->head + dsp->mask + 1));
+    dsp->head++;
+
+    return sub;
+}
+
+/**
+ * @internal
+ *
+ * @brief Enqueue a command on the command queue of the dispatcher
+ * (dispatcher thread only).
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] sub Command to enqueue.
+ * */
+static void ccl_dispatcher_enqueue(CCLDispatcher * dsp, CCLSubmission * sub) {
+
+    CCLEvent * evt = NULL;
+
+    switch (sub->type) {
+        case CCL_SUBMISSION_NDRANGE:
+            evt = ccl_kernel_set_args_and_enqueue_ndrange_v(sub->krnl,
+                dsp->cq, sub->work_dim, sub->has_gwo ? sub->gwo : NULL,
+                sub->gws, sub->has_lws ? sub->lws : NULL, NULL,
+                sub->args, &sub->err);
+            ccl_kernel_unref(sub->krnl);
+            break;
+        case CCL_SUBMISSION_WRITE:
+            evt = ccl_buffer_enqueue_write(sub->buf, dsp->cq, CL_FALSE,
+                sub->offset, sub->size, sub->ptr, NULL, &sub->err);
+            ccl_buffer_unref(sub->buf);
+            break;
+        case CCL_SUBMISSION_READ:
+            evt = ccl_buffer_enqueue_read(sub->buf, dsp->cq, CL_FALSE,
+                sub->offset, sub->size, sub->ptr, NULL, &sub->err);
+            ccl_buffer_unref(sub->buf);
+            break;
+        case CCL_SUBMISSION_FUNC:
+            evt = sub->func(dsp->cq, sub->ptr, &sub->err);
+            break;
+        default:
+            g_assert_not_reached();
+    }
+
+    /* Keep the OpenCL event, which outlives the event wrapper if the
+     * command queue releases its events. */
+    if (evt != NULL) {
+        sub->event = ccl_event_unwrap(evt);
+        clRetainEvent(sub->event);
+    }
+
+    /* Signal that the command was dispatched, waking waiting producers if
+     * there are any. */
+    g_atomic_int_set(&sub->dispatched, 1);
+    if (g_atomic_int_get(&dsp->waiters) > 0) {
+        g_mutex_lock(&dsp->mutex);
+        g_cond_broadcast(&dsp->done_cond);
+        g_mutex_unlock(&dsp->mutex);
+    }
+
+    /* The dispatcher no longer needs the command. */
+    ccl_submission_unref(sub);
+}
+
+/**
+ * @internal
+ *
+ * @brief Dispatcher thread, which takes commands from the ring and
+ * enqueues them on the command queue.
+ *
+ * @param[in] data Dispatcher.
+ * @return Always `NULL`.
+ * */
+static gpointer ccl_dispatcher_thread(gpointer data) {
+
+    CCLDispatcher * dsp = (CCLDispatcher *) data;
+    CCLSubmission * sub;
+    cl_bool stop = CL_FALSE;
+    cl_bool pending = CL_FALSE;
+
+    while (!stop) {
+
+        /* Dispatch commands while there are any. */
+        while ((sub = ccl_dispatcher_pop(dsp)) != NULL) {
+            if (sub->type == CCL_SUBMISSION_STOP) {
+                ccl_submission_unref(sub);
+                stop = CL_TRUE;
+                break;
+            }
+            ccl_dispatcher_enqueue(dsp, sub);
+            pending = CL_TRUE;
+        }
+
+        /* Ring is empty, submit dispatched commands to the device. */
+        if (pending) {
+            clFlush(ccl_queue_unwrap(dsp->cq));
+            pending = CL_FALSE;
+        }
+        if (stop) break;
+
+        /* Sleep until commands are submitted. */
+        g_mutex_lock(&dsp->mutex);
+        g_atomic_int_set(&dsp->sleeping, 1);
+        while (g_atomic_int_get(&dsp->slots[dsp->head & dsp->mask].seq)
+                != (gint) (dsp->head + 1))
+            g_cond_wait(&dsp->wake_cond, &dsp->mutex);
+        g_atomic_int_set(&dsp->sleeping, 0);
+        g_mutex_unlock(&dsp->mutex);
+    }
+
+    return NULL;
+}
+
+/**
+ * @addtogroup CCL_DISPATCHER
+ * @{
+ */
+
+/**
+ * Create a new dispatcher for a command queue, and start its dispatcher
+ * thread.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] cq Command queue wrapper object to which commands will be
+ * dispatched. The dispatcher keeps a reference to it.
+ * @param[in] capacity Maximum number of commands waiting to be dispatched,
+ * rounded up to a power of two. If 0,
+ * ::CCL_DISPATCHER_DEFAULT_CAPACITY is used.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new dispatcher, or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLDispatcher * ccl_dispatcher_new(
+    CCLQueue * cq, cl_uint capacity, CCLErr ** err) {
+
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* Dispatcher to create. */
+    CCLDispatcher * dsp = NULL;
+    /* Number of slots in the ring. */
+    guint num_slots = 1;
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    if (capacity == 0) capacity = CCL_DISPATCHER_DEFAULT_CAPACITY;
+    while (num_slots < capacity) num_slots <<= 1;
+
+    /* Initialize dispatcher. */
+    dsp = g_slice_new0(CCLDispatcher);
+    dsp->cq = cq;
+    dsp->mask = num_slots - 1;
+    dsp->slots = g_new(CCLDispatcherSlot, num_slots);
+    for (guint i = 0; i < num_slots; ++i) {
+        dsp->slots[i].seq = (gint) i;
+        dsp->slots[i].sub = NULL;
+    }
+    g_mutex_init(&dsp->mutex);
+    g_cond_init(&dsp->wake_cond);
+    g_cond_init(&dsp->done_cond);
+
+    /* Start dispatcher thread. */
+    dsp->thread = g_thread_try_new(
+        "ccl_dispatcher", ccl_dispatcher_thread, dsp, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Keep command queue alive while the dispatcher exists. */
+    ccl_queue_ref(cq);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    /* Destroy partially initialized dispatcher. */
+    g_mutex_clear(&dsp->mutex);
+    g_cond_clear(&dsp->wake_cond);
+    g_cond_clear(&dsp->done_cond);
+    g_free(dsp->slots);
+    g_slice_free(CCLDispatcher, dsp);
+    dsp = NULL;
+
+finish:
+
+    /* Return dispatcher. */
+    return dsp;
+}
+
+/**
+ * Dispatch the commands which are still in the ring, stop the dispatcher
+ * thread and destroy the dispatcher. The dispatched commands are flushed,
+ * but not waited for.
+ *
+ * The dispatcher should not be destroyed while producers may still submit
+ * commands to it. Handles of submitted commands remain valid until they
+ * are released with ::ccl_submission_destroy().
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher to destroy.
+ * */
+CCL_EXPORT
+void ccl_dispatcher_destroy(CCLDispatcher * dsp) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_if_fail(dsp != NULL);
+
+    /* Stop command, with a single reference, held by the dispatcher. */
+    CCLSubmission * stop = ccl_submission_new(dsp, CCL_SUBMISSION_STOP);
+    stop->ref_count = 1;
+
+    /* Stop the dispatcher thread after the pending commands. */
+    ccl_dispatcher_push(dsp, stop);
+    g_thread_join(dsp->thread);
+
+    /* Release resources. */
+    ccl_queue_unref(dsp->cq);
+    g_mutex_clear(&dsp->mutex);
+    g_cond_clear(&dsp->wake_cond);
+    g_cond_clear(&dsp->done_cond);
+    g_free(dsp->slots);
+    g_slice_free(CCLDispatcher, dsp);
+}
+
+/**
+ * Submit a kernel execution to the dispatcher. This function accepts a
+ * variable list of `NULL`-terminated arguments, as
+ * ::ccl_kernel_set_args_and_enqueue_ndrange().
+ *
+ * This function is thread-safe.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] work_dim The number of dimensions used to specify the global
+ * work-items and work-items in the work-group (1, 2 or 3).
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item, or `NULL`.
+ * @param[in] global_work_size An array of `work_dim` unsigned values that
+ * describe the number of global work-items.
+ * @param[in] local_work_size An array of `work_dim` unsigned values that
+ * describe the number of work-items that make up a work-group, or `NULL`.
+ * @param[in] ... A `NULL`-terminated list of arguments to set.
+ * @return Handle of the submitted command.
+ * */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_ndrange(CCLDispatcher * dsp,
+    CCLKernel * krnl, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    ...) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_val_if_fail(dsp != NULL, NULL);
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, NULL);
+
+    /* Submission handle. */
+    CCLSubmission * sub;
+    /* The va_list, which represents the variable argument list. */
+    va_list args_va;
+    /* Array of arguments, to be created from the va_list. */
+    void ** args_array = NULL;
+    /* Number of arguments. */
+    guint num_args = 0;
+    /* Aux. arg. when cycling through the va_list. */
+    void * aux_arg;
+
+    /* Initialize the va_list. */
+    va_start(args_va, local_work_size);
+
+    /* Get first argument. */
+    aux_arg = va_arg(args_va, void *);
+
+    /* Check if any arguments are given, and if so, populate array
+     * of arguments. */
+    if (aux_arg != NULL) {
+
+        /* 1. Determine number of arguments. */
+        while (aux_arg != NULL) {
+            num_args++;
+            aux_arg = va_arg(args_va, void *);
+        }
+        va_end(args_va);
+
+        /* 2. Populate array of arguments. */
+        args_array = g_slice_alloc((num_args + 1) * sizeof(void *));
+        va_start(args_va, local_work_size);
+
+        for (guint i = 0; i < num_args; ++i) {
+            aux_arg = va_arg(args_va, void *);
+            args_array[i] = aux_arg;
+        }
+        va_end(args_va);
+        args_array[num_args] = NULL;
+
+    } else {
+        va_end(args_va);
+    }
+
+    /* Submit kernel execution. */
+    sub = ccl_dispatcher_submit_ndrange_v(dsp, krnl, work_dim,
+        global_work_offset, global_work_size, local_work_size, args_array);
+
+    /* Free array of arguments. */
+    if (args_array != NULL)
+        g_slice_free1((num_args + 1) * sizeof(void *), args_array);
+
+    return sub;
+}
+
+/**
+ * Submit a kernel execution to the dispatcher. This function accepts a
+ * `NULL`-terminated array of arguments, as
+ * ::ccl_kernel_set_args_and_enqueue_ndrange_v().
+ *
+ * The kernel arguments are set by the dispatcher thread, right before the
+ * kernel is enqueued, so several producers can submit executions of the
+ * same kernel with different arguments. As with ::ccl_kernel_set_arg(),
+ * the ::CCLArg* objects are owned by the kernel once they're set.
+ *
+ * This function is thread-safe.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] work_dim The number of dimensions used to specify the global
+ * work-items and work-items in the work-group (1, 2 or 3).
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item, or `NULL`.
+ * @param[in] global_work_size An array of `work_dim` unsigned values that
+ * describe the number of global work-items.
+ * @param[in] local_work_size An array of `work_dim` unsigned values that
+ * describe the number of work-items that make up a work-group, or `NULL`.
+ * @param[in] args A `NULL`-terminated array of arguments to set, or
+ * `NULL`.
+ * @return Handle of the submitted command.
+ * */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_ndrange_v(CCLDispatcher * dsp,
+    CCLKernel * krnl, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    void ** args) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_val_if_fail(dsp != NULL, NULL);
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, NULL);
+    /* Make sure work_dim is valid. */
+    g_return_val_if_fail((work_dim > 0) && (work_dim <= 3), NULL);
+    /* Make sure global_work_size is not NULL. */
+    g_return_val_if_fail(global_work_size != NULL, NULL);
+
+    CCLSubmission * sub = ccl_submission_new(dsp, CCL_SUBMISSION_NDRANGE);
+
+    /* Keep kernel alive until the command is dispatched. */
+    ccl_kernel_ref(krnl);
+    sub->krnl = krnl;
+
+    /* Copy work sizes. */
+    sub->work_dim = work_dim;
+    sub->has_gwo = global_work_offset != NULL;
+    sub->has_lws = local_work_size != NULL;
+    for (cl_uint i = 0; i < work_dim; ++i) {
+        sub->gws[i] = global_work_size[i];
+        if (sub->has_gwo) sub->gwo[i] = global_work_offset[i];
+        if (sub->has_lws) sub->lws[i] = local_work_size[i];
+    }
+
+    /* Copy array of arguments. */
+    if (args != NULL) {
+        guint num_args = 0;
+        while (args[num_args] != NULL) num_args++;
+        sub->args = g_slice_copy((num_args + 1) * sizeof(void *), args);
+    }
+
+    ccl_dispatcher_push(dsp, sub);
+
+    return sub;
+}
+
+/**
+ * Submit a non-blocking buffer write to the dispatcher. The host memory
+ * must not be modified until the command completes.
+ *
+ * This function is thread-safe.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] buf Buffer wrapper object.
+ * @param[in] offset The offset in bytes in the buffer object to write to.
+ * @param[in] size The size in bytes of data being written.
+ * @param[in] ptr The pointer to buffer in host memory where data is to be
+ * written from.
+ * @return Handle of the submitted command.
+ * */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_write(CCLDispatcher * dsp,
+    CCLBuffer * buf, size_t offset, size_t size, const void * ptr) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_val_if_fail(dsp != NULL, NULL);
+    /* Make sure buf is not NULL. */
+    g_return_val_if_fail(buf != NULL, NULL);
+
+    CCLSubmission * sub = ccl_submission_new(dsp, CCL_SUBMISSION_WRITE);
+
+    /* Keep buffer alive until the command is dispatched. */
+    ccl_buffer_ref(buf);
+    sub->buf = buf;
+    sub->offset = offset;
+    sub->size = size;
+    sub->ptr = (void *) ptr;
+
+    ccl_dispatcher_push(dsp, sub);
+
+    return sub;
+}
+
+/**
+ * Submit a non-blocking buffer read to the dispatcher. The host memory
+ * contains the read data once ::ccl_submission_wait() returns.
+ *
+ * This function is thread-safe.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] buf Buffer wrapper object.
+ * @param[in] offset The offset in bytes in the buffer object to read from.
+ * @param[in] size The size in bytes of data being read.
+ * @param[out] ptr The pointer to buffer in host memory where data is to be
+ * read into.
+ * @return Handle of the submitted command.
+ * */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_read(CCLDispatcher * dsp,
+    CCLBuffer * buf, size_t offset, size_t size, void * ptr) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_val_if_fail(dsp != NULL, NULL);
+    /* Make sure buf is not NULL. */
+    g_return_val_if_fail(buf != NULL, NULL);
+
+    CCLSubmission * sub = ccl_submission_new(dsp, CCL_SUBMISSION_READ);
+
+    /* Keep buffer alive until the command is dispatched. */
+    ccl_buffer_ref(buf);
+    sub->buf = buf;
+    sub->offset = offset;
+    sub->size = size;
+    sub->ptr = ptr;
+
+    ccl_dispatcher_push(dsp, sub);
+
+    return sub;
+}
+
+/**
+ * Submit a function which enqueues commands, to be invoked by the
+ * dispatcher thread. This allows any sequence of _cf4ocl_ enqueue
+ * functions to be submitted. The event returned by the function, if any,
+ * is the one waited for by ::ccl_submission_wait().
+ *
+ * This function is thread-safe.
+ *
+ * @public @memberof ccl_dispatcher
+ *
+ * @param[in] dsp Dispatcher.
+ * @param[in] func Function to invoke.
+ * @param[in] data User data to pass to the function.
+ * @return Handle of the submitted command.
+ * */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_func(CCLDispatcher * dsp,
+    ccl_dispatcher_func func, void * data) {
+
+    /* Make sure dsp is not NULL. */
+    g_return_val_if_fail(dsp != NULL, NULL);
+    /* Make sure func is not NULL. */
+    g_return_val_if_fail(func != NULL, NULL);
+
+    CCLSubmission * sub = ccl_submission_new(dsp, CCL_SUBMISSION_FUNC);
+
+    sub->func = func;
+    sub->ptr = data;
+
+    ccl_dispatcher_push(dsp, sub);
+
+    return sub;
+}
+
+/**
+ * Wait for a submitted command to be dispatched and to complete. If the
+ * command queue is event-less, this function only waits for the command
+ * to be dispatched.
+ *
+ * @public @memberof ccl_submission
+ *
+ * @param[in] sub Handle of the submitted command.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if the command completed successfully, `CL_FALSE` if
+ * it could not be enqueued or its execution failed.
+ * */
+CCL_EXPORT
+cl_bool ccl_submission_wait(CCLSubmission * sub, CCLErr ** err) {
+
+    /* Make sure sub is not NULL. */
+    g_return_val_if_fail(sub != NULL, CL_FALSE);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    /* OpenCL function status. */
+    cl_int ocl_status;
+
+    /* Wait for the command to be dispatched. */
+    if (!g_atomic_int_get(&sub->dispatched)) {
+        CCLDispatcher * dsp = sub->dsp;
+        g_atomic_int_inc(&dsp->waiters);
+        g_mutex_lock(&dsp->mutex);
+        while (!g_atomic_int_get(&sub->dispatched))
+            g_cond_wait(&dsp->done_cond, &dsp->mutex);
+        g_mutex_unlock(&dsp->mutex);
+        g_atomic_int_add(&dsp->waiters, -1);
+    }
+
+    /* Was the command enqueued? */
+    if (sub->err != NULL) {
+        g_propagate_error(err, g_error_copy(sub->err));
+        goto error_handler;
+    }
+
+    /* Wait for the command to complete. */
+    if (sub->event != NULL) {
+        ocl_status = clWaitForEvents(1, &sub->event);
+        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+            CL_SUCCESS != ocl_status, ocl_status, error_handler,
+            "%s: error while waiting for submitted command "
+            "(OpenCL error %d: %s).",
+            CCL_STRD, ocl_status, ccl_err(ocl_status));
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    return CL_TRUE;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    return CL_FALSE;
+}
+
+/**
+ * Release a submission handle. The command is still dispatched if it
+ * wasn't yet.
+ *
+ * @public @memberof ccl_submission
+ *
+ * @param[in] sub Handle of the submitted command.
+ * */
+CCL_EXPORT
+void ccl_submission_destroy(CCLSubmission * sub) {
+
+    /* Make sure sub is not NULL. */
+    g_return_if_fail(sub != NULL);
+
+    ccl_submission_unref(sub);
+}
+
+/** @} */
@@ -0,0 +1,173 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Definition of classes and methods for submitting commands to a single
+ * command queue from several host threads.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_DISPATCHER_H_
+#define _CCL_DISPATCHER_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_buffer_wrapper.h"
+#include "ccl_kernel_wrapper.h"
+#include "ccl_queue_wrapper.h"
+#include "ccl_event_wrapper.h"
+
+/**
+ * @defgroup CCL_DISPATCHER Dispatchers
+ *
+ * The dispatcher module provides the ::CCLDispatcher* class, a thread-safe
+ * front-end which lets several host threads feed a single command queue.
+ *
+ * Kernel wrappers and command queue wrappers are not thread-safe, so
+ * threads which share a device usually either own a command queue each,
+ * or serialize enqueue operations with a mutex. A dispatcher owns a
+ * lock-free, bounded, multi-producer single-consumer ring of commands and
+ * a dispatcher thread. Producer threads submit fully described commands
+ * to the ring with the `ccl_dispatcher_submit_*()` functions, which never
+ * block unless the ring is full. The dispatcher thread takes commands from
+ * the ring in submission order, sets kernel arguments, enqueues the
+ * commands and flushes the command queue whenever the ring becomes empty.
+ * All OpenCL calls on the command queue are thus performed by a single
+ * thread.
+ *
+ * Each submission returns a ::CCLSubmission* handle, with which the
+ * producer can wait for the command to complete using
+ * ::ccl_submission_wait(). Handles must be released with
+ * ::ccl_submission_destroy(), which can be done right after submission
+ * if the producer is not interested in the completion of the command.
+ * Errors which occur when the command is enqueued are reported by
+ * ::ccl_submission_wait().
+ *
+ * While a dispatcher exists, the command queue and the kernels used in
+ * submissions should not be used directly by other threads. Buffers,
+ * kernels and the command queue are kept alive by the dispatcher until
+ * the commands which use them are dispatched.
+ *
+ * _Example:_
+ *
+ * ```c
+ * CCLDispatcher * dsp;
+ * CCLSubmission * sub;
+ * ```
+ *
+ * ```c
+ * dsp = ccl_dispatcher_new(cq, 0, &err);
+ * ```
+ *
+ * In each producer thread:
+ *
+ * ```c
+ * sub = ccl_dispatcher_submit_ndrange(dsp, krnl, 1, NULL, &gws, &lws,
+ *     buf, ccl_arg_priv(n, cl_uint), NULL);
+ * ccl_submission_wait(sub, &err);
+ * ccl_submission_destroy(sub);
+ * ```
+ *
+ * ```c
+ * ccl_dispatcher_destroy(dsp);
+ * ```
+ *
+ * @{
+ */
+
+/** Default capacity of the command ring of a dispatcher. */
+#define CCL_DISPATCHER_DEFAULT_CAPACITY 256
+
+/**
+ * Dispatcher of commands submitted by several host threads to a single
+ * command queue.
+ * */
+typedef struct ccl_dispatcher CCLDispatcher;
+
+/**
+ * Handle to a command submitted to a dispatcher.
+ * */
+typedef struct ccl_submission CCLSubmission;
+
+/**
+ * A function which enqueues commands on a command queue, invoked by the
+ * dispatcher thread.
+ *
+ * @param[in] cq Command queue wrapper object.
+ * @param[in] data User data given to ::ccl_dispatcher_submit_func().
+ * @param[out] err Return location for a ::CCLErr object.
+ * @return Event of the last enqueued command, or `NULL`.
+ * */
+typedef CCLEvent * (*ccl_dispatcher_func)(
+    CCLQueue * cq, void * data, CCLErr ** err);
+
+/* Create a new dispatcher for a command queue. */
+CCL_EXPORT
+CCLDispatcher * ccl_dispatcher_new(
+    CCLQueue * cq, cl_uint capacity, CCLErr ** err);
+
+/* Dispatch pending commands and destroy the dispatcher. */
+CCL_EXPORT
+void ccl_dispatcher_destroy(CCLDispatcher * dsp);
+
+/* Submit a kernel execution. This function accepts a variable list of
+ * `NULL`-terminated arguments. */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_ndrange(CCLDispatcher * dsp,
+    CCLKernel * krnl, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    ...) G_GNUC_NULL_TERMINATED;
+
+/* Submit a kernel execution. This function accepts a `NULL`-terminated
+ * array of arguments. */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_ndrange_v(CCLDispatcher * dsp,
+    CCLKernel * krnl, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    void ** args);
+
+/* Submit a non-blocking buffer write. */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_write(CCLDispatcher * dsp,
+    CCLBuffer * buf, size_t offset, size_t size, const void * ptr);
+
+/* Submit a non-blocking buffer read. */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_read(CCLDispatcher * dsp,
+    CCLBuffer * buf, size_t offset, size_t size, void * ptr);
+
+/* Submit a function which enqueues commands. */
+CCL_EXPORT
+CCLSubmission * ccl_dispatcher_submit_func(CCLDispatcher * dsp,
+    ccl_dispatcher_func func, void * data);
+
+/* Wait for a submitted command to complete. */
+CCL_EXPORT
+cl_bool ccl_submission_wait(CCLSubmission * sub, CCLErr ** err);
+
+/* Release a submission handle. */
+CCL_EXPORT
+void ccl_submission_destroy(CCLSubmission * sub);
+
+/** @} */
+
+#endif
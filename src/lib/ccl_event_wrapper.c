@@ -27,6 +27,7 @@
 
 #include "ccl_event_wrapper.h"
 #include "ccl_queue_wrapper.h"
+#include "_ccl_event_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
 #include "_ccl_defs.h"
 
@@ -49,6 +50,12 @@ struct ccl_event {
      * */
     const char * name;
 
+    /**
+     * OpenCL version of the associated platform, or 0 if not yet
+     * determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
 };
 
 /**
@@ -381,6 +388,10 @@ cl_uint ccl_event_get_opencl_version(CCLEvent * evt, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&evt->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&evt->ocl_ver);
+
     /* OpenCL version. */
     cl_uint ocl_ver;
 
@@ -425,7 +436,11 @@ finish:
 
 #endif
 
-    /* Return event wrapper. */
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ocl_ver > 0)
+        g_atomic_int_set(&evt->ocl_ver, (gint) ocl_ver);
+
+    /* Return OpenCL version, cached above unless an error occurred. */
     return ocl_ver;
 }
 
@@ -696,6 +711,646 @@ finish:
     return ret_status;
 }
 
+#ifdef CL_VERSION_1_1
+
+/**
+ * @internal
+ *
+ * @brief A host function to run once an event completes, and the user
+ * event which signals its completion.
+ * */
+struct ccl_event_then_task {
+
+    /**
+     * Host function.
+     * @private
+     * */
+    ccl_event_host_fn fn;
+
+    /**
+     * User data passed to the host function.
+     * @private
+     * */
+    void * user_data;
+
+    /**
+     * User event to complete once the host function returns.
+     * @private
+     * */
+    cl_event future;
+
+    /**
+     * Execution status of the event on which the task depends.
+     * @private
+     * */
+    cl_int status;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief State shared by the callbacks of the events combined with
+ * ::ccl_event_when_all().
+ * */
+struct ccl_event_when_all_data {
+
+    /**
+     * Number of pending events, plus one while callbacks are being set.
+     * @private
+     * */
+    volatile gint pending;
+
+    /**
+     * Execution status of the combined events, negative if any of them
+     * terminated abnormally.
+     * @private
+     * */
+    volatile gint status;
+
+    /**
+     * User event to complete once all events complete.
+     * @private
+     * */
+    cl_event future;
+
+};
+
+/* Worker pool which runs host functions given to ccl_event_then(),
+ * created on demand. */
+static GThreadPool * evt_then_pool = NULL;
+
+/* Number of host functions given to ccl_event_then() which have not yet
+ * returned. The worker pool can't be freed while there are any. */
+static volatile gint evt_then_pending = 0;
+
+/* Protects creation and destruction of the worker pool. */
+static GMutex evt_then_mutex;
+
+/**
+ * @internal
+ *
+ * @brief Worker pool function which runs a host function and completes
+ * the respective user event.
+ *
+ * @param[in] data A ::ccl_event_then_task object.
+ * @param[in] pool_data Not used.
+ * */
+static void ccl_event_then_run(gpointer data, gpointer pool_data) {
+
+    struct ccl_event_then_task * task = (struct ccl_event_then_task *) data;
+
+    CCL_UNUSED(pool_data);
+
+    /* Run host function. */
+    task->fn(task->status, task->user_data);
+
+    /* Signal completion, propagating abnormal termination. */
+    clSetUserEventStatus(task->future,
+        task->status < 0 ? task->status : CL_COMPLETE);
+    clReleaseEvent(task->future);
+
+    g_slice_free(struct ccl_event_then_task, task);
+    g_atomic_int_add(&evt_then_pending, -1);
+}
+
+/**
+ * @internal
+ *
+ * @brief Event callback which hands a host function to the worker pool.
+ * Runs on a thread of the OpenCL implementation.
+ *
+ * @param[in] event Completed OpenCL event.
+ * @param[in] status Execution status of the event.
+ * @param[in] user_data A ::ccl_event_then_task object.
+ * */
+static void CL_CALLBACK ccl_event_then_cb(
+    cl_event event, cl_int status, void * user_data) {
+
+    struct ccl_event_then_task * task =
+        (struct ccl_event_then_task *) user_data;
+
+    CCL_UNUSED(event);
+
+    task->status = status;
+    g_thread_pool_push(evt_then_pool, task, NULL);
+}
+
+/**
+ * @internal
+ *
+ * @brief Free the worker pool which runs host functions given to
+ * ::ccl_event_then(), waiting for its threads to finish. Nothing is done
+ * if the pool doesn't exist or if host functions are still pending, since
+ * event callbacks may still hand them to the pool. The pool is created
+ * again if required. Called by ::ccl_wrapper_memcheck() once no wrappers
+ * exist.
+ * */
+void ccl_event_then_pool_free() {
+
+    g_mutex_lock(&evt_then_mutex);
+    if ((evt_then_pool != NULL)
+        && (g_atomic_int_get(&evt_then_pending) == 0)) {
+
+        g_thread_pool_free(evt_then_pool, FALSE, TRUE);
+        evt_then_pool = NULL;
+    }
+    g_mutex_unlock(&evt_then_mutex);
+}
+
+/**
+ * @internal
+ *
+ * @brief Account for a completed event (or for the end of callback
+ * registration) in ::ccl_event_when_all(), completing the combined user
+ * event if no events remain pending.
+ *
+ * @param[in] data A ::ccl_event_when_all_data object.
+ * @param[in] status Execution status of the completed event.
+ * */
+static void ccl_event_when_all_done(
+    struct ccl_event_when_all_data * data, cl_int status) {
+
+    /* Keep abnormal termination status. */
+    if (status < 0)
+        g_atomic_int_compare_and_exchange(&data->status, CL_COMPLETE, status);
+
+    if (g_atomic_int_dec_and_test(&data->pending)) {
+        clSetUserEventStatus(
+            data->future, (cl_int) g_atomic_int_get(&data->status));
+        clReleaseEvent(data->future);
+        g_slice_free(struct ccl_event_when_all_data, data);
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Event callback for events combined with ::ccl_event_when_all().
+ * Runs on a thread of the OpenCL implementation.
+ *
+ * @param[in] event Completed OpenCL event.
+ * @param[in] status Execution status of the event.
+ * @param[in] user_data A ::ccl_event_when_all_data object.
+ * */
+static void CL_CALLBACK ccl_event_when_all_cb(
+    cl_event event, cl_int status, void * user_data) {
+
+    CCL_UNUSED(event);
+
+    ccl_event_when_all_done(
+        (struct ccl_event_when_all_data *) user_data, status);
+}
+
+/**
+ * @internal
+ *
+ * @brief Create a user event in the same context of the given OpenCL
+ * event.
+ *
+ * @param[in] event OpenCL event.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new user event wrapper, or `NULL` if an error occurs.
+ * */
+static CCLEvent * ccl_event_new_future(cl_event event, CCLErr ** err) {
+
+    CCLEvent * evt = ccl_event_new_wrap(event);
+    CCLEvent * future = NULL;
+    CCLContext * ctx = NULL;
+    cl_context context;
+    CCLErr * err_internal = NULL;
+
+    /* Get context of event. */
+    context = ccl_event_get_info_scalar(
+        evt, CL_EVENT_CONTEXT, cl_context, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    ctx = ccl_context_new_wrap(context);
+
+    /* Create user event in same context. */
+    future = ccl_user_event_new(ctx, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Release wrappers. */
+    if (ctx != NULL) ccl_context_unref(ctx);
+    ccl_event_destroy(evt);
+
+    /* Return user event wrapper. */
+    return future;
+}
+
+#endif
+
+/**
+ * Run a host function on a library-managed worker thread once the given
+ * event completes.
+ *
+ * Contrary to ::ccl_event_set_callback(), the host function does not run
+ * on a thread of the OpenCL implementation, so it can perform lengthy
+ * work (e.g. decoding or writing results) and call OpenCL functions. Host
+ * functions run on a pool of worker threads, with as many threads as
+ * processors, such that host post-processing overlaps with device work
+ * without blocking an application thread.
+ *
+ * The returned user event completes once the host function returns, and
+ * can be used to chain further host functions or as a dependency of
+ * enqueued commands, or combined with other events with
+ * ::ccl_event_when_all(). If the given event terminates abnormally, the
+ * host function still runs, receiving the negative execution status, and
+ * the returned user event terminates with the same status.
+ *
+ * @public @memberof ccl_event
+ * @note Requires OpenCL >= 1.1
+ *
+ * @param[in] evt Event wrapper object.
+ * @param[in] fn Host function to run once `evt` completes.
+ * @param[in] user_data User data to pass to `fn`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A user event which completes once `fn` returns, which should be
+ * freed using ccl_event_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_event_then(CCLEvent * evt, ccl_event_host_fn fn,
+    void * user_data, CCLErr ** err) {
+
+    /* Make sure evt is not NULL. */
+    g_return_val_if_fail(evt != NULL, NULL);
+    /* Make sure fn is not NULL. */
+    g_return_val_if_fail(fn != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* User event which completes when the host function returns. */
+    CCLEvent * future = NULL;
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+#ifndef CL_VERSION_1_1
+
+    CCL_UNUSED(user_data);
+    CCL_UNUSED(err_internal);
+
+    /* If cf4ocl was not compiled with support for OpenCL >= 1.1, always throw
+     * error. */
+    ccl_if_err_create_goto(*err, CCL_ERROR, TRUE,
+        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
+        "%s: Event continuations require cf4ocl to be deployed with "
+        "support for OpenCL version 1.1 or newer.",
+        CCL_STRD);
+
+#else
+
+    /* Task to hand to the worker pool. */
+    struct ccl_event_then_task * task;
+
+    /* Create user event which signals completion of host function. */
+    future = ccl_event_new_future(ccl_event_unwrap(evt), &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Create worker pool if required, and keep it while the task is
+     * pending. */
+    g_mutex_lock(&evt_then_mutex);
+    if (evt_then_pool == NULL) {
+        evt_then_pool = g_thread_pool_new(ccl_event_then_run, NULL,
+            (gint) g_get_num_processors(), FALSE, NULL);
+    }
+    g_atomic_int_inc(&evt_then_pending);
+    g_mutex_unlock(&evt_then_mutex);
+
+    /* Create task, which keeps its own reference to the user event. */
+    task = g_slice_new(struct ccl_event_then_task);
+    task->fn = fn;
+    task->user_data = user_data;
+    task->future = ccl_event_unwrap(future);
+    clRetainEvent(task->future);
+
+    /* Hand task to worker pool when event completes. */
+    if (!ccl_event_set_callback(evt, CL_COMPLETE, ccl_event_then_cb, task,
+        &err_internal)) {
+
+        clReleaseEvent(task->future);
+        g_slice_free(struct ccl_event_then_task, task);
+        g_atomic_int_add(&evt_then_pending, -1);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    }
+
+#endif
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    /* An error occurred, return NULL to signal it. */
+    if (future != NULL) ccl_event_destroy(future);
+    future = NULL;
+
+finish:
+
+    /* Return user event. */
+    return future;
+}
+
+/**
+ * Combine the events in an event wait list into a single user event,
+ * which completes once all of them complete.
+ *
+ * The returned user event can be used with ::ccl_event_then(), as a
+ * dependency of enqueued commands, or waited upon. If any of the combined
+ * events terminates abnormally, the returned user event terminates with
+ * the same (negative) execution status. No application or worker thread
+ * blocks while waiting for the events to complete.
+ *
+ * @public @memberof ccl_event
+ * @note Requires OpenCL >= 1.1
+ *
+ * @param[in,out] evt_wait_lst Events to combine. The list will be cleared
+ * and can be reused by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A user event which completes once all events in `evt_wait_lst`
+ * complete, which should be freed using ccl_event_destroy(), or `NULL` if
+ * an error occurs.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_event_when_all(
+    CCLEventWaitList * evt_wait_lst, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* Number of events to combine and the events themselves. */
+    cl_uint num_evts = ccl_event_wait_list_get_num_events(evt_wait_lst);
+    const cl_event * evts = ccl_event_wait_list_get_clevents(evt_wait_lst);
+    /* User event which completes when all events complete. */
+    CCLEvent * future = NULL;
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Make sure there are events to combine. */
+    g_return_val_if_fail(num_evts > 0, NULL);
+
+#ifndef CL_VERSION_1_1
+
+    CCL_UNUSED(evts);
+    CCL_UNUSED(err_internal);
+
+    /* If cf4ocl was not compiled with support for OpenCL >= 1.1, always throw
+     * error. */
+    ccl_if_err_create_goto(*err, CCL_ERROR, TRUE,
+        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
+        "%s: Combining events requires cf4ocl to be deployed with "
+        "support for OpenCL version 1.1 or newer.",
+        CCL_STRD);
+
+#else
+
+    /* State shared by event callbacks. */
+    struct ccl_event_when_all_data * data;
+    /* OpenCL status. */
+    cl_int ocl_status = CL_SUCCESS;
+    /* Event index. */
+    cl_uint i;
+
+    /* Create user event in the context of the first event. */
+    future = ccl_event_new_future(evts[0], &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Initialize shared state, keeping one pending count while callbacks
+     * are being set, so that the user event isn't completed early. */
+    data = g_slice_new(struct ccl_event_when_all_data);
+    data->pending = (gint) num_evts + 1;
+    data->status = CL_COMPLETE;
+    data->future = ccl_event_unwrap(future);
+    clRetainEvent(data->future);
+
+    /* Set callbacks. The events were already checked for OpenCL >= 1.1
+     * when the user event was created. */
+    for (i = 0; i < num_evts; ++i) {
+        ocl_status = clSetEventCallback(
+            evts[i], CL_COMPLETE, ccl_event_when_all_cb, data);
+        if (ocl_status != CL_SUCCESS) {
+            /* Events without callbacks are no longer pending. */
+            g_atomic_int_add(&data->pending, - (gint) (num_evts - i));
+            break;
+        }
+    }
+
+    /* Callbacks are set, the user event may now be completed. If a
+     * callback couldn't be set, the user event terminates abnormally. */
+    ccl_event_when_all_done(data, ocl_status < 0 ? ocl_status : CL_COMPLETE);
+
+    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+        CL_SUCCESS != ocl_status, ocl_status, error_handler,
+        "%s: unable to set event callback (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+#endif
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    /* An error occurred, return NULL to signal it. */
+    if (future != NULL) ccl_event_destroy(future);
+    future = NULL;
+
+finish:
+
+    /* Clear event wait list. */
+    ccl_event_wait_list_clear(evt_wait_lst);
+
+    /* Return user event. */
+    return future;
+}
+
+/**
+ * @internal
+ *
+ * @brief Maximum number of recycled event wait lists kept per thread.
+ * */
+#define CCL_EVENT_WAIT_LIST_POOL_SIZE 8
+
+/**
+ * @internal
+ *
+ * @brief Per-thread pool of recycled event wait lists.
+ * */
+struct ccl_event_wait_list_pool {
+
+    /**
+     * Recycled event wait lists.
+     * @private
+     * */
+    CCLEventWaitListBuf * free[CCL_EVENT_WAIT_LIST_POOL_SIZE];
+
+    /**
+     * Number of recycled event wait lists.
+     * @private
+     * */
+    guint count;
+
+};
+
+/* Destroy the event wait list pool of a thread, called on thread exit. */
+static void ccl_event_wait_list_pool_destroy(gpointer data) {
+
+    struct ccl_event_wait_list_pool * pool =
+        (struct ccl_event_wait_list_pool *) data;
+
+    for (guint i = 0; i < pool->count; ++i)
+        g_slice_free(CCLEventWaitListBuf, pool->free[i]);
+    g_slice_free(struct ccl_event_wait_list_pool, pool);
+}
+
+/* Thread-local event wait list pool. */
+static GPrivate evt_wait_lst_pool =
+    G_PRIVATE_INIT(ccl_event_wait_list_pool_destroy);
+
+/**
+ * @internal
+ *
+ * @brief Get storage for a new event wait list, recycling a previously
+ * cleared event wait list if possible.
+ *
+ * @return Storage for an empty event wait list.
+ * */
+static CCLEventWaitList ccl_event_wait_list_alloc(void) {
+
+    struct ccl_event_wait_list_pool * pool =
+        g_private_get(&evt_wait_lst_pool);
+    CCLEventWaitListBuf * buf;
+
+    if ((pool != NULL) && (pool->count > 0))
+        buf = pool->free[--pool->count];
+    else
+        buf = g_slice_new(CCLEventWaitListBuf);
+
+    ccl_event_wait_list_init(buf);
+    buf->client_owned = CL_FALSE;
+
+    return buf;
+}
+
+/**
+ * @internal
+ *
+ * @brief Release the storage of an event wait list, keeping it in the
+ * pool of the calling thread for reuse if possible.
+ *
+ * @param[in] buf Storage of an event wait list not owned by client code.
+ * */
+static void ccl_event_wait_list_free(CCLEventWaitListBuf * buf) {
+
+    struct ccl_event_wait_list_pool * pool =
+        g_private_get(&evt_wait_lst_pool);
+
+    /* Create pool for this thread if it doesn't exist yet. */
+    if (pool == NULL) {
+        pool = g_slice_new0(struct ccl_event_wait_list_pool);
+        g_private_set(&evt_wait_lst_pool, pool);
+    }
+
+    if (pool->count < CCL_EVENT_WAIT_LIST_POOL_SIZE)
+        pool->free[pool->count++] = buf;
+    else
+        g_slice_free(CCLEventWaitListBuf, buf);
+}
+
+/**
+ * @internal
+ *
+ * @brief Append an OpenCL event to an event wait list, growing the list
+ * storage beyond its inline storage if required.
+ *
+ * @param[in] lst Event wait list.
+ * @param[in] event OpenCL event to append.
+ * */
+static void ccl_event_wait_list_append(CCLEventWaitList lst, cl_event event) {
+
+    if (lst->len == lst->alloc) {
+        lst->alloc *= 2;
+        if (lst->pdata == lst->inline_evts) {
+            lst->pdata = g_new(cl_event, lst->alloc);
+            memcpy(lst->pdata, lst->inline_evts,
+                lst->len * sizeof(cl_event));
+        } else {
+            lst->pdata = g_renew(cl_event, lst->pdata, lst->alloc);
+        }
+    }
+    lst->pdata[lst->len++] = event;
+}
+
+/**
+ * @internal
+ *
+ * @brief Add an OpenCL event to an event wait list, unless the event is
+ * already in the list.
+ *
+ * @param[out] evt_wait_lst Event wait list.
+ * @param[in] event OpenCL event to add.
+ * */
+void ccl_event_wait_list_add_clevent(
+    CCLEventWaitList * evt_wait_lst, cl_event event) {
+
+    /* Initialize list if required. */
+    if (*evt_wait_lst == NULL)
+        *evt_wait_lst = ccl_event_wait_list_alloc();
+
+    /* Don't add the same event twice. */
+    for (cl_uint i = 0; i < (*evt_wait_lst)->len; ++i)
+        if ((*evt_wait_lst)->pdata[i] == event) return;
+
+    ccl_event_wait_list_append(*evt_wait_lst, event);
+}
+
+/**
+ * Initialize an event wait list with storage provided by client code,
+ * e.g. on the stack.
+ *
+ * The returned event wait list can be used as any other event wait list,
+ * with the difference that, when cleared (e.g. when consumed by a
+ * `ccl_*_enqueue_*()` function), it is reset for reuse instead of being
+ * set to `NULL`. Up to ::CCL_EVENT_WAIT_LIST_INLINE events are stored
+ * in `buf`; if more events are added, additional memory is allocated,
+ * which is released when the list is cleared. As such, a non-empty event
+ * wait list should be cleared before its storage goes out of scope.
+ *
+ * @param[out] buf Storage for the event wait list.
+ * @return An empty event wait list using the given storage.
+ * */
+CCL_EXPORT
+CCLEventWaitList ccl_event_wait_list_init(CCLEventWaitListBuf * buf) {
+
+    /* Check that buf is not NULL. */
+    g_return_val_if_fail(buf != NULL, NULL);
+
+    buf->pdata = buf->inline_evts;
+    buf->len = 0;
+    buf->alloc = CCL_EVENT_WAIT_LIST_INLINE;
+    buf->client_owned = CL_TRUE;
+
+    return buf;
+}
+
 /**
  * Add event wrapper objects to an event wait list (variable argument
  * list version).
@@ -719,7 +1374,7 @@ CCLEventWaitList * ccl_event_wait_list_add(
 
     /* Initialize list if required. */
     if (*evt_wait_lst == NULL)
-        *evt_wait_lst = g_ptr_array_new();
+        *evt_wait_lst = ccl_event_wait_list_alloc();
 
     /* Initialize variable argument list. */
     va_start(al, evt_wait_lst);
@@ -728,7 +1383,7 @@ CCLEventWaitList * ccl_event_wait_list_add(
     while ((evt = va_arg(al, CCLEvent *)) != NULL) {
 
         /* Add event wrapper to array. */
-        g_ptr_array_add(*evt_wait_lst, ccl_event_unwrap(evt));
+        ccl_event_wait_list_append(*evt_wait_lst, ccl_event_unwrap(evt));
 
     }
 
@@ -764,13 +1419,14 @@ CCLEventWaitList * ccl_event_wait_list_add_v(
 
     /* Initialize list if required. */
     if (*evt_wait_lst == NULL)
-        *evt_wait_lst = g_ptr_array_new();
+        *evt_wait_lst = ccl_event_wait_list_alloc();
 
     /* Cycle through array of event wrapper objects. */
     for (guint i = 0; evts[i] != NULL; ++i) {
 
         /* Add wrapped cl_event to array. */
-        g_ptr_array_add(*evt_wait_lst, ccl_event_unwrap(evts[i]));
+        ccl_event_wait_list_append(
+            *evt_wait_lst, ccl_event_unwrap(evts[i]));
 
     }
 
@@ -785,14 +1441,31 @@ CCLEventWaitList * ccl_event_wait_list_add_v(
  * wait lists are automatically cleared when passed to
  * `ccl_*_enqueue_*()` functions.
  *
+ * Event wait lists initialized with ::ccl_event_wait_list_init() are
+ * reset and can be reused; other event wait lists are set to `NULL`.
+ *
  * @param[out] evt_wait_lst Event wait list.
  * */
 CCL_EXPORT
 void ccl_event_wait_list_clear(CCLEventWaitList * evt_wait_lst) {
 
     if ((evt_wait_lst != NULL) && (*evt_wait_lst != NULL)) {
-        g_ptr_array_free(*evt_wait_lst, TRUE);
-        *evt_wait_lst = NULL;
+
+        CCLEventWaitList lst = *evt_wait_lst;
+
+        /* Release storage allocated beyond the inline storage. */
+        if (lst->pdata != lst->inline_evts) {
+            g_free(lst->pdata);
+            lst->pdata = lst->inline_evts;
+            lst->alloc = CCL_EVENT_WAIT_LIST_INLINE;
+        }
+        lst->len = 0;
+
+        /* Lists not owned by client code are recycled. */
+        if (!lst->client_owned) {
+            ccl_event_wait_list_free(lst);
+            *evt_wait_lst = NULL;
+        }
     }
 }
 
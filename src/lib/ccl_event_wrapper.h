@@ -89,6 +89,18 @@
 typedef void (CL_CALLBACK * ccl_event_callback)(cl_event event,
     cl_int event_command_exec_status, void * user_data);
 
+/**
+ * Prototype for host functions run by ::ccl_event_then() once an event
+ * completes.
+ *
+ * @public @memberof ccl_event
+ *
+ * @param[in] exec_status Execution status of the event, `CL_COMPLETE` or
+ * a negative value if the event terminated abnormally.
+ * @param[in] user_data A pointer to user supplied data.
+ * */
+typedef void (*ccl_event_host_fn)(cl_int exec_status, void * user_data);
+
 /* Get the event wrapper for the given OpenCL event. */
 CCL_EXPORT
 CCLEvent * ccl_event_new_wrap(cl_event event);
@@ -132,6 +144,12 @@ CCL_EXPORT
 cl_bool ccl_user_event_set_status(
     CCLEvent * evt, cl_int execution_status, CCLErr ** err);
 
+/* Run a host function on a library-managed worker thread once the given
+ * event completes. */
+CCL_EXPORT
+CCLEvent * ccl_event_then(CCLEvent * evt, ccl_event_host_fn fn,
+    void * user_data, CCLErr ** err);
+
 /**
  * Get a ::CCLWrapperInfo event information object.
  *
@@ -302,6 +320,16 @@ cl_bool ccl_user_event_set_status(
  * wait lists should be freed with the ::ccl_event_wait_list_clear()
  * function.
  *
+ * Event wait lists store up to ::CCL_EVENT_WAIT_LIST_INLINE events without
+ * additional allocations, and the memory of cleared event wait lists is
+ * recycled, such that steady-state use of event wait lists does not
+ * require heap allocations. Alternatively, the storage of an event wait
+ * list can be provided by client code (e.g. on the stack) with
+ * ::ccl_event_wait_list_init() (see example 3). Such event wait lists are
+ * reset instead of being set to `NULL` when cleared, and can be used
+ * with ::ccl_ewl() and `ccl_*_enqueue_*()` functions as any other event
+ * wait list.
+ *
  * _Example 1:_
  *
  * ```c
@@ -336,11 +364,81 @@ cl_bool ccl_user_event_set_status(
  * ccl_kernel_enqueue_ndrange(krnl, cq2, dim, offset, gws, lws,
  *     ccl_ewl(&evt_wait_lst, evt, NULL), NULL);
  * ```
+ *
+ * _Example 3:_
+ *
+ * ```c
+ * CCLEvent * evt1, * evt2;
+ * CCLEventWaitListBuf evt_wait_buf;
+ * CCLEventWaitList evt_wait_lst = ccl_event_wait_list_init(&evt_wait_buf);
+ * ```
+ *
+ * ```c
+ * for (i = 0; i < iters; ++i) {
+ *     evt1 = ccl_buffer_enqueue_write(cq1, a_dev, CL_FALSE, 0, size, a_host, NULL, NULL);
+ *     evt2 = ccl_buffer_enqueue_write(cq2, b_dev, CL_FALSE, 0, size, b_host, NULL, NULL);
+ *     ccl_kernel_enqueue_ndrange(krnl, cq1, dim, offset, gws, lws,
+ *         ccl_ewl(&evt_wait_lst, evt1, evt2, NULL), NULL);
+ * }
+ * ```
  * @{
  */
 
-/** A list of event objects on which enqueued commands can wait. */
-typedef GPtrArray * CCLEventWaitList;
+/**
+ * Number of events stored in an event wait list without additional memory
+ * allocations.
+ * */
+#define CCL_EVENT_WAIT_LIST_INLINE 8
+
+/**
+ * Storage for an event wait list. The fields of this structure should not
+ * be directly accessed by client code.
+ * */
+typedef struct ccl_event_wait_list_buf {
+
+    /**
+     * Events in the list, pointing to `inline_evts` unless the list
+     * contains more than ::CCL_EVENT_WAIT_LIST_INLINE events.
+     * @private
+     * */
+    cl_event * pdata;
+
+    /**
+     * Number of events in the list.
+     * @private
+     * */
+    cl_uint len;
+
+    /**
+     * Number of events which fit in `pdata`.
+     * @private
+     * */
+    cl_uint alloc;
+
+    /**
+     * Is the storage provided by client code?
+     * @private
+     * */
+    cl_bool client_owned;
+
+    /**
+     * Inline storage for events.
+     * @private
+     * */
+    cl_event inline_evts[CCL_EVENT_WAIT_LIST_INLINE];
+
+} CCLEventWaitListBuf;
+
+/**
+ * A list of event objects on which enqueued commands can wait.
+ *
+ * @attention Before library ABI version 3, ::CCLEventWaitList was a
+ * `GPtrArray *`. This is no longer the case, so event wait lists must not
+ * be accessed with `g_ptr_array_*()` functions or through `GPtrArray`
+ * fields. Use ::ccl_event_wait_list_get_num_events() and
+ * ::ccl_event_wait_list_get_clevents() instead.
+ * */
+typedef CCLEventWaitListBuf * CCLEventWaitList;
 
 /**
  * Alias the for the ::ccl_event_wait_list_add() function. Intended as
@@ -364,6 +462,16 @@ CCLEventWaitList * ccl_event_wait_list_add_v(
 CCL_EXPORT
 void ccl_event_wait_list_clear(CCLEventWaitList * evt_wait_lst);
 
+/* Combine the events in an event wait list into a single user event, which
+ * completes once all of them complete. */
+CCL_EXPORT
+CCLEvent * ccl_event_when_all(
+    CCLEventWaitList * evt_wait_lst, CCLErr ** err);
+
+/* Initialize an event wait list with storage provided by client code. */
+CCL_EXPORT
+CCLEventWaitList ccl_event_wait_list_init(CCLEventWaitListBuf * buf);
+
 /**
  * Get number of events in the event wait list.
  *
@@ -385,10 +493,12 @@ void ccl_event_wait_list_clear(CCLEventWaitList * evt_wait_lst);
  * rarely be called from client code.
  *
  * @param[in] evt_wait_lst Event wait list.
- * @return Array of OpenCL cl_event objects in the event wait list.
+ * @return Array of OpenCL cl_event objects in the event wait list, or
+ * `NULL` if the event wait list is empty.
  * */
 #define ccl_event_wait_list_get_clevents(evt_wait_lst) \
-    ((((evt_wait_lst) != NULL) && (*(evt_wait_lst) != NULL)) \
+    ((((evt_wait_lst) != NULL) && (*(evt_wait_lst) != NULL) \
+        && ((*(evt_wait_lst))->len > 0)) \
         ? (const cl_event *) (*(evt_wait_lst))->pdata \
         : NULL)
 
@@ -0,0 +1,901 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for recording sequences of OpenCL
+ * commands and replaying them on command queues.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_graph.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_queue_wrapper.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ *
+ * @brief Type of command recorded in a graph node.
+ * */
+typedef enum ccl_graph_node_type {
+
+    /** Buffer write. */
+    CCL_GRAPH_NODE_WRITE,
+    /** Buffer read. */
+    CCL_GRAPH_NODE_READ,
+    /** Copy between buffers. */
+    CCL_GRAPH_NODE_COPY,
+    /** Kernel execution. */
+    CCL_GRAPH_NODE_KERNEL
+
+} CCLGraphNodeType;
+
+/**
+ * @internal
+ *
+ * @brief A kernel argument captured by a graph node.
+ * */
+typedef struct ccl_graph_arg {
+
+    /** Argument index. */
+    cl_uint index;
+    /** Argument size in bytes. */
+    size_t size;
+    /** Copy of argument value, `NULL` for local memory arguments. */
+    void * value;
+    /** Was the argument changed since it was last set? */
+    cl_bool dirty;
+
+} CCLGraphArg;
+
+/**
+ * @internal
+ *
+ * @brief A command recorded in a graph.
+ * */
+typedef struct ccl_graph_node {
+
+    /** Type of command. */
+    CCLGraphNodeType type;
+    /** Kernel wrapper (kernel executions only). */
+    CCLKernel * krnl;
+    /** Buffer wrapper (source buffer in copies). */
+    CCLBuffer * buf;
+    /** Destination buffer wrapper (copies only). */
+    CCLBuffer * dst_buf;
+    /** Offset in buffer (source offset in copies). */
+    size_t offset;
+    /** Offset in destination buffer (copies only). */
+    size_t dst_offset;
+    /** Size in bytes of data to transfer. */
+    size_t size;
+    /** Host pointer (reads and writes only). */
+    void * ptr;
+    /** Number of work dimensions (kernel executions only). */
+    cl_uint work_dim;
+    /** Global work offset, if given. */
+    size_t gwo[3];
+    /** Global work size. */
+    size_t gws[3];
+    /** Local work size, if given. */
+    size_t lws[3];
+    /** Was the global work offset given? */
+    cl_bool has_gwo;
+    /** Was the local work size given? */
+    cl_bool has_lws;
+    /** Captured kernel arguments (array of ::CCLGraphArg). */
+    GArray * args;
+    /** Were any kernel arguments changed since they were last set? */
+    cl_bool args_dirty;
+    /** Is the kernel also executed by other nodes of the graph? */
+    cl_bool shared_krnl;
+    /** Indexes of nodes this node depends on (array of `cl_uint`). */
+    GArray * deps;
+    /** Wait list with room for the events of the dependencies. */
+    cl_event * wait;
+    /** Is this node a dependency of some other node? */
+    cl_bool needs_evt;
+
+} CCLGraphNode;
+
+/**
+ * Command graph class.
+ * */
+struct ccl_graph {
+
+    /**
+     * Recorded commands (array of ::CCLGraphNode*).
+     * @private
+     * */
+    GPtrArray * nodes;
+
+    /**
+     * Events of the last replay, one per node.
+     * @private
+     * */
+    cl_event * events;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief Destroy a graph node, releasing the wrappers it references.
+ *
+ * @param[in] data Graph node to destroy.
+ * */
+static void ccl_graph_node_destroy(gpointer data) {
+
+    CCLGraphNode * node = (CCLGraphNode *) data;
+
+    if (node->krnl != NULL) ccl_kernel_unref(node->krnl);
+    if (node->buf != NULL) ccl_buffer_unref(node->buf);
+    if (node->dst_buf != NULL) ccl_buffer_unref(node->dst_buf);
+    if (node->args != NULL) {
+        for (guint i = 0; i < node->args->len; ++i)
+            g_free(g_array_index(node->args, CCLGraphArg, i).value);
+        g_array_free(node->args, TRUE);
+    }
+    if (node->deps != NULL) g_array_free(node->deps, TRUE);
+    g_free(node->wait);
+    g_slice_free(CCLGraphNode, node);
+}
+
+/**
+ * @internal
+ *
+ * @brief Append a new node to the graph, keeping the event array of the
+ * graph sized to the number of nodes.
+ *
+ * @param[in] graph Command graph.
+ * @param[in] type Type of command.
+ * @return A new graph node, owned by the graph.
+ * */
+static CCLGraphNode * ccl_graph_node_new(
+    CCLGraph * graph, CCLGraphNodeType type) {
+
+    CCLGraphNode * node = g_slice_new0(CCLGraphNode);
+
+    node->type = type;
+    g_ptr_array_add(graph->nodes, node);
+    graph->events = g_renew(cl_event, graph->events, graph->nodes->len);
+    graph->events[graph->nodes->len - 1] = NULL;
+
+    return node;
+}
+
+/**
+ * @internal
+ *
+ * @brief Get a node of the graph.
+ *
+ * @param[in] graph Command graph.
+ * @param[in] node Node index.
+ * @return The graph node at the given index.
+ * */
+#define ccl_graph_node(graph, node) \
+    ((CCLGraphNode *) g_ptr_array_index((graph)->nodes, (node)))
+
+/**
+ * @internal
+ *
+ * @brief Capture a kernel argument in a graph node, copying its value.
+ *
+ * @param[in] node Kernel execution node.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to capture. The argument is destroyed after its
+ * value is copied.
+ * */
+static void ccl_graph_node_capture_arg(
+    CCLGraphNode * node, cl_uint arg_index, CCLArg * arg) {
+
+    CCLGraphArg * garg = NULL;
+    size_t size = ccl_arg_size(arg);
+    void * value = ccl_arg_value(arg);
+
+    /* Is the argument already captured? */
+    for (guint i = 0; i < node->args->len; ++i) {
+        if (g_array_index(node->args, CCLGraphArg, i).index == arg_index) {
+            garg = &g_array_index(node->args, CCLGraphArg, i);
+            g_free(garg->value);
+            break;
+        }
+    }
+
+    /* If not, add it. */
+    if (garg == NULL) {
+        CCLGraphArg new_arg = { arg_index, 0, NULL, CL_TRUE };
+        g_array_append_val(node->args, new_arg);
+        garg = &g_array_index(node->args, CCLGraphArg, node->args->len - 1);
+    }
+
+    /* Keep a copy of the argument value. */
+    garg->size = size;
+    garg->value = (value != NULL) ? g_memdup(value, size) : NULL;
+    garg->dirty = CL_TRUE;
+    node->args_dirty = CL_TRUE;
+
+    /* The graph takes ownership of the argument. */
+    ccl_arg_destroy(arg);
+}
+
+/**
+ * @internal
+ *
+ * @brief Record a buffer read or write.
+ *
+ * @param[in] graph Command graph.
+ * @param[in] type ::CCL_GRAPH_NODE_WRITE or ::CCL_GRAPH_NODE_READ.
+ * @param[in] buf Buffer wrapper object.
+ * @param[in] offset Offset in bytes in the buffer object.
+ * @param[in] size Size in bytes of data to transfer.
+ * @param[in] ptr Host pointer.
+ * @return Index of the recorded node.
+ * */
+static cl_uint ccl_graph_transfer(CCLGraph * graph, CCLGraphNodeType type,
+    CCLBuffer * buf, size_t offset, size_t size, void * ptr) {
+
+    CCLGraphNode * node = ccl_graph_node_new(graph, type);
+
+    ccl_buffer_ref(buf);
+    node->buf = buf;
+    node->offset = offset;
+    node->size = size;
+    node->ptr = ptr;
+
+    return graph->nodes->len - 1;
+}
+
+/**
+ * Create a new, empty, command graph.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @return A new command graph, which should be destroyed with
+ * ::ccl_graph_destroy() when no longer needed.
+ * */
+CCL_EXPORT
+CCLGraph * ccl_graph_new() {
+
+    CCLGraph * graph = g_slice_new0(CCLGraph);
+
+    graph->nodes = g_ptr_array_new_with_free_func(ccl_graph_node_destroy);
+
+    return graph;
+}
+
+/**
+ * Destroy a command graph.
+ *
+ * Wrappers referenced by the recorded commands are unreferenced.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph to destroy.
+ * */
+CCL_EXPORT
+void ccl_graph_destroy(CCLGraph * graph) {
+
+    /* Make sure graph is not NULL. */
+    g_return_if_fail(graph != NULL);
+
+    g_ptr_array_free(graph->nodes, TRUE);
+    g_free(graph->events);
+    g_slice_free(CCLGraph, graph);
+}
+
+/**
+ * Get the number of commands recorded in a command graph.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @return The number of recorded commands.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_get_num_nodes(CCLGraph * graph) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, 0);
+
+    return graph->nodes->len;
+}
+
+/**
+ * Record a buffer write, which will be replayed with a non-blocking
+ * `clEnqueueWriteBuffer()` call.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] buf Buffer wrapper object, which is referenced by the graph.
+ * @param[in] offset Offset in bytes in the buffer object to write to.
+ * @param[in] size Size in bytes of data being written.
+ * @param[in] ptr Pointer to buffer in host memory where data is to be
+ * written from. It must remain valid until the replayed write completes.
+ * @return Index of the recorded command, or ::CCL_GRAPH_NODE_NONE if
+ * invalid arguments are given.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_write(CCLGraph * graph, CCLBuffer * buf, size_t offset,
+    size_t size, const void * ptr) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure buf is not NULL. */
+    g_return_val_if_fail(buf != NULL, CCL_GRAPH_NODE_NONE);
+
+    return ccl_graph_transfer(
+        graph, CCL_GRAPH_NODE_WRITE, buf, offset, size, (void *) ptr);
+}
+
+/**
+ * Record a buffer read, which will be replayed with a non-blocking
+ * `clEnqueueReadBuffer()` call.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] buf Buffer wrapper object, which is referenced by the graph.
+ * @param[in] offset Offset in bytes in the buffer object to read from.
+ * @param[in] size Size in bytes of data being read.
+ * @param[out] ptr Pointer to buffer in host memory where data is to be
+ * read into. Data is only available after the replayed read completes.
+ * @return Index of the recorded command, or ::CCL_GRAPH_NODE_NONE if
+ * invalid arguments are given.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_read(CCLGraph * graph, CCLBuffer * buf, size_t offset,
+    size_t size, void * ptr) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure buf is not NULL. */
+    g_return_val_if_fail(buf != NULL, CCL_GRAPH_NODE_NONE);
+
+    return ccl_graph_transfer(
+        graph, CCL_GRAPH_NODE_READ, buf, offset, size, ptr);
+}
+
+/**
+ * Record a copy from one buffer object to another.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] src_buf Source buffer wrapper object, which is referenced by
+ * the graph.
+ * @param[in] dst_buf Destination buffer wrapper object, which is referenced
+ * by the graph.
+ * @param[in] src_offset The offset where to begin copying data from
+ * `src_buf`.
+ * @param[in] dst_offset The offset where to begin copying data into
+ * `dst_buf`.
+ * @param[in] size Size in bytes to copy.
+ * @return Index of the recorded command, or ::CCL_GRAPH_NODE_NONE if
+ * invalid arguments are given.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_copy(CCLGraph * graph, CCLBuffer * src_buf,
+    CCLBuffer * dst_buf, size_t src_offset, size_t dst_offset, size_t size) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure src_buf is not NULL. */
+    g_return_val_if_fail(src_buf != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure dst_buf is not NULL. */
+    g_return_val_if_fail(dst_buf != NULL, CCL_GRAPH_NODE_NONE);
+
+    cl_uint idx = ccl_graph_transfer(
+        graph, CCL_GRAPH_NODE_COPY, src_buf, src_offset, size, NULL);
+    CCLGraphNode * node = ccl_graph_node(graph, idx);
+
+    ccl_buffer_ref(dst_buf);
+    node->dst_buf = dst_buf;
+    node->dst_offset = dst_offset;
+
+    return idx;
+}
+
+/**
+ * Record a kernel execution. This function accepts a variable list of
+ * `NULL`-terminated arguments, as ::ccl_kernel_set_args_and_enqueue_ndrange().
+ *
+ * The ::ccl_graph_kernel_v() function performs the same operation but
+ * accepts an array of arguments instead.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @attention The variable argument list must end with `NULL`.
+ *
+ * @param[in] graph Command graph.
+ * @param[in] krnl Kernel wrapper object, which is referenced by the graph.
+ * @param[in] work_dim The number of dimensions used to specify the global
+ * work-items and work-items in the work-group.
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item.
+ * @param[in] global_work_size An array of `work_dim` unsigned values that
+ * describe the number of global work-items in `work_dim` dimensions that
+ * will execute the kernel function.
+ * @param[in] local_work_size An array of `work_dim` unsigned values that
+ * describe the number of work-items that make up a work-group that will
+ * execute the specified kernel.
+ * @param[in] ... A `NULL`-terminated list of arguments to set.
+ * @return Index of the recorded command, or ::CCL_GRAPH_NODE_NONE if
+ * invalid arguments are given.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_kernel(CCLGraph * graph, CCLKernel * krnl,
+    cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    ...) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, CCL_GRAPH_NODE_NONE);
+
+    /* Index of recorded node. */
+    cl_uint idx;
+    /* The va_list, which represents the variable argument list. */
+    va_list args_va;
+    /* Array of arguments, to be created from the va_list. */
+    void ** args_array = NULL;
+    /* Number of arguments. */
+    guint num_args = 0;
+    /* Aux. arg. when cycling through the va_list. */
+    void * aux_arg;
+
+    /* Initialize the va_list. */
+    va_start(args_va, local_work_size);
+
+    /* Get first argument. */
+    aux_arg = va_arg(args_va, void *);
+
+    /* Check if any arguments are given, and if so, populate array
+     * of arguments. */
+    if (aux_arg != NULL) {
+
+        /* 1. Determine number of arguments. */
+        while (aux_arg != NULL) {
+            num_args++;
+            aux_arg = va_arg(args_va, void *);
+        }
+        va_end(args_va);
+
+        /* 2. Populate array of arguments. */
+        args_array = g_slice_alloc((num_args + 1) * sizeof(void *));
+        va_start(args_va, local_work_size);
+
+        for (guint i = 0; i < num_args; ++i) {
+            aux_arg = va_arg(args_va, void *);
+            args_array[i] = aux_arg;
+        }
+        va_end(args_va);
+        args_array[num_args] = NULL;
+
+    } else {
+        va_end(args_va);
+    }
+
+    /* Record kernel execution. */
+    idx = ccl_graph_kernel_v(graph, krnl, work_dim, global_work_offset,
+        global_work_size, local_work_size, args_array);
+
+    /* Free array of arguments. */
+    if (args_array != NULL)
+        g_slice_free1((num_args + 1) * sizeof(void *), args_array);
+
+    return idx;
+}
+
+/**
+ * Record a kernel execution. This function accepts a `NULL`-terminated
+ * array of arguments, as ::ccl_kernel_set_args_and_enqueue_ndrange_v().
+ *
+ * The values of the given arguments are copied into the graph, which takes
+ * ownership of the ::CCLArg* objects, as ::ccl_kernel_set_arg() does. If
+ * the ::ccl_arg_skip constant is passed in place of a specific argument,
+ * that argument is not set during replay, so the value currently set on the
+ * kernel is used. Buffers passed as arguments are not referenced by the
+ * graph, and must remain valid while the graph is replayed.
+ *
+ * Arguments are only set on the kernel in the first replay and when
+ * changed with ::ccl_graph_set_arg(), unless the kernel is recorded more
+ * than once in the graph, in which case its arguments are set in every
+ * replay. Arguments of recorded kernels should therefore not be changed
+ * outside the graph between replays.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] krnl Kernel wrapper object, which is referenced by the graph.
+ * @param[in] work_dim The number of dimensions used to specify the global
+ * work-items and work-items in the work-group (1, 2 or 3).
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item.
+ * @param[in] global_work_size An array of `work_dim` unsigned values that
+ * describe the number of global work-items in `work_dim` dimensions that
+ * will execute the kernel function.
+ * @param[in] local_work_size An array of `work_dim` unsigned values that
+ * describe the number of work-items that make up a work-group that will
+ * execute the specified kernel.
+ * @param[in] args A `NULL`-terminated list of arguments to set.
+ * @return Index of the recorded command, or ::CCL_GRAPH_NODE_NONE if
+ * invalid arguments are given.
+ * */
+CCL_EXPORT
+cl_uint ccl_graph_kernel_v(CCLGraph * graph, CCLKernel * krnl,
+    cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    void ** args) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, CCL_GRAPH_NODE_NONE);
+    /* Make sure work_dim is valid. */
+    g_return_val_if_fail(work_dim >= 1 && work_dim <= 3, CCL_GRAPH_NODE_NONE);
+    /* Make sure global_work_size is not NULL. */
+    g_return_val_if_fail(global_work_size != NULL, CCL_GRAPH_NODE_NONE);
+
+    CCLGraphNode * node = ccl_graph_node_new(graph, CCL_GRAPH_NODE_KERNEL);
+
+    ccl_kernel_ref(krnl);
+    node->krnl = krnl;
+    node->work_dim = work_dim;
+    node->has_gwo = (global_work_offset != NULL);
+    node->has_lws = (local_work_size != NULL);
+    for (cl_uint i = 0; i < work_dim; ++i) {
+        node->gws[i] = global_work_size[i];
+        if (node->has_gwo) node->gwo[i] = global_work_offset[i];
+        if (node->has_lws) node->lws[i] = local_work_size[i];
+    }
+    node->args = g_array_new(FALSE, FALSE, sizeof(CCLGraphArg));
+
+    /* Capture arguments, ignoring "skip" arguments. */
+    if (args != NULL) {
+        for (cl_uint i = 0; args[i] != NULL; ++i) {
+            if (args[i] == ccl_arg_skip) continue;
+            ccl_graph_node_capture_arg(node, i, (CCLArg *) args[i]);
+        }
+    }
+
+    /* Check if the kernel is executed by other nodes, in which case
+     * arguments must be set in every replay. */
+    for (guint i = 0; i < graph->nodes->len - 1; ++i) {
+        CCLGraphNode * other = ccl_graph_node(graph, i);
+        if ((other->type == CCL_GRAPH_NODE_KERNEL)
+            && (ccl_kernel_unwrap(other->krnl) == ccl_kernel_unwrap(krnl))) {
+            other->shared_krnl = CL_TRUE;
+            node->shared_krnl = CL_TRUE;
+        }
+    }
+
+    return graph->nodes->len - 1;
+}
+
+/**
+ * Specify that a recorded command depends on a previously recorded
+ * command.
+ *
+ * Commands are replayed in the order in which they were recorded, so
+ * dependencies only need to be specified for out-of-order command queues.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] node Index of dependent command.
+ * @param[in] dep Index of command on which `node` depends, which must have
+ * been recorded before `node`.
+ * */
+CCL_EXPORT
+void ccl_graph_add_dep(CCLGraph * graph, cl_uint node, cl_uint dep) {
+
+    /* Make sure graph is not NULL. */
+    g_return_if_fail(graph != NULL);
+    /* Make sure node is valid. */
+    g_return_if_fail(node < graph->nodes->len);
+    /* Make sure dep was recorded before node. */
+    g_return_if_fail(dep < node);
+
+    CCLGraphNode * n = ccl_graph_node(graph, node);
+
+    if (n->deps == NULL) n->deps = g_array_new(FALSE, FALSE, sizeof(cl_uint));
+    g_array_append_val(n->deps, dep);
+
+    /* Keep the wait list sized to the number of dependencies. */
+    n->wait = g_renew(cl_event, n->wait, n->deps->len);
+
+    ccl_graph_node(graph, dep)->needs_evt = CL_TRUE;
+}
+
+/**
+ * Change an argument of a recorded kernel execution. The argument is set on
+ * the kernel in the next replay.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] node Index of a kernel execution command.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to set. The graph takes ownership of the
+ * argument, as ::ccl_kernel_set_arg() does.
+ * */
+CCL_EXPORT
+void ccl_graph_set_arg(CCLGraph * graph, cl_uint node, cl_uint arg_index,
+    void * arg) {
+
+    /* Make sure graph is not NULL. */
+    g_return_if_fail(graph != NULL);
+    /* Make sure node is valid. */
+    g_return_if_fail(node < graph->nodes->len);
+    /* Make sure node is a kernel execution. */
+    g_return_if_fail(
+        ccl_graph_node(graph, node)->type == CCL_GRAPH_NODE_KERNEL);
+    /* Make sure arg is not NULL. */
+    g_return_if_fail(arg != NULL);
+
+    if (arg == ccl_arg_skip) return;
+
+    ccl_graph_node_capture_arg(
+        ccl_graph_node(graph, node), arg_index, (CCLArg *) arg);
+}
+
+/**
+ * Change the buffer of a recorded buffer read or write.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] node Index of a buffer read or write command.
+ * @param[in] buf New buffer wrapper object, which is referenced by the
+ * graph.
+ * */
+CCL_EXPORT
+void ccl_graph_set_buffer(CCLGraph * graph, cl_uint node, CCLBuffer * buf) {
+
+    /* Make sure graph is not NULL. */
+    g_return_if_fail(graph != NULL);
+    /* Make sure node is valid. */
+    g_return_if_fail(node < graph->nodes->len);
+    /* Make sure node is a buffer read or write. */
+    g_return_if_fail(
+        (ccl_graph_node(graph, node)->type == CCL_GRAPH_NODE_WRITE)
+        || (ccl_graph_node(graph, node)->type == CCL_GRAPH_NODE_READ));
+    /* Make sure buf is not NULL. */
+    g_return_if_fail(buf != NULL);
+
+    CCLGraphNode * n = ccl_graph_node(graph, node);
+
+    ccl_buffer_ref(buf);
+    ccl_buffer_unref(n->buf);
+    n->buf = buf;
+}
+
+/**
+ * Change the host pointer of a recorded buffer read or write.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] node Index of a buffer read or write command.
+ * @param[in] ptr New host pointer.
+ * */
+CCL_EXPORT
+void ccl_graph_set_host_ptr(CCLGraph * graph, cl_uint node, void * ptr) {
+
+    /* Make sure graph is not NULL. */
+    g_return_if_fail(graph != NULL);
+    /* Make sure node is valid. */
+    g_return_if_fail(node < graph->nodes->len);
+    /* Make sure node is a buffer read or write. */
+    g_return_if_fail(
+        (ccl_graph_node(graph, node)->type == CCL_GRAPH_NODE_WRITE)
+        || (ccl_graph_node(graph, node)->type == CCL_GRAPH_NODE_READ));
+
+    ccl_graph_node(graph, node)->ptr = ptr;
+}
+
+/**
+ * Enqueue the recorded commands on a command queue.
+ *
+ * Commands are enqueued in the order in which they were recorded. Events
+ * are only requested for commands on which other commands depend, and for
+ * the last command. These events are released by this function, except for
+ * the event of the last command, which is wrapped, associated with the
+ * command queue, and returned.
+ *
+ * @public @memberof ccl_graph
+ *
+ * @param[in] graph Command graph.
+ * @param[in] cq Command queue wrapper object.
+ * @param[in,out] evt_wait_lst List of events that need to complete before
+ * commands without recorded dependencies can be executed. The list will be
+ * cleared and can be reused by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return Event wrapper object that identifies the last recorded command,
+ * or `NULL` if an error occurs or if the queue is event-less.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_graph_replay(CCLGraph * graph, CCLQueue * cq,
+    CCLEventWaitList * evt_wait_lst, CCLErr ** err) {
+
+    /* Make sure graph is not NULL. */
+    g_return_val_if_fail(graph != NULL, NULL);
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* OpenCL status flag. */
+    cl_int ocl_status;
+    /* Event wrapper. */
+    CCLEvent * evt = NULL;
+    /* Number of recorded commands. */
+    guint num_nodes = graph->nodes->len;
+    /* Index of current command. */
+    guint i;
+    /* OpenCL command queue. */
+    cl_command_queue queue = ccl_queue_unwrap(cq);
+
+    /* Check that the graph is not empty. */
+    ccl_if_err_create_goto(*err, CCL_ERROR, num_nodes == 0,
+        CCL_ERROR_ARGS, error_handler,
+        "%s: command graph has no recorded commands.", CCL_STRD);
+
+    for (i = 0; i < num_nodes; ++i) {
+
+        CCLGraphNode * node = ccl_graph_node(graph, i);
+        cl_uint num_wait;
+        const cl_event * wait;
+        cl_event * event = NULL;
+
+        /* Determine events to wait on. */
+        if (node->deps != NULL) {
+            num_wait = node->deps->len;
+            for (guint j = 0; j < num_wait; ++j)
+                node->wait[j] =
+                    graph->events[g_array_index(node->deps, cl_uint, j)];
+            wait = node->wait;
+        } else {
+            num_wait = ccl_event_wait_list_get_num_events(evt_wait_lst);
+            wait = ccl_event_wait_list_get_clevents(evt_wait_lst);
+        }
+
+        /* Determine if an event is required for this command. */
+        if (i == num_nodes - 1)
+            event = ccl_queue_event_ptr(cq, &graph->events[i]);
+        else if (node->needs_evt)
+            event = &graph->events[i];
+
+        switch (node->type) {
+
+            case CCL_GRAPH_NODE_WRITE:
+                ocl_status = clEnqueueWriteBuffer(queue,
+                    ccl_buffer_unwrap(node->buf), CL_FALSE, node->offset,
+                    node->size, node->ptr, num_wait, wait, event);
+                break;
+
+            case CCL_GRAPH_NODE_READ:
+                ocl_status = clEnqueueReadBuffer(queue,
+                    ccl_buffer_unwrap(node->buf), CL_FALSE, node->offset,
+                    node->size, node->ptr, num_wait, wait, event);
+                break;
+
+            case CCL_GRAPH_NODE_COPY:
+                ocl_status = clEnqueueCopyBuffer(queue,
+                    ccl_buffer_unwrap(node->buf),
+                    ccl_buffer_unwrap(node->dst_buf), node->offset,
+                    node->dst_offset, node->size, num_wait, wait, event);
+                break;
+
+            case CCL_GRAPH_NODE_KERNEL:
+
+                /* Set changed arguments, or all of them if the kernel is
+                 * shared with other commands. */
+                if (node->args_dirty || node->shared_krnl) {
+                    for (guint j = 0; j < node->args->len; ++j) {
+                        CCLGraphArg * garg =
+                            &g_array_index(node->args, CCLGraphArg, j);
+                        if (!garg->dirty && !node->shared_krnl) continue;
+                        ocl_status = clSetKernelArg(
+                            ccl_kernel_unwrap(node->krnl), garg->index,
+                            garg->size, garg->value);
+                        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+                            CL_SUCCESS != ocl_status, ocl_status,
+                            error_handler, "%s: unable to set kernel arg "
+                            "%d (OpenCL error %d: %s).", CCL_STRD,
+                            garg->index, ocl_status, ccl_err(ocl_status));
+                        ccl_kernel_forget_arg(node->krnl, garg->index);
+                        garg->dirty = CL_FALSE;
+                    }
+                    node->args_dirty = CL_FALSE;
+                }
+
+                ocl_status = clEnqueueNDRangeKernel(queue,
+                    ccl_kernel_unwrap(node->krnl), node->work_dim,
+                    node->has_gwo ? node->gwo : NULL, node->gws,
+                    node->has_lws ? node->lws : NULL,
+                    num_wait, wait, event);
+                break;
+
+            default:
+                g_assert_not_reached();
+        }
+
+        ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+            CL_SUCCESS != ocl_status, ocl_status, error_handler,
+            "%s: unable to enqueue command %d of graph (OpenCL error %d: %s).",
+            CCL_STRD, i, ocl_status, ccl_err(ocl_status));
+    }
+
+    /* Release the events of intermediate commands. */
+    for (i = 0; i < num_nodes - 1; ++i) {
+        if (graph->events[i] != NULL) {
+            clReleaseEvent(graph->events[i]);
+            graph->events[i] = NULL;
+        }
+    }
+
+    /* Wrap the event of the last command and associate it with the
+     * command queue, unless the queue is event-less. */
+    if (graph->events[num_nodes - 1] != NULL) {
+        evt = ccl_queue_produce_event(cq, graph->events[num_nodes - 1]);
+        graph->events[num_nodes - 1] = NULL;
+    }
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, num_nodes);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    /* Release events of the commands enqueued so far. */
+    for (i = 0; i < num_nodes; ++i) {
+        if (graph->events[i] != NULL) {
+            clReleaseEvent(graph->events[i]);
+            graph->events[i] = NULL;
+        }
+    }
+
+    /* An error occurred, return NULL to signal it. */
+    evt = NULL;
+
+finish:
+
+    /* Clear event wait list. */
+    ccl_event_wait_list_clear(evt_wait_lst);
+
+    /* Return evt. */
+    return evt;
+}
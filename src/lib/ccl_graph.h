@@ -0,0 +1,175 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Definition of classes and methods for recording sequences of OpenCL
+ * commands and replaying them on command queues.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_GRAPH_H_
+#define _CCL_GRAPH_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_buffer_wrapper.h"
+#include "ccl_kernel_wrapper.h"
+#include "ccl_queue_wrapper.h"
+#include "ccl_event_wrapper.h"
+
+/**
+ * @defgroup CCL_GRAPH Command graphs
+ *
+ * The command graph module provides the ::CCLGraph* class, which records a
+ * sequence of buffer transfers and kernel executions, together with their
+ * dependencies, so that it can be replayed many times on a command queue.
+ *
+ * Applications which enqueue the same commands over and over again (e.g.
+ * one iteration of a simulation) pay, in each iteration, the price of
+ * setting up every kernel argument, wrapping every event and building every
+ * event wait list. A command graph is recorded once with the
+ * `ccl_graph_*()` functions, which mirror the respective `ccl_*_enqueue_*()`
+ * functions. Recorded commands keep the OpenCL `cl_kernel` and `cl_mem`
+ * objects, the work sizes, the kernel argument values and the event arrays
+ * used to express dependencies. ::ccl_graph_replay() then enqueues the
+ * recorded commands directly, in the order in which they were recorded,
+ * only setting kernel arguments which changed since the previous replay.
+ * Only the event of the last command is wrapped and returned.
+ *
+ * Recorded commands can be patched between replays with
+ * ::ccl_graph_set_arg(), ::ccl_graph_set_buffer() and
+ * ::ccl_graph_set_host_ptr().
+ *
+ * Commands are replayed in recording order, which is enough to satisfy
+ * dependencies in in-order command queues. Dependencies for out-of-order
+ * command queues are specified with ::ccl_graph_add_dep().
+ *
+ * _Example:_
+ *
+ * ```c
+ * CCLGraph * graph;
+ * CCLEvent * evt;
+ * cl_uint nwrite;
+ * ```
+ *
+ * ```c
+ * graph = ccl_graph_new();
+ * nwrite = ccl_graph_write(graph, buf, 0, size, inputs[0]);
+ * ccl_graph_kernel(graph, krnl, 1, NULL, &gws, &lws,
+ *     buf, ccl_arg_priv(n, cl_uint), NULL);
+ * ccl_graph_read(graph, buf, 0, size, host_out);
+ * ```
+ *
+ * ```c
+ * for (i = 0; i < iters; ++i) {
+ *     ccl_graph_set_host_ptr(graph, nwrite, inputs[i]);
+ *     evt = ccl_graph_replay(graph, cq, NULL, &err);
+ *     ccl_event_wait(ccl_ewl(&ewl, evt, NULL), &err);
+ * }
+ * ```
+ *
+ * ```c
+ * ccl_graph_destroy(graph);
+ * ```
+ *
+ * @{
+ */
+
+/**
+ * Node index returned by the recording functions on invalid arguments.
+ * */
+#define CCL_GRAPH_NODE_NONE G_MAXUINT
+
+/**
+ * A recorded sequence of OpenCL commands.
+ * */
+typedef struct ccl_graph CCLGraph;
+
+/* Create a new, empty, command graph. */
+CCL_EXPORT
+CCLGraph * ccl_graph_new(void);
+
+/* Destroy a command graph. */
+CCL_EXPORT
+void ccl_graph_destroy(CCLGraph * graph);
+
+/* Get the number of commands recorded in a command graph. */
+CCL_EXPORT
+cl_uint ccl_graph_get_num_nodes(CCLGraph * graph);
+
+/* Record a buffer write. */
+CCL_EXPORT
+cl_uint ccl_graph_write(CCLGraph * graph, CCLBuffer * buf, size_t offset,
+    size_t size, const void * ptr);
+
+/* Record a buffer read. */
+CCL_EXPORT
+cl_uint ccl_graph_read(CCLGraph * graph, CCLBuffer * buf, size_t offset,
+    size_t size, void * ptr);
+
+/* Record a copy between buffers. */
+CCL_EXPORT
+cl_uint ccl_graph_copy(CCLGraph * graph, CCLBuffer * src_buf,
+    CCLBuffer * dst_buf, size_t src_offset, size_t dst_offset, size_t size);
+
+/* Record a kernel execution. This function accepts a variable list of
+ * `NULL`-terminated arguments. */
+CCL_EXPORT
+cl_uint ccl_graph_kernel(CCLGraph * graph, CCLKernel * krnl,
+    cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    ...) G_GNUC_NULL_TERMINATED;
+
+/* Record a kernel execution. This function accepts a `NULL`-terminated
+ * array of arguments. */
+CCL_EXPORT
+cl_uint ccl_graph_kernel_v(CCLGraph * graph, CCLKernel * krnl,
+    cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    void ** args);
+
+/* Specify that a recorded command depends on a previously recorded
+ * command. */
+CCL_EXPORT
+void ccl_graph_add_dep(CCLGraph * graph, cl_uint node, cl_uint dep);
+
+/* Change an argument of a recorded kernel execution. */
+CCL_EXPORT
+void ccl_graph_set_arg(CCLGraph * graph, cl_uint node, cl_uint arg_index,
+    void * arg);
+
+/* Change the buffer of a recorded buffer read or write. */
+CCL_EXPORT
+void ccl_graph_set_buffer(CCLGraph * graph, cl_uint node, CCLBuffer * buf);
+
+/* Change the host pointer of a recorded buffer read or write. */
+CCL_EXPORT
+void ccl_graph_set_host_ptr(CCLGraph * graph, cl_uint node, void * ptr);
+
+/* Enqueue the recorded commands on a command queue. */
+CCL_EXPORT
+CCLEvent * ccl_graph_replay(CCLGraph * graph, CCLQueue * cq,
+    CCLEventWaitList * evt_wait_lst, CCLErr ** err);
+
+/** @} */
+
+#endif
@@ -28,6 +28,7 @@
 #include "ccl_image_wrapper.h"
 #include "ccl_buffer_wrapper.h"
 #include "_ccl_memobj_wrapper.h"
+#include "_ccl_queue_wrapper.h"
 #include "_ccl_defs.h"
 
 /**
@@ -487,24 +488,39 @@ CCLEvent * ccl_image_enqueue_read(CCLImage * img, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(img), CL_FALSE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Read image from device into host. */
     ocl_status = clEnqueueReadImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(img), blocking_read, origin, region,
         row_pitch, slice_pitch, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue an image read (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -576,24 +592,39 @@ CCLEvent * ccl_image_enqueue_write(CCLImage * img, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(img), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Write image to device from host. */
     ocl_status = clEnqueueWriteImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(img), blocking_write, origin, region,
         input_row_pitch, input_slice_pitch, ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue an image write (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -664,24 +695,41 @@ CCLEvent * ccl_image_enqueue_copy(CCLImage * src_img, CCLImage * dst_img,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(src_img), CL_FALSE },
+        { ccl_memobj_unwrap(dst_img), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Copy image. */
     ocl_status = clEnqueueCopyImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(src_img), ccl_memobj_unwrap(dst_img),
         src_origin, dst_origin, region,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue an image copy (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -751,24 +799,41 @@ CCLEvent * ccl_image_enqueue_copy_to_buffer(CCLImage * src_img,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(src_img), CL_FALSE },
+        { ccl_memobj_unwrap(dst_buf), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Copy image to buffer. */
     ocl_status = clEnqueueCopyImageToBuffer(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(src_img), ccl_memobj_unwrap(dst_buf),
         src_origin, region, dst_offset,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to copy image to buffer (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -845,28 +910,42 @@ void * ccl_image_enqueue_map(CCLImage * img, CCLQueue * cq,
 
     cl_int ocl_status;
     cl_event event = NULL;
+    CCLEventWaitList hz_lst = NULL;
     CCLEvent * evt_inner = NULL;
     void * ptr = NULL;
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = {
+        { ccl_memobj_unwrap(img), map_flags != CL_MAP_READ } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Perform image map. */
     ptr = clEnqueueMapImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(img), blocking_map, map_flags,
         origin, region, image_row_pitch, image_slice_pitch,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
         ccl_event_wait_list_get_clevents(evt_wait_lst),
-        &event, &ocl_status);
+        ccl_queue_event_ptr(cq, &event), &ocl_status);
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to map image (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt_inner = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt_inner = ccl_queue_produce_event(cq, event);
     if (evt != NULL)
         *evt = evt_inner;
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -930,6 +1009,8 @@ CCLEvent * ccl_image_enqueue_fill(CCLImage * img, CCLQueue * cq,
     cl_int ocl_status;
     /* OpenCL event object. */
     cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper object. */
     CCLEvent * evt = NULL;
     /* OpenCL version of the underlying platform. */
@@ -945,6 +1026,7 @@ CCLEvent * ccl_image_enqueue_fill(CCLImage * img, CCLQueue * cq,
     CCL_UNUSED(evt_wait_lst);
     CCL_UNUSED(ocl_status);
     CCL_UNUSED(event);
+    CCL_UNUSED(hz_lst);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
 
@@ -969,23 +1051,36 @@ CCLEvent * ccl_image_enqueue_fill(CCLImage * img, CCLQueue * cq,
         "%s: Image fill requires OpenCL version 1.2 or newer.",
         CCL_STRD);
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(img), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
+
     /* Fill image. */
     ocl_status = clEnqueueFillImage(ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(img), fill_color, origin, region,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue a fill image command (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
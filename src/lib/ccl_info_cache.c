@@ -0,0 +1,383 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Implementation of a persistent on-disk cache of platform and device
+ * information.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include <errno.h>
+#include "ccl_info_cache.h"
+#include "_ccl_info_cache.h"
+#include "_ccl_abstract_wrapper.h"
+#include "_ccl_defs.h"
+
+/* Name of info cache file within the info cache folder. */
+#define CCL_INFO_CACHE_FILE "info.ini"
+
+/* Protects the info cache. */
+static GMutex info_cache_mutex;
+
+/* Cached information, or NULL if info cache is disabled. */
+static GKeyFile * info_cache = NULL;
+
+/* Location of info cache file. */
+static gchar * info_cache_path = NULL;
+
+/* Platform information kept in the info cache. */
+static const cl_uint info_cache_platform_params[] = {
+    CL_PLATFORM_PROFILE, CL_PLATFORM_VERSION, CL_PLATFORM_NAME,
+    CL_PLATFORM_VENDOR, CL_PLATFORM_EXTENSIONS
+};
+
+/* Device information kept in the info cache. Information which refers to
+ * other OpenCL objects (e.g. the device platform) and information which
+ * may change (e.g. device availability) is not kept. */
+static const cl_uint info_cache_device_params[] = {
+    CL_DEVICE_TYPE, CL_DEVICE_VENDOR_ID, CL_DEVICE_MAX_COMPUTE_UNITS,
+    CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+    CL_DEVICE_MAX_WORK_GROUP_SIZE, CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT,
+    CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE, CL_DEVICE_MAX_CLOCK_FREQUENCY,
+    CL_DEVICE_ADDRESS_BITS, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+    CL_DEVICE_IMAGE_SUPPORT, CL_DEVICE_MAX_READ_IMAGE_ARGS,
+    CL_DEVICE_MAX_WRITE_IMAGE_ARGS, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+    CL_DEVICE_IMAGE2D_MAX_HEIGHT, CL_DEVICE_IMAGE3D_MAX_WIDTH,
+    CL_DEVICE_IMAGE3D_MAX_HEIGHT, CL_DEVICE_IMAGE3D_MAX_DEPTH,
+    CL_DEVICE_MAX_SAMPLERS, CL_DEVICE_MAX_PARAMETER_SIZE,
+    CL_DEVICE_MEM_BASE_ADDR_ALIGN, CL_DEVICE_MIN_DATA_TYPE_ALIGN_SIZE,
+    CL_DEVICE_SINGLE_FP_CONFIG, CL_DEVICE_GLOBAL_MEM_CACHE_TYPE,
+    CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE,
+    CL_DEVICE_GLOBAL_MEM_SIZE, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE,
+    CL_DEVICE_MAX_CONSTANT_ARGS, CL_DEVICE_LOCAL_MEM_TYPE,
+    CL_DEVICE_LOCAL_MEM_SIZE, CL_DEVICE_ERROR_CORRECTION_SUPPORT,
+    CL_DEVICE_PROFILING_TIMER_RESOLUTION, CL_DEVICE_ENDIAN_LITTLE,
+    CL_DEVICE_COMPILER_AVAILABLE, CL_DEVICE_EXECUTION_CAPABILITIES,
+    CL_DEVICE_QUEUE_PROPERTIES, CL_DEVICE_NAME, CL_DEVICE_VENDOR,
+    CL_DRIVER_VERSION, CL_DEVICE_PROFILE, CL_DEVICE_VERSION,
+    CL_DEVICE_EXTENSIONS,
+#ifdef CL_VERSION_1_1
+    CL_DEVICE_HOST_UNIFIED_MEMORY, CL_DEVICE_OPENCL_C_VERSION,
+#endif
+#ifdef CL_VERSION_1_2
+    CL_DEVICE_LINKER_AVAILABLE, CL_DEVICE_BUILT_IN_KERNELS,
+    CL_DEVICE_PARTITION_MAX_SUB_DEVICES,
+#endif
+};
+
+/**
+ * @internal
+ *
+ * @brief Get name of info cache group for the given key.
+ *
+ * Keys may contain characters which are not allowed in group names, so
+ * groups are named after a checksum of the key. The size of `size_t` is
+ * part of the checksum, since some of the cached values (e.g. the maximum
+ * work-item sizes) are arrays of `size_t`, so that 32-bit and 64-bit
+ * processes sharing the same info cache don't read each other's values.
+ *
+ * @private @memberof ccl_info_cache
+ *
+ * @param[in] prefix Group name prefix.
+ * @param[in] key Key identifying cached information.
+ * @return Name of info cache group, should be freed with g_free().
+ * */
+static gchar * ccl_info_cache_group(const char * prefix, const char * key) {
+
+    gchar * abi_key = g_strdup_printf("%d|%s", GLIB_SIZEOF_SIZE_T, key);
+    gchar * checksum = g_compute_checksum_for_string(
+        G_CHECKSUM_SHA1, abi_key, -1);
+    gchar * group = g_strconcat(prefix, checksum, NULL);
+    g_free(checksum);
+    g_free(abi_key);
+    return group;
+}
+
+/**
+ * @internal
+ *
+ * @brief Pre-populate a wrapper with information from an info cache group.
+ *
+ * @private @memberof ccl_info_cache
+ *
+ * @param[in] wrapper Platform or device wrapper.
+ * @param[in] info_type Type of information kept in group.
+ * @param[in] group Name of info cache group.
+ * @return `TRUE` if group exists in info cache, `FALSE` otherwise.
+ * */
+static gboolean ccl_info_cache_restore(CCLWrapper * wrapper,
+    CCLInfo info_type, const gchar * group) {
+
+    gchar ** keys;
+    gchar * value;
+    guchar * data;
+    gsize size;
+    cl_uint param_name;
+
+    /* Get all cached parameters in group. */
+    keys = g_key_file_get_keys(info_cache, group, NULL, NULL);
+    if (keys == NULL) return FALSE;
+
+    /* Keys have the form "pXXXX", where XXXX is the parameter name in
+     * hexadecimal, and values are base64-encoded. */
+    for (guint i = 0; keys[i] != NULL; ++i) {
+        if (keys[i][0] != 'p') continue;
+        param_name = (cl_uint) g_ascii_strtoull(keys[i] + 1, NULL, 16);
+        value = g_key_file_get_value(info_cache, group, keys[i], NULL);
+        if (value == NULL) continue;
+        data = g_base64_decode(value, &size);
+        ccl_wrapper_add_info_immutable(
+            wrapper, param_name, info_type, data, size);
+        g_free(data);
+        g_free(value);
+    }
+
+    g_strfreev(keys);
+    return TRUE;
+}
+
+/**
+ * @internal
+ *
+ * @brief Query a wrapper for information and keep it in an info cache
+ * group.
+ *
+ * @private @memberof ccl_info_cache
+ *
+ * @param[in] wrapper Platform or device wrapper.
+ * @param[in] info_type Type of information to query.
+ * @param[in] param_names Parameters to query.
+ * @param[in] num_params Number of parameters in `param_names`.
+ * @param[in] group Name of info cache group.
+ * */
+static void ccl_info_cache_store(CCLWrapper * wrapper, CCLInfo info_type,
+    const cl_uint * param_names, cl_uint num_params, const gchar * group) {
+
+    CCLWrapperInfo * info;
+    gchar key[16];
+    gchar * value;
+
+    /* Query all parameters in one go, unsupported parameters are
+     * ignored. */
+    ccl_wrapper_prefetch_info(
+        wrapper, NULL, param_names, num_params, info_type);
+
+    /* Keep parameters which are now cached. */
+    for (cl_uint i = 0; i < num_params; ++i) {
+        info = ccl_wrapper_lookup_info_immutable(
+            wrapper, param_names[i], info_type);
+        if (info == NULL) continue;
+        g_snprintf(key, sizeof(key), "p%04x", param_names[i]);
+        value = g_base64_encode(info->value, info->size);
+        g_key_file_set_value(info_cache, group, key, value);
+        g_free(value);
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Pre-populate platform and device wrappers with cached information,
+ * or query and cache their information if not yet cached.
+ *
+ * This function does nothing if the info cache is not enabled. Otherwise,
+ * it's called once for each platform, after the platform devices are
+ * initialized.
+ *
+ * @protected @memberof ccl_info_cache
+ *
+ * @param[in] platf Platform wrapper.
+ * @param[in] devices Devices in platform.
+ * @param[in] num_devices Number of devices in platform.
+ * */
+void ccl_info_cache_load_platform(CCLPlatform * platf,
+    CCLDevice * const * devices, cl_uint num_devices) {
+
+    /* Make sure platf is not NULL. */
+    g_return_if_fail(platf != NULL);
+
+    char * name;
+    char * version;
+    gchar * platf_key = NULL;
+    gchar * dev_key;
+    gchar * group;
+    gboolean dirty = FALSE;
+
+    g_mutex_lock(&info_cache_mutex);
+
+    /* Nothing to do if info cache is disabled. */
+    if (info_cache == NULL) goto finish;
+
+    /* Platform information is keyed by platform name and version. */
+    name = ccl_platform_get_info_string(platf, CL_PLATFORM_NAME, NULL);
+    version = ccl_platform_get_info_string(platf, CL_PLATFORM_VERSION, NULL);
+    if ((name == NULL) || (version == NULL)) goto finish;
+    platf_key = g_strjoin("|", name, version, NULL);
+
+    group = ccl_info_cache_group("platform-", platf_key);
+    if (!ccl_info_cache_restore((CCLWrapper *) platf,
+        CCL_INFO_PLATFORM, group)) {
+
+        ccl_info_cache_store((CCLWrapper *) platf, CCL_INFO_PLATFORM,
+            info_cache_platform_params,
+            G_N_ELEMENTS(info_cache_platform_params), group);
+        dirty = TRUE;
+    }
+    g_free(group);
+
+    /* Device information is additionally keyed by device index in
+     * platform, vendor ID, name and driver version. */
+    for (cl_uint i = 0; i < num_devices; ++i) {
+
+        dev_key = g_strdup_printf("%s|%u|%u|%s|%s", platf_key, i,
+            ccl_device_get_info_scalar(
+                devices[i], CL_DEVICE_VENDOR_ID, cl_uint, NULL),
+            ccl_device_get_info_array(
+                devices[i], CL_DEVICE_NAME, char, NULL),
+            ccl_device_get_info_array(
+                devices[i], CL_DRIVER_VERSION, char, NULL));
+
+        group = ccl_info_cache_group("device-", dev_key);
+        if (!ccl_info_cache_restore((CCLWrapper *) devices[i],
+            CCL_INFO_DEVICE, group)) {
+
+            ccl_info_cache_store((CCLWrapper *) devices[i], CCL_INFO_DEVICE,
+                info_cache_device_params,
+                G_N_ELEMENTS(info_cache_device_params), group);
+            dirty = TRUE;
+        }
+        g_free(group);
+        g_free(dev_key);
+    }
+
+    /* Write new information to disk. Failing to do so is not an error,
+     * information will be cached again next time. */
+    if (dirty) g_key_file_save_to_file(info_cache, info_cache_path, NULL);
+
+finish:
+
+    g_mutex_unlock(&info_cache_mutex);
+    g_free(platf_key);
+}
+
+/**
+ * @addtogroup CCL_INFO_CACHE
+ * @{
+ */
+
+/**
+ * Enable the persistent cache of platform and device information.
+ *
+ * Information is kept in an `info.ini` file within the given folder,
+ * which is created if it doesn't exist. An existing file which can't be
+ * read is ignored and will be overwritten.
+ *
+ * @public @memberof ccl_info_cache
+ *
+ * @param[in] dir Folder where to keep the cached information, or `NULL`
+ * to use the `cf4ocl` folder within the user cache folder (e.g.
+ * `$XDG_CACHE_HOME/cf4ocl`).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if the info cache is enabled, `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_info_cache_enable(const char * dir, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    gchar * cache_dir;
+    cl_bool status;
+
+    /* Determine info cache folder and make sure it exists. */
+    cache_dir = (dir != NULL)
+        ? g_strdup(dir)
+        : g_build_filename(g_get_user_cache_dir(), "cf4ocl", NULL);
+    ccl_if_err_create_goto(*err, CCL_ERROR,
+        g_mkdir_with_parents(cache_dir, 0700) != 0,
+        CCL_ERROR_OPENFILE, error_handler,
+        "%s: unable to create info cache folder '%s' (%s).",
+        CCL_STRD, cache_dir, g_strerror(errno));
+
+    g_mutex_lock(&info_cache_mutex);
+
+    /* Discard previously enabled info cache, if any. */
+    if (info_cache != NULL) g_key_file_free(info_cache);
+    g_free(info_cache_path);
+
+    /* Load existing information, start afresh if there's none. */
+    info_cache_path = g_build_filename(cache_dir, CCL_INFO_CACHE_FILE, NULL);
+    info_cache = g_key_file_new();
+    if (!g_key_file_load_from_file(
+        info_cache, info_cache_path, G_KEY_FILE_NONE, NULL)) {
+
+        g_key_file_free(info_cache);
+        info_cache = g_key_file_new();
+    }
+
+    g_mutex_unlock(&info_cache_mutex);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    status = CL_FALSE;
+
+finish:
+
+    g_free(cache_dir);
+
+    /* Return status. */
+    return status;
+}
+
+/**
+ * Disable the persistent cache of platform and device information.
+ *
+ * Information already placed in existing wrappers remains available.
+ *
+ * @public @memberof ccl_info_cache
+ * */
+CCL_EXPORT
+void ccl_info_cache_disable() {
+
+    g_mutex_lock(&info_cache_mutex);
+
+    if (info_cache != NULL) g_key_file_free(info_cache);
+    g_free(info_cache_path);
+    info_cache = NULL;
+    info_cache_path = NULL;
+
+    g_mutex_unlock(&info_cache_mutex);
+}
+
+/** @} */
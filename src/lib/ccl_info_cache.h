@@ -0,0 +1,86 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Functions for managing a persistent on-disk cache of platform and device
+ * information.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_INFO_CACHE_H_
+#define _CCL_INFO_CACHE_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+
+/**
+ * @defgroup CCL_INFO_CACHE Info cache
+ *
+ * The info cache module provides an opt-in persistent cache of platform
+ * and device information.
+ *
+ * Platform and device information which can't change during the lifetime
+ * of the respective OpenCL objects (e.g. device names, limits and
+ * extensions) is the same in every process, as long as the OpenCL
+ * implementation stays the same. When the info cache is enabled with
+ * ::ccl_info_cache_enable(), such information is stored on disk the first
+ * time the devices of a platform are requested, and is used to
+ * pre-populate the platform and device wrappers in subsequent processes.
+ * This way, device selection, device queries and context creation will
+ * not query the OpenCL implementation for immutable information.
+ *
+ * Cached information is keyed by platform name and version, and by
+ * device index, vendor ID, name and driver version, as well as by the size
+ * of `size_t` of the process. Information cached for a previous driver
+ * version, or by a 32-bit process for a 64-bit one (or vice-versa), is thus
+ * never used. The cache can be disabled with ::ccl_info_cache_disable().
+ *
+ * The info cache should be enabled before platform devices are first
+ * requested, since platforms whose devices are already known are not
+ * checked against the info cache.
+ *
+ * _Example:_
+ *
+ * ```c
+ * CCLErr * err = NULL;
+ * CCLDevSelDevices devs;
+ * ```
+ *
+ * ```c
+ * ccl_info_cache_enable(NULL, &err);
+ * devs = ccl_devsel_devices_new(&err);
+ * ```
+ *
+ * @{
+ */
+
+/* Enable the persistent cache of platform and device information. */
+CCL_EXPORT
+cl_bool ccl_info_cache_enable(const char * dir, CCLErr ** err);
+
+/* Disable the persistent cache of platform and device information. */
+CCL_EXPORT
+void ccl_info_cache_disable(void);
+
+/** @} */
+
+#endif
@@ -81,9 +81,11 @@ CCLArg * ccl_arg_new(void * value, size_t size) {
     /* Make sure size is > 0. */
     g_return_val_if_fail(size > 0, NULL);
 
-    CCLArg * arg = g_slice_new(CCLArg);
+    /* Argument and its value are kept in a single allocation. */
+    CCLArg * arg = g_slice_alloc(sizeof(CCLArg) + (value ? size : 0));
 
-    arg->cl_object = g_memdup((const void *) value, (guint) size);
+    arg->class = CCL_NONE;
+    arg->cl_object = value ? memcpy(arg + 1, value, size) : NULL;
     arg->info = (void *) &arg_local_marker;
     arg->ref_count = (gint) size;
 
@@ -104,8 +106,8 @@ void ccl_arg_destroy(CCLArg * arg) {
     g_return_if_fail(arg != NULL);
 
     if ccl_arg_is_local(arg) {
-        g_free(arg->cl_object);
-        g_slice_free(CCLArg, arg);
+        g_slice_free1(sizeof(CCLArg)
+            + (arg->cl_object ? (size_t) arg->ref_count : 0), arg);
     }
 }
 
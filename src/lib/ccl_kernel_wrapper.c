@@ -28,8 +28,141 @@
 #include "ccl_kernel_wrapper.h"
 #include "ccl_program_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_queue_wrapper.h"
+#include "_ccl_tuning_db.h"
 #include "_ccl_defs.h"
 
+/**
+ * Memory object set as a kernel argument, kept for hazard tracking.
+ * */
+struct ccl_kernel_mem_arg {
+
+    /**
+     * Argument index.
+     * @private
+     * */
+    cl_uint index;
+
+    /**
+     * OpenCL memory object.
+     * @private
+     * */
+    cl_mem mem;
+
+    /**
+     * Does the kernel (possibly) write to the argument? -1 if not yet
+     * determined.
+     * @private
+     * */
+    cl_int write;
+
+};
+
+/**
+ * Number of timed kernel executions for each candidate local work size in
+ * ::ccl_kernel_autotune_worksizes().
+ * */
+#define CCL_KERNEL_AUTOTUNE_RUNS 3
+
+/**
+ * Size in bytes of argument values which are kept inline in the argument
+ * table of a kernel.
+ * */
+#define CCL_KERNEL_ARG_INLINE_SIZE 16
+
+/**
+ * Slot of the argument table of a kernel. Keeps the argument waiting to be
+ * passed to the OpenCL kernel, and a shadow copy of the argument last
+ * passed to the OpenCL kernel with clSetKernelArg().
+ * */
+struct ccl_kernel_arg_slot {
+
+    /**
+     * Argument set with ::ccl_kernel_set_arg() and not yet passed to the
+     * OpenCL kernel, or `NULL`.
+     * @private
+     * */
+    CCLArg * pending;
+
+    /**
+     * Is the shadow copy valid?
+     * @private
+     * */
+    cl_bool known;
+
+    /**
+     * Was the last argument passed with a value (i.e. was it not a local
+     * memory or a `NULL` argument)?
+     * @private
+     * */
+    cl_bool has_value;
+
+    /**
+     * Size in bytes of the last argument passed to the OpenCL kernel.
+     * @private
+     * */
+    size_t size;
+
+    /**
+     * Shadow copy of small argument values.
+     * @private
+     * */
+    guint64 inline_value[CCL_KERNEL_ARG_INLINE_SIZE / sizeof(guint64)];
+
+    /**
+     * Shadow copy of argument values larger than
+     * ::CCL_KERNEL_ARG_INLINE_SIZE.
+     * @private
+     * */
+    void * heap_value;
+
+};
+
+/**
+ * Maximum number of suggested work sizes memoized for each kernel and
+ * device.
+ * */
+#define CCL_KERNEL_WS_MEMO_MAX 256
+
+/**
+ * Kernel and device limits which determine suggested work sizes, and
+ * work sizes already suggested for the kernel and device.
+ * */
+struct ccl_kernel_ws_limits {
+
+    /**
+     * Maximum number of work-item dimensions of device.
+     * @private
+     * */
+    cl_uint dev_dims;
+
+    /**
+     * Maximum number of work-items in each dimension of device.
+     * @private
+     * */
+    size_t * max_wi_sizes;
+
+    /**
+     * Maximum work-group size.
+     * @private
+     * */
+    size_t wg_size_max;
+
+    /**
+     * Preferred work-group size multiple.
+     * @private
+     * */
+    size_t wg_size_mult;
+
+    /**
+     * Memoized work sizes, or `NULL`.
+     * @private
+     * */
+    GHashTable * memo;
+
+};
+
 /**
  * Kernel wrapper class.
  *
@@ -44,11 +177,41 @@ struct ccl_kernel {
     CCLWrapper base;
 
     /**
-     * Kernel arguments.
+     * Argument table, with one slot per kernel argument.
+     * @private
+     * */
+    struct ccl_kernel_arg_slot * args;
+
+    /**
+     * Number of slots in argument table.
+     * @private
+     * */
+    cl_uint num_args;
+
+    /**
+     * Number of arguments waiting to be passed to the OpenCL kernel.
+     * @private
+     * */
+    cl_uint num_pending;
+
+    /**
+     * OpenCL version of the associated platform, or 0 if not yet
+     * determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
+
+    /**
+     * Memory objects set as kernel arguments, for hazard tracking.
      * @private
      * */
-    GHashTable * args;
+    GArray * mem_args;
 
+    /**
+     * Kernel and device limits for suggesting work sizes, keyed by device.
+     * @private
+     * */
+    GHashTable * ws_limits;
 };
 
 /**
@@ -67,170 +230,570 @@ static void ccl_kernel_release_fields(CCLKernel * krnl) {
     g_return_if_fail(krnl != NULL);
 
     /* Free kernel arguments. */
-    if (krnl->args != NULL)
-        g_hash_table_destroy(krnl->args);
+    for (cl_uint i = 0; i < krnl->num_args; ++i) {
+        if (krnl->args[i].pending != NULL)
+            ccl_arg_destroy(krnl->args[i].pending);
+        g_free(krnl->args[i].heap_value);
+    }
+    g_free(krnl->args);
 
-}
+    /* Free memory object arguments. */
+    if (krnl->mem_args != NULL)
+        g_array_free(krnl->mem_args, TRUE);
 
-/**
- * @addtogroup CCL_KERNEL_WRAPPER
- * @{
- */
+    /* Free limits and memoized work sizes. */
+    if (krnl->ws_limits != NULL)
+        g_hash_table_destroy(krnl->ws_limits);
+
+}
 
 /**
- * Get the kernel wrapper for the given OpenCL kernel.
- *
- * If the wrapper doesn't exist, its created with a reference count
- * of 1. Otherwise, the existing wrapper is returned and its reference
- * count is incremented by 1.
+ * @internal
  *
- * This function will rarely be called from client code, except when
- * clients wish to create the OpenCL kernel directly (using the
- * clCreateKernel() function) and then wrap the OpenCL kernel in a
- * ::CCLKernel wrapper object.
+ * @brief Keep track of the memory object set as a kernel argument, or
+ * forget the memory object previously set as the argument if the new
+ * argument is not a memory object.
  *
- * @public @memberof ccl_kernel
+ * @private @memberof ccl_kernel
  *
- * @param[in] kernel The OpenCL kernel to be wrapped.
- * @return The ::CCLKernel wrapper for the given OpenCL kernel.
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg The new argument.
  * */
-CCL_EXPORT
-CCLKernel * ccl_kernel_new_wrap(cl_kernel kernel) {
+static void ccl_kernel_update_mem_arg(
+    CCLKernel * krnl, cl_uint arg_index, CCLArg * arg) {
 
-    return (CCLKernel *) ccl_wrapper_new(
-        CCL_KERNEL, (void *) kernel, sizeof(CCLKernel));
+    cl_bool is_mem = (arg->class == CCL_BUFFER) || (arg->class == CCL_IMAGE);
+    struct ccl_kernel_mem_arg * ma = NULL;
+    guint i;
+
+    if (krnl->mem_args == NULL) {
+        if (!is_mem) return;
+        krnl->mem_args = g_array_new(
+            FALSE, FALSE, sizeof(struct ccl_kernel_mem_arg));
+    }
+
+    /* Find argument. */
+    for (i = 0; i < krnl->mem_args->len; ++i) {
+        ma = &g_array_index(krnl->mem_args, struct ccl_kernel_mem_arg, i);
+        if (ma->index == arg_index) break;
+    }
 
+    if (i == krnl->mem_args->len) {
+        /* Argument not yet known, add it if it's a memory object. */
+        if (is_mem) {
+            struct ccl_kernel_mem_arg new_ma =
+                { arg_index, (cl_mem) arg->cl_object, -1 };
+            g_array_append_val(krnl->mem_args, new_ma);
+        }
+    } else if (is_mem) {
+        /* Replace memory object, the argument access stays the same. */
+        ma->mem = (cl_mem) arg->cl_object;
+    } else {
+        /* Argument is no longer a memory object. */
+        g_array_remove_index_fast(krnl->mem_args, i);
+    }
 }
 
 /**
- * Create a new kernel wrapper object.
+ * @internal
  *
- * @public @memberof ccl_kernel
+ * @brief Determine if a kernel may write to a memory object argument.
  *
- * @param[in] prg A program wrapper object.
- * @param[in] kernel_name The kernel name.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return A new kernel wrapper object.
+ * Arguments declared `__constant`, `const` or `read_only` are read-only.
+ * If kernel argument information is not available (OpenCL < 1.2, or
+ * programs built without the `-cl-kernel-arg-info` option), arguments are
+ * assumed to be written to.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @return `CL_TRUE` if the kernel may write to the argument, `CL_FALSE`
+ * otherwise.
  * */
-CCL_EXPORT
-CCLKernel * ccl_kernel_new(
-    CCLProgram * prg, const char * kernel_name, CCLErr ** err) {
-
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
-
-    /* Make sure prg is not NULL. */
-    g_return_val_if_fail(prg != NULL, NULL);
-
-    /* Make sure kernel_name is not NULL. */
-    g_return_val_if_fail(kernel_name != NULL, NULL);
+static cl_bool ccl_kernel_arg_is_written(CCLKernel * krnl, cl_uint arg_index) {
 
-    /* Kernel wrapper object. */
-    CCLKernel * krnl = NULL;
+    cl_bool write = CL_TRUE;
 
-    /* OpenCL return status. */
-    cl_int ocl_status;
+#ifdef CL_VERSION_1_2
 
-    /* The OpenCL kernel object. */
-    cl_kernel kernel = NULL;
+    CCLErr * err_internal = NULL;
+    cl_kernel_arg_address_qualifier addr;
+    cl_kernel_arg_access_qualifier access;
+    cl_kernel_arg_type_qualifier type;
+
+    /* Get kernel argument qualifiers. */
+    addr = ccl_kernel_get_arg_info_scalar(krnl, arg_index,
+        CL_KERNEL_ARG_ADDRESS_QUALIFIER, cl_kernel_arg_address_qualifier,
+        &err_internal);
+    if (err_internal != NULL) goto finish;
+    access = ccl_kernel_get_arg_info_scalar(krnl, arg_index,
+        CL_KERNEL_ARG_ACCESS_QUALIFIER, cl_kernel_arg_access_qualifier,
+        &err_internal);
+    if (err_internal != NULL) goto finish;
+    type = ccl_kernel_get_arg_info_scalar(krnl, arg_index,
+        CL_KERNEL_ARG_TYPE_QUALIFIER, cl_kernel_arg_type_qualifier,
+        &err_internal);
+    if (err_internal != NULL) goto finish;
+
+    write = !((addr == CL_KERNEL_ARG_ADDRESS_CONSTANT)
+        || (access == CL_KERNEL_ARG_ACCESS_READ_ONLY)
+        || (type & CL_KERNEL_ARG_TYPE_CONST));
 
-    /* Create kernel. */
-    kernel = clCreateKernel(ccl_program_unwrap(prg),
-        kernel_name, &ocl_status);
-    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
-        CL_SUCCESS != ocl_status, ocl_status, error_handler,
-        "%s: unable to create kernel (OpenCL error %d: %s).",
-        CCL_STRD, ocl_status, ccl_err(ocl_status));
+finish:
 
-    /* Create kernel wrapper. */
-    krnl = ccl_kernel_new_wrap(kernel);
+    /* Information unavailable, assume argument is written to. */
+    g_clear_error(&err_internal);
 
-    /* If we got here, everything is OK. */
-    g_assert(err == NULL || *err == NULL);
-    goto finish;
+#else
 
-error_handler:
+    CCL_UNUSED(krnl);
+    CCL_UNUSED(arg_index);
 
-    /* If we got here there was an error, verify that it is so. */
-    g_assert(err == NULL || *err != NULL);
+#endif
 
-    krnl = NULL;
+    return write;
+}
 
-finish:
+/**
+ * @internal
+ *
+ * @brief Get the number of memory objects accessed by a kernel execution,
+ * for hazard tracking purposes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] cq Command queue where the kernel will be executed.
+ * @return Number of memory objects set as kernel arguments, or 0 if the
+ * command queue does not track hazards.
+ * */
+static cl_uint ccl_kernel_get_num_mem_accesses(
+    CCLKernel * krnl, CCLQueue * cq) {
 
-    /* Return kernel wrapper. */
-    return krnl;
+    return ((krnl->mem_args != NULL) && ccl_queue_has_hazard_tracking(cq))
+        ? krnl->mem_args->len
+        : 0;
 }
 
 /**
- * Decrements the reference count of the kernel wrapper object.
- * If it reaches 0, the kernel wrapper object is destroyed.
+ * @internal
  *
- * @public @memberof ccl_kernel
+ * @brief Get the accesses of a kernel execution to the memory objects set
+ * as kernel arguments.
  *
- * @param[in] krnl The kernel wrapper object.
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[out] acc Location where to put the accesses, with space for the
+ * number of accesses given by ccl_kernel_get_num_mem_accesses().
+ * @param[in] num_acc Number of accesses.
  * */
-CCL_EXPORT
-void ccl_kernel_destroy(CCLKernel * krnl) {
+static void ccl_kernel_get_mem_accesses(
+    CCLKernel * krnl, CCLQueueAccess * acc, cl_uint num_acc) {
 
-    ccl_wrapper_unref((CCLWrapper *) krnl, sizeof(CCLKernel),
-        (ccl_wrapper_release_fields) ccl_kernel_release_fields,
-        (ccl_wrapper_release_cl_object) clReleaseKernel, NULL);
+    for (cl_uint i = 0; i < num_acc; ++i) {
+
+        struct ccl_kernel_mem_arg * ma =
+            &g_array_index(krnl->mem_args, struct ccl_kernel_mem_arg, i);
+
+        /* Determine argument access if still unknown. */
+        if (ma->write < 0)
+            ma->write = ccl_kernel_arg_is_written(krnl, ma->index);
+
+        acc[i].mem = ma->mem;
+        acc[i].write = (cl_bool) ma->write;
+    }
 }
 
 /**
- * Set one kernel argument. The argument is not immediately set with the
- * clSetKernelArg() OpenCL function, but is instead kept in an argument
- * table for this kernel. The clSetKernelArg() function is called only
- * before kernel execution for arguments which have not yet been set or
- * have not been updated meanwhile.
+ * @internal
  *
- * @warning This function is not thread-safe. For multi-threaded
- * access to the same kernel function, create multiple instances of
- * a kernel wrapper for the given kernel function with ccl_kernel_new(),
- * one for each thread.
+ * @brief Make sure the argument table of a kernel has a slot for the given
+ * argument index. The table is initially sized from the number of kernel
+ * arguments.
  *
- * @public @memberof ccl_kernel
+ * @private @memberof ccl_kernel
  *
  * @param[in] krnl A kernel wrapper object.
  * @param[in] arg_index Argument index.
- * @param[in] arg Argument to set. Arguments must be of type ::CCLArg*,
- * ::CCLBuffer*, ::CCLImage* or ::CCLSampler*.
  * */
-CCL_EXPORT
-void ccl_kernel_set_arg(CCLKernel * krnl, cl_uint arg_index, void * arg) {
+static void ccl_kernel_grow_args(CCLKernel * krnl, cl_uint arg_index) {
 
-    /* Make sure krnl is not NULL. */
-    g_return_if_fail(krnl != NULL);
+    cl_uint num_args = 0;
+
+    if (arg_index < krnl->num_args) return;
 
-    /* Initialize table of kernel arguments if necessary. */
+    /* Get number of kernel arguments the first time. */
     if (krnl->args == NULL) {
-        krnl->args = g_hash_table_new_full(g_direct_hash,
-            g_direct_equal, NULL, (GDestroyNotify) ccl_arg_destroy);
+        CCLErr * err_internal = NULL;
+        num_args = ccl_kernel_get_info_scalar(
+            krnl, CL_KERNEL_NUM_ARGS, cl_uint, &err_internal);
+        g_clear_error(&err_internal);
     }
 
-    /* Keep argument in table. */
-    g_hash_table_replace(krnl->args, GUINT_TO_POINTER(arg_index),
-        (gpointer) arg);
+    /* If information is unavailable or wrong, grow just enough. */
+    if (num_args <= arg_index) num_args = arg_index + 1;
+
+    krnl->args = g_renew(struct ccl_kernel_arg_slot, krnl->args, num_args);
+    memset(krnl->args + krnl->num_args, 0,
+        (num_args - krnl->num_args) * sizeof(struct ccl_kernel_arg_slot));
+    krnl->num_args = num_args;
 }
 
 /**
- * Set all kernel arguments. This function accepts a variable list of
- * arguments which must end with `NULL`. Internally, this method
- * sets each argument individually using the ::ccl_kernel_set_arg()
- * function.
+ * @internal
  *
- * If the ::ccl_arg_skip constant is passed in place of a specific
- * argument, that argument will not be set by this function call. Any
- * previously set argument continues to be valid.
+ * @brief Forget the argument last passed to the OpenCL kernel, so that
+ * the next argument set at the given index is always passed with
+ * clSetKernelArg(). Must be called when the argument is set directly
+ * with clSetKernelArg(), bypassing the argument table.
  *
- * The ::ccl_kernel_set_args_v() function performs the same operation
- * but accepts an array of kernel arguments instead.
+ * @private @memberof ccl_kernel
  *
- * @public @memberof ccl_kernel
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * */
+void ccl_kernel_forget_arg(CCLKernel * krnl, cl_uint arg_index) {
+
+    if (arg_index < krnl->num_args)
+        krnl->args[arg_index].known = CL_FALSE;
+}
+
+/**
+ * @internal
  *
- * @attention The variable argument list must end with `NULL`.
+ * @brief Pass an argument to the OpenCL kernel with clSetKernelArg(),
+ * unless it's equal to the argument last passed at the same index.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] size Argument size.
+ * @param[in] value Argument value, or `NULL` for local memory and `NULL`
+ * memory object arguments.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if argument was successfully set, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_pass_arg(CCLKernel * krnl, cl_uint arg_index,
+    size_t size, const void * value, CCLErr ** err) {
+
+    /* OpenCL status flag. */
+    cl_int ocl_status;
+
+    struct ccl_kernel_arg_slot * slot = &krnl->args[arg_index];
+    void * shadow = (size <= CCL_KERNEL_ARG_INLINE_SIZE)
+        ? (void *) slot->inline_value : slot->heap_value;
+
+    /* Nothing to do if the OpenCL kernel already holds the argument. */
+    if (slot->known && (slot->size == size)
+        && (slot->has_value == (value != NULL))
+        && ((value == NULL) || (memcmp(shadow, value, size) == 0)))
+        return CL_TRUE;
+
+    ocl_status = clSetKernelArg(
+        ccl_kernel_unwrap(krnl), arg_index, size, value);
+    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+        CL_SUCCESS != ocl_status, ocl_status, error_handler,
+        "%s: unable to set kernel arg %d (OpenCL error %d: %s).",
+        CCL_STRD, arg_index, ocl_status, ccl_err(ocl_status));
+
+    /* Keep shadow copy of the argument. */
+    if ((size > CCL_KERNEL_ARG_INLINE_SIZE) && (slot->size != size)) {
+        g_free(slot->heap_value);
+        slot->heap_value = g_malloc(size);
+        shadow = slot->heap_value;
+    }
+    if (value != NULL) memcpy(shadow, value, size);
+    slot->known = CL_TRUE;
+    slot->has_value = (value != NULL);
+    slot->size = size;
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    return CL_TRUE;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    return CL_FALSE;
+}
+
+/**
+ * @internal
+ *
+ * @brief Set the kernel arguments defined with ::ccl_kernel_set_arg() which
+ * were not yet passed to the OpenCL kernel.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if arguments were successfully set, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_set_pending_args(CCLKernel * krnl, CCLErr ** err) {
+
+    /* Internal error object. */
+    CCLErr * err_internal = NULL;
+
+    /* Set pending kernel arguments, skipping those which are equal to the
+     * arguments already held by the OpenCL kernel. */
+    for (cl_uint i = 0; krnl->num_pending > 0 && i < krnl->num_args; ++i) {
+
+        CCLArg * arg = krnl->args[i].pending;
+
+        if (arg == NULL) continue;
+
+        ccl_kernel_pass_arg(krnl, i, ccl_arg_size(arg), ccl_arg_value(arg),
+            &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        ccl_kernel_update_mem_arg(krnl, i, arg);
+        ccl_arg_destroy(arg);
+        krnl->args[i].pending = NULL;
+        krnl->num_pending--;
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    return CL_TRUE;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    return CL_FALSE;
+}
+
+/**
+ * @addtogroup CCL_KERNEL_WRAPPER
+ * @{
+ */
+
+/**
+ * Get the kernel wrapper for the given OpenCL kernel.
+ *
+ * If the wrapper doesn't exist, its created with a reference count
+ * of 1. Otherwise, the existing wrapper is returned and its reference
+ * count is incremented by 1.
+ *
+ * This function will rarely be called from client code, except when
+ * clients wish to create the OpenCL kernel directly (using the
+ * clCreateKernel() function) and then wrap the OpenCL kernel in a
+ * ::CCLKernel wrapper object.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] kernel The OpenCL kernel to be wrapped.
+ * @return The ::CCLKernel wrapper for the given OpenCL kernel.
+ * */
+CCL_EXPORT
+CCLKernel * ccl_kernel_new_wrap(cl_kernel kernel) {
+
+    return (CCLKernel *) ccl_wrapper_new(
+        CCL_KERNEL, (void *) kernel, sizeof(CCLKernel));
+
+}
+
+/**
+ * Create a new kernel wrapper object.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] prg A program wrapper object.
+ * @param[in] kernel_name The kernel name.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new kernel wrapper object.
+ * */
+CCL_EXPORT
+CCLKernel * ccl_kernel_new(
+    CCLProgram * prg, const char * kernel_name, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+
+    /* Make sure prg is not NULL. */
+    g_return_val_if_fail(prg != NULL, NULL);
+
+    /* Make sure kernel_name is not NULL. */
+    g_return_val_if_fail(kernel_name != NULL, NULL);
+
+    /* Kernel wrapper object. */
+    CCLKernel * krnl = NULL;
+
+    /* OpenCL return status. */
+    cl_int ocl_status;
+
+    /* The OpenCL kernel object. */
+    cl_kernel kernel = NULL;
+
+    /* Create kernel. */
+    kernel = clCreateKernel(ccl_program_unwrap(prg),
+        kernel_name, &ocl_status);
+    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+        CL_SUCCESS != ocl_status, ocl_status, error_handler,
+        "%s: unable to create kernel (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+    /* Create kernel wrapper. */
+    krnl = ccl_kernel_new_wrap(kernel);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+    krnl = NULL;
+
+finish:
+
+    /* Return kernel wrapper. */
+    return krnl;
+}
+
+/**
+ * Decrements the reference count of the kernel wrapper object.
+ * If it reaches 0, the kernel wrapper object is destroyed.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl The kernel wrapper object.
+ * */
+CCL_EXPORT
+void ccl_kernel_destroy(CCLKernel * krnl) {
+
+    ccl_wrapper_unref((CCLWrapper *) krnl, sizeof(CCLKernel),
+        (ccl_wrapper_release_fields) ccl_kernel_release_fields,
+        (ccl_wrapper_release_cl_object) clReleaseKernel, NULL);
+}
+
+/**
+ * Set one kernel argument. The argument is not immediately set with the
+ * clSetKernelArg() OpenCL function, but is instead kept in an argument
+ * table for this kernel. The clSetKernelArg() function is called only
+ * before kernel execution, and only for arguments which differ from the
+ * ones last passed to the OpenCL kernel. Setting an argument to the same
+ * value in consecutive kernel executions is therefore cheap.
+ *
+ * @warning This function is not thread-safe. For multi-threaded
+ * access to the same kernel function, create multiple instances of
+ * a kernel wrapper for the given kernel function with ccl_kernel_new(),
+ * one for each thread.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to set. Arguments must be of type ::CCLArg*,
+ * ::CCLBuffer*, ::CCLImage* or ::CCLSampler*.
+ * */
+CCL_EXPORT
+void ccl_kernel_set_arg(CCLKernel * krnl, cl_uint arg_index, void * arg) {
+
+    /* Make sure krnl is not NULL. */
+    g_return_if_fail(krnl != NULL);
+
+    /* Make sure the argument table has a slot for the argument. */
+    ccl_kernel_grow_args(krnl, arg_index);
+
+    /* Keep argument in table, replacing any argument still pending. A
+     * `NULL` argument only clears the slot, so it's not counted as
+     * pending. */
+    if (krnl->args[arg_index].pending != NULL) {
+        ccl_arg_destroy(krnl->args[arg_index].pending);
+        krnl->num_pending--;
+    }
+    if (arg != NULL)
+        krnl->num_pending++;
+    krnl->args[arg_index].pending = (CCLArg *) arg;
+}
+
+/**
+ * Immediately set one kernel argument from a value, without creating a
+ * ::CCLArg* object. As with arguments set with ::ccl_kernel_set_arg(),
+ * clSetKernelArg() is not called if the OpenCL kernel already holds the
+ * given value. An argument previously set at the same index with
+ * ::ccl_kernel_set_arg(), and not yet passed to the OpenCL kernel, is
+ * discarded.
+ *
+ * This function is meant for private (e.g. scalar or vector) arguments,
+ * local memory arguments and `NULL` memory object arguments, and is used
+ * by the launch functions generated by the `ccl_c` utility. Memory
+ * objects, images and samplers should be set with ::ccl_kernel_set_arg(),
+ * which does not allocate memory for wrapper objects.
+ *
+ * @warning This function is not thread-safe, in the same way as
+ * ::ccl_kernel_set_arg().
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] size Argument size in bytes.
+ * @param[in] value Argument value, or `NULL` for local memory arguments
+ * (with `size` bytes) and `NULL` memory object arguments.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if argument was successfully set, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_set_arg_value(CCLKernel * krnl, cl_uint arg_index,
+    size_t size, const void * value, CCLErr ** err) {
+
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, CL_FALSE);
+    /* Make sure size is > 0. */
+    g_return_val_if_fail(size > 0, CL_FALSE);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    /* Make sure the argument table has a slot for the argument. */
+    ccl_kernel_grow_args(krnl, arg_index);
+
+    /* Discard pending argument, if any. */
+    if (krnl->args[arg_index].pending != NULL) {
+        ccl_arg_destroy(krnl->args[arg_index].pending);
+        krnl->args[arg_index].pending = NULL;
+        krnl->num_pending--;
+    }
+
+    if (!ccl_kernel_pass_arg(krnl, arg_index, size, value, err))
+        return CL_FALSE;
+
+    /* The argument is not a memory object. */
+    ccl_kernel_update_mem_arg(krnl, arg_index, (CCLArg *) ccl_arg_skip);
+    return CL_TRUE;
+}
+
+/**
+ * Set all kernel arguments. This function accepts a variable list of
+ * arguments which must end with `NULL`. Internally, this method
+ * sets each argument individually using the ::ccl_kernel_set_arg()
+ * function.
+ *
+ * If the ::ccl_arg_skip constant is passed in place of a specific
+ * argument, that argument will not be set by this function call. Any
+ * previously set argument continues to be valid.
+ *
+ * The ::ccl_kernel_set_args_v() function performs the same operation
+ * but accepts an array of kernel arguments instead.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @attention The variable argument list must end with `NULL`.
  *
  * @warning This function is not thread-safe. For multi-threaded
  * access to the same kernel function, create multiple instances of
@@ -404,45 +967,54 @@ CCLEvent * ccl_kernel_enqueue_ndrange(CCLKernel * krnl, CCLQueue * cq,
     cl_int ocl_status;
 
     /* OpenCL event. */
-    cl_event event;
+    cl_event event = NULL;
     /* Event wrapper. */
-    CCLEvent * evt;
+    CCLEvent * evt = NULL;
 
-    /* Iterator for table of kernel arguments. */
-    GHashTableIter iter;
-    gpointer arg_index_ptr, arg_ptr;
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Accesses to memory objects, for hazard tracking. */
+    CCLQueueAccess * acc = NULL;
+    /* Number of accesses to memory objects. */
+    cl_uint num_acc;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
 
     /* Set pending kernel arguments. */
-    if (krnl->args != NULL) {
-        g_hash_table_iter_init(&iter, krnl->args);
-        while (g_hash_table_iter_next(&iter, &arg_index_ptr, &arg_ptr)) {
-            cl_uint arg_index = GPOINTER_TO_UINT(arg_index_ptr);
-            CCLArg * arg = (CCLArg *) arg_ptr;
-            ocl_status = clSetKernelArg(ccl_kernel_unwrap(krnl), arg_index,
-                ccl_arg_size(arg), ccl_arg_value(arg));
-            ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
-                CL_SUCCESS != ocl_status, ocl_status, error_handler,
-                "%s: unable to set kernel arg %d (OpenCL error %d: %s).",
-                CCL_STRD, arg_index, ocl_status, ccl_err(ocl_status));
-            g_hash_table_iter_remove(&iter);
-        }
-    }
+    ccl_kernel_set_pending_args(krnl, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    num_acc = ccl_kernel_get_num_mem_accesses(krnl, cq);
+    acc = g_newa(CCLQueueAccess, num_acc + 1);
+    ccl_kernel_get_mem_accesses(krnl, acc, num_acc);
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, num_acc);
 
     /* Run kernel. */
     ocl_status = clEnqueueNDRangeKernel(ccl_queue_unwrap(cq),
         ccl_kernel_unwrap(krnl), work_dim, global_work_offset,
         global_work_size, local_work_size,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue kernel (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, num_acc);
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -674,16 +1246,399 @@ finish:
 }
 
 /**
- * Enqueues a command to execute a native C/C++ function not compiled
- * using the OpenCL compiler. This function is a wrapper for the
- * clEnqueueNativeKernel() OpenCL function, the documentation of which
- * provides additional information.
+ * @internal
  *
- * @public @memberof ccl_kernel
+ * @brief Range of chunks still to be executed by one of the command
+ * queues of a multi-device NDRange.
+ * */
+struct ccl_kernel_multi_range {
+
+    /** Command queue which owns the range. */
+    CCLQueue * cq;
+    /** Index of next chunk to execute. */
+    size_t begin;
+    /** One past the index of the last chunk to execute. */
+    size_t end;
+    /** Number of chunks executed by the command queue. */
+    size_t done;
+
+};
+
+/**
+ * @internal
  *
- * @param[in] cq A command queue wrapper object.
- * @param[in] user_func A pointer to a host-callable user function.
- * @param[in] args A pointer to the args list that `user_func` should be
+ * @brief Data shared by the threads of a multi-device NDRange.
+ * */
+struct ccl_kernel_multi_data {
+
+    /** Kernel to execute. */
+    cl_kernel kernel;
+    /** Number of work dimensions. */
+    cl_uint work_dim;
+    /** Global work offset. */
+    const size_t * gwo;
+    /** Global work size. */
+    const size_t * gws;
+    /** Local work size. */
+    const size_t * lws;
+    /** Size of each chunk along dimension 0. */
+    size_t chunk_size;
+    /** Ranges of chunks, one per command queue. */
+    struct ccl_kernel_multi_range * ranges;
+    /** Number of command queues. */
+    cl_uint num_queues;
+    /** Protects the ranges of chunks and the error. */
+    GMutex mutex;
+    /** First error which occurred, if any. */
+    CCLErr * err;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief Argument of each thread of a multi-device NDRange.
+ * */
+struct ccl_kernel_multi_thread {
+
+    /** Shared data. */
+    struct ccl_kernel_multi_data * md;
+    /** Index of the command queue handled by the thread. */
+    cl_uint idx;
+
+};
+
+/**
+ * @internal
+ *
+ * @brief Get the next chunk to execute on a command queue. Chunks are taken
+ * from the front of the range owned by the queue. When it is empty, the
+ * back half of the largest remaining range of another queue is stolen.
+ *
+ * @param[in] md Data shared by the threads of a multi-device NDRange.
+ * @param[in] idx Index of command queue.
+ * @param[out] chunk Location where to put the index of the next chunk.
+ * @return `CL_TRUE` if a chunk was obtained, `CL_FALSE` if there are no
+ * more chunks to execute or if an error occurred in another thread.
+ * */
+static cl_bool ccl_kernel_multi_next_chunk(
+    struct ccl_kernel_multi_data * md, cl_uint idx, size_t * chunk) {
+
+    struct ccl_kernel_multi_range * own = &md->ranges[idx];
+    struct ccl_kernel_multi_range * victim = NULL;
+    cl_bool found = CL_FALSE;
+
+    g_mutex_lock(&md->mutex);
+
+    /* Stop if another thread failed. */
+    if (md->err != NULL) goto finish;
+
+    /* Steal work if own range is empty. */
+    if (own->begin == own->end) {
+        for (cl_uint i = 0; i < md->num_queues; ++i) {
+            struct ccl_kernel_multi_range * r = &md->ranges[i];
+            if ((r->end - r->begin)
+                > ((victim != NULL) ? (victim->end - victim->begin) : 0))
+                victim = r;
+        }
+        if (victim == NULL) goto finish;
+        own->begin = victim->end - (victim->end - victim->begin + 1) / 2;
+        own->end = victim->end;
+        victim->end = own->begin;
+    }
+
+    /* Take chunk from the front of own range. */
+    *chunk = own->begin++;
+    found = CL_TRUE;
+
+finish:
+
+    g_mutex_unlock(&md->mutex);
+    return found;
+}
+
+/**
+ * @internal
+ *
+ * @brief Execute chunks of a multi-device NDRange on one command queue,
+ * keeping at most two chunks in flight.
+ *
+ * @param[in] data A `struct ccl_kernel_multi_thread` object.
+ * @return Always `NULL`.
+ * */
+static gpointer ccl_kernel_multi_thread_run(gpointer data) {
+
+    struct ccl_kernel_multi_thread * mt =
+        (struct ccl_kernel_multi_thread *) data;
+    struct ccl_kernel_multi_data * md = mt->md;
+    struct ccl_kernel_multi_range * own = &md->ranges[mt->idx];
+    cl_command_queue queue = ccl_queue_unwrap(own->cq);
+    size_t gwo[3], gws[3];
+    size_t chunk;
+    cl_event prev = NULL, event = NULL;
+    cl_int ocl_status = CL_SUCCESS;
+    const char * what = NULL;
+
+    /* Dimensions other than 0 are the same for all chunks. */
+    for (cl_uint i = 1; i < md->work_dim; ++i) {
+        gwo[i] = (md->gwo != NULL) ? md->gwo[i] : 0;
+        gws[i] = md->gws[i];
+    }
+
+    while (ccl_kernel_multi_next_chunk(md, mt->idx, &chunk)) {
+
+        /* Determine offset and size of chunk along dimension 0. */
+        gwo[0] = ((md->gwo != NULL) ? md->gwo[0] : 0)
+            + chunk * md->chunk_size;
+        gws[0] = MIN(md->chunk_size, md->gws[0] - chunk * md->chunk_size);
+
+        /* Enqueue chunk and submit it to the device. */
+        ocl_status = clEnqueueNDRangeKernel(queue, md->kernel, md->work_dim,
+            gwo, gws, md->lws, 0, NULL, &event);
+        if (ocl_status != CL_SUCCESS) {
+            what = "enqueue kernel chunk";
+            break;
+        }
+        ocl_status = clFlush(queue);
+        if (ocl_status != CL_SUCCESS) {
+            what = "flush command queue";
+            break;
+        }
+        own->done++;
+
+        /* Wait for previous chunk while this one is in flight. */
+        if (prev != NULL) {
+            ocl_status = clWaitForEvents(1, &prev);
+            clReleaseEvent(prev);
+            prev = NULL;
+            if (ocl_status != CL_SUCCESS) {
+                what = "wait for kernel chunk";
+                break;
+            }
+        }
+        prev = event;
+        event = NULL;
+    }
+
+    /* Wait for last chunk. */
+    if (prev != NULL) {
+        cl_int wait_status = clWaitForEvents(1, &prev);
+        clReleaseEvent(prev);
+        if ((ocl_status == CL_SUCCESS) && (wait_status != CL_SUCCESS)) {
+            ocl_status = wait_status;
+            what = "wait for kernel chunk";
+        }
+    }
+    if (event != NULL) clReleaseEvent(event);
+
+    /* Keep the first error. */
+    if (ocl_status != CL_SUCCESS) {
+        g_mutex_lock(&md->mutex);
+        if (md->err == NULL) {
+            g_set_error(&md->err, CCL_OCL_ERROR, ocl_status,
+                "%s: unable to %s on queue %d (OpenCL error %d: %s).",
+                CCL_STRD, what, mt->idx, ocl_status, ccl_err(ocl_status));
+        }
+        g_mutex_unlock(&md->mutex);
+    }
+
+    return NULL;
+}
+
+/**
+ * Execute a kernel over an NDRange split across several command queues,
+ * typically one for each device (or sub-device) of a context.
+ *
+ * The NDRange is divided in chunks along dimension 0, each chunk being
+ * executed with the appropriate global work offset. Chunks are initially
+ * distributed evenly among the command queues, and each queue is fed by
+ * its own host thread, which keeps up to two chunks in flight. Queues which
+ * run out of chunks steal half of the remaining chunks of the busiest
+ * queue, so faster devices end up executing more chunks. This function
+ * blocks until all chunks complete.
+ *
+ * Since chunks are identified by their global work offset, kernels see the
+ * same global IDs as when the NDRange is executed on a single device, and
+ * can be used without changes. Memory objects are shared by all devices of
+ * the context; each chunk should only write to the region of the buffers
+ * which corresponds to its global IDs.
+ *
+ * Kernel arguments defined with ::ccl_kernel_set_arg() are set before the
+ * chunks are enqueued. The kernel must be built for the devices of all the
+ * given command queues. Chunk commands are not associated with event
+ * wrappers, so they are not visible to the profiler.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @note Requires OpenCL >= 1.1
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] queues Array of command queue wrapper objects, all associated
+ * with the same context.
+ * @param[in] num_queues Number of command queues in `queues`.
+ * @param[in] work_dim The number of dimensions used to specify the
+ * global work-items and work-items in the work-group.
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item.
+ * @param[in] global_work_size An array of `work_dim` unsigned values
+ * that describe the number of global work-items in `work_dim`
+ * dimensions that will execute the kernel function.
+ * @param[in] local_work_size An array of `work_dim` unsigned values
+ * that describe the number of work-items that make up a work-group that
+ * will execute the specified kernel. May be `NULL`.
+ * @param[in] chunk_size Number of work-items along dimension 0 in each
+ * chunk, which must be a multiple of `local_work_size[0]`, if the latter is
+ * given. If 0, a chunk size which yields about eight chunks per command
+ * queue is used.
+ * @param[out] chunks_done If not `NULL`, an array of `num_queues` elements
+ * where the number of chunks executed by each command queue is placed.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if all chunks were successfully executed, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_enqueue_ndrange_multi(CCLKernel * krnl,
+    CCLQueue * const * queues, cl_uint num_queues, cl_uint work_dim,
+    const size_t * global_work_offset, const size_t * global_work_size,
+    const size_t * local_work_size, size_t chunk_size, size_t * chunks_done,
+    CCLErr ** err) {
+
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, CL_FALSE);
+    /* Make sure there is at least one command queue. */
+    g_return_val_if_fail(queues != NULL && num_queues > 0, CL_FALSE);
+    /* Make sure work_dim is valid. */
+    g_return_val_if_fail(work_dim >= 1 && work_dim <= 3, CL_FALSE);
+    /* Make sure global_work_size is not NULL. */
+    g_return_val_if_fail(global_work_size != NULL, CL_FALSE);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    /* Data shared by threads. */
+    struct ccl_kernel_multi_data md;
+    /* Thread arguments and threads, one per command queue. */
+    struct ccl_kernel_multi_thread * mt = NULL;
+    GThread ** threads = NULL;
+    /* Total number of chunks. */
+    size_t num_chunks;
+    /* Work-group size along dimension 0. */
+    size_t lws0 = (local_work_size != NULL) ? local_work_size[0] : 1;
+    /* OpenCL version of the platform associated with the kernel. */
+    cl_uint ocl_ver;
+    /* Return status. */
+    cl_bool status;
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    md.ranges = NULL;
+    md.err = NULL;
+    g_mutex_init(&md.mutex);
+
+    /* Global work offsets, used to identify chunks, require
+     * OpenCL >= 1.1. */
+    ocl_ver = ccl_kernel_get_opencl_version(krnl, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    ccl_if_err_create_goto(*err, CCL_ERROR, ocl_ver < 110,
+        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
+        "%s: splitting an NDRange requires OpenCL version 1.1 or newer.",
+        CCL_STRD);
+
+    /* Determine chunk size if not given. */
+    if (chunk_size == 0) {
+        chunk_size = global_work_size[0] / (num_queues * 8);
+        chunk_size = MAX(lws0, chunk_size - chunk_size % lws0);
+    }
+    ccl_if_err_create_goto(*err, CCL_ERROR, chunk_size % lws0 != 0,
+        CCL_ERROR_ARGS, error_handler,
+        "%s: chunk size (%d) is not a multiple of the local work size (%d).",
+        CCL_STRD, (int) chunk_size, (int) lws0);
+
+    /* Set pending kernel arguments, once for all chunks. */
+    ccl_kernel_set_pending_args(krnl, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Distribute chunks evenly among command queues. */
+    num_chunks = (global_work_size[0] + chunk_size - 1) / chunk_size;
+    md.kernel = ccl_kernel_unwrap(krnl);
+    md.work_dim = work_dim;
+    md.gwo = global_work_offset;
+    md.gws = global_work_size;
+    md.lws = local_work_size;
+    md.chunk_size = chunk_size;
+    md.num_queues = num_queues;
+    md.ranges = g_new(struct ccl_kernel_multi_range, num_queues);
+    for (cl_uint i = 0; i < num_queues; ++i) {
+        md.ranges[i].cq = queues[i];
+        md.ranges[i].begin = num_chunks * i / num_queues;
+        md.ranges[i].end = num_chunks * (i + 1) / num_queues;
+        md.ranges[i].done = 0;
+    }
+
+    /* Feed each command queue in its own thread, except for the first
+     * queue, which is fed by the calling thread. */
+    mt = g_new(struct ccl_kernel_multi_thread, num_queues);
+    threads = g_new0(GThread *, num_queues);
+    for (cl_uint i = 0; i < num_queues; ++i) {
+        mt[i].md = &md;
+        mt[i].idx = i;
+        if (i > 0)
+            threads[i] = g_thread_new("ccl_ndrange_multi",
+                ccl_kernel_multi_thread_run, &mt[i]);
+    }
+    ccl_kernel_multi_thread_run(&mt[0]);
+
+    /* Wait for all threads to finish. */
+    for (cl_uint i = 1; i < num_queues; ++i)
+        g_thread_join(threads[i]);
+
+    /* Report number of chunks executed by each command queue. */
+    if (chunks_done != NULL)
+        for (cl_uint i = 0; i < num_queues; ++i)
+            chunks_done[i] = md.ranges[i].done;
+
+    /* Check if any of the threads failed. */
+    if (md.err != NULL) {
+        g_propagate_error(err, md.err);
+        md.err = NULL;
+        goto error_handler;
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    status = CL_FALSE;
+
+finish:
+
+    /* Release temporary data. */
+    g_free(md.ranges);
+    g_free(mt);
+    g_free(threads);
+    g_mutex_clear(&md.mutex);
+
+    return status;
+}
+
+/**
+ * Enqueues a command to execute a native C/C++ function not compiled
+ * using the OpenCL compiler. This function is a wrapper for the
+ * clEnqueueNativeKernel() OpenCL function, the documentation of which
+ * provides additional information.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] cq A command queue wrapper object.
+ * @param[in] user_func A pointer to a host-callable user function.
+ * @param[in] args A pointer to the args list that `user_func` should be
  * called with.
  * @param[in] cb_args The size in bytes of the args list that `args` points to.
  * @param[in] num_mos The number of ::CCLMemObj* objects that are passed
@@ -727,31 +1682,55 @@ CCLEvent * ccl_kernel_enqueue_native(CCLQueue * cq,
     CCLEvent * evt = NULL;
     /* List of cl_mem objects. */
     cl_mem * mem_list = NULL;
-
-    /* Unwrap memory objects. */
+    /* Accesses to memory objects, for hazard tracking. */
+    CCLQueueAccess * acc = g_newa(CCLQueueAccess, num_mos + 1);
+    /* Number of accesses to memory objects. */
+    cl_uint num_acc = 0;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
+
+    /* Unwrap memory objects. Native kernels are considered to write to
+     * all memory objects they receive. */
     if (num_mos > 0) {
         mem_list = g_slice_alloc(sizeof(cl_mem) * num_mos);
         for (cl_uint i = 0; i < num_mos; ++i) {
             mem_list[i] = mo_list[i] != NULL
                 ? ccl_memobj_unwrap(mo_list[i])
                 : NULL;
+            if (mem_list[i] != NULL) {
+                acc[num_acc].mem = mem_list[i];
+                acc[num_acc].write = CL_TRUE;
+                ++num_acc;
+            }
         }
     }
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, num_acc);
+
     /* Enqueue kernel. */
     ocl_status = clEnqueueNativeKernel(ccl_queue_unwrap(cq), user_func,
         args, cb_args, num_mos, (const cl_mem *) mem_list, args_mem_loc,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to enqueue native kernel (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, num_acc);
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -776,51 +1755,797 @@ finish:
 }
 
 /**
- * Get the OpenCL version of the platform associated with this kernel.
- * The version is returned as an integer, in the following format:
+ * Get the OpenCL version of the platform associated with this kernel.
+ * The version is returned as an integer, in the following format:
+ *
+ * * 100 for OpenCL 1.0
+ * * 110 for OpenCL 1.1
+ * * 120 for OpenCL 1.2
+ * * 200 for OpenCL 2.0
+ * * 210 for OpenCL 2.1
+ * * etc.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The OpenCL version of the platform associated with this
+ * kernel as an integer. If an error occurs, 0 is returned.
+ * */
+CCL_EXPORT
+cl_uint ccl_kernel_get_opencl_version(CCLKernel * krnl, CCLErr ** err) {
+
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, 0);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, 0);
+
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&krnl->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&krnl->ocl_ver);
+
+    cl_context context;
+    CCLContext * ctx = NULL;
+    CCLErr * err_internal = NULL;
+    cl_uint ocl_ver;
+
+    /* Get cl_context object for this kernel. */
+    context = ccl_kernel_get_info_scalar(
+        krnl, CL_KERNEL_CONTEXT, cl_context, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Get context wrapper. */
+    ctx = ccl_context_new_wrap(context);
+
+    /* Get OpenCL version. */
+    ocl_ver = ccl_context_get_opencl_version(ctx, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Unref. the context wrapper. */
+    ccl_context_unref(ctx);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    ocl_ver = 0;
+
+finish:
+
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ocl_ver > 0)
+        g_atomic_int_set(&krnl->ocl_ver, (gint) ocl_ver);
+
+    /* Return OpenCL version, cached above unless an error occurred. */
+    return ocl_ver;
+}
+
+/**
+ * @internal
+ *
+ * @brief Helper macro which tests if the error is a
+ * `CCL_ERROR_INFO_UNAVAILABLE_OCL` error, and if so, generates a warning and
+ * clears the error. Otherwise it tests the error in the same way as
+ * ccl_if_err_propagate_goto().
+ *
+ * @param[out] err Destination CCLErr** object.
+ * @param[in] err_internal Source CCLErr* object.
+ * @param[in] error_handler Label to goto if an error other than
+ * `CCL_ERROR_INFO_UNAVAILABLE_OCL` is detected.
+ * */
+#define ccl_if_err_not_info_unavailable_propagate_goto( \
+            err, err_internal, error_handler) \
+    if (((err_internal) != NULL) && ((err_internal)->domain == CCL_ERROR) && \
+            ((err_internal)->code == CCL_ERROR_INFO_UNAVAILABLE_OCL)) { \
+        g_warning("In %s: %s", CCL_STRD, (err_internal)->message); \
+        ccl_err_clear(&(err_internal)); \
+    } else { \
+        ccl_if_err_propagate_goto(err, err_internal, error_handler); \
+    }
+
+/**
+ * @internal
+ *
+ * @brief Protects the tables of kernel and device limits and of memoized
+ * work sizes of all kernels. The lock is only held while looking up or
+ * inserting table entries, never across OpenCL queries, and the limits
+ * themselves are not changed once inserted.
+ * */
+static GMutex ws_mutex;
+
+/**
+ * @internal
+ *
+ * @brief Destroy kernel and device limits which determine suggested work
+ * sizes, together with the memoized work sizes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] limits Kernel and device limits.
+ * */
+static void ccl_kernel_ws_limits_destroy(gpointer limits) {
+
+    struct ccl_kernel_ws_limits * wsl =
+        (struct ccl_kernel_ws_limits *) limits;
+
+    g_free(wsl->max_wi_sizes);
+    if (wsl->memo != NULL) g_hash_table_destroy(wsl->memo);
+    g_slice_free(struct ccl_kernel_ws_limits, wsl);
+}
+
+/**
+ * @internal
+ *
+ * @brief Hash function for keys of memoized work sizes.
+ *
+ * Keys are arrays of `size_t` with the number of dimensions, a flag
+ * indicating if a global work size was requested, the real work size and
+ * the maximum local work size given by client code.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] key Key of memoized work sizes.
+ * @return Hash value of key.
+ * */
+static guint ccl_kernel_ws_key_hash(gconstpointer key) {
+
+    const size_t * k = (const size_t *) key;
+    guint hash = 5381;
+
+    for (size_t i = 0; i < 2 + 2 * k[0]; ++i)
+        hash = hash * 33
+            + (guint) (((guint64) k[i]) ^ (((guint64) k[i]) >> 32));
+    return hash;
+}
+
+/**
+ * @internal
+ *
+ * @brief Equality function for keys of memoized work sizes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] a Key of memoized work sizes.
+ * @param[in] b Key of memoized work sizes.
+ * @return `TRUE` if keys are equal, `FALSE` otherwise.
+ * */
+static gboolean ccl_kernel_ws_key_equal(gconstpointer a, gconstpointer b) {
+
+    const size_t * ka = (const size_t *) a;
+    const size_t * kb = (const size_t *) b;
+
+    return (ka[0] == kb[0])
+        && (memcmp(ka, kb, (2 + 2 * ka[0]) * sizeof(size_t)) == 0);
+}
+
+/**
+ * @internal
+ *
+ * @brief Determine the kernel and device limits which determine suggested
+ * work sizes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object, or `NULL` to use only device
+ * limits.
+ * @param[in] dev Device wrapper object.
+ * @param[out] limits Location where to place kernel and device limits.
+ * Device maximum work-item sizes should be freed with g_free().
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE` otherwise.
+ * */
+static cl_bool ccl_kernel_get_ws_limits(CCLKernel * krnl, CCLDevice * dev,
+    struct ccl_kernel_ws_limits * limits, CCLErr ** err) {
+
+    const size_t * dev_max_wi_sizes;
+    cl_bool ret_status;
+
+    /* Error handling object. */
+    CCLErr * err_internal = NULL;
+
+    limits->wg_size_max = 0;
+    limits->wg_size_mult = 0;
+    limits->max_wi_sizes = NULL;
+    limits->memo = NULL;
+
+    /* Get number of dimensions supported by device. */
+    limits->dev_dims = ccl_device_get_info_scalar(
+        dev, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, cl_uint, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Get max. work item sizes for device. The device value is cached, so
+     * a copy is kept. */
+    dev_max_wi_sizes = ccl_device_get_info_array(
+        dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    limits->max_wi_sizes = g_memdup(
+        dev_max_wi_sizes, limits->dev_dims * sizeof(size_t));
+
+    /* If kernel is not NULL, query it about workgroup size preferences
+     * and capabilities. */
+    if (krnl != NULL) {
+
+        /* Determine maximum workgroup size. */
+        limits->wg_size_max = ccl_kernel_get_workgroup_info_scalar(krnl, dev,
+            CL_KERNEL_WORK_GROUP_SIZE, size_t, &err_internal);
+        ccl_if_err_not_info_unavailable_propagate_goto(
+            err, err_internal, error_handler);
+
+#ifdef CL_VERSION_1_1
+
+        /* Determine preferred workgroup size multiple (OpenCL >= 1.1). */
+
+        /* Get OpenCL version of the underlying platform. */
+        cl_uint ocl_ver = ccl_kernel_get_opencl_version(krnl, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        /* If OpenCL version of the underlying platform is >= 1.1 ... */
+        if (ocl_ver >= 110) {
+
+            /* ...use CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE... */
+            limits->wg_size_mult = ccl_kernel_get_workgroup_info_scalar(
+                krnl, dev, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                size_t, &err_internal);
+            ccl_if_err_not_info_unavailable_propagate_goto(
+                err, err_internal, error_handler);
+
+        } else {
+
+            /* ...otherwise just use CL_KERNEL_WORK_GROUP_SIZE. */
+            limits->wg_size_mult = limits->wg_size_max;
+
+        }
+
+#else
+
+        limits->wg_size_mult = limits->wg_size_max;
+
+#endif
+
+    }
+
+    /* If it was not possible to obtain wg_size_mult and wg_size_max, either
+     * because kernel is NULL or the information was unavailable, use values
+     * obtained from device. */
+    if ((limits->wg_size_max == 0) && (limits->wg_size_mult == 0)) {
+        limits->wg_size_max = ccl_device_get_info_scalar(
+            dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        limits->wg_size_mult = limits->wg_size_max;
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    ret_status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    g_free(limits->max_wi_sizes);
+    limits->max_wi_sizes = NULL;
+    ret_status = CL_FALSE;
+
+finish:
+
+    /* Return status. */
+    return ret_status;
+}
+
+/**
+ * @internal
+ *
+ * @brief Find the largest divisor of `n` which is not larger than `bound`.
+ *
+ * Divisors are searched in pairs, `i` and `n / i`, with `i` going up to
+ * the square root of `n` or to `bound`, whichever is smaller.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] n Number to find divisor of.
+ * @param[in] bound Maximum value of divisor.
+ * @return The largest divisor of `n` not larger than `bound`, or 1 if
+ * there is none.
+ * */
+static size_t ccl_kernel_largest_divisor(size_t n, size_t bound) {
+
+    size_t best = 1;
+
+    for (size_t i = 1; (i <= bound) && (i <= n / i); ++i) {
+        if (n % i != 0) continue;
+        /* Large divisors decrease as i increases, so the first one within
+         * bound is the largest divisor within bound. */
+        if (n / i <= bound) return n / i;
+        best = i;
+    }
+    return best;
+}
+
+/**
+ * @internal
+ *
+ * @brief Determine suggested work sizes from kernel and device limits. See
+ * ::ccl_kernel_suggest_worksizes() for the meaning of parameters.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] limits Kernel and device limits.
+ * @param[in] dims The number of dimensions.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place global worksize, or `NULL`.
+ * @param[in,out] lws Maximum local work sizes as input, suggested local
+ * work size as output.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE` otherwise.
+ * */
+static cl_bool ccl_kernel_compute_worksizes(
+    const struct ccl_kernel_ws_limits * limits, cl_uint dims,
+    const size_t * real_worksize, size_t * gws, size_t * lws,
+    CCLErr ** err) {
+
+    size_t wg_size_mult = limits->wg_size_mult;
+    size_t wg_size_max = limits->wg_size_max;
+    size_t wg_size = 1, wg_size_aux;
+    size_t * max_wi_sizes;
+    cl_bool ret_status;
+    size_t real_ws = 1;
+
+    /* For each dimension, if the user specified a maximum local work
+     * size, the effective maximum local work size will be the minimum
+     * between the user value and the device value. */
+    max_wi_sizes = g_newa(size_t, dims);
+    for (cl_uint i = 0; i < dims; ++i) {
+        max_wi_sizes[i] = (lws[i] != 0)
+            ? MIN(limits->max_wi_sizes[i], lws[i])
+            : limits->max_wi_sizes[i];
+    }
+
+    /* Try to find an appropriate local worksize. */
+    for (cl_uint i = 0; i < dims; ++i) {
+
+        /* Each lws component is at most the preferred workgroup
+         * multiple or the maximum size of that component in device. */
+        lws[i] = MIN(wg_size_mult, max_wi_sizes[i]);
+
+        /* Update total workgroup size. */
+        wg_size *= lws[i];
+
+        /* Update total real worksize. */
+        real_ws *= real_worksize[i];
+
+    }
+
+    /* Don't let each component of the local worksize to be
+     * higher than the respective component of the real
+     * worksize. */
+    for (cl_uint i = 0; i < dims; ++i) {
+        while (lws[i] > real_worksize[i]) {
+            lws[i] /= 2;
+            wg_size /= 2;
+        }
+    }
+
+    /* The total workgroup size can't be higher than the maximum
+     * supported by the device. */
+    while (wg_size > wg_size_max) {
+        wg_size_aux = wg_size;
+        for (int i = dims - 1; i >= 0; --i) {
+            if (lws[i] > 1) {
+                /* Local work size can't be smaller than 1. */
+                lws[i] /= 2;
+                wg_size /= 2;
+            }
+            if (wg_size <= wg_size_max) break;
+        }
+        /* Avoid infinite loops and throw error if wg_size didn't
+         * change. */
+        ccl_if_err_create_goto(*err, CCL_ERROR, wg_size == wg_size_aux,
+            CCL_ERROR_OTHER, error_handler,
+            "%s: Unable to determine a work size within the device limit (%d).",
+            CCL_STRD, (int) wg_size_max);
+    }
+
+    /* If output variable gws is not NULL... */
+    if (gws != NULL) {
+        /* ...find a global worksize which is a multiple of the local
+         * worksize and is big enough to handle the real worksize. */
+        for (cl_uint i = 0; i < dims; ++i) {
+            gws[i] = ((real_worksize[i] / lws[i])
+                + (((real_worksize[i] % lws[i]) > 0) ? 1 : 0))
+                * lws[i];
+        }
+    } else {
+        /* ...otherwise check if found local worksizes are divisors of
+         * the respective real_worksize. If so keep them, otherwise find
+         * local worksizes which respect the maximum sizes allowed by
+         * the kernel and the device, and is a dimension-wise divisor of
+         * the real_worksize. */
+        cl_bool lws_are_divisors = CL_TRUE;
+        for (cl_uint i = 0; i < dims; ++i) {
+            /* Check if lws[i] is divisor of real_worksize[i]. */
+            if (real_worksize[i] % lws[i] != 0) {
+                /* Ops... lws[i] is not divisor of real_worksize[i], so
+                 * we'll have to try and find new lws ahead. */
+                lws_are_divisors = CL_FALSE;
+                break;
+            }
+        }
+        /* Is lws divisor of real_worksize, dimension-wise? */
+        if (!lws_are_divisors) {
+            /* No, so we'll have to find new lws. */
+            wg_size = 1;
+            for (cl_uint i = 0; i < dims; ++i) {
+
+                /* For each dimension, try to use the previously
+                 * found lws[i]. */
+                if ((real_worksize[i] % lws[i] != 0)
+                    || (lws[i] * wg_size > wg_size_max))
+                {
+                    /* Previously found lws[i] not usable, find
+                     * new one. Must be a divisor of real_worksize[i]
+                     * and respect the kernel and device maximum lws,
+                     * and, as before, not be larger than half of
+                     * real_worksize[i]. */
+                    lws[i] = ccl_kernel_largest_divisor(real_worksize[i],
+                        MIN(real_worksize[i] / 2,
+                            MIN(max_wi_sizes[i], wg_size_max / wg_size)));
+                }
+                /* Update absolute workgroup size (all dimensions). */
+                wg_size *= lws[i];
+            }
+        }
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    ret_status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    ret_status = CL_FALSE;
+
+finish:
+
+    /* Return status. */
+    return ret_status;
+}
+
+/**
+ * Suggest appropriate local (and optionally global) work sizes for the
+ * given real work size, based on device and kernel characteristics.
+ *
+ * If the `gws` parameter is not `NULL`, it will be populated with a
+ * global worksize which may be larger than the real work size
+ * in order to better fit the kernel preferred multiple work size. As
+ * such, kernels enqueued with global work sizes suggested by this
+ * function should check if their global ID is within `real_worksize`.
+ *
+ * Kernel and device limits are determined once for each kernel and
+ * device, and suggested work sizes are memoized for each combination of
+ * real work size and maximum local work size, so repeated calls for the
+ * same kernel, device and work sizes are cheap. Memoization is not
+ * performed if `krnl` is `NULL`.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object. If `NULL`, use only device
+ * information for determining global and local worksizes.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims The number of dimensions used to specify the global
+ * work-items and work-items in the work-group.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place a "nice" global worksize for
+ * the given kernel and device, which must be equal or larger than the `
+ * real_worksize` and a multiple of `lws`. This memory location should
+ * be pre-allocated with space for `dims` values of size `size_t`. If
+ * `NULL` it is assumed that the global worksize must be equal to
+ * `real_worksize`.
+ * @param[in,out] lws This memory location, of size `dims * sizeof(size_t)`,
+ * serves a dual purpose: 1) as an input, containing the maximum allowed local
+ * work size for each dimension, or zeros if these maximums are to be fetched
+ * from the given device `CL_DEVICE_MAX_WORK_ITEM_SIZES` information (if the
+ * specified values are larger than the device limits, the device limits are
+ * used instead); 2) as an output, where to place a "nice" local worksize,
+ * which is based and respects the limits of the given kernel and device (and
+ * of the non-zero values given as input).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_suggest_worksizes(CCLKernel * krnl, CCLDevice * dev,
+    cl_uint dims, const size_t * real_worksize, size_t * gws, size_t * lws,
+    CCLErr ** err) {
+
+    /* Make sure dev is not NULL. */
+    g_return_val_if_fail(dev != NULL, CL_FALSE);
+    /* Make sure dims not zero. */
+    g_return_val_if_fail(dims > 0, CL_FALSE);
+    /* Make sure real_worksize is not NULL. */
+    g_return_val_if_fail(real_worksize != NULL, CL_FALSE);
+    /* Make sure lws is not NULL. */
+    g_return_val_if_fail(lws != NULL, CL_FALSE);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    /* Kernel and device limits. */
+    struct ccl_kernel_ws_limits dev_limits = { 0, NULL, 0, 0, NULL };
+    struct ccl_kernel_ws_limits * limits = NULL;
+    /* Key and value of memoized work sizes. */
+    size_t * key = NULL;
+    size_t * memo_ws;
+    cl_bool ret_status;
+
+    /* Error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Look for previously determined kernel and device limits. */
+    if (krnl != NULL) {
+        g_mutex_lock(&ws_mutex);
+        if (krnl->ws_limits != NULL) {
+            limits = g_hash_table_lookup(
+                krnl->ws_limits, ccl_device_unwrap(dev));
+        }
+        g_mutex_unlock(&ws_mutex);
+    }
+
+    /* Determine kernel and device limits if not yet known. The OpenCL
+     * queries are performed without holding the lock, so the limits are
+     * only kept if another thread did not keep them in the meantime. */
+    if (limits == NULL) {
+        ccl_kernel_get_ws_limits(krnl, dev, &dev_limits, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        if (krnl != NULL) {
+            g_mutex_lock(&ws_mutex);
+            if (krnl->ws_limits == NULL) {
+                krnl->ws_limits = g_hash_table_new_full(g_direct_hash,
+                    g_direct_equal, NULL, ccl_kernel_ws_limits_destroy);
+            }
+            limits = g_hash_table_lookup(
+                krnl->ws_limits, ccl_device_unwrap(dev));
+            if (limits == NULL) {
+                limits = g_slice_dup(
+                    struct ccl_kernel_ws_limits, &dev_limits);
+                dev_limits.max_wi_sizes = NULL;
+                g_hash_table_insert(
+                    krnl->ws_limits, ccl_device_unwrap(dev), limits);
+            }
+            g_mutex_unlock(&ws_mutex);
+        } else {
+            limits = &dev_limits;
+        }
+    }
+
+    /* Check if device supports the requested dims. */
+    ccl_if_err_create_goto(*err, CCL_ERROR, dims > limits->dev_dims,
+        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
+        "%s: device only supports a maximum of %d dimension(s), "
+        "but %d were requested.",
+        CCL_STRD, limits->dev_dims, dims);
+
+    /* Use memoized work sizes, if any. The lookup key lives on the stack,
+     * and is only copied to the heap if the work sizes are memoized. */
+    if (krnl != NULL) {
+        key = g_newa(size_t, 2 + 2 * dims);
+        key[0] = dims;
+        key[1] = (gws != NULL);
+        memcpy(key + 2, real_worksize, dims * sizeof(size_t));
+        memcpy(key + 2 + dims, lws, dims * sizeof(size_t));
+        g_mutex_lock(&ws_mutex);
+        memo_ws = (limits->memo != NULL)
+            ? g_hash_table_lookup(limits->memo, key) : NULL;
+        if (memo_ws != NULL) {
+            memcpy(lws, memo_ws, dims * sizeof(size_t));
+            if (gws != NULL)
+                memcpy(gws, memo_ws + dims, dims * sizeof(size_t));
+        }
+        g_mutex_unlock(&ws_mutex);
+        if (memo_ws != NULL) goto success;
+    }
+
+    /* Determine work sizes. */
+    ccl_kernel_compute_worksizes(
+        limits, dims, real_worksize, gws, lws, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Memoize work sizes, discarding the previous ones if there are too
+     * many. */
+    if (krnl != NULL) {
+        memo_ws = g_new0(size_t, 2 * dims);
+        memcpy(memo_ws, lws, dims * sizeof(size_t));
+        if (gws != NULL)
+            memcpy(memo_ws + dims, gws, dims * sizeof(size_t));
+        g_mutex_lock(&ws_mutex);
+        if (limits->memo == NULL) {
+            limits->memo = g_hash_table_new_full(ccl_kernel_ws_key_hash,
+                ccl_kernel_ws_key_equal, g_free, g_free);
+        } else if (g_hash_table_size(limits->memo) >= CCL_KERNEL_WS_MEMO_MAX) {
+            g_hash_table_remove_all(limits->memo);
+        }
+        g_hash_table_insert(limits->memo,
+            g_memdup(key, (guint) ((2 + 2 * dims) * sizeof(size_t))),
+            memo_ws);
+        g_mutex_unlock(&ws_mutex);
+    }
+
+success:
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    ret_status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    ret_status = CL_FALSE;
+
+finish:
+
+    g_free(dev_limits.max_wi_sizes);
+
+    /* Return status. */
+    return ret_status;
+}
+
+/**
+ * @internal
+ *
+ * @brief Update a checksum with the binaries of a program, for all of the
+ * program devices.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] prg Program wrapper object.
+ * @param[in] checksum Checksum to update.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE` otherwise.
+ * */
+static cl_bool ccl_kernel_checksum_binaries(
+    CCLProgram * prg, GChecksum * checksum, CCLErr ** err) {
+
+    cl_uint num_devs;
+    const size_t * sizes;
+    unsigned char ** bins = NULL;
+    cl_int ocl_status;
+    cl_bool ret_status;
+    CCLErr * err_internal = NULL;
+
+    num_devs = ccl_program_get_info_scalar(
+        prg, CL_PROGRAM_NUM_DEVICES, cl_uint, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    sizes = ccl_program_get_info_array(
+        prg, CL_PROGRAM_BINARY_SIZES, size_t, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    bins = g_new0(unsigned char *, num_devs);
+    for (cl_uint i = 0; i < num_devs; ++i)
+        bins[i] = g_malloc(sizes[i]);
+
+    ocl_status = clGetProgramInfo(ccl_program_unwrap(prg),
+        CL_PROGRAM_BINARIES, num_devs * sizeof(unsigned char *), bins, NULL);
+    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+        CL_SUCCESS != ocl_status, ocl_status, error_handler,
+        "%s: unable to get program binaries (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+    for (cl_uint i = 0; i < num_devs; ++i)
+        g_checksum_update(checksum, bins[i], (gssize) sizes[i]);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    ret_status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    ret_status = CL_FALSE;
+
+finish:
+
+    if (bins != NULL) {
+        for (cl_uint i = 0; i < num_devs; ++i)
+            g_free(bins[i]);
+        g_free(bins);
+    }
+
+    /* Return status. */
+    return ret_status;
+}
+
+/**
+ * @internal
  *
- * * 100 for OpenCL 1.0
- * * 110 for OpenCL 1.1
- * * 120 for OpenCL 1.2
- * * 200 for OpenCL 2.0
- * * 210 for OpenCL 2.1
- * * etc.
+ * @brief Get the key which identifies tuned work sizes in the tuning
+ * database.
  *
- * @public @memberof ccl_kernel
+ * Keys contain the kernel name, a checksum of the program source (or of
+ * the program binaries if the program has no source) and build options,
+ * the device vendor ID, name and driver version, and the real work size.
  *
- * @param[in] krnl A kernel wrapper object.
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real worksize.
+ * @param[in] round_gws Can the global work size be larger than the real
+ * work size?
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
- * @return The OpenCL version of the platform associated with this
- * kernel as an integer. If an error occurs, 0 is returned.
+ * @return Key identifying tuned work sizes, which should be freed with
+ * g_free(), or `NULL` if an error occurs.
  * */
-CCL_EXPORT
-cl_uint ccl_kernel_get_opencl_version(CCLKernel * krnl, CCLErr ** err) {
-
-    /* Make sure krnl is not NULL. */
-    g_return_val_if_fail(krnl != NULL, 0);
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, 0);
+static gchar * ccl_kernel_tuning_key(CCLKernel * krnl, CCLDevice * dev,
+    cl_uint dims, const size_t * real_worksize, cl_bool round_gws,
+    CCLErr ** err) {
 
-    cl_context context;
-    CCLContext * ctx = NULL;
+    char * name;
+    cl_program program;
+    CCLProgram * prg = NULL;
+    GChecksum * checksum;
+    char * src;
+    char * opts;
+    GString * key = NULL;
     CCLErr * err_internal = NULL;
-    cl_uint ocl_ver;
 
-    /* Get cl_context object for this kernel. */
-    context = ccl_kernel_get_info_scalar(
-        krnl, CL_KERNEL_CONTEXT, cl_context, &err_internal);
-    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    checksum = g_checksum_new(G_CHECKSUM_SHA1);
 
-    /* Get context wrapper. */
-    ctx = ccl_context_new_wrap(context);
+    name = ccl_kernel_get_info_array(
+        krnl, CL_KERNEL_FUNCTION_NAME, char, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
 
-    /* Get OpenCL version. */
-    ocl_ver = ccl_context_get_opencl_version(ctx, &err_internal);
+    program = ccl_kernel_get_info_scalar(
+        krnl, CL_KERNEL_PROGRAM, cl_program, &err_internal);
     ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    prg = ccl_program_new_wrap(program);
 
-    /* Unref. the context wrapper. */
-    ccl_context_unref(ctx);
+    /* Programs created from binaries have no source. */
+    src = ccl_program_get_info_array(
+        prg, CL_PROGRAM_SOURCE, char, &err_internal);
+    if ((err_internal == NULL) && (src != NULL) && (*src != '\0')) {
+        g_checksum_update(checksum, (const guchar *) src, -1);
+    } else {
+        g_clear_error(&err_internal);
+        ccl_kernel_checksum_binaries(prg, checksum, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    }
+
+    /* Build options are not always available. */
+    opts = ccl_program_get_build_info_array(
+        prg, dev, CL_PROGRAM_BUILD_OPTIONS, char, &err_internal);
+    if ((err_internal == NULL) && (opts != NULL)) {
+        g_checksum_update(checksum, (const guchar *) "|", 1);
+        g_checksum_update(checksum, (const guchar *) opts, -1);
+    }
+    g_clear_error(&err_internal);
+
+    key = g_string_new(NULL);
+    g_string_append_printf(key, "%s|%s|%u|%s|%s|%c", name,
+        g_checksum_get_string(checksum),
+        ccl_device_get_info_scalar(dev, CL_DEVICE_VENDOR_ID, cl_uint, NULL),
+        ccl_device_get_info_array(dev, CL_DEVICE_NAME, char, NULL),
+        ccl_device_get_info_array(dev, CL_DRIVER_VERSION, char, NULL),
+        round_gws ? 'r' : 'e');
+    for (cl_uint i = 0; i < dims; ++i)
+        g_string_append_printf(
+            key, "|%" G_GSIZE_FORMAT, (gsize) real_worksize[i]);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -830,80 +2555,107 @@ error_handler:
 
     /* If we got here there was an error, verify that it is so. */
     g_assert(err == NULL || *err != NULL);
-    ocl_ver = 0;
 
 finish:
 
-    /* Return event wrapper. */
-    return ocl_ver;
+    if (prg != NULL) ccl_program_unref(prg);
+    g_checksum_free(checksum);
+
+    /* Return key. */
+    return key != NULL ? g_string_free(key, FALSE) : NULL;
 }
 
 /**
  * @internal
  *
- * @brief Helper macro which tests if the error is a
- * `CCL_ERROR_INFO_UNAVAILABLE_OCL` error, and if so, generates a warning and
- * clears the error. Otherwise it tests the error in the same way as
- * ccl_if_err_propagate_goto().
+ * @brief Add power-of-two candidate local work sizes, from one work-item
+ * up to the maximum work-group size. In more than one dimension, both
+ * work-groups spanning only the first dimension and square-ish work-groups
+ * spanning the first two dimensions are added.
  *
- * @param[out] err Destination CCLErr** object.
- * @param[in] err_internal Source CCLErr* object.
- * @param[in] error_handler Label to goto if an error other than
- * `CCL_ERROR_INFO_UNAVAILABLE_OCL` is detected.
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] dims Number of dimensions.
+ * @param[in] wg_size_max Maximum work-group size.
+ * @param[in,out] cands Candidate local work sizes, `dims` values each.
  * */
-#define ccl_if_err_not_info_unavailable_propagate_goto( \
-            err, err_internal, error_handler) \
-    if (((err_internal) != NULL) && ((err_internal)->domain == CCL_ERROR) && \
-            ((err_internal)->code == CCL_ERROR_INFO_UNAVAILABLE_OCL)) { \
-        g_warning("In %s: %s", CCL_STRD, (err_internal)->message); \
-        ccl_err_clear(&(err_internal)); \
-    } else { \
-        ccl_if_err_propagate_goto(err, err_internal, error_handler); \
+static void ccl_kernel_autotune_candidates(
+    cl_uint dims, size_t wg_size_max, GArray * cands) {
+
+    size_t * lws = g_newa(size_t, dims);
+
+    for (cl_uint k = 0; ((size_t) 1 << k) <= wg_size_max; ++k) {
+
+        for (cl_uint i = 0; i < dims; ++i) lws[i] = 1;
+        lws[0] = (size_t) 1 << k;
+        g_array_append_vals(cands, lws, dims);
+
+        if ((dims > 1) && (k > 1)) {
+            lws[0] = (size_t) 1 << ((k + 1) / 2);
+            lws[1] = (size_t) 1 << (k / 2);
+            g_array_append_vals(cands, lws, dims);
+        }
     }
+}
 
 /**
- * Suggest appropriate local (and optionally global) work sizes for the
- * given real work size, based on device and kernel characteristics.
+ * Find the fastest local work size for executing a kernel with the given
+ * real work size, by timing kernel executions with several candidate
+ * local work sizes.
+ *
+ * Tuned work sizes are kept in the tuning database (see
+ * @ref CCL_TUNING_DB "the tuning database module"), keyed by kernel name,
+ * program, device and real work size. If a tuned work size is already
+ * available, it is returned without executing the kernel. Otherwise, the
+ * kernel is executed a few times for each candidate local work size, in
+ * the given command queue, and the candidate with the shortest execution
+ * time (as given by event profiling information) is kept in the tuning
+ * database.
+ *
+ * Kernel arguments must be set (e.g. with ::ccl_kernel_set_args()) before
+ * calling this function. Since the kernel is executed several times,
+ * it should not have side effects which prevent its re-execution, or
+ * which client code relies upon.
  *
  * If the `gws` parameter is not `NULL`, it will be populated with a
- * global worksize which may be larger than the real work size
- * in order to better fit the kernel preferred multiple work size. As
- * such, kernels enqueued with global work sizes suggested by this
- * function should check if their global ID is within `real_worksize`.
+ * global worksize which may be larger than the real work size, as in
+ * ::ccl_kernel_suggest_worksizes(). Otherwise, only candidates which are
+ * dimension-wise divisors of the real work size are considered.
  *
  * @public @memberof ccl_kernel
  *
- * @param[in] krnl Kernel wrapper object. If `NULL`, use only device
- * information for determining global and local worksizes.
- * @param[in] dev Device wrapper object.
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] cq Command queue wrapper object, which must have profiling
+ * enabled and must not be event-less.
  * @param[in] dims The number of dimensions used to specify the global
  * work-items and work-items in the work-group.
  * @param[in] real_worksize The real worksize.
- * @param[out] gws Location where to place a "nice" global worksize for
- * the given kernel and device, which must be equal or larger than the `
- * real_worksize` and a multiple of `lws`. This memory location should
- * be pre-allocated with space for `dims` values of size `size_t`. If
- * `NULL` it is assumed that the global worksize must be equal to
- * `real_worksize`.
- * @param[in,out] lws This memory location, of size `dims * sizeof(size_t)`,
- * serves a dual purpose: 1) as an input, containing the maximum allowed local
- * work size for each dimension, or zeros if these maximums are to be fetched
- * from the given device `CL_DEVICE_MAX_WORK_ITEM_SIZES` information (if the
- * specified values are larger than the device limits, the device limits are
- * used instead); 2) as an output, where to place a "nice" local worksize,
- * which is based and respects the limits of the given kernel and device (and
- * of the non-zero values given as input).
+ * @param[in] candidates Candidate local work sizes, `dims` values for each
+ * candidate, or `NULL` to use a default set of candidates, which includes
+ * the local work size given by ::ccl_kernel_suggest_worksizes() and
+ * power-of-two local work sizes. Candidates which exceed kernel or device
+ * limits are ignored.
+ * @param[in] num_candidates Number of candidates in `candidates`, ignored
+ * if `candidates` is `NULL`.
+ * @param[out] gws Location where to place a global worksize for the tuned
+ * local work size, which is equal or larger than `real_worksize` and a
+ * multiple of `lws`, with space for `dims` values. If `NULL` it is assumed
+ * that the global worksize must be equal to `real_worksize`.
+ * @param[out] lws Location where to place the tuned local work size, with
+ * space for `dims` values.
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * @return `CL_TRUE` if function returns successfully, `CL_FALSE` otherwise.
  * */
 CCL_EXPORT
-cl_bool ccl_kernel_suggest_worksizes(CCLKernel * krnl, CCLDevice * dev,
-    cl_uint dims, const size_t * real_worksize, size_t * gws, size_t * lws,
-    CCLErr ** err) {
+cl_bool ccl_kernel_autotune_worksizes(CCLKernel * krnl, CCLQueue * cq,
+    cl_uint dims, const size_t * real_worksize, const size_t * candidates,
+    cl_uint num_candidates, size_t * gws, size_t * lws, CCLErr ** err) {
 
-    /* Make sure dev is not NULL. */
-    g_return_val_if_fail(dev != NULL, CL_FALSE);
+    /* Make sure krnl is not NULL. */
+    g_return_val_if_fail(krnl != NULL, CL_FALSE);
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, CL_FALSE);
     /* Make sure dims not zero. */
     g_return_val_if_fail(dims > 0, CL_FALSE);
     /* Make sure real_worksize is not NULL. */
@@ -913,198 +2665,147 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel * krnl, CCLDevice * dev,
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
 
-    /* The preferred workgroup size. */
-    size_t wg_size_mult = 0;
+    CCLDevice * dev;
+    gchar * key = NULL;
+    GArray * cands = NULL;
+    cl_command_queue_properties qprop;
+    const size_t * max_wi_sizes;
     size_t wg_size_max = 0;
-    size_t wg_size = 1, wg_size_aux;
-    size_t * max_wi_sizes;
-    cl_uint dev_dims;
+    size_t * cand_gws = g_newa(size_t, dims);
+    size_t * heur_lws = g_newa(size_t, dims);
+    cl_ulong best_time = G_MAXUINT64;
     cl_bool ret_status;
-    size_t real_ws = 1;
-
-    /* Error handling object. */
     CCLErr * err_internal = NULL;
 
-    /* Check if device supports the requested dims. */
-    dev_dims = ccl_device_get_info_scalar(
-        dev, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, cl_uint, &err_internal);
+    /* Get device associated with queue. */
+    dev = ccl_queue_get_device(cq, &err_internal);
     ccl_if_err_propagate_goto(err, err_internal, error_handler);
-    ccl_if_err_create_goto(*err, CCL_ERROR, dims > dev_dims,
-        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
-        "%s: device only supports a maximum of %d dimension(s), "
-        "but %d were requested.",
-        CCL_STRD, dev_dims, dims);
 
-    /* Get max. work item sizes for device. */
+    /* Use tuned work size if available. */
+    key = ccl_kernel_tuning_key(
+        krnl, dev, dims, real_worksize, gws != NULL, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    if (ccl_tuning_db_lookup(key, dims, lws)) goto set_gws;
+
+    /* Kernel executions can only be timed with profiling enabled. */
+    qprop = ccl_queue_get_info_scalar(cq, CL_QUEUE_PROPERTIES,
+        cl_command_queue_properties, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    ccl_if_err_create_goto(*err, CCL_ERROR,
+        (qprop & CL_QUEUE_PROFILING_ENABLE) == 0, CCL_ERROR_ARGS,
+        error_handler,
+        "%s: the command queue does not have profiling enabled.",
+        CCL_STRD);
+
+    /* Get kernel and device limits. */
     max_wi_sizes = ccl_device_get_info_array(
         dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t, &err_internal);
     ccl_if_err_propagate_goto(err, err_internal, error_handler);
-
-    /* For each dimension, if the user specified a maximum local work
-     * size, the effective maximum local work size will be the minimum
-     * between the user value and the device value. */
-    for (cl_uint i = 0; i < dims; ++i) {
-        if (lws[i] != 0)
-            max_wi_sizes[i] = MIN(max_wi_sizes[i], lws[i]);
+    wg_size_max = ccl_kernel_get_workgroup_info_scalar(krnl, dev,
+        CL_KERNEL_WORK_GROUP_SIZE, size_t, &err_internal);
+    ccl_if_err_not_info_unavailable_propagate_goto(
+        err, err_internal, error_handler);
+    if (wg_size_max == 0) {
+        wg_size_max = ccl_device_get_info_scalar(
+            dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
     }
 
-    /* If kernel is not NULL, query it about workgroup size preferences
-     * and capabilities. */
-    if (krnl != NULL) {
-
-        /* Determine maximum workgroup size. */
-        wg_size_max = ccl_kernel_get_workgroup_info_scalar(krnl, dev,
-            CL_KERNEL_WORK_GROUP_SIZE, size_t, &err_internal);
-        ccl_if_err_not_info_unavailable_propagate_goto(
-            err, err_internal, error_handler);
-
-#ifdef CL_VERSION_1_1
-
-        /* Determine preferred workgroup size multiple (OpenCL >= 1.1). */
-
-        /* Get OpenCL version of the underlying platform. */
-        cl_uint ocl_ver = ccl_kernel_get_opencl_version(krnl, &err_internal);
+    /* Determine candidate local work sizes. */
+    cands = g_array_new(FALSE, FALSE, sizeof(size_t));
+    if (candidates != NULL) {
+        g_array_append_vals(cands, candidates, num_candidates * dims);
+    } else {
+        /* The heuristic local work size is the first candidate. */
+        memset(heur_lws, 0, dims * sizeof(size_t));
+        ccl_kernel_suggest_worksizes(krnl, dev, dims, real_worksize,
+            gws != NULL ? cand_gws : NULL, heur_lws, &err_internal);
         ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        g_array_append_vals(cands, heur_lws, dims);
+        ccl_kernel_autotune_candidates(dims, wg_size_max, cands);
+    }
 
-        /* If OpenCL version of the underlying platform is >= 1.1 ... */
-        if (ocl_ver >= 110) {
-
-            /* ...use CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE... */
-            wg_size_mult = ccl_kernel_get_workgroup_info_scalar(
-                krnl, dev, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
-                size_t, &err_internal);
-            ccl_if_err_not_info_unavailable_propagate_goto(
-                err, err_internal, error_handler);
-
-        } else {
+    /* Time kernel executions with each valid candidate. */
+    for (guint c = 0; c < cands->len / dims; ++c) {
 
-            /* ...otherwise just use CL_KERNEL_WORK_GROUP_SIZE. */
-            wg_size_mult = wg_size_max;
+        size_t * cand_lws = &g_array_index(cands, size_t, c * dims);
+        size_t wg_size = 1;
+        cl_bool valid = CL_TRUE;
+        cl_ulong cand_time = G_MAXUINT64;
 
+        /* Candidates must respect kernel and device limits, and in each
+         * dimension not exceed (or, if the global work size can't be
+         * larger than the real work size, divide) the real work size. */
+        for (cl_uint i = 0; i < dims; ++i) {
+            wg_size *= cand_lws[i];
+            if ((cand_lws[i] == 0) || (cand_lws[i] > max_wi_sizes[i])
+                || (cand_lws[i] > real_worksize[i])
+                || ((gws == NULL) && (real_worksize[i] % cand_lws[i] != 0)))
+                valid = CL_FALSE;
         }
+        if (!valid || (wg_size > wg_size_max)) continue;
 
-#else
-
-        wg_size_mult = wg_size_max;
-
-#endif
-
-    }
+        /* Skip candidates which were already timed. */
+        for (guint d = 0; valid && (d < c); ++d) {
+            if (memcmp(cand_lws, &g_array_index(cands, size_t, d * dims),
+                dims * sizeof(size_t)) == 0)
+                valid = CL_FALSE;
+        }
+        if (!valid) continue;
 
-    /* If it was not possible to obtain wg_size_mult and wg_size_max, either
-     * because kernel is NULL or the information was unavailable, use values
-     * obtained from device. */
-    if ((wg_size_max == 0) && (wg_size_mult == 0)) {
-        wg_size_max = ccl_device_get_info_scalar(
-            dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err_internal);
-        ccl_if_err_propagate_goto(err, err_internal, error_handler);
-        wg_size_mult = wg_size_max;
-    }
+        for (cl_uint i = 0; i < dims; ++i) {
+            cand_gws[i] = ((real_worksize[i] + cand_lws[i] - 1)
+                / cand_lws[i]) * cand_lws[i];
+        }
 
-    /* Try to find an appropriate local worksize. */
-    for (cl_uint i = 0; i < dims; ++i) {
+        /* The shortest of several executions is the candidate time. */
+        for (cl_uint r = 0; r < CCL_KERNEL_AUTOTUNE_RUNS; ++r) {
 
-        /* Each lws component is at most the preferred workgroup
-         * multiple or the maximum size of that component in device. */
-        lws[i] = MIN(wg_size_mult, max_wi_sizes[i]);
+            CCLEvent * evt;
+            CCLEventWaitList ewl = NULL;
+            cl_ulong start, end;
 
-        /* Update total workgroup size. */
-        wg_size *= lws[i];
+            evt = ccl_kernel_enqueue_ndrange(krnl, cq, dims, NULL, cand_gws,
+                cand_lws, NULL, &err_internal);
+            ccl_if_err_propagate_goto(err, err_internal, error_handler);
+            ccl_if_err_create_goto(*err, CCL_ERROR, evt == NULL,
+                CCL_ERROR_ARGS, error_handler,
+                "%s: kernel executions can't be timed in an event-less "
+                "command queue.", CCL_STRD);
 
-        /* Update total real worksize. */
-        real_ws *= real_worksize[i];
+            ccl_event_wait(ccl_ewl(&ewl, evt, NULL), &err_internal);
+            ccl_if_err_propagate_goto(err, err_internal, error_handler);
 
-    }
+            start = ccl_event_get_profiling_info_scalar(
+                evt, CL_PROFILING_COMMAND_START, cl_ulong, &err_internal);
+            ccl_if_err_propagate_goto(err, err_internal, error_handler);
+            end = ccl_event_get_profiling_info_scalar(
+                evt, CL_PROFILING_COMMAND_END, cl_ulong, &err_internal);
+            ccl_if_err_propagate_goto(err, err_internal, error_handler);
 
-    /* Don't let each component of the local worksize to be
-     * higher than the respective component of the real
-     * worksize. */
-    for (cl_uint i = 0; i < dims; ++i) {
-        while (lws[i] > real_worksize[i]) {
-            lws[i] /= 2;
-            wg_size /= 2;
+            cand_time = MIN(cand_time, end - start);
         }
-    }
 
-    /* The total workgroup size can't be higher than the maximum
-     * supported by the device. */
-    while (wg_size > wg_size_max) {
-        wg_size_aux = wg_size;
-        for (int i = dims - 1; i >= 0; --i) {
-            if (lws[i] > 1) {
-                /* Local work size can't be smaller than 1. */
-                lws[i] /= 2;
-                wg_size /= 2;
-            }
-            if (wg_size <= wg_size_max) break;
+        /* Keep fastest candidate so far. */
+        if (cand_time < best_time) {
+            best_time = cand_time;
+            memcpy(lws, cand_lws, dims * sizeof(size_t));
         }
-        /* Avoid infinite loops and throw error if wg_size didn't
-         * change. */
-        ccl_if_err_create_goto(*err, CCL_ERROR, wg_size == wg_size_aux,
-            CCL_ERROR_OTHER, error_handler,
-            "%s: Unable to determine a work size within the device limit (%d).",
-            CCL_STRD, (int) wg_size_max);
     }
 
-    /* If output variable gws is not NULL... */
-    if (gws != NULL) {
-        /* ...find a global worksize which is a multiple of the local
-         * worksize and is big enough to handle the real worksize. */
-        for (cl_uint i = 0; i < dims; ++i) {
-            gws[i] = ((real_worksize[i] / lws[i])
-                + (((real_worksize[i] % lws[i]) > 0) ? 1 : 0))
-                * lws[i];
-        }
-    } else {
-        /* ...otherwise check if found local worksizes are divisors of
-         * the respective real_worksize. If so keep them, otherwise find
-         * local worksizes which respect the maximum sizes allowed by
-         * the kernel and the device, and is a dimension-wise divisor of
-         * the real_worksize. */
-        cl_bool lws_are_divisors = CL_TRUE;
-        for (cl_uint i = 0; i < dims; ++i) {
-            /* Check if lws[i] is divisor of real_worksize[i]. */
-            if (real_worksize[i] % lws[i] != 0) {
-                /* Ops... lws[i] is not divisor of real_worksize[i], so
-                 * we'll have to try and find new lws ahead. */
-                lws_are_divisors = CL_FALSE;
-                break;
-            }
-        }
-        /* Is lws divisor of real_worksize, dimension-wise? */
-        if (!lws_are_divisors) {
-            /* No, so we'll have to find new lws. */
-            wg_size = 1;
-            for (cl_uint i = 0; i < dims; ++i) {
+    ccl_if_err_create_goto(*err, CCL_ERROR, best_time == G_MAXUINT64,
+        CCL_ERROR_ARGS, error_handler,
+        "%s: none of the candidate local work sizes is valid.", CCL_STRD);
 
-                /* For each dimension, try to use the previously
-                 * found lws[i]. */
-                if ((real_worksize[i] % lws[i] != 0)
-                    || (lws[i] * wg_size > wg_size_max))
-                {
-                    /* Previously found lws[i] not usable, find
-                     * new one. Must be a divisor of real_worksize[i]
-                     * and respect the kernel and device maximum lws.*/
-                    cl_uint best_lws_i = 1;
-                    for (cl_uint j = 2; j <= real_worksize[i] / 2; ++j) {
-                        /* If current value is higher than the kernel
-                         * and device limits, stop searching and use
-                         * the best one so far. */
-                        if ((wg_size * j > wg_size_max)
-                            || (j > max_wi_sizes[i])) break;
-                        /* Otherwise check if current value is divisor
-                         * of lws[i]. If so, keep it as the best so
-                         * far. */
-                        if (real_worksize[i] % j == 0)
-                            best_lws_i = j;
-                    }
-                    /* Keep the best divisor for current dimension. */
-                    lws[i] = best_lws_i;
-                }
-                /* Update absolute workgroup size (all dimensions). */
-                wg_size *= lws[i];
-            }
-        }
+    /* Keep tuned work size. */
+    ccl_tuning_db_store(key, dims, lws);
+
+set_gws:
+
+    /* Determine global work size for tuned local work size. */
+    if (gws != NULL) {
+        for (cl_uint i = 0; i < dims; ++i)
+            gws[i] = ((real_worksize[i] + lws[i] - 1) / lws[i]) * lws[i];
     }
 
     /* If we got here, everything is OK. */
@@ -1120,6 +2821,9 @@ error_handler:
 
 finish:
 
+    if (cands != NULL) g_array_free(cands, TRUE);
+    g_free(key);
+
     /* Return status. */
     return ret_status;
 }
@@ -129,6 +129,12 @@ void ccl_kernel_destroy(CCLKernel * krnl);
 CCL_EXPORT
 void ccl_kernel_set_arg(CCLKernel * krnl, cl_uint arg_index, void * arg);
 
+/* Immediately set one kernel argument from a value, without creating a
+ * ::CCLArg* object. */
+CCL_EXPORT
+cl_bool ccl_kernel_set_arg_value(CCLKernel * krnl, cl_uint arg_index,
+    size_t size, const void * value, CCLErr ** err);
+
 /* Set all kernel arguments. This function accepts a variable list of
  * arguments which must end with `NULL`. */
 CCL_EXPORT
@@ -161,6 +167,14 @@ CCLEvent * ccl_kernel_set_args_and_enqueue_ndrange_v(CCLKernel * krnl,
     const size_t * global_work_size, const size_t * local_work_size,
     CCLEventWaitList * evt_wait_lst, void ** args, CCLErr ** err);
 
+/* Execute a kernel over an NDRange split across several command queues. */
+CCL_EXPORT
+cl_bool ccl_kernel_enqueue_ndrange_multi(CCLKernel * krnl,
+    CCLQueue * const * queues, cl_uint num_queues, cl_uint work_dim,
+    const size_t * global_work_offset, const size_t * global_work_size,
+    const size_t * local_work_size, size_t chunk_size, size_t * chunks_done,
+    CCLErr ** err);
+
 /* Enqueues a command to execute a native C/C++ function not compiled
  * using the OpenCL compiler. */
 CCL_EXPORT
@@ -182,6 +196,13 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel * krnl, CCLDevice * dev,
     cl_uint dims, const size_t * real_worksize, size_t * gws, size_t * lws,
     CCLErr ** err);
 
+/* Find the fastest local work size for executing a kernel with the given
+ * real work size, by timing kernel executions. */
+CCL_EXPORT
+cl_bool ccl_kernel_autotune_worksizes(CCLKernel * krnl, CCLQueue * cq,
+    cl_uint dims, const size_t * real_worksize, const size_t * candidates,
+    cl_uint num_candidates, size_t * gws, size_t * lws, CCLErr ** err);
+
 /**
  * Get a ::CCLWrapperInfo kernel information object.
  *
@@ -0,0 +1,307 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for repeatedly launching a kernel
+ * with a fixed command queue and work geometry.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_launch.h"
+#include "_ccl_defs.h"
+
+/**
+ * Launch handle class.
+ * */
+struct ccl_launch {
+
+    /**
+     * Kernel wrapper owned by the handle.
+     * @private
+     * */
+    CCLKernel * krnl;
+
+    /**
+     * Command queue wrapper.
+     * @private
+     * */
+    CCLQueue * cq;
+
+    /**
+     * Number of work dimensions.
+     * @private
+     * */
+    cl_uint work_dim;
+
+    /**
+     * Global work offset, if given.
+     * @private
+     * */
+    size_t gwo[3];
+
+    /**
+     * Global work size.
+     * @private
+     * */
+    size_t gws[3];
+
+    /**
+     * Local work size, if given.
+     * @private
+     * */
+    size_t lws[3];
+
+    /**
+     * Was the global work offset given?
+     * @private
+     * */
+    cl_bool has_gwo;
+
+    /**
+     * Was the local work size given?
+     * @private
+     * */
+    cl_bool has_lws;
+
+};
+
+/**
+ * @addtogroup CCL_LAUNCH
+ * @{
+ */
+
+/**
+ * Create a new launch handle for a program kernel.
+ *
+ * The handle creates its own kernel wrapper with ::ccl_kernel_new(), so
+ * that its argument slots are not shared with other launch handles or with
+ * the kernel wrapper returned by ::ccl_program_get_kernel(). The work
+ * geometry is copied into the handle, and the command queue wrapper is
+ * referenced by it.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] prg A program wrapper object.
+ * @param[in] kernel_name The kernel name.
+ * @param[in] cq Command queue wrapper object on which the kernel will be
+ * enqueued.
+ * @param[in] work_dim The number of dimensions used to specify the global
+ * work-items and work-items in the work-group, between 1 and 3.
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item.
+ * @param[in] global_work_size An array of `work_dim` unsigned values that
+ * describe the number of global work-items in `work_dim` dimensions that
+ * will execute the kernel function.
+ * @param[in] local_work_size An array of `work_dim` unsigned values that
+ * describe the number of work-items that make up a work-group that will
+ * execute the specified kernel.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new launch handle, which should be destroyed with
+ * ::ccl_launch_destroy() when no longer needed, or `NULL` if an error
+ * occurs.
+ * */
+CCL_EXPORT
+CCLLaunch * ccl_launch_new(CCLProgram * prg, const char * kernel_name,
+    CCLQueue * cq, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    CCLErr ** err) {
+
+    /* Make sure prg is not NULL. */
+    g_return_val_if_fail(prg != NULL, NULL);
+    /* Make sure kernel_name is not NULL. */
+    g_return_val_if_fail(kernel_name != NULL, NULL);
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure global_work_size is not NULL. */
+    g_return_val_if_fail(global_work_size != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* Launch handle. */
+    CCLLaunch * lnc = NULL;
+    /* Kernel wrapper. */
+    CCLKernel * krnl = NULL;
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Check number of work dimensions. */
+    ccl_if_err_create_goto(*err, CCL_ERROR,
+        (work_dim < 1) || (work_dim > 3), CCL_ERROR_ARGS, error_handler,
+        "%s: number of work dimensions must be between 1 and 3, got %u.",
+        CCL_STRD, work_dim);
+
+    /* Create a kernel wrapper for this handle only. */
+    krnl = ccl_kernel_new(prg, kernel_name, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Create launch handle, which takes ownership of the kernel. */
+    lnc = g_slice_new0(CCLLaunch);
+    lnc->krnl = krnl;
+    ccl_queue_ref(cq);
+    lnc->cq = cq;
+    lnc->work_dim = work_dim;
+    lnc->has_gwo = (global_work_offset != NULL);
+    lnc->has_lws = (local_work_size != NULL);
+    for (cl_uint i = 0; i < work_dim; ++i) {
+        lnc->gws[i] = global_work_size[i];
+        if (lnc->has_gwo) lnc->gwo[i] = global_work_offset[i];
+        if (lnc->has_lws) lnc->lws[i] = local_work_size[i];
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return launch handle. */
+    return lnc;
+}
+
+/**
+ * Destroy a launch handle.
+ *
+ * The kernel wrapper of the handle is destroyed, and the command queue
+ * wrapper is unreferenced.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] lnc Launch handle to destroy.
+ * */
+CCL_EXPORT
+void ccl_launch_destroy(CCLLaunch * lnc) {
+
+    /* Make sure lnc is not NULL. */
+    g_return_if_fail(lnc != NULL);
+
+    ccl_kernel_destroy(lnc->krnl);
+    ccl_queue_destroy(lnc->cq);
+    g_slice_free(CCLLaunch, lnc);
+}
+
+/**
+ * Get the kernel wrapper of a launch handle.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] lnc Launch handle.
+ * @return The kernel wrapper object, which should not be destroyed by the
+ * caller.
+ * */
+CCL_EXPORT
+CCLKernel * ccl_launch_get_kernel(CCLLaunch * lnc) {
+
+    /* Make sure lnc is not NULL. */
+    g_return_val_if_fail(lnc != NULL, NULL);
+
+    return lnc->krnl;
+}
+
+/**
+ * Change one argument slot of a launch handle. The argument is passed to
+ * the OpenCL kernel by the next call to ::ccl_launch_fire(), and only if
+ * it differs from the value the kernel already holds.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] lnc Launch handle.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to set, with the same semantics as in
+ * ::ccl_kernel_set_arg().
+ * */
+CCL_EXPORT
+void ccl_launch_set_arg(CCLLaunch * lnc, cl_uint arg_index, void * arg) {
+
+    /* Make sure lnc is not NULL. */
+    g_return_if_fail(lnc != NULL);
+    /* Make sure arg is not NULL. */
+    g_return_if_fail(arg != NULL);
+
+    if (arg == ccl_arg_skip) return;
+
+    ccl_kernel_set_arg(lnc->krnl, arg_index, arg);
+}
+
+/**
+ * Change one argument slot of a launch handle from a value, without
+ * creating a ::CCLArg* object. clSetKernelArg() is only called if the
+ * value differs from the one the kernel already holds.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] lnc Launch handle.
+ * @param[in] arg_index Argument index.
+ * @param[in] size Argument size in bytes.
+ * @param[in] value Argument value, with the same semantics as in
+ * ::ccl_kernel_set_arg_value().
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if argument was successfully set, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_launch_set_arg_value(CCLLaunch * lnc, cl_uint arg_index,
+    size_t size, const void * value, CCLErr ** err) {
+
+    /* Make sure lnc is not NULL. */
+    g_return_val_if_fail(lnc != NULL, CL_FALSE);
+
+    return ccl_kernel_set_arg_value(lnc->krnl, arg_index, size, value, err);
+}
+
+/**
+ * Enqueue the prepared kernel execution on the command queue of the launch
+ * handle. Only the arguments changed since the previous launch are passed
+ * to the OpenCL kernel before clEnqueueNDRangeKernel() is called.
+ *
+ * @public @memberof ccl_launch
+ *
+ * @param[in] lnc Launch handle.
+ * @param[in,out] evt_wait_lst List of events that need to complete before
+ * this command can be executed. The list will be cleared and can be reused
+ * by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return Event wrapper object that identifies this command, or `NULL` if
+ * an error occurs or if the queue is event-less.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_launch_fire(CCLLaunch * lnc, CCLEventWaitList * evt_wait_lst,
+    CCLErr ** err) {
+
+    /* Make sure lnc is not NULL. */
+    g_return_val_if_fail(lnc != NULL, NULL);
+
+    return ccl_kernel_enqueue_ndrange(lnc->krnl, lnc->cq, lnc->work_dim,
+        lnc->has_gwo ? lnc->gwo : NULL, lnc->gws,
+        lnc->has_lws ? lnc->lws : NULL, evt_wait_lst, err);
+}
+
+/** @} */
@@ -0,0 +1,123 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Definition of classes and methods for repeatedly launching a kernel with
+ * a fixed command queue and work geometry.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_LAUNCH_H_
+#define _CCL_LAUNCH_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_kernel_wrapper.h"
+#include "ccl_program_wrapper.h"
+#include "ccl_queue_wrapper.h"
+#include "ccl_event_wrapper.h"
+
+/**
+ * @defgroup CCL_LAUNCH Launch handles
+ *
+ * The launch module provides the ::CCLLaunch* class, a prepared kernel
+ * execution for code which runs the same kernel with the same command
+ * queue and work geometry many times, e.g. in a hot loop.
+ *
+ * Each call to ::ccl_program_enqueue_kernel() looks up the kernel by name,
+ * walks a variable list of arguments and hands them to the kernel. A
+ * launch handle does this work once: the kernel is looked up and the
+ * command queue and work geometry are captured when the handle is created
+ * with ::ccl_launch_new(). Arguments are kept in slots which can be changed
+ * individually between launches with ::ccl_launch_set_arg() or
+ * ::ccl_launch_set_arg_value(). ::ccl_launch_fire() then only calls
+ * clSetKernelArg() for the arguments which changed since the previous
+ * launch, followed by clEnqueueNDRangeKernel().
+ *
+ * Each launch handle has its own kernel object, and thus its own argument
+ * slots, so several handles for the same program kernel (e.g. with
+ * different command queues or work geometries) can be used side by side.
+ * As with kernel wrappers, a launch handle is not thread-safe.
+ *
+ * _Example:_
+ *
+ * ```c
+ * CCLLaunch * lnc;
+ * ```
+ *
+ * ```c
+ * lnc = ccl_launch_new(prg, "step", cq, 1, NULL, &gws, &lws, &err);
+ * ccl_launch_set_arg(lnc, 0, buf);
+ * ```
+ *
+ * ```c
+ * for (cl_uint i = 0; i < num_steps; ++i) {
+ *     ccl_launch_set_arg_value(lnc, 1, sizeof(cl_uint), &i, &err);
+ *     ccl_launch_fire(lnc, NULL, &err);
+ * }
+ * ```
+ *
+ * ```c
+ * ccl_launch_destroy(lnc);
+ * ```
+ *
+ * @{
+ */
+
+/**
+ * Prepared kernel execution with a fixed kernel, command queue and work
+ * geometry.
+ * */
+typedef struct ccl_launch CCLLaunch;
+
+/* Create a new launch handle for a program kernel. */
+CCL_EXPORT
+CCLLaunch * ccl_launch_new(CCLProgram * prg, const char * kernel_name,
+    CCLQueue * cq, cl_uint work_dim, const size_t * global_work_offset,
+    const size_t * global_work_size, const size_t * local_work_size,
+    CCLErr ** err);
+
+/* Destroy a launch handle. */
+CCL_EXPORT
+void ccl_launch_destroy(CCLLaunch * lnc);
+
+/* Get the kernel wrapper of a launch handle. */
+CCL_EXPORT
+CCLKernel * ccl_launch_get_kernel(CCLLaunch * lnc);
+
+/* Change one argument slot of a launch handle. */
+CCL_EXPORT
+void ccl_launch_set_arg(CCLLaunch * lnc, cl_uint arg_index, void * arg);
+
+/* Change one argument slot of a launch handle from a value. */
+CCL_EXPORT
+cl_bool ccl_launch_set_arg_value(CCLLaunch * lnc, cl_uint arg_index,
+    size_t size, const void * value, CCLErr ** err);
+
+/* Enqueue the prepared kernel execution. */
+CCL_EXPORT
+CCLEvent * ccl_launch_fire(CCLLaunch * lnc, CCLEventWaitList * evt_wait_lst,
+    CCLErr ** err);
+
+/** @} */
+
+#endif
@@ -18,6 +18,7 @@
 
 #include "ccl_memobj_wrapper.h"
 #include "_ccl_memobj_wrapper.h"
+#include "_ccl_queue_wrapper.h"
 #include "_ccl_defs.h"
 
  /**
@@ -62,6 +63,10 @@ cl_uint ccl_memobj_get_opencl_version(CCLMemObj * mo, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&mo->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&mo->ocl_ver);
+
     cl_context context;
     CCLContext * ctx = NULL;
     CCLErr * err_internal = NULL;
@@ -94,7 +99,11 @@ error_handler:
 
 finish:
 
-    /* Return event wrapper. */
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ocl_ver > 0)
+        g_atomic_int_set(&mo->ocl_ver, (gint) ocl_ver);
+
+    /* Return OpenCL version, cached above unless an error occurred. */
     return ocl_ver;
 }
 
@@ -130,24 +139,39 @@ CCLEvent * ccl_memobj_enqueue_unmap(CCLMemObj * mo, CCLQueue * cq,
     /* OpenCL function status. */
     cl_int ocl_status;
     /* OpenCL event. */
-    cl_event event;
+    cl_event event = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
     /* Event wrapper. */
-    CCLEvent * evt;
+    CCLEvent * evt = NULL;
+
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    CCLQueueAccess acc[] = { { ccl_memobj_unwrap(mo), CL_TRUE } };
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, G_N_ELEMENTS(acc));
 
     /* Enqueue unmap command. */
     ocl_status = clEnqueueUnmapMemObject (ccl_queue_unwrap(cq),
         ccl_memobj_unwrap(mo), mapped_ptr,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to unmap memory object (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, G_N_ELEMENTS(acc));
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
+
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
 
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
@@ -298,15 +322,19 @@ CCLEvent * ccl_memobj_enqueue_migrate(CCLMemObj ** mos, cl_uint num_mos,
     /* OpenCL function status. */
     cl_int ocl_status;
     /* OpenCL event. */
-    cl_event event;
+    cl_event event = NULL;
     /* Event wrapper. */
-    CCLEvent * evt;
+    CCLEvent * evt = NULL;
     /* OpenCL version. */
     double ocl_ver;
     /* Internal error handling object. */
     CCLErr * err_internal = NULL;
     /* Array of OpenCL memory objects. */
     cl_mem * mem_objects = NULL;
+    /* Accesses to memory objects, for hazard tracking. */
+    CCLQueueAccess * acc = NULL;
+    /* Event wait list with hazards, if required. */
+    CCLEventWaitList hz_lst = NULL;
 
 #ifndef CL_VERSION_1_2
 
@@ -316,6 +344,8 @@ CCLEvent * ccl_memobj_enqueue_migrate(CCLMemObj ** mos, cl_uint num_mos,
     CCL_UNUSED(event);
     CCL_UNUSED(ocl_ver);
     CCL_UNUSED(err_internal);
+    CCL_UNUSED(acc);
+    CCL_UNUSED(hz_lst);
 
     /* If cf4ocl was not compiled with support for OpenCL >= 1.2, always throw
      * error. */
@@ -341,28 +371,44 @@ CCLEvent * ccl_memobj_enqueue_migrate(CCLMemObj ** mos, cl_uint num_mos,
     /* Allocate memory for memory objects. */
     mem_objects = (cl_mem *) g_slice_alloc(sizeof(cl_mem) * num_mos);
 
-    /* Gather OpenCL memory objects in a array. */
+    /* Gather OpenCL memory objects in a array. Migration is considered a
+     * write for the purpose of hazard tracking. */
+    acc = g_newa(CCLQueueAccess, num_mos);
     for (cl_uint i = 0; i < num_mos; ++i) {
         mem_objects[i] = ccl_memobj_unwrap(mos[i]);
+        acc[i].mem = mem_objects[i];
+        acc[i].write = CL_TRUE;
     }
 
+    /* Wait for conflicting commands if the queue tracks hazards. */
+    evt_wait_lst = ccl_queue_hazards_wait(
+        cq, evt_wait_lst, &hz_lst, acc, num_mos);
+
     /* Migrate memory objects. */
     ocl_status = clEnqueueMigrateMemObjects(ccl_queue_unwrap(cq),
         num_mos, (const cl_mem*) mem_objects, flags,
         ccl_event_wait_list_get_num_events(evt_wait_lst),
-        ccl_event_wait_list_get_clevents(evt_wait_lst), &event);
+        ccl_event_wait_list_get_clevents(evt_wait_lst),
+        ccl_queue_event_ptr(cq, &event));
     ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
         CL_SUCCESS != ocl_status, ocl_status, error_handler,
         "%s: unable to migrate memory objects (OpenCL error %d: %s).",
         CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* Wrap event and associate it with the respective command queue.
-     * The event object will be released automatically when the command
-     * queue is released. */
-    evt = ccl_queue_produce_event(cq, event);
+    /* Track memory accesses of the command. */
+    ccl_queue_hazards_record(cq, event, acc, num_mos);
+
+    /* Wrap event and associate it with the respective command queue,
+     * unless the queue is event-less. The event object will be released
+     * automatically when the command queue is released. */
+    if (event != NULL)
+        evt = ccl_queue_produce_event(cq, event);
 
 #endif
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -29,6 +29,7 @@
 #include "ccl_platform_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
 #include "_ccl_abstract_dev_container_wrapper.h"
+#include "_ccl_info_cache.h"
 #include "_ccl_defs.h"
 
 /**
@@ -43,6 +44,18 @@ struct ccl_platform {
      * @private
      * */
     CCLDevContainer base;
+
+    /**
+     * Was the persistent info cache already checked for this platform?
+     * @private
+     * */
+    volatile gint info_cache_loaded;
+
+    /**
+     * OpenCL version of the platform, or 0 if not yet determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
 };
 
 /**
@@ -114,6 +127,27 @@ finish:
     return info;
 }
 
+/**
+ * @internal
+ *
+ * @brief Pre-populate the platform and its devices with information from
+ * the persistent info cache, once the platform devices are initialized.
+ *
+ * @private @memberof ccl_platform
+ *
+ * @param[in] platf The platform wrapper object.
+ * */
+static void ccl_platform_load_cached_info(CCLPlatform * platf) {
+
+    CCLDevContainer * devcon = (CCLDevContainer *) platf;
+
+    if ((platf != NULL) && (devcon->devices != NULL)
+        && g_atomic_int_compare_and_exchange(&platf->info_cache_loaded, 0, 1))
+
+        ccl_info_cache_load_platform(
+            platf, devcon->devices, devcon->num_devices);
+}
+
 /**
  * @addtogroup CCL_PLATFORM_WRAPPER
  * @{
@@ -234,6 +268,10 @@ cl_uint ccl_platform_get_opencl_version(CCLPlatform * platf, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&platf->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&platf->ocl_ver);
+
     char * ver_str = NULL;
     cl_uint ver = 0;
 
@@ -246,6 +284,10 @@ cl_uint ccl_platform_get_opencl_version(CCLPlatform * platf, CCLErr ** err) {
             atoi(ver_str + 7) * 100 + /* Major version. */
             atoi(ver_str + 9) * 10; /* Minor version. */
     }
+
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ver > 0)
+        g_atomic_int_set(&platf->ocl_ver, (gint) ver);
     return ver;
 }
 
@@ -267,8 +309,10 @@ cl_uint ccl_platform_get_opencl_version(CCLPlatform * platf, CCLErr ** err) {
 CCLDevice * const * ccl_platform_get_all_devices(
     CCLPlatform * platf, CCLErr ** err) {
 
-    return ccl_dev_container_get_all_devices(
+    CCLDevice * const * devices = ccl_dev_container_get_all_devices(
         (CCLDevContainer *) platf, ccl_platform_get_cldevices, err);
+    ccl_platform_load_cached_info(platf);
+    return devices;
 }
 
 /**
@@ -286,8 +330,10 @@ CCL_EXPORT
 CCLDevice * ccl_platform_get_device(
     CCLPlatform * platf, cl_uint index, CCLErr ** err) {
 
-    return ccl_dev_container_get_device((CCLDevContainer *) platf,
-        ccl_platform_get_cldevices, index, err);
+    CCLDevice * device = ccl_dev_container_get_device(
+        (CCLDevContainer *) platf, ccl_platform_get_cldevices, index, err);
+    ccl_platform_load_cached_info(platf);
+    return device;
 }
 
 /**
@@ -304,8 +350,10 @@ CCLDevice * ccl_platform_get_device(
 CCL_EXPORT
 cl_uint ccl_platform_get_num_devices(CCLPlatform * platf, CCLErr ** err) {
 
-    return ccl_dev_container_get_num_devices(
+    cl_uint num_devices = ccl_dev_container_get_num_devices(
         (CCLDevContainer *) platf, ccl_platform_get_cldevices, err);
+    ccl_platform_load_cached_info(platf);
+    return num_devices;
 }
 
 /** @}*/
@@ -27,6 +27,8 @@
  * */
 
 #include "ccl_profiler.h"
+#include "_ccl_profiler.h"
+#include "_ccl_queue_wrapper.h"
 #include "_ccl_defs.h"
 
 /**
@@ -714,6 +716,47 @@ finish:
     return;
 }
 
+/**
+ * @internal
+ *
+ * @brief Add an event which is about to be released by its command queue
+ * for profiling.
+ *
+ * This function is called by command queues whose event retention policy
+ * is ::CCL_QUEUE_EVTS_PROFILE_COMPLETED. Events without profiling
+ * information are ignored.
+ *
+ * @protected @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] cq_name Command queue name.
+ * @param[in] evt Event wrapper object.
+ * */
+void ccl_prof_collect_event(
+    CCLProf * prof, const char * cq_name, CCLEvent * evt) {
+
+    /* Make sure profile object is not NULL. */
+    g_return_if_fail(prof != NULL);
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Events can't be added after calculations are performed. */
+    if (prof->calc) return;
+
+    /* Create table of event names if required. */
+    if (prof->event_names == NULL)
+        prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+
+    /* Add event for profiling. */
+    ccl_prof_add_event(prof, cq_name, evt, &err_internal);
+    if (err_internal != NULL) {
+        g_info("The '%s' event was not profiled: %s",
+            ccl_event_get_final_name(evt), err_internal->message);
+        ccl_err_clear(&err_internal);
+    }
+}
+
 /**
  * @internal
  *
@@ -787,6 +830,9 @@ static void ccl_prof_process_queues(CCLProf * prof, CCLErr ** err) {
 
         /* Release queue events. */
         ccl_queue_gc((CCLQueue *) cq);
+
+        /* Events produced from now on are no longer profiled. */
+        ccl_queue_detach_profiler((CCLQueue *) cq, prof);
     }
 
     /* If we got here, everything is OK. */
@@ -1140,9 +1186,16 @@ void ccl_prof_destroy(CCLProf * prof) {
     if (prof->event_name_ids != NULL)
         g_hash_table_destroy(prof->event_name_ids);
 
-    /* Destroy table of command queue wrappers. */
-    if (prof->queues != NULL)
+    /* Detach profile object from command queues and destroy table of
+     * command queue wrappers. */
+    if (prof->queues != NULL) {
+        GHashTableIter iter;
+        gpointer cq;
+        g_hash_table_iter_init(&iter, prof->queues);
+        while (g_hash_table_iter_next(&iter, NULL, &cq))
+            ccl_queue_detach_profiler((CCLQueue *) cq, prof);
         g_hash_table_destroy(prof->queues);
+    }
 
     /* Destroy list of all event instants. */
     if (prof->instants != NULL)
@@ -1251,6 +1304,9 @@ void ccl_prof_add_queue(CCLProf * prof, const char * cq_name, CCLQueue * cq) {
     /* Must be added before calculations. */
     g_return_if_fail(prof->calc == FALSE);
 
+    /* Command queue being replaced, if any. */
+    CCLQueue * replaced;
+
     /* Check if table needs to be created first. */
     if (prof->queues == NULL) {
         prof->queues = g_hash_table_new_full(
@@ -1259,15 +1315,23 @@ void ccl_prof_add_queue(CCLProf * prof, const char * cq_name, CCLQueue * cq) {
     }
     /* Warn if table already contains a queue with the specified
      * name. */
-    if (g_hash_table_contains(prof->queues, cq_name))
+    replaced = g_hash_table_lookup(prof->queues, cq_name);
+    if (replaced != NULL) {
         g_warning("Profile object already contains a queue named '%s'." \
             "The existing queue will be replaced.", cq_name);
+        ccl_queue_detach_profiler(replaced, prof);
+    }
+
+    /* Increment queue ref. count. */
+    ccl_queue_ref(cq);
 
     /* Add queue to queue table. */
     g_hash_table_replace(prof->queues, (gpointer) cq_name, cq);
 
-    /* Increment queue ref. count. */
-    ccl_queue_ref(cq);
+    /* Queues whose event retention policy is
+     * CCL_QUEUE_EVTS_PROFILE_COMPLETED hand their completed events to this
+     * profile object. */
+    ccl_queue_attach_profiler(cq, prof, cq_name);
 }
 
 /**
@@ -1275,7 +1339,9 @@ void ccl_prof_add_queue(CCLProf * prof, const char * cq_name, CCLQueue * cq) {
  *
  * The command queues to be profiled will have their events garbage collected
  * with ::ccl_queue_gc(). As such, they can be reused and re-added for
- * profiling to a new profile object.
+ * profiling to a new profile object. Events previously released by command
+ * queues with a ::CCL_QUEUE_EVTS_PROFILE_COMPLETED event retention policy
+ * are also taken into account.
  *
  * @public @memberof ccl_prof
  *
@@ -1309,8 +1375,11 @@ cl_bool ccl_prof_calc(CCLProf * prof, CCLErr ** err) {
     /* Auxiliary pointers for determining the table of event_ids. */
     gpointer p_evt_name, p_id;
 
-    /* Create table of event names. */
-    prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+    /* Create table of event names, unless events were already collected
+     * from queues with a CCL_QUEUE_EVTS_PROFILE_COMPLETED event retention
+     * policy. */
+    if (prof->event_names == NULL)
+        prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
 
     /* Process queues and respective events. */
     ccl_prof_process_queues(prof, &err_internal);
@@ -70,6 +70,26 @@ struct ccl_program {
      * @private
      * */
     gchar * build_logs_concat;
+
+    /**
+     * OpenCL version of the associated platform, or 0 if not yet
+     * determined.
+     * @private
+     * */
+    volatile gint ocl_ver;
+
+    /**
+     * ID of the program in thread-local kernel caches, or 0 if not yet
+     * assigned.
+     * @private
+     * */
+    volatile gint thread_cache_id;
+
+    /**
+     * Kernels created for specific threads (list of ::CCLKernel*).
+     * @private
+     * */
+    GSList * volatile thread_krnls;
 };
 
 /**
@@ -145,6 +165,11 @@ static void ccl_program_release_fields(CCLProgram * prg) {
 
     }
 
+    /* Release kernels created for specific threads, and the thread-local
+     * caches which refer to them. */
+    ccl_wrapper_thread_cache_release(&prg->thread_cache_id);
+    g_slist_free_full(prg->thread_krnls, (GDestroyNotify) ccl_kernel_destroy);
+
     /* If the binaries table was created... */
     if (prg->binaries != NULL) {
 
@@ -1378,6 +1403,10 @@ cl_uint ccl_program_get_opencl_version(CCLProgram * prg, CCLErr ** err) {
     /* Make sure err is NULL or it is not set. */
     g_return_val_if_fail(err == NULL || *err == NULL, 0);
 
+    /* Return the OpenCL version if it was already determined. */
+    if (g_atomic_int_get(&prg->ocl_ver) > 0)
+        return (cl_uint) g_atomic_int_get(&prg->ocl_ver);
+
     cl_context context;
     CCLContext * ctx = NULL;
     CCLErr * err_internal = NULL;
@@ -1410,7 +1439,11 @@ error_handler:
 
 finish:
 
-    /* Return event wrapper. */
+    /* Keep OpenCL version, which doesn't change, for subsequent calls. */
+    if (ocl_ver > 0)
+        g_atomic_int_set(&prg->ocl_ver, (gint) ocl_ver);
+
+    /* Return OpenCL version, cached above unless an error occurred. */
     return ocl_ver;
 }
 
@@ -1422,8 +1455,9 @@ finish:
  * such, it must not be externally destroyed with ccl_kernel_destroy().
  *
  * @warning For multi-threaded handling and execution of the same kernel
- * function, create different kernel wrapper instances with the
- * ccl_kernel_new() function.
+ * function, get a different kernel wrapper instance for each thread with
+ * ccl_program_get_kernel_for_thread(), or create different kernel wrapper
+ * instances with the ccl_kernel_new() function.
  *
  * @public @memberof ccl_program
  *
@@ -1491,6 +1525,94 @@ finish:
     return krnl;
 }
 
+/**
+ * Get the calling thread's kernel wrapper object for the given program
+ * kernel function. This function returns the same kernel wrapper instance
+ * for each kernel function name when called from the same thread, and
+ * different instances when called from different threads.
+ *
+ * Since kernel arguments are kept in kernel objects, the kernel wrapper
+ * returned by ccl_program_get_kernel() can't be used by several threads at
+ * the same time. With this function, each thread gets its own kernel
+ * object, created with ccl_kernel_new() the first time the thread requests
+ * it, and found in a thread-local cache, without locking, in subsequent
+ * requests. Threads can thus set arguments and enqueue the same kernel
+ * function concurrently.
+ *
+ * The returned kernel wrapper object is automatically released when the
+ * program wrapper object is destroyed, and must not be externally destroyed
+ * with ccl_kernel_destroy(). Kernels created for threads which have
+ * exited are also only released with the program.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] kernel_name Name of kernel function.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The calling thread's kernel wrapper object for the given program
+ * kernel function.
+ * */
+CCL_EXPORT
+CCLKernel * ccl_program_get_kernel_for_thread(
+    CCLProgram * prg, const char * kernel_name, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+    /* Make sure prg is not NULL. */
+    g_return_val_if_fail(prg != NULL, NULL);
+    /* Make sure kernel_name is not NULL. */
+    g_return_val_if_fail(kernel_name != NULL, NULL);
+
+    /* Internal error reporting object. */
+    CCLErr * err_internal = NULL;
+    /* Kernel wrapper object. */
+    CCLKernel * krnl = NULL;
+    /* Thread-local cache of kernels of this program. */
+    GHashTable * cache;
+    /* Node for the list of kernels created for threads. */
+    GSList * node;
+
+    /* Check if the calling thread already has the requested kernel. */
+    cache = ccl_wrapper_thread_cache(
+        &prg->thread_cache_id, g_str_hash, g_str_equal, g_free);
+    krnl = g_hash_table_lookup(cache, kernel_name);
+
+    if (krnl == NULL) {
+
+        /* If not, create a new kernel wrapper for this thread. */
+        krnl = ccl_kernel_new(prg, kernel_name, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        /* Keep it in the thread-local cache. */
+        g_hash_table_insert(cache, g_strdup(kernel_name), krnl);
+
+        /* Keep it in the program, so it can be released with it. The list
+         * is shared by all threads, so add it without locking. */
+        node = g_slist_alloc();
+        node->data = krnl;
+        do {
+            node->next = g_atomic_pointer_get(&prg->thread_krnls);
+        } while (!g_atomic_pointer_compare_and_exchange(
+            &prg->thread_krnls, node->next, node));
+
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return kernel wrapper. */
+    return krnl;
+}
+
 /**
  * Enqueues a program kernel function for execution on a device. This is a
  * utility function which handles one kernel wrapper instance for each kernel
@@ -116,11 +116,13 @@
  * * ::ccl_program_get_build_info_array()
  * * ::ccl_program_get_build_info()
  *
- * For simple programs and kernels, the program wrapper module offers three
+ * For simple programs and kernels, the program wrapper module offers four
  * functions, which can be used after a program is built:
  *
  * * ::ccl_program_get_kernel() - Get the kernel wrapper object for the given
  *   program kernel function.
+ * * ::ccl_program_get_kernel_for_thread() - Get the calling thread's kernel
+ *   wrapper object for the given program kernel function.
  * * ::ccl_program_enqueue_kernel() - Enqueues a program kernel function for
  *   execution on a device, accepting kernel arguments as `NULL`-terminated
  *   variable list of parameters.
@@ -338,6 +340,12 @@ CCL_EXPORT
 CCLKernel * ccl_program_get_kernel(
     CCLProgram * prg, const char * kernel_name, CCLErr ** err);
 
+/* Get the calling thread's kernel wrapper object for the given program
+ * kernel function. */
+CCL_EXPORT
+CCLKernel * ccl_program_get_kernel_for_thread(
+    CCLProgram * prg, const char * kernel_name, CCLErr ** err);
+
 /* Enqueues a program kernel function for execution on a device. */
 CCL_EXPORT
 CCLEvent * ccl_program_enqueue_kernel(CCLProgram * prg,
@@ -26,9 +26,175 @@
  * */
 
 #include "ccl_queue_wrapper.h"
+#include "_ccl_queue_wrapper.h"
+#include "_ccl_profiler.h"
+#include "_ccl_event_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
 #include "_ccl_defs.h"
 
+/* Number of events kept in each chunk of the queue event log. */
+#define CCL_QUEUE_EVT_CHUNK_SIZE 256
+
+/* Number of pending readers of a memory object above which the completed
+ * ones are released by the hazard tracker. */
+#define CCL_QUEUE_HAZARD_READERS_MAX 32
+
+/**
+ * Chunk of the append-only log of events associated with a command queue.
+ * */
+struct ccl_queue_evt_chunk {
+
+    /**
+     * Next chunk in the log, or `NULL` if this is the last chunk.
+     * @private
+     * */
+    struct ccl_queue_evt_chunk * next;
+
+    /**
+     * Number of events in this chunk.
+     * @private
+     * */
+    guint count;
+
+    /**
+     * Events in this chunk, in the order they were produced.
+     * @private
+     * */
+    CCLEvent * evts[CCL_QUEUE_EVT_CHUNK_SIZE];
+
+};
+
+/**
+ * Pool of command queues, with one command queue per thread and device.
+ * */
+struct ccl_queue_pool {
+
+    /**
+     * Context of the command queues.
+     * @private
+     * */
+    CCLContext * ctx;
+
+    /**
+     * Properties of the command queues.
+     * @private
+     * */
+    cl_command_queue_properties properties;
+
+    /**
+     * ID of the pool in thread-local queue caches, or 0 if not yet
+     * assigned.
+     * @private
+     * */
+    volatile gint thread_cache_id;
+
+    /**
+     * Command queues created by the pool (list of ::CCLQueue*).
+     * @private
+     * */
+    GSList * volatile queues;
+
+};
+
+/**
+ * State of a memory object in the hazard tracker of a command queue.
+ * */
+struct ccl_queue_mem_state {
+
+    /**
+     * Event of the last command which wrote to the memory object, or
+     * `NULL`.
+     * @private
+     * */
+    cl_event writer;
+
+    /**
+     * Events of the commands which read from the memory object after the
+     * last write.
+     * @private
+     * */
+    GPtrArray * readers;
+
+};
+
+/**
+ * Flush policy and flush statistics of a command queue.
+ * */
+struct ccl_queue_flush {
+
+    /**
+     * Protects this structure, shared with the timer thread.
+     * @private
+     * */
+    GMutex mutex;
+
+    /**
+     * Signals the timer thread when commands become pending or when it
+     * should stop.
+     * @private
+     * */
+    GCond cond;
+
+    /**
+     * Timer thread, or `NULL` if there is no time-based trigger.
+     * @private
+     * */
+    GThread * timer;
+
+    /**
+     * Should the timer thread stop?
+     * @private
+     * */
+    gboolean stop;
+
+    /**
+     * Flush when this number of commands is pending, or 0.
+     * @private
+     * */
+    cl_uint max_cmds;
+
+    /**
+     * Flush when commands are pending for this number of microseconds,
+     * or 0.
+     * @private
+     * */
+    cl_ulong max_delay_us;
+
+    /**
+     * Flush when the estimated device time of pending commands reaches
+     * this number of nanoseconds, or 0.
+     * @private
+     * */
+    cl_ulong max_device_ns;
+
+    /**
+     * Number of commands enqueued since the last flush.
+     * @private
+     * */
+    cl_uint pending;
+
+    /**
+     * Monotonic time, in microseconds, at which the oldest pending command
+     * was enqueued.
+     * @private
+     * */
+    gint64 pending_since;
+
+    /**
+     * Moving average of the device time of commands, in nanoseconds, or 0
+     * if not yet known.
+     * @private
+     * */
+    cl_ulong avg_cmd_ns;
+
+    /**
+     * Flush statistics.
+     * @private
+     * */
+    CCLQueueFlushStats stats;
+
+};
+
 /**
  * Command queue wrapper class.
  *
@@ -55,584 +221,1607 @@ struct ccl_queue {
     CCLDevice * dev;
 
     /**
-     * Events associated with the command queue.
+     * First chunk of the log of events associated with the command queue.
+     * @private
+     * */
+    struct ccl_queue_evt_chunk * evts;
+
+    /**
+     * Last chunk of the log of events, where new events are appended.
+     * @private
+     * */
+    struct ccl_queue_evt_chunk * evts_last;
+
+    /**
+     * Empty chunk kept for reuse after the events are released.
+     * @private
+     * */
+    struct ccl_queue_evt_chunk * evts_spare;
+
+    /**
+     * Event iterator: current chunk.
+     * @private
+     * */
+    struct ccl_queue_evt_chunk * evt_iter_chunk;
+
+    /**
+     * Event iterator: index of next event in current chunk.
+     * @private
+     * */
+    guint evt_iter_idx;
+
+    /**
+     * Index of the oldest event in the first chunk of the event log.
+     * @private
+     * */
+    guint evts_first;
+
+    /**
+     * Number of events in the event log.
+     * @private
+     * */
+    guint num_evts;
+
+    /**
+     * Event retention policy.
+     * @private
+     * */
+    CCLQueueEvtRetention retention;
+
+    /**
+     * Maximum number of events, as specified with the retention policy.
+     * @private
+     * */
+    cl_uint max_evts;
+
+    /**
+     * Number of events in the event log which triggers the release of
+     * completed events.
+     * @private
+     * */
+    guint evts_check;
+
+    /**
+     * Profiler to which completed events are handed, or `NULL`.
+     * @private
+     * */
+    CCLProf * prof;
+
+    /**
+     * Name of the command queue in the profiler.
+     * @private
+     * */
+    const char * prof_name;
+
+    /**
+     * Is the command queue event-less?
+     * @private
+     * */
+    cl_bool event_less;
+
+    /**
+     * Flush policy and statistics, or `NULL` if no flush policy was ever
+     * set.
      * @private
      * */
-    GHashTable * evts;
+    struct ccl_queue_flush * flush;
 
     /**
-     * Event iterator.
+     * Hazard tracker, mapping memory objects to their state, or `NULL` if
+     * hazards are not tracked.
      * @private
      * */
-    GHashTableIter evt_iter;
+    GHashTable * hazards;
 };
 
 /**
  * @internal
  *
- * @brief Implementation of ccl_wrapper_release_fields() function for
- * ::CCLQueue wrapper objects.
+ * @brief Free a chunk of the event log, or keep it for reuse.
  *
  * @private @memberof ccl_queue
  *
- * @param[in] cq A ::CCLQueue wrapper object.
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] chunk Chunk, which no longer belongs to the event log.
  * */
-static void ccl_queue_release_fields(CCLQueue * cq) {
+static void ccl_queue_evt_chunk_free(
+    CCLQueue * cq, struct ccl_queue_evt_chunk * chunk) {
 
-    /* Make sure cq wrapper object is not NULL. */
-    g_return_if_fail(cq != NULL);
-
-    /* Decrease reference count of context and device wrappers, if
-     * they're set. */
-     if (cq->ctx != NULL)
-        ccl_context_unref(cq->ctx);
-     if (cq->dev != NULL)
-        ccl_device_unref(cq->dev);
-
-    /* Destroy the events table. */
-    if (cq->evts != NULL) {
-        g_hash_table_destroy(cq->evts);
-    }
+    if (cq->evts_spare == NULL)
+        cq->evts_spare = chunk;
+    else
+        g_slice_free(struct ccl_queue_evt_chunk, chunk);
 }
 
 /**
- * @addtogroup CCL_QUEUE_WRAPPER
- * @{
- */
+ * @internal
+ *
+ * @brief Release an event which is being removed from the event log,
+ * handing it to the attached profiler first if the retention policy
+ * requires it.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] evt Event wrapper to release.
+ * */
+static void ccl_queue_evt_release(CCLQueue * cq, CCLEvent * evt) {
+
+    if ((cq->retention == CCL_QUEUE_EVTS_PROFILE_COMPLETED)
+        && (cq->prof != NULL))
+
+        ccl_prof_collect_event(cq->prof, cq->prof_name, evt);
+
+    ccl_event_destroy(evt);
+}
 
 /**
- * Get the command queue wrapper for the given OpenCL command queue.
- *
- * If the wrapper doesn't exist, its created with a reference count of 1.
- * Otherwise, the existing wrapper is returned and its reference count is
- * incremented by 1.
+ * @internal
  *
- * This function will rarely be called from client code, except when clients
- * wish to create the OpenCL command queue directly (using the
- * clCreateCommandQueue() function) and then wrap the OpenCL command queue in a
- * ::CCLQueue wrapper object.
+ * @brief Release the oldest event in the event log.
  *
- * @public @memberof ccl_queue
+ * @private @memberof ccl_queue
  *
- * @param[in] command_queue The OpenCL command queue to be wrapped.
- * @return The ::CCLQueue wrapper for the given OpenCL command queue.
+ * @param[in] cq The command queue wrapper object, which must have events.
  * */
-CCL_EXPORT
-CCLQueue * ccl_queue_new_wrap(cl_command_queue command_queue) {
+static void ccl_queue_release_oldest(CCLQueue * cq) {
 
-    return (CCLQueue *) ccl_wrapper_new(
-        CCL_QUEUE, (void *) command_queue, sizeof(CCLQueue));
+    struct ccl_queue_evt_chunk * chunk = cq->evts;
+
+    ccl_queue_evt_release(cq, chunk->evts[cq->evts_first++]);
+    cq->num_evts--;
+
+    /* Remove first chunk if it no longer has events. */
+    if (cq->evts_first == chunk->count) {
+        cq->evts = chunk->next;
+        if (cq->evts == NULL) cq->evts_last = NULL;
+        cq->evts_first = 0;
+        ccl_queue_evt_chunk_free(cq, chunk);
+    }
+
+    /* Keep any ongoing iteration within the event log. */
+    if ((cq->evt_iter_chunk == chunk) && (cq->evts != chunk)) {
+        cq->evt_iter_chunk = cq->evts;
+        cq->evt_iter_idx = 0;
+    } else if ((cq->evt_iter_chunk == cq->evts)
+        && (cq->evt_iter_idx < cq->evts_first)) {
+        cq->evt_iter_idx = cq->evts_first;
+    }
 }
 
 /**
- * Create a new command queue wrapper object.
+ * @internal
  *
- * This function accepts a zero-terminated list of `cl_queue_properties`
- * (instead of the `cl_command_queue_properties` bitfield used in the
- * ::ccl_queue_new() constructor), following the behavior of the
- * clCreateCommandQueueWithProperties() function (OpenCL >= 2.0). The exact
- * OpenCL constructor used is automatically selected based on the OpenCL
- * version of the underlying platform (i.e. clCreateCommandQueue() if OpenCL <=
- * 1.2, or clCreateCommandQueueWithProperties() for OpenCL >= 2.0). However, if
- * OpenCL >= 2.0 only properties are specified and the underlying platform is
- * OpenCL <= 1.2, a warning will be logged, and the queue will be created with
- * OpenCL <= 1.2 properties only.
+ * @brief Release the completed events in the event log, compacting the
+ * remaining ones in place such that they keep their order.
  *
- * @public @memberof ccl_queue
+ * @private @memberof ccl_queue
  *
- * @param[in] ctx Context wrapper object.
- * @param[in] dev Device wrapper object, must be associated with `ctx`.
- * @param[in] prop_full A zero-terminated list of `cl_queue_properties`.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The ::CCLQueue wrapper for the given device and context, or `NULL`
- * if an error occurs.
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] all_complete `TRUE` if all events are known to be complete,
+ * in which case their execution status is not queried.
  * */
-CCL_EXPORT
-CCLQueue * ccl_queue_new_full(CCLContext * ctx, CCLDevice * dev,
-    const cl_queue_properties * prop_full, CCLErr ** err) {
-
-    /* Make sure ctx is not NULL. */
-    g_return_val_if_fail(ctx != NULL, NULL);
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+static void ccl_queue_release_completed(
+    CCLQueue * cq, gboolean all_complete) {
 
-    /* The OpenCL status flag. */
-    cl_int ocl_status;
-    /* The OpenCL command queue object. */
-    cl_command_queue queue = NULL;
-    /* The command queue wrapper object. */
-    CCLQueue * cq = NULL;
-    /* Internal error object. */
+    /* Chunks and indexes for reading and for writing remaining events. */
+    struct ccl_queue_evt_chunk * src, * dst = cq->evts, * next;
+    guint si = cq->evts_first, di = cq->evts_first;
+    /* Current event and its execution status. */
+    CCLEvent * evt;
+    cl_int status;
+    /* Number of remaining events. */
+    guint kept = 0;
+    /* Internal error handling object. */
     CCLErr * err_internal = NULL;
-    /* OpenCL <= 1.2 properties. */
-    cl_command_queue_properties properties = 0;
-    /* Are there any OpenCL >= 2.0 properties? */
-    cl_bool prop_other = CL_FALSE;
 
-    /* Extract <= 1.2 properties and initialize flag indicating if any >= 2.0
-     * properties are passed. */
-    if (prop_full != NULL) {
+    for (src = cq->evts; src != NULL; src = src->next, si = 0) {
+        for (; si < src->count; ++si) {
+
+            evt = src->evts[si];
+
+            /* Events which terminated abnormally are also released. Keep
+             * events whose status can't be determined. */
+            status = CL_COMPLETE;
+            if (!all_complete) {
+                status = ccl_event_get_info_scalar(evt,
+                    CL_EVENT_COMMAND_EXECUTION_STATUS, cl_int,
+                    &err_internal);
+                if (err_internal != NULL) {
+                    ccl_err_clear(&err_internal);
+                    status = CL_QUEUED;
+                }
+            }
 
-        /* Cycle through the prop_full array. */
+            if (status <= CL_COMPLETE) {
+                ccl_queue_evt_release(cq, evt);
+            } else {
+                if (di == CCL_QUEUE_EVT_CHUNK_SIZE) {
+                    dst = dst->next;
+                    di = 0;
+                }
+                dst->evts[di++] = evt;
+                kept++;
+            }
+        }
+    }
+
+    /* Free chunks which no longer have events. */
+    next = (kept > 0) ? dst->next : cq->evts;
+    for (src = next; src != NULL; src = next) {
+        next = src->next;
+        ccl_queue_evt_chunk_free(cq, src);
+    }
+    if (kept > 0) {
+        dst->count = di;
+        dst->next = NULL;
+        cq->evts_last = dst;
+    } else {
+        cq->evts = NULL;
+        cq->evts_last = NULL;
+        cq->evts_first = 0;
+    }
+    cq->num_evts = kept;
+
+    /* Invalidate any ongoing iteration. */
+    cq->evt_iter_chunk = NULL;
+    cq->evt_iter_idx = 0;
+}
+
+/**
+ * @internal
+ *
+ * @brief Apply the event retention policy.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] room Number of events about to be added to the event log.
+ * */
+static void ccl_queue_retain_events(CCLQueue * cq, guint room) {
+
+    switch (cq->retention) {
+        case CCL_QUEUE_EVTS_KEEP_LAST:
+            while ((cq->num_evts > 0)
+                && (cq->num_evts + room > cq->max_evts))
+                ccl_queue_release_oldest(cq);
+            break;
+        case CCL_QUEUE_EVTS_RELEASE_COMPLETED:
+        case CCL_QUEUE_EVTS_PROFILE_COMPLETED:
+            /* Only check events again once max_evts more events were
+             * produced, so that the cost of checking is amortized. */
+            if ((cq->max_evts > 0)
+                && (cq->num_evts + room > cq->evts_check)) {
+                ccl_queue_release_completed(cq, FALSE);
+                cq->evts_check = cq->num_evts + cq->max_evts;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Account for a flush of the pending commands of a command queue.
+ * Must be called with the flush policy mutex locked.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] fl Flush policy and statistics of the command queue.
+ * @param[in] counter Flush statistics counter to increment.
+ * */
+static void ccl_queue_flush_account(
+    struct ccl_queue_flush * fl, cl_ulong * counter) {
+
+    (*counter)++;
+
+    if (fl->pending > 0) {
+
+        /* Determine latency bin of the oldest pending command. */
+        gint64 latency = g_get_monotonic_time() - fl->pending_since;
+        guint bin = 0;
+        while ((bin < CCL_QUEUE_FLUSH_LATENCY_BINS - 1)
+            && (latency >= ((gint64) 1 << bin)))
+            bin++;
+
+        fl->stats.latency[bin]++;
+        fl->stats.commands += fl->pending;
+        fl->pending = 0;
+    }
+}
+
+/**
+ * @internal
+ *
+ * @brief Timer thread which flushes a command queue when commands have been
+ * pending for longer than allowed by the flush policy.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] data The command queue wrapper object.
+ * @return Always `NULL`.
+ * */
+static gpointer ccl_queue_flush_timer(gpointer data) {
+
+    CCLQueue * cq = (CCLQueue *) data;
+    struct ccl_queue_flush * fl = cq->flush;
+
+    g_mutex_lock(&fl->mutex);
+    while (!fl->stop) {
+        if (fl->pending == 0) {
+            /* Nothing to flush, wait until commands are enqueued. */
+            g_cond_wait(&fl->cond, &fl->mutex);
+        } else {
+            gint64 deadline =
+                fl->pending_since + (gint64) fl->max_delay_us;
+            if (g_get_monotonic_time() >= deadline) {
+                clFlush(ccl_queue_unwrap(cq));
+                ccl_queue_flush_account(fl, &fl->stats.by_time);
+            } else {
+                g_cond_wait_until(&fl->cond, &fl->mutex, deadline);
+            }
+        }
+    }
+    g_mutex_unlock(&fl->mutex);
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Stop the flush policy timer thread of a command queue, if it's
+ * running.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * */
+static void ccl_queue_flush_timer_stop(CCLQueue * cq) {
+
+    struct ccl_queue_flush * fl = cq->flush;
+
+    if ((fl == NULL) || (fl->timer == NULL)) return;
+
+    g_mutex_lock(&fl->mutex);
+    fl->stop = TRUE;
+    g_cond_signal(&fl->cond);
+    g_mutex_unlock(&fl->mutex);
+    g_thread_join(fl->timer);
+    fl->timer = NULL;
+    fl->stop = FALSE;
+
+    /* The timer thread kept its own reference to the OpenCL queue. */
+    clReleaseCommandQueue(ccl_queue_unwrap(cq));
+}
+
+/**
+ * @internal
+ *
+ * @brief Account for a flush requested by client code and, after a finish,
+ * update the estimated device time of commands.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] finished Was the command queue finished?
+ * */
+static void ccl_queue_flush_client(CCLQueue * cq, cl_bool finished) {
+
+    struct ccl_queue_flush * fl = cq->flush;
+    cl_ulong start, end;
+
+    if (fl == NULL) return;
+
+    g_mutex_lock(&fl->mutex);
+
+    ccl_queue_flush_account(fl, &fl->stats.by_client);
+
+    /* Sample the device time of the most recent command, if it has an
+     * event with profiling information. */
+    if (finished && (cq->num_evts > 0)) {
+        cl_event event = ccl_event_unwrap(
+            cq->evts_last->evts[cq->evts_last->count - 1]);
+        if ((clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                sizeof(cl_ulong), &start, NULL) == CL_SUCCESS)
+            && (clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                sizeof(cl_ulong), &end, NULL) == CL_SUCCESS)
+            && (end >= start)) {
+            fl->avg_cmd_ns = (fl->avg_cmd_ns == 0)
+                ? end - start
+                : (3 * fl->avg_cmd_ns + (end - start)) / 4;
+        }
+    }
+
+    g_mutex_unlock(&fl->mutex);
+}
+
+/**
+ * @internal
+ *
+ * @brief Destroy the hazard tracker state of a memory object, releasing
+ * the events it holds.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] data State of a memory object.
+ * */
+static void ccl_queue_mem_state_destroy(gpointer data) {
+
+    struct ccl_queue_mem_state * st = (struct ccl_queue_mem_state *) data;
+
+    if (st->writer != NULL) clReleaseEvent(st->writer);
+    for (guint i = 0; i < st->readers->len; ++i)
+        clReleaseEvent((cl_event) g_ptr_array_index(st->readers, i));
+    g_ptr_array_free(st->readers, TRUE);
+    g_slice_free(struct ccl_queue_mem_state, st);
+}
+
+/**
+ * @internal
+ *
+ * @brief Implementation of ccl_wrapper_release_fields() function for
+ * ::CCLQueue wrapper objects.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq A ::CCLQueue wrapper object.
+ * */
+static void ccl_queue_release_fields(CCLQueue * cq) {
+
+    /* Make sure cq wrapper object is not NULL. */
+    g_return_if_fail(cq != NULL);
+
+    /* Decrease reference count of context and device wrappers, if
+     * they're set. */
+     if (cq->ctx != NULL)
+        ccl_context_unref(cq->ctx);
+     if (cq->dev != NULL)
+        ccl_device_unref(cq->dev);
+
+    /* Release events and destroy the event log. */
+    ccl_queue_gc(cq);
+    if (cq->evts_spare != NULL)
+        g_slice_free(struct ccl_queue_evt_chunk, cq->evts_spare);
+
+    /* Destroy hazard tracker. */
+    if (cq->hazards != NULL)
+        g_hash_table_destroy(cq->hazards);
+
+    /* Destroy flush policy. */
+    if (cq->flush != NULL) {
+        ccl_queue_flush_timer_stop(cq);
+        g_mutex_clear(&cq->flush->mutex);
+        g_cond_clear(&cq->flush->cond);
+        g_slice_free(struct ccl_queue_flush, cq->flush);
+    }
+}
+
+/**
+ * @addtogroup CCL_QUEUE_WRAPPER
+ * @{
+ */
+
+/**
+ * Get the command queue wrapper for the given OpenCL command queue.
+ *
+ * If the wrapper doesn't exist, its created with a reference count of 1.
+ * Otherwise, the existing wrapper is returned and its reference count is
+ * incremented by 1.
+ *
+ * This function will rarely be called from client code, except when clients
+ * wish to create the OpenCL command queue directly (using the
+ * clCreateCommandQueue() function) and then wrap the OpenCL command queue in a
+ * ::CCLQueue wrapper object.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] command_queue The OpenCL command queue to be wrapped.
+ * @return The ::CCLQueue wrapper for the given OpenCL command queue.
+ * */
+CCL_EXPORT
+CCLQueue * ccl_queue_new_wrap(cl_command_queue command_queue) {
+
+    return (CCLQueue *) ccl_wrapper_new(
+        CCL_QUEUE, (void *) command_queue, sizeof(CCLQueue));
+}
+
+/**
+ * Create a new command queue wrapper object.
+ *
+ * This function accepts a zero-terminated list of `cl_queue_properties`
+ * (instead of the `cl_command_queue_properties` bitfield used in the
+ * ::ccl_queue_new() constructor), following the behavior of the
+ * clCreateCommandQueueWithProperties() function (OpenCL >= 2.0). The exact
+ * OpenCL constructor used is automatically selected based on the OpenCL
+ * version of the underlying platform (i.e. clCreateCommandQueue() if OpenCL <=
+ * 1.2, or clCreateCommandQueueWithProperties() for OpenCL >= 2.0). However, if
+ * OpenCL >= 2.0 only properties are specified and the underlying platform is
+ * OpenCL <= 1.2, a warning will be logged, and the queue will be created with
+ * OpenCL <= 1.2 properties only.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] ctx Context wrapper object.
+ * @param[in] dev Device wrapper object, must be associated with `ctx`.
+ * @param[in] prop_full A zero-terminated list of `cl_queue_properties`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The ::CCLQueue wrapper for the given device and context, or `NULL`
+ * if an error occurs.
+ * */
+CCL_EXPORT
+CCLQueue * ccl_queue_new_full(CCLContext * ctx, CCLDevice * dev,
+    const cl_queue_properties * prop_full, CCLErr ** err) {
+
+    /* Make sure ctx is not NULL. */
+    g_return_val_if_fail(ctx != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* The OpenCL status flag. */
+    cl_int ocl_status;
+    /* The OpenCL command queue object. */
+    cl_command_queue queue = NULL;
+    /* The command queue wrapper object. */
+    CCLQueue * cq = NULL;
+    /* Internal error object. */
+    CCLErr * err_internal = NULL;
+    /* OpenCL <= 1.2 properties. */
+    cl_command_queue_properties properties = 0;
+    /* Are there any OpenCL >= 2.0 properties? */
+    cl_bool prop_other = CL_FALSE;
+
+    /* Extract <= 1.2 properties and initialize flag indicating if any >= 2.0
+     * properties are passed. */
+    if (prop_full != NULL) {
+
+        /* Cycle through the prop_full array. */
         for (cl_uint i = 0; prop_full[i] != 0; i = i + 2) {
 
-            /* Check if current property name is known in OpenCL <= 1.2. */
-            if (prop_full[i] == CL_QUEUE_PROPERTIES) {
+            /* Check if current property name is known in OpenCL <= 1.2. */
+            if (prop_full[i] == CL_QUEUE_PROPERTIES) {
+
+                /* Yes, current property name (CL_QUEUE_PROPERTIES) is known in
+                 * OpenCL <= 1.2. */
+                properties = prop_full[i + 1];
+
+            } else {
+
+                /* No, current property name is valid only for OpenCL >= 2.0. */
+                prop_other = CL_TRUE;
+            }
+        }
+
+        /* Check if all values in the CL_QUEUE_PROPERTIES bitfield are known
+         * in OpenCL <= 1.2. */
+        if ((properties &
+            ~(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
+            CL_QUEUE_PROFILING_ENABLE)) != 0) {
+
+            /* There are values in the CL_QUEUE_PROPERTIES bitfield which
+             * require OpenCL >= 2.0. */
+            prop_other = CL_TRUE;
+        }
+    }
+
+    /* If dev is NULL, get first device in context. */
+    if (dev == NULL) {
+        dev = ccl_context_get_device(ctx, 0, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    }
+
+#ifdef CL_VERSION_2_0
+
+    /* OpenCL platform version of the given context. */
+    double platf_ver;
+
+    /* Get context platform version. */
+    platf_ver = ccl_context_get_opencl_version(ctx, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* Create and keep the OpenCL command queue object. */
+    if (platf_ver >= 200) {
+
+        /* Platform is OpenCL >= 2.0 and supports
+         * clCreateCommandQueueWithProperties(). */
+        queue = clCreateCommandQueueWithProperties(
+            ccl_context_unwrap(ctx), ccl_device_unwrap(dev),
+            prop_full, &ocl_status);
+
+    } else {
+
+        /* Platform is OpenCL <= 1.2 and we should use
+         * clCreateCommandQueue(). */
+
+        /* Where any OpenCL >= 2.0 property names or values specified? */
+        if (prop_other) {
+
+            /* If so, log warning and ignore them. */
+            g_warning("OpenCL >= 2.0 queue properties are not supported by "
+                "the selected OpenCL platform and will be ignored.");
+            properties = properties &
+                (CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
+                CL_QUEUE_PROFILING_ENABLE);
+        }
+
+        /* Create queue with clCreateCommandQueue(). */
+        CCL_BEGIN_IGNORE_DEPRECATIONS
+        queue = clCreateCommandQueue(ccl_context_unwrap(ctx),
+            ccl_device_unwrap(dev), properties, &ocl_status);
+        CCL_END_IGNORE_DEPRECATIONS
+    }
+
+#else
+
+    /* Were any OpenCL >= 2.0 property names or values specified? */
+    if (prop_other) {
+
+        /* If so, log warning and ignore them. */
+        g_warning("OpenCL >= 2.0 queue properties are not supported by "
+            "the selected OpenCL platform and will be ignored.");
+        properties = properties &
+            (CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
+            CL_QUEUE_PROFILING_ENABLE);
+    }
+
+    /* Create queue with clCreateCommandQueue(). */
+    queue = clCreateCommandQueue(ccl_context_unwrap(ctx),
+        ccl_device_unwrap(dev), properties, &ocl_status);
+
+#endif
+
+    /* Check for errors in queue creation. */
+    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
+        CL_SUCCESS != ocl_status, ocl_status, error_handler,
+        "%s: unable to create queue (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+    /* Wrap the queue. */
+    cq = ccl_queue_new_wrap(queue);
+
+    /* Keep the context and device wrappers, update their reference
+     * count. */
+    cq->ctx = ctx;
+    ccl_context_ref(ctx);
+    cq->dev = dev;
+    ccl_device_ref(dev);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return the new command queue wrapper object. */
+    return cq;
+}
+
+/**
+ * Create a new command queue wrapper object.
+ *
+ * This function accepts a `cl_command_queue_properties` bitfield  of command
+ * queue properties, mimicking the behavior of the OpenCL
+ * clCreateCommandQueue() constructor (deprecated in OpenCL 2.0). The exact
+ * OpenCL constructor used is automatically selected based on the OpenCL
+ * version of the underlying platform (i.e. clCreateCommandQueue() if OpenCL <=
+ * 1.2, or clCreateCommandQueueWithProperties() for OpenCL >= 2.0).
+ *
+ * To specify OpenCL >= 2.0 only features, such as on-device queue size, use
+ * the ::ccl_queue_new_full() constructor.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] ctx Context wrapper object.
+ * @param[in] dev Device wrapper object, must be associated with `ctx`.
+ * @param[in] properties Bitfield of command queue properties.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The ::CCLQueue wrapper for the given device and context, or `NULL`
+ * if an error occurs.
+ * */
+CCL_EXPORT
+CCLQueue * ccl_queue_new(CCLContext * ctx, CCLDevice * dev,
+    cl_command_queue_properties properties, CCLErr ** err) {
+
+    const cl_queue_properties prop_full[] =
+        { CL_QUEUE_PROPERTIES, properties, 0 };
+
+    return ccl_queue_new_full(ctx, dev, prop_full, err);
+}
+
+/**
+ * Decrements the reference count of the command queue wrapper object. If it
+ * reaches 0, the command queue wrapper object is destroyed.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * */
+CCL_EXPORT
+void ccl_queue_destroy(CCLQueue * cq) {
+
+    ccl_wrapper_unref((CCLWrapper *) cq, sizeof(CCLQueue),
+        (ccl_wrapper_release_fields) ccl_queue_release_fields,
+        (ccl_wrapper_release_cl_object) clReleaseCommandQueue, NULL);
+}
+
+/**
+ * Get the context associated with the given command queue wrapper object.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The context associated with the given command queue wrapper object,
+ * or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLContext * ccl_queue_get_context(CCLQueue * cq, CCLErr ** err) {
+
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    CCLContext * ctx = NULL;
+
+    /* Internal error object. */
+    CCLErr * err_internal = NULL;
+
+    /* Check if context wrapper is already kept by the queue wrapper. */
+    if (cq->ctx != NULL) {
+        /* If so, return it. */
+        ctx = cq->ctx;
+    } else {
+        /* Otherwise, get it using a query. */
+        CCLWrapperInfo * info = NULL;
+        info = ccl_queue_get_info(cq, CL_QUEUE_CONTEXT, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        ctx = ccl_context_new_wrap(*((cl_context *) info->value));
+        cq->ctx = ctx;
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return the command queue context wrapper. */
+    return ctx;
+}
+
+/**
+ * Get the device associated with the given command queue wrapper object.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The device associated with the given command queue wrapper object,
+ * or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLDevice * ccl_queue_get_device(CCLQueue * cq, CCLErr ** err) {
+
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* The device wrapper object to return. */
+    CCLDevice * dev = NULL;
+
+    /* Internal error object. */
+    CCLErr * err_internal = NULL;
+
+    /* Check if device wrapper is already kept by the queue wrapper. */
+    if (cq->dev != NULL) {
+        /* If so, return it. */
+        dev = cq->dev;
+    } else {
+        /* Otherwise, get it using a query. */
+        CCLWrapperInfo * info = NULL;
+        info = ccl_queue_get_info(cq, CL_QUEUE_DEVICE, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        dev = ccl_device_new_wrap(*((cl_device_id *) info->value));
+        cq->dev = dev;
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return the command queue device wrapper object. */
+    return dev;
+}
+
+/**
+ * @brief Create an event wrapper from a given OpenCL event object and
+ * associate it with the command queue.
+ *
+ * This function is used by the `ccl_*_enqueue_*()` functions and will rarely
+ * be called from client code.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] event The OpenCL event to wrap and associate with the given
+ * command queue.
+ * @return The event wrapper object for the given OpenCL event object.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_queue_produce_event(CCLQueue * cq, cl_event event) {
+
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
+    /* Make sure event is not NULL. */
+    g_return_val_if_fail(event != NULL, NULL);
+
+    /* Wrap the OpenCL event. */
+    CCLEvent * evt = ccl_event_new_wrap(event);
+
+    /* Last chunk of the event log. */
+    struct ccl_queue_evt_chunk * chunk;
+
+    /* If the event was already wrapped, it may already be associated
+     * with this command queue, in which case the extra reference is
+     * dropped. */
+    if (ccl_wrapper_ref_count((CCLWrapper *) evt) > 1) {
+        for (struct ccl_queue_evt_chunk * c = cq->evts; c != NULL;
+            c = c->next) {
+            for (guint i = (c == cq->evts) ? cq->evts_first : 0;
+                i < c->count; ++i) {
+                if (c->evts[i] == evt) {
+                    ccl_event_destroy(evt);
+                    return evt;
+                }
+            }
+        }
+    }
+
+    /* Release older events if required by the retention policy. This is
+     * done before appending the new event so that the event returned to
+     * the caller is never released here. */
+    ccl_queue_retain_events(cq, 1);
+
+    /* Start a new chunk if the last one is full or if there isn't one. */
+    chunk = cq->evts_last;
+    if ((chunk == NULL) || (chunk->count == CCL_QUEUE_EVT_CHUNK_SIZE)) {
+
+        /* Reuse spare chunk if available. */
+        if (cq->evts_spare != NULL) {
+            chunk = cq->evts_spare;
+            cq->evts_spare = NULL;
+        } else {
+            chunk = g_slice_new(struct ccl_queue_evt_chunk);
+        }
+        chunk->next = NULL;
+        chunk->count = 0;
+
+        /* Link it at the end of the event log. */
+        if (cq->evts_last != NULL)
+            cq->evts_last->next = chunk;
+        else
+            cq->evts = chunk;
+        cq->evts_last = chunk;
+    }
+
+    /* Append the wrapped event to the event log of this command queue. */
+    chunk->evts[chunk->count++] = evt;
+    cq->num_evts++;
+
+    /* Return the wrapped event. */
+    return evt;
+}
+
+/**
+ * Initialize an iterator for this command queue's list of event wrappers. The
+ * event wrappers can be iterated in a loop using the
+ * ccl_queue_iter_event_next() function, in the order they were produced.
+ *
+ * This function is used by @ref CCL_PROFILER "profile module" functions and
+ * will rarely be called from client code.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ *
+ * */
+CCL_EXPORT
+void ccl_queue_iter_event_init(CCLQueue * cq) {
+
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
+
+    /* Initialize iterator. */
+    cq->evt_iter_chunk = cq->evts;
+    cq->evt_iter_idx = cq->evts_first;
+}
+
+/**
+ * Get the next event wrapper associated with this queue.
+ *
+ * This function is used by @ref CCL_PROFILER "profile module" functions and
+ * will rarely be called from client code.
+ *
+ * @attention Calling this before ccl_queue_iter_event_init() is undefined
+ * behavior.
+ * @warning This function is not thread-safe.
+ * @warning No events should be enqueued on this queue while the iteration is
+ * ongoing.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @return The next event wrapper associated with this queue, or `NULL` if no
+ * more event wrappers are available.
+ * */
+CCL_EXPORT
+CCLEvent * ccl_queue_iter_event_next(CCLQueue * cq) {
+
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, NULL);
 
-                /* Yes, current property name (CL_QUEUE_PROPERTIES) is known in
-                 * OpenCL <= 1.2. */
-                properties = prop_full[i + 1];
+    /* Skip to the next chunk if the current one is exhausted. */
+    while ((cq->evt_iter_chunk != NULL)
+        && (cq->evt_iter_idx >= cq->evt_iter_chunk->count)) {
 
-            } else {
+        cq->evt_iter_chunk = cq->evt_iter_chunk->next;
+        cq->evt_iter_idx = 0;
+    }
 
-                /* No, current property name is valid only for OpenCL >= 2.0. */
-                prop_other = CL_TRUE;
-            }
-        }
+    return cq->evt_iter_chunk != NULL
+        ? cq->evt_iter_chunk->evts[cq->evt_iter_idx++]
+        : NULL;
+}
 
-        /* Check if all values in the CL_QUEUE_PROPERTIES bitfield are known
-         * in OpenCL <= 1.2. */
-        if ((properties &
-            ~(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
-            CL_QUEUE_PROFILING_ENABLE)) != 0) {
+/**
+ * Issues all previously queued commands in a command queue to the associated
+ * device. This function is a wrapper for the clFlush() OpenCL function.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_queue_flush(CCLQueue * cq, CCLErr ** err) {
 
-            /* There are values in the CL_QUEUE_PROPERTIES bitfield which
-             * require OpenCL >= 2.0. */
-            prop_other = CL_TRUE;
-        }
-    }
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_INT_MAX);
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, CL_INVALID_COMMAND_QUEUE);
 
-    /* If dev is NULL, get first device in context. */
-    if (dev == NULL) {
-        dev = ccl_context_get_device(ctx, 0, &err_internal);
-        ccl_if_err_propagate_goto(err, err_internal, error_handler);
-    }
+    /* OpenCL status flag. */
+    cl_int ocl_status;
 
-#ifdef CL_VERSION_2_0
+    /* Flush queue. */
+    ocl_status = clFlush(ccl_queue_unwrap(cq));
+    if (ocl_status != CL_SUCCESS)
+        g_set_error(err, CCL_OCL_ERROR, ocl_status,
+            "%s: unable to flush queue (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-    /* OpenCL platform version of the given context. */
-    double platf_ver;
+    else {
 
-    /* Get context platform version. */
-    platf_ver = ccl_context_get_opencl_version(ctx, &err_internal);
-    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        /* Update flush statistics. */
+        ccl_queue_flush_client(cq, CL_FALSE);
 
-    /* Create and keep the OpenCL command queue object. */
-    if (platf_ver >= 200) {
+        /* Release completed events if required by the retention
+         * policy. */
+        if ((cq->retention == CCL_QUEUE_EVTS_RELEASE_COMPLETED)
+            || (cq->retention == CCL_QUEUE_EVTS_PROFILE_COMPLETED))
+            ccl_queue_release_completed(cq, FALSE);
+    }
 
-        /* Platform is OpenCL >= 2.0 and supports
-         * clCreateCommandQueueWithProperties(). */
-        queue = clCreateCommandQueueWithProperties(
-            ccl_context_unwrap(ctx), ccl_device_unwrap(dev),
-            prop_full, &ocl_status);
+    /* Return status. */
+    return ocl_status == CL_SUCCESS ? CL_TRUE : CL_FALSE;
+}
 
-    } else {
+/**
+ * Blocks until all previously queued OpenCL commands in a command-queue are
+ * issued to the associated device and have completed. This function is a
+ * wrapper for the clFinish() OpenCL function.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_queue_finish(CCLQueue * cq, CCLErr ** err) {
 
-        /* Platform is OpenCL <= 1.2 and we should use
-         * clCreateCommandQueue(). */
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_INT_MAX);
+    /* Make sure cq is not NULL. */
+    g_return_val_if_fail(cq != NULL, CL_INVALID_COMMAND_QUEUE);
 
-        /* Where any OpenCL >= 2.0 property names or values specified? */
-        if (prop_other) {
+    /* OpenCL status flag. */
+    cl_int ocl_status;
 
-            /* If so, log warning and ignore them. */
-            g_warning("OpenCL >= 2.0 queue properties are not supported by "
-                "the selected OpenCL platform and will be ignored.");
-            properties = properties &
-                (CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
-                CL_QUEUE_PROFILING_ENABLE);
-        }
+    /* Finish queue. */
+    ocl_status = clFinish(ccl_queue_unwrap(cq));
+    if (ocl_status != CL_SUCCESS)
+        g_set_error(err, CCL_OCL_ERROR, ocl_status,
+            "%s: unable to finish queue (OpenCL error %d: %s).",
+        CCL_STRD, ocl_status, ccl_err(ocl_status));
 
-        /* Create queue with clCreateCommandQueue(). */
-        CCL_BEGIN_IGNORE_DEPRECATIONS
-        queue = clCreateCommandQueue(ccl_context_unwrap(ctx),
-            ccl_device_unwrap(dev), properties, &ocl_status);
-        CCL_END_IGNORE_DEPRECATIONS
-    }
+    else {
 
-#else
+        /* Update flush statistics and estimated command device time. */
+        ccl_queue_flush_client(cq, CL_TRUE);
 
-    /* Were any OpenCL >= 2.0 property names or values specified? */
-    if (prop_other) {
+        /* All commands are complete, so there are no hazards left. */
+        if (cq->hazards != NULL)
+            g_hash_table_remove_all(cq->hazards);
 
-        /* If so, log warning and ignore them. */
-        g_warning("OpenCL >= 2.0 queue properties are not supported by "
-            "the selected OpenCL platform and will be ignored.");
-        properties = properties &
-            (CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE |
-            CL_QUEUE_PROFILING_ENABLE);
+        /* Release events if required by the retention policy. All events
+         * are complete at this point. */
+        if ((cq->retention == CCL_QUEUE_EVTS_RELEASE_COMPLETED)
+            || (cq->retention == CCL_QUEUE_EVTS_PROFILE_COMPLETED))
+            ccl_queue_release_completed(cq, TRUE);
     }
 
-    /* Create queue with clCreateCommandQueue(). */
-    queue = clCreateCommandQueue(ccl_context_unwrap(ctx),
-        ccl_device_unwrap(dev), properties, &ocl_status);
+    /* Return status. */
+    return ocl_status == CL_SUCCESS ? CL_TRUE : CL_FALSE;
+}
 
-#endif
+/**
+ * Release all events associated with the command queue.
+ *
+ * _cf4ocl_ command queue wrappers internally keep events for profiling
+ * purposes and simpler handling of event associated memory. However, a very
+ * large number of events can have an impact on utilized memory. In such cases,
+ * this function can be used to periodically release these events.
+ * Alternatively, an event retention policy can be set with
+ * ::ccl_queue_set_event_retention().
+ *
+ * This function is also called by the ::ccl_prof_calc() function, i.e., the
+ * queue events are released after the profiling analysis is performed.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * */
+CCL_EXPORT
+void ccl_queue_gc(CCLQueue * cq) {
 
-    /* Check for errors in queue creation. */
-    ccl_if_err_create_goto(*err, CCL_OCL_ERROR,
-        CL_SUCCESS != ocl_status, ocl_status, error_handler,
-        "%s: unable to create queue (OpenCL error %d: %s).",
-        CCL_STRD, ocl_status, ccl_err(ocl_status));
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
 
-    /* Wrap the queue. */
-    cq = ccl_queue_new_wrap(queue);
+    /* Chunk being released. */
+    struct ccl_queue_evt_chunk * chunk;
 
-    /* Keep the context and device wrappers, update their reference
-     * count. */
-    cq->ctx = ctx;
-    ccl_context_ref(ctx);
-    cq->dev = dev;
-    ccl_device_ref(dev);
+    /* Release events, chunk by chunk. */
+    while (cq->evts != NULL) {
 
-    /* If we got here, everything is OK. */
-    g_assert(err == NULL || *err == NULL);
-    goto finish;
+        chunk = cq->evts;
+        cq->evts = chunk->next;
 
-error_handler:
-    /* If we got here there was an error, verify that it is so. */
-    g_assert(err == NULL || *err != NULL);
+        for (guint i = cq->evts_first; i < chunk->count; ++i)
+            ccl_event_destroy(chunk->evts[i]);
+        cq->evts_first = 0;
 
-finish:
+        /* Keep one chunk for reuse, free the others. */
+        ccl_queue_evt_chunk_free(cq, chunk);
+    }
+    cq->evts_last = NULL;
+    cq->num_evts = 0;
+    cq->evts_check = cq->max_evts;
 
-    /* Return the new command queue wrapper object. */
-    return cq;
+    /* Invalidate any ongoing iteration. */
+    cq->evt_iter_chunk = NULL;
+    cq->evt_iter_idx = 0;
 }
 
 /**
- * Create a new command queue wrapper object.
+ * Set the policy for retaining events associated with the command queue.
  *
- * This function accepts a `cl_command_queue_properties` bitfield  of command
- * queue properties, mimicking the behavior of the OpenCL
- * clCreateCommandQueue() constructor (deprecated in OpenCL 2.0). The exact
- * OpenCL constructor used is automatically selected based on the OpenCL
- * version of the underlying platform (i.e. clCreateCommandQueue() if OpenCL <=
- * 1.2, or clCreateCommandQueueWithProperties() for OpenCL >= 2.0).
+ * By default, command queue wrappers keep all events until
+ * ::ccl_queue_gc() is called or the queue is destroyed, which is not
+ * appropriate for long-running programs. The following policies are
+ * available:
  *
- * To specify OpenCL >= 2.0 only features, such as on-device queue size, use
- * the ::ccl_queue_new_full() constructor.
+ * * ::CCL_QUEUE_EVTS_KEEP_ALL - Keep all events (default).
+ * * ::CCL_QUEUE_EVTS_KEEP_LAST - Keep only the last `max_evts` events,
+ * which must be larger than zero; older events are released as new ones
+ * are produced.
+ * * ::CCL_QUEUE_EVTS_RELEASE_COMPLETED - Release completed events when
+ * the queue is flushed or finished with ::ccl_queue_flush() or
+ * ::ccl_queue_finish(). If `max_evts` is not zero, completed events are
+ * also released every time `max_evts` new events are produced.
+ * * ::CCL_QUEUE_EVTS_PROFILE_COMPLETED - Same as
+ * ::CCL_QUEUE_EVTS_RELEASE_COMPLETED, but completed events are handed to
+ * the profiler to which the queue was added with ::ccl_prof_add_queue()
+ * before being released.
+ *
+ * Event wrappers released due to the retention policy are no longer
+ * valid, so clients should not keep them if such a policy is in effect.
  *
  * @public @memberof ccl_queue
  *
- * @param[in] ctx Context wrapper object.
- * @param[in] dev Device wrapper object, must be associated with `ctx`.
- * @param[in] properties Bitfield of command queue properties.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The ::CCLQueue wrapper for the given device and context, or `NULL`
- * if an error occurs.
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] retention Event retention policy.
+ * @param[in] max_evts Maximum number of events, with the meaning given
+ * above.
  * */
 CCL_EXPORT
-CCLQueue * ccl_queue_new(CCLContext * ctx, CCLDevice * dev,
-    cl_command_queue_properties properties, CCLErr ** err) {
+void ccl_queue_set_event_retention(CCLQueue * cq,
+    CCLQueueEvtRetention retention, cl_uint max_evts) {
 
-    const cl_queue_properties prop_full[] =
-        { CL_QUEUE_PROPERTIES, properties, 0 };
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
+    /* Make sure at least one event is kept with CCL_QUEUE_EVTS_KEEP_LAST. */
+    g_return_if_fail((retention != CCL_QUEUE_EVTS_KEEP_LAST)
+        || (max_evts > 0));
 
-    return ccl_queue_new_full(ctx, dev, prop_full, err);
+    cq->retention = retention;
+    cq->max_evts = max_evts;
+    cq->evts_check = max_evts;
+
+    /* Apply policy to existing events. */
+    ccl_queue_retain_events(cq, 0);
 }
 
 /**
- * Decrements the reference count of the command queue wrapper object. If it
- * reaches 0, the command queue wrapper object is destroyed.
+ * Enable or disable event-less mode for the command queue.
+ *
+ * By default, enqueue functions request an event from the OpenCL
+ * implementation, which is wrapped and associated with the command queue,
+ * and returned to the caller. For very large numbers of short commands,
+ * this bookkeeping can be as costly as the commands themselves. In
+ * event-less mode, the `ccl_buffer_enqueue_*()`, `ccl_image_enqueue_*()`,
+ * `ccl_memobj_enqueue_*()` and `ccl_kernel_enqueue_*()` functions (and
+ * functions based on them) do not request events. As such, these
+ * functions return `NULL` (map functions set their event output to
+ * `NULL`), errors being reported only through the `err` parameter, and the
+ * respective commands will not be profiled.
+ *
+ * Markers and barriers enqueued with ::ccl_enqueue_marker() and
+ * ::ccl_enqueue_barrier() always produce events, and can be used when a
+ * dependency on previously enqueued commands is required. Event-less mode
+ * can also be enabled for a single enqueue operation by enabling it just
+ * before the operation and disabling it afterwards.
  *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
+ * @param[in] event_less `CL_TRUE` to enable event-less mode, `CL_FALSE`
+ * to disable it.
  * */
 CCL_EXPORT
-void ccl_queue_destroy(CCLQueue * cq) {
+void ccl_queue_set_event_less(CCLQueue * cq, cl_bool event_less) {
 
-    ccl_wrapper_unref((CCLWrapper *) cq, sizeof(CCLQueue),
-        (ccl_wrapper_release_fields) ccl_queue_release_fields,
-        (ccl_wrapper_release_cl_object) clReleaseCommandQueue, NULL);
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
+
+    cq->event_less = event_less;
 }
 
 /**
- * Get the context associated with the given command queue wrapper object.
+ * Is event-less mode enabled for the command queue?
  *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The context associated with the given command queue wrapper object,
- * or `NULL` if an error occurs.
+ * @return `CL_TRUE` if event-less mode is enabled, `CL_FALSE` otherwise.
  * */
 CCL_EXPORT
-CCLContext * ccl_queue_get_context(CCLQueue * cq, CCLErr ** err) {
+cl_bool ccl_queue_is_event_less(CCLQueue * cq) {
 
     /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, NULL);
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
-
-    CCLContext * ctx = NULL;
-
-    /* Internal error object. */
-    CCLErr * err_internal = NULL;
-
-    /* Check if context wrapper is already kept by the queue wrapper. */
-    if (cq->ctx != NULL) {
-        /* If so, return it. */
-        ctx = cq->ctx;
-    } else {
-        /* Otherwise, get it using a query. */
-        CCLWrapperInfo * info = NULL;
-        info = ccl_queue_get_info(cq, CL_QUEUE_CONTEXT, &err_internal);
-        ccl_if_err_propagate_goto(err, err_internal, error_handler);
-        ctx = ccl_context_new_wrap(*((cl_context *) info->value));
-        cq->ctx = ctx;
-    }
+    g_return_val_if_fail(cq != NULL, CL_FALSE);
 
-    /* If we got here, everything is OK. */
-    g_assert(err == NULL || *err == NULL);
-    goto finish;
+    return cq->event_less;
+}
 
-error_handler:
-    /* If we got here there was an error, verify that it is so. */
-    g_assert(err == NULL || *err != NULL);
+/**
+ * Enable or disable automatic hazard tracking for the command queue.
+ *
+ * Commands in out-of-order command queues only wait for the events in
+ * their event wait lists. With hazard tracking, the command queue keeps
+ * track of the memory objects read and written by the commands enqueued
+ * with _cf4ocl_ functions, and adds the events of previous commands which
+ * must complete first to the event wait list of each new command:
+ *
+ * * A command which reads a memory object waits for the last command
+ * which wrote to it (read-after-write).
+ * * A command which writes to a memory object waits for the last command
+ * which wrote to it (write-after-write) and for the commands which read
+ * from it since then (write-after-read).
+ *
+ * Independent commands can thus execute concurrently, without manually
+ * built event wait lists. Buffer and image transfers, copies, fills, maps,
+ * unmaps and migrations declare the memory objects they access. Kernel
+ * executions declare the memory objects set as kernel arguments. Kernel
+ * arguments are considered read-only if they're declared `__constant`,
+ * `const`, or `read_only` (images), as reported by
+ * `clGetKernelArgInfo()`; otherwise, or if such information is
+ * unavailable (OpenCL < 1.2 or programs built without
+ * `-cl-kernel-arg-info`), they're considered to be written to. Native
+ * kernels are considered to write to all memory objects they receive.
+ *
+ * Only commands enqueued in this command queue are tracked; dependencies
+ * on commands in other queues must still be specified explicitly, as must
+ * dependencies of commands replayed from a ::CCLGraph*. The tracker
+ * retains the events of the commands it tracks until they are superseded,
+ * until the queue is finished with ::ccl_queue_finish(), or until hazard
+ * tracking is disabled. Event-less mode has no effect while hazards are
+ * tracked.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] track `CL_TRUE` to enable hazard tracking, `CL_FALSE` to
+ * disable it.
+ * */
+CCL_EXPORT
+void ccl_queue_set_hazard_tracking(CCLQueue * cq, cl_bool track) {
 
-finish:
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
 
-    /* Return the command queue context wrapper. */
-    return ctx;
+    if (track && (cq->hazards == NULL)) {
+        cq->hazards = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, ccl_queue_mem_state_destroy);
+    } else if (!track && (cq->hazards != NULL)) {
+        g_hash_table_destroy(cq->hazards);
+        cq->hazards = NULL;
+    }
 }
 
 /**
- * Get the device associated with the given command queue wrapper object.
+ * Does the command queue track hazards?
  *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The device associated with the given command queue wrapper object,
- * or `NULL` if an error occurs.
+ * @return `CL_TRUE` if hazard tracking is enabled, `CL_FALSE` otherwise.
  * */
 CCL_EXPORT
-CCLDevice * ccl_queue_get_device(CCLQueue * cq, CCLErr ** err) {
+cl_bool ccl_queue_has_hazard_tracking(CCLQueue * cq) {
 
     /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, NULL);
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
-
-    /* The device wrapper object to return. */
-    CCLDevice * dev = NULL;
-
-    /* Internal error object. */
-    CCLErr * err_internal = NULL;
-
-    /* Check if device wrapper is already kept by the queue wrapper. */
-    if (cq->dev != NULL) {
-        /* If so, return it. */
-        dev = cq->dev;
-    } else {
-        /* Otherwise, get it using a query. */
-        CCLWrapperInfo * info = NULL;
-        info = ccl_queue_get_info(cq, CL_QUEUE_DEVICE, &err_internal);
-        ccl_if_err_propagate_goto(err, err_internal, error_handler);
-        dev = ccl_device_new_wrap(*((cl_device_id *) info->value));
-        cq->dev = dev;
-    }
-
-    /* If we got here, everything is OK. */
-    g_assert(err == NULL || *err == NULL);
-    goto finish;
-
-error_handler:
-    /* If we got here there was an error, verify that it is so. */
-    g_assert(err == NULL || *err != NULL);
-
-finish:
+    g_return_val_if_fail(cq != NULL, CL_FALSE);
 
-    /* Return the command queue device wrapper object. */
-    return dev;
+    return (cq->hazards != NULL) ? CL_TRUE : CL_FALSE;
 }
 
 /**
- * @brief Create an event wrapper from a given OpenCL event object and
- * associate it with the command queue.
+ * Set the policy for automatically flushing the command queue.
  *
- * This function is used by the `ccl_*_enqueue_*()` functions and will rarely
- * be called from client code.
+ * Commands enqueued with _cf4ocl_ functions are only submitted to the
+ * device when the queue is flushed, either explicitly or by a blocking
+ * operation. Flushing after every command incurs a round trip to the
+ * driver, while never flushing delays the execution of commands. With a
+ * flush policy, the command queue is automatically flushed when any of the
+ * following conditions is met:
+ *
+ * * `max_cmds` commands are pending.
+ * * Commands have been pending for `max_delay_us` microseconds. This
+ * condition is checked by a timer thread associated with the queue.
+ * * The estimated device time of the pending commands reaches
+ * `max_device_ns` nanoseconds. The estimate is given by the number of
+ * pending commands multiplied by a moving average of the device time of
+ * commands, sampled from the most recent event every time the queue is
+ * finished with ::ccl_queue_finish(). It requires a queue created with
+ * `CL_QUEUE_PROFILING_ENABLE`, and is not used until the first sample is
+ * obtained.
+ *
+ * Conditions set to 0 are disabled; setting all of them to 0 disables the
+ * flush policy. Automatic flushes only submit commands to the device, and
+ * do not release events as ::ccl_queue_flush() may do. Flush statistics
+ * can be obtained with ::ccl_queue_get_flush_stats().
  *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @param[in] event The OpenCL event to wrap and associate with the given
- * command queue.
- * @return The event wrapper object for the given OpenCL event object.
+ * @param[in] max_cmds Maximum number of pending commands, or 0.
+ * @param[in] max_delay_us Maximum time in microseconds commands can be
+ * pending, or 0.
+ * @param[in] max_device_ns Maximum estimated device time in nanoseconds of
+ * pending commands, or 0.
  * */
 CCL_EXPORT
-CCLEvent * ccl_queue_produce_event(CCLQueue * cq, cl_event event) {
+void ccl_queue_set_flush_policy(CCLQueue * cq, cl_uint max_cmds,
+    cl_ulong max_delay_us, cl_ulong max_device_ns) {
 
     /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, NULL);
-    /* Make sure event is not NULL. */
-    g_return_val_if_fail(event != NULL, NULL);
+    g_return_if_fail(cq != NULL);
 
-    /* Wrap the OpenCL event. */
-    CCLEvent * evt = ccl_event_new_wrap(event);
+    /* Stop timer thread of the previous policy, if any. */
+    ccl_queue_flush_timer_stop(cq);
 
-    /* Initialize the list of events of this command queue. */
-    if (cq->evts == NULL) {
-        cq->evts = g_hash_table_new_full(g_direct_hash, g_direct_equal,
-            (GDestroyNotify) ccl_event_destroy, NULL);
+    /* Create flush policy if required. */
+    if (cq->flush == NULL) {
+        if ((max_cmds == 0) && (max_delay_us == 0) && (max_device_ns == 0))
+            return;
+        cq->flush = g_slice_new0(struct ccl_queue_flush);
+        g_mutex_init(&cq->flush->mutex);
+        g_cond_init(&cq->flush->cond);
     }
 
-    /* Add the wrapped event to the list of events of this command
-     * queue. */
-    g_hash_table_add(cq->evts, (gpointer) evt);
-
-    /* Return the wrapped event. */
-    return evt;
+    g_mutex_lock(&cq->flush->mutex);
+    cq->flush->max_cmds = max_cmds;
+    cq->flush->max_delay_us = max_delay_us;
+    cq->flush->max_device_ns = max_device_ns;
+    g_mutex_unlock(&cq->flush->mutex);
+
+    /* Start timer thread for the time-based trigger. The thread keeps its
+     * own reference to the OpenCL queue. */
+    if (max_delay_us > 0) {
+        clRetainCommandQueue(ccl_queue_unwrap(cq));
+        cq->flush->timer = g_thread_new(
+            "ccl_queue_flush", ccl_queue_flush_timer, cq);
+    }
 }
 
 /**
- * Initialize an iterator for this command queue's list of event wrappers. The
- * event wrappers can be iterated in a loop using the
- * ccl_queue_iter_event_next() function.
+ * Get flush statistics of the command queue.
  *
- * This function is used by @ref CCL_PROFILER "profile module" functions and
- * will rarely be called from client code.
+ * Statistics are collected from the moment a flush policy is first set
+ * with ::ccl_queue_set_flush_policy(); if no flush policy was ever set, all
+ * statistics are zero.
  *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- *
+ * @param[out] stats Location where to place the flush statistics.
  * */
 CCL_EXPORT
-void ccl_queue_iter_event_init(CCLQueue * cq) {
+void ccl_queue_get_flush_stats(CCLQueue * cq, CCLQueueFlushStats * stats) {
 
     /* Make sure cq is not NULL. */
     g_return_if_fail(cq != NULL);
+    /* Make sure stats is not NULL. */
+    g_return_if_fail(stats != NULL);
 
-    /* Initialize iterator. */
-    g_hash_table_iter_init(&cq->evt_iter, cq->evts);
+    if (cq->flush == NULL) {
+        memset(stats, 0, sizeof(CCLQueueFlushStats));
+    } else {
+        g_mutex_lock(&cq->flush->mutex);
+        *stats = cq->flush->stats;
+        g_mutex_unlock(&cq->flush->mutex);
+    }
 }
 
 /**
- * Get the next event wrapper associated with this queue.
+ * @internal
  *
- * This function is used by @ref CCL_PROFILER "profile module" functions and
- * will rarely be called from client code.
+ * @brief Get the location where enqueue functions should place the OpenCL
+ * event produced by a command.
  *
- * @attention Calling this before ccl_queue_iter_event_init() is undefined
- * behavior.
- * @warning This function is not thread-safe.
- * @warning No events should be enqueued on this queue while the iteration is
- * ongoing.
+ * @protected @memberof ccl_queue
  *
- * @public @memberof ccl_queue
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] event Location of OpenCL event.
+ * @return `event`, or `NULL` if the command queue is event-less and does
+ * not track hazards.
+ * */
+cl_event * ccl_queue_event_ptr(CCLQueue * cq, cl_event * event) {
+
+    return (cq->event_less && (cq->hazards == NULL)) ? NULL : event;
+}
+
+/**
+ * @internal
+ *
+ * @brief Notify the command queue that commands were enqueued, flushing it
+ * if required by its flush policy.
+ *
+ * @protected @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @return The next event wrapper associated with this queue, or `NULL` if no
- * more event wrappers are available.
+ * @param[in] num_cmds Number of enqueued commands.
  * */
-CCL_EXPORT
-CCLEvent * ccl_queue_iter_event_next(CCLQueue * cq) {
+void ccl_queue_submitted(CCLQueue * cq, cl_uint num_cmds) {
 
-    /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, NULL);
+    struct ccl_queue_flush * fl = cq->flush;
+    cl_ulong * counter = NULL;
+
+    /* Nothing to do if there is no flush policy. */
+    if (fl == NULL) return;
 
-    gpointer evt;
-    gboolean exists = g_hash_table_iter_next(&cq->evt_iter, &evt, NULL);
-    return exists ? (CCLEvent *) evt : NULL;
+    g_mutex_lock(&fl->mutex);
+
+    /* Wake up the timer thread if there were no pending commands. */
+    if (fl->pending == 0) {
+        fl->pending_since = g_get_monotonic_time();
+        if (fl->timer != NULL) g_cond_signal(&fl->cond);
+    }
+    fl->pending += num_cmds;
+
+    /* Check count and device time triggers. */
+    if ((fl->max_cmds > 0) && (fl->pending >= fl->max_cmds))
+        counter = &fl->stats.by_count;
+    else if ((fl->max_device_ns > 0) && (fl->avg_cmd_ns > 0)
+        && (fl->pending * fl->avg_cmd_ns >= fl->max_device_ns))
+        counter = &fl->stats.by_device_time;
+
+    if (counter != NULL) {
+        clFlush(ccl_queue_unwrap(cq));
+        ccl_queue_flush_account(fl, counter);
+    }
+
+    g_mutex_unlock(&fl->mutex);
 }
 
 /**
- * Issues all previously queued commands in a command queue to the associated
- * device. This function is a wrapper for the clFlush() OpenCL function.
+ * @internal
  *
- * @public @memberof ccl_queue
+ * @brief Add the events of previous commands whose accesses to memory
+ * objects conflict with the given accesses to the event wait list of a
+ * new command, if the queue tracks hazards.
+ *
+ * @protected @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return `CL_TRUE` if operation is successful, or `CL_FALSE` otherwise.
+ * @param[in] evt_wait_lst Event wait list given to the enqueue function,
+ * possibly `NULL`.
+ * @param[in] hz_lst Event wait list, initially `NULL`, to use if
+ * `evt_wait_lst` is `NULL`.
+ * @param[in] acc Accesses of the new command.
+ * @param[in] num_acc Number of accesses in `acc`.
+ * @return The event wait list to use for the new command, which should be
+ * cleared after use.
  * */
-CCL_EXPORT
-cl_bool ccl_queue_flush(CCLQueue * cq, CCLErr ** err) {
+CCLEventWaitList * ccl_queue_hazards_wait(CCLQueue * cq,
+    CCLEventWaitList * evt_wait_lst, CCLEventWaitList * hz_lst,
+    const CCLQueueAccess * acc, cl_uint num_acc) {
 
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, CL_INT_MAX);
-    /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, CL_INVALID_COMMAND_QUEUE);
+    /* Nothing to do if hazards are not tracked. */
+    if ((cq->hazards == NULL) || (num_acc == 0)) return evt_wait_lst;
 
-    /* OpenCL status flag. */
-    cl_int ocl_status;
+    if (evt_wait_lst == NULL) evt_wait_lst = hz_lst;
 
-    /* Flush queue. */
-    ocl_status = clFlush(ccl_queue_unwrap(cq));
-    if (ocl_status != CL_SUCCESS)
-        g_set_error(err, CCL_OCL_ERROR, ocl_status,
-            "%s: unable to flush queue (OpenCL error %d: %s).",
-        CCL_STRD, ocl_status, ccl_err(ocl_status));
+    for (cl_uint i = 0; i < num_acc; ++i) {
 
-    /* Return status. */
-    return ocl_status == CL_SUCCESS ? CL_TRUE : CL_FALSE;
+        struct ccl_queue_mem_state * st =
+            g_hash_table_lookup(cq->hazards, acc[i].mem);
+        if (st == NULL) continue;
+
+        /* Read-after-write and write-after-write. */
+        if (st->writer != NULL)
+            ccl_event_wait_list_add_clevent(evt_wait_lst, st->writer);
+
+        /* Write-after-read. */
+        if (acc[i].write)
+            for (guint j = 0; j < st->readers->len; ++j)
+                ccl_event_wait_list_add_clevent(evt_wait_lst,
+                    (cl_event) g_ptr_array_index(st->readers, j));
+    }
+
+    return evt_wait_lst;
 }
 
 /**
- * Blocks until all previously queued OpenCL commands in a command-queue are
- * issued to the associated device and have completed. This function is a
- * wrapper for the clFinish() OpenCL function.
+ * @internal
  *
- * @public @memberof ccl_queue
+ * @brief Record the accesses to memory objects of an enqueued command, if
+ * the queue tracks hazards.
+ *
+ * @protected @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return `CL_TRUE` if operation is successful, or `CL_FALSE` otherwise.
+ * @param[in] event Event of the enqueued command.
+ * @param[in] acc Accesses of the enqueued command.
+ * @param[in] num_acc Number of accesses in `acc`.
  * */
-CCL_EXPORT
-cl_bool ccl_queue_finish(CCLQueue * cq, CCLErr ** err) {
+void ccl_queue_hazards_record(CCLQueue * cq, cl_event event,
+    const CCLQueueAccess * acc, cl_uint num_acc) {
 
-    /* Make sure err is NULL or it is not set. */
-    g_return_val_if_fail(err == NULL || *err == NULL, CL_INT_MAX);
-    /* Make sure cq is not NULL. */
-    g_return_val_if_fail(cq != NULL, CL_INVALID_COMMAND_QUEUE);
+    /* Nothing to do if hazards are not tracked. */
+    if ((cq->hazards == NULL) || (event == NULL)) return;
 
-    /* OpenCL status flag. */
-    cl_int ocl_status;
+    for (cl_uint i = 0; i < num_acc; ++i) {
 
-    /* Finish queue. */
-    ocl_status = clFinish(ccl_queue_unwrap(cq));
-    if (ocl_status != CL_SUCCESS)
-        g_set_error(err, CCL_OCL_ERROR, ocl_status,
-            "%s: unable to finish queue (OpenCL error %d: %s).",
-        CCL_STRD, ocl_status, ccl_err(ocl_status));
+        struct ccl_queue_mem_state * st =
+            g_hash_table_lookup(cq->hazards, acc[i].mem);
 
-    /* Return status. */
-    return ocl_status == CL_SUCCESS ? CL_TRUE : CL_FALSE;
+        /* Start tracking memory object if required. */
+        if (st == NULL) {
+            st = g_slice_new0(struct ccl_queue_mem_state);
+            st->readers = g_ptr_array_new();
+            g_hash_table_insert(cq->hazards, acc[i].mem, st);
+        }
+
+        if (acc[i].write) {
+
+            /* A write supersedes previous reads and writes. */
+            if (st->writer != NULL) clReleaseEvent(st->writer);
+            for (guint j = 0; j < st->readers->len; ++j)
+                clReleaseEvent((cl_event) g_ptr_array_index(st->readers, j));
+            g_ptr_array_set_size(st->readers, 0);
+            st->writer = event;
+
+        } else {
+
+            /* Release completed readers if there are too many. */
+            if (st->readers->len >= CCL_QUEUE_HAZARD_READERS_MAX) {
+                for (guint j = st->readers->len; j > 0; --j) {
+                    cl_event reader =
+                        (cl_event) g_ptr_array_index(st->readers, j - 1);
+                    cl_int exec_status;
+                    if ((clGetEventInfo(reader,
+                            CL_EVENT_COMMAND_EXECUTION_STATUS,
+                            sizeof(cl_int), &exec_status, NULL)
+                        == CL_SUCCESS) && (exec_status == CL_COMPLETE)) {
+                        clReleaseEvent(reader);
+                        g_ptr_array_remove_index_fast(st->readers, j - 1);
+                    }
+                }
+            }
+            g_ptr_array_add(st->readers, event);
+        }
+        clRetainEvent(event);
+    }
 }
 
 /**
- * Release all events associated with the command queue.
+ * @internal
  *
- * _cf4ocl_ command queue wrappers internally keep events for profiling
- * purposes and simpler handling of event associated memory. However, a very
- * large number of events can have an impact on utilized memory. In such cases,
- * this function can be used to periodically release these events.
+ * @brief Attach a profiler to a command queue, such that completed events
+ * can be handed to it before being released, if the queue event retention
+ * policy is ::CCL_QUEUE_EVTS_PROFILE_COMPLETED.
  *
- * This function is also called by the ::ccl_prof_calc() function, i.e., the
- * queue events are released after the profiling analysis is performed.
+ * @protected @memberof ccl_queue
  *
- * @public @memberof ccl_queue
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] prof Profiler.
+ * @param[in] cq_name Name of the command queue in the profiler.
+ * */
+void ccl_queue_attach_profiler(
+    CCLQueue * cq, CCLProf * prof, const char * cq_name) {
+
+    /* Make sure cq is not NULL. */
+    g_return_if_fail(cq != NULL);
+
+    cq->prof = prof;
+    cq->prof_name = cq_name;
+}
+
+/**
+ * @internal
+ *
+ * @brief Detach a profiler from a command queue, if it's attached.
+ *
+ * @protected @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
+ * @param[in] prof Profiler.
  * */
-CCL_EXPORT
-void ccl_queue_gc(CCLQueue * cq) {
+void ccl_queue_detach_profiler(CCLQueue * cq, CCLProf * prof) {
 
     /* Make sure cq is not NULL. */
     g_return_if_fail(cq != NULL);
 
-    /* Release events. */
-    if (cq->evts != NULL) {
-        g_hash_table_remove_all(cq->evts);
+    if (cq->prof == prof) {
+        cq->prof = NULL;
+        cq->prof_name = NULL;
     }
 }
 
@@ -809,6 +1998,9 @@ CCLEvent * ccl_enqueue_barrier(
      * queue is released. */
     evt = ccl_queue_produce_event(cq, event);
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -981,6 +2173,9 @@ CCLEvent * ccl_enqueue_marker(
      * queue is released. */
     evt = ccl_queue_produce_event(cq, event);
 
+    /* Apply the flush policy of the command queue. */
+    ccl_queue_submitted(cq, 1);
+
     /* If we got here, everything is OK. */
     g_assert(err == NULL || *err == NULL);
     goto finish;
@@ -1002,4 +2197,138 @@ finish:
     return evt;
 }
 
+/**
+ * Create a new pool of command queues, which provides each thread with its
+ * own command queue for each device of a context.
+ *
+ * Command queue wrappers are not thread-safe, so threads which execute
+ * commands on the same device concurrently need different command queues.
+ * The command queue of the calling thread for a given device is obtained
+ * with ::ccl_queue_pool_get(). It is created the first time it's
+ * requested, and found in a thread-local cache, without locking, in
+ * subsequent requests.
+ *
+ * @public @memberof ccl_queue_pool
+ *
+ * @param[in] ctx Context wrapper object. The pool keeps a reference to it.
+ * @param[in] properties Bitfield of properties of the command queues in
+ * the pool.
+ * @return A new pool of command queues, which should be destroyed with
+ * ::ccl_queue_pool_destroy().
+ * */
+CCL_EXPORT
+CCLQueuePool * ccl_queue_pool_new(
+    CCLContext * ctx, cl_command_queue_properties properties) {
+
+    /* Make sure ctx is not NULL. */
+    g_return_val_if_fail(ctx != NULL, NULL);
+
+    CCLQueuePool * pool = g_slice_new0(CCLQueuePool);
+
+    ccl_context_ref(ctx);
+    pool->ctx = ctx;
+    pool->properties = properties;
+
+    return pool;
+}
+
+/**
+ * Get the command queue of the calling thread for a given device. The
+ * returned command queue is released when the pool is destroyed, and must
+ * not be externally destroyed with ::ccl_queue_destroy().
+ *
+ * @public @memberof ccl_queue_pool
+ *
+ * @param[in] pool Pool of command queues.
+ * @param[in] dev Device wrapper object, must be associated with the context
+ * of the pool. If `NULL`, the first device of the context is used.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The command queue of the calling thread for the given device, or
+ * `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLQueue * ccl_queue_pool_get(
+    CCLQueuePool * pool, CCLDevice * dev, CCLErr ** err) {
+
+    /* Make sure pool is not NULL. */
+    g_return_val_if_fail(pool != NULL, NULL);
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+    /* Command queue wrapper object. */
+    CCLQueue * cq = NULL;
+    /* Thread-local cache of command queues of this pool. */
+    GHashTable * cache;
+    /* Node for the list of command queues of the pool. */
+    GSList * node;
+
+    /* Use first device of the context if none is given. */
+    if (dev == NULL) {
+        dev = ccl_context_get_device(pool->ctx, 0, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    }
+
+    /* Check if the calling thread already has a queue for the device. */
+    cache = ccl_wrapper_thread_cache(
+        &pool->thread_cache_id, g_direct_hash, g_direct_equal, NULL);
+    cq = g_hash_table_lookup(cache, dev);
+
+    if (cq == NULL) {
+
+        /* If not, create a new command queue for this thread. */
+        cq = ccl_queue_new(pool->ctx, dev, pool->properties, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        /* Keep it in the thread-local cache. */
+        g_hash_table_insert(cache, dev, cq);
+
+        /* Keep it in the pool, so it can be released with it. The list is
+         * shared by all threads, so add it without locking. */
+        node = g_slist_alloc();
+        node->data = cq;
+        do {
+            node->next = g_atomic_pointer_get(&pool->queues);
+        } while (!g_atomic_pointer_compare_and_exchange(
+            &pool->queues, node->next, node));
+
+    }
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Return command queue. */
+    return cq;
+}
+
+/**
+ * Destroy a pool of command queues, releasing all its command queues. The
+ * pool should not be destroyed while other threads are using it.
+ *
+ * @public @memberof ccl_queue_pool
+ *
+ * @param[in] pool Pool of command queues to destroy.
+ * */
+CCL_EXPORT
+void ccl_queue_pool_destroy(CCLQueuePool * pool) {
+
+    /* Make sure pool is not NULL. */
+    g_return_if_fail(pool != NULL);
+
+    ccl_wrapper_thread_cache_release(&pool->thread_cache_id);
+    g_slist_free_full(pool->queues, (GDestroyNotify) ccl_queue_destroy);
+    ccl_context_unref(pool->ctx);
+    g_slice_free(CCLQueuePool, pool);
+}
+
 /** @} */
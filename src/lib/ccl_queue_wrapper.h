@@ -78,6 +78,66 @@
  * @{
  */
 
+/**
+ * Policies for retaining the events associated with a command queue.
+ *
+ * @see ccl_queue_set_event_retention()
+ * */
+typedef enum ccl_queue_evt_retention {
+
+    /** Keep all events until ::ccl_queue_gc() is called (default). */
+    CCL_QUEUE_EVTS_KEEP_ALL = 0,
+
+    /** Keep only the most recent events. */
+    CCL_QUEUE_EVTS_KEEP_LAST = 1,
+
+    /** Release completed events when the queue is flushed or finished. */
+    CCL_QUEUE_EVTS_RELEASE_COMPLETED = 2,
+
+    /** Hand completed events to the attached profiler and release them
+     * when the queue is flushed or finished. */
+    CCL_QUEUE_EVTS_PROFILE_COMPLETED = 3
+
+} CCLQueueEvtRetention;
+
+/**
+ * Number of bins in the flush latency histogram of a command queue.
+ *
+ * @see ccl_queue_get_flush_stats()
+ * */
+#define CCL_QUEUE_FLUSH_LATENCY_BINS 16
+
+/**
+ * Flush statistics of a command queue with a flush policy.
+ *
+ * @see ccl_queue_set_flush_policy()
+ * */
+typedef struct ccl_queue_flush_stats {
+
+    /** Flushes triggered by the number of pending commands. */
+    cl_ulong by_count;
+
+    /** Flushes triggered by the time commands were pending. */
+    cl_ulong by_time;
+
+    /** Flushes triggered by the estimated device time of pending
+     * commands. */
+    cl_ulong by_device_time;
+
+    /** Flushes requested by client code with ::ccl_queue_flush() or
+     * ::ccl_queue_finish(). */
+    cl_ulong by_client;
+
+    /** Commands submitted to the device by all flushes. */
+    cl_ulong commands;
+
+    /** Flush latency histogram. Bin `i` counts the flushes in which the
+     * oldest pending command waited less than 2<sup>i</sup> microseconds
+     * before being flushed; the last bin counts all remaining flushes. */
+    cl_ulong latency[CCL_QUEUE_FLUSH_LATENCY_BINS];
+
+} CCLQueueFlushStats;
+
 /* Get the command queue wrapper for the given OpenCL command queue. */
 CCL_EXPORT
 CCLQueue * ccl_queue_new_wrap(cl_command_queue command_queue);
@@ -132,6 +192,56 @@ cl_bool ccl_queue_finish(CCLQueue * cq, CCLErr ** err);
 CCL_EXPORT
 void ccl_queue_gc(CCLQueue * cq);
 
+/* Set the policy for retaining events associated with the command
+ * queue. */
+CCL_EXPORT
+void ccl_queue_set_event_retention(CCLQueue * cq,
+    CCLQueueEvtRetention retention, cl_uint max_evts);
+
+/* Enable or disable event-less mode for the command queue. */
+CCL_EXPORT
+void ccl_queue_set_event_less(CCLQueue * cq, cl_bool event_less);
+
+/* Is event-less mode enabled for the command queue? */
+CCL_EXPORT
+cl_bool ccl_queue_is_event_less(CCLQueue * cq);
+
+/* Enable or disable automatic hazard tracking for the command queue. */
+CCL_EXPORT
+void ccl_queue_set_hazard_tracking(CCLQueue * cq, cl_bool track);
+
+/* Does the command queue track hazards? */
+CCL_EXPORT
+cl_bool ccl_queue_has_hazard_tracking(CCLQueue * cq);
+
+/* Set the policy for automatically flushing the command queue. */
+CCL_EXPORT
+void ccl_queue_set_flush_policy(CCLQueue * cq, cl_uint max_cmds,
+    cl_ulong max_delay_us, cl_ulong max_device_ns);
+
+/* Get flush statistics of the command queue. */
+CCL_EXPORT
+void ccl_queue_get_flush_stats(CCLQueue * cq, CCLQueueFlushStats * stats);
+
+/**
+ * Pool of command queues, with one command queue per thread and device.
+ * */
+typedef struct ccl_queue_pool CCLQueuePool;
+
+/* Create a new pool of command queues. */
+CCL_EXPORT
+CCLQueuePool * ccl_queue_pool_new(
+    CCLContext * ctx, cl_command_queue_properties properties);
+
+/* Get the command queue of the calling thread for a given device. */
+CCL_EXPORT
+CCLQueue * ccl_queue_pool_get(
+    CCLQueuePool * pool, CCLDevice * dev, CCLErr ** err);
+
+/* Destroy a pool of command queues. */
+CCL_EXPORT
+void ccl_queue_pool_destroy(CCLQueuePool * pool);
+
 /* Enqueues a barrier command on the given command queue. */
 CCL_EXPORT
 CCLEvent * ccl_enqueue_barrier(
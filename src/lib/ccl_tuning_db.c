@@ -0,0 +1,275 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Implementation of a persistent database of tuned kernel work sizes.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include <errno.h>
+#include "ccl_tuning_db.h"
+#include "_ccl_tuning_db.h"
+#include "_ccl_defs.h"
+
+/* Name of tuning database file within the tuning database folder. */
+#define CCL_TUNING_DB_FILE "tuning.ini"
+
+/* Name of key holding the local work size in each group. */
+#define CCL_TUNING_DB_LWS "lws"
+
+/* Protects the tuning database. */
+static GMutex tuning_db_mutex;
+
+/* Tuned work sizes, created when first needed. */
+static GKeyFile * tuning_db = NULL;
+
+/* Location of tuning database file, or NULL if only kept in memory. */
+static gchar * tuning_db_path = NULL;
+
+/**
+ * @internal
+ *
+ * @brief Get name of tuning database group for the given key.
+ *
+ * Keys may contain characters which are not allowed in group names, so
+ * groups are named after a checksum of the key.
+ *
+ * @private @memberof ccl_tuning_db
+ *
+ * @param[in] key Key identifying a tuned work size.
+ * @return Name of tuning database group, should be freed with g_free().
+ * */
+static gchar * ccl_tuning_db_group(const char * key) {
+
+    gchar * checksum = g_compute_checksum_for_string(
+        G_CHECKSUM_SHA1, key, -1);
+    gchar * group = g_strconcat("kernel-", checksum, NULL);
+    g_free(checksum);
+    return group;
+}
+
+/**
+ * @internal
+ *
+ * @brief Get tuned local work size from the tuning database.
+ *
+ * @protected @memberof ccl_tuning_db
+ *
+ * @param[in] key Key identifying the tuned work size.
+ * @param[in] dims Number of dimensions.
+ * @param[out] lws Location where to place the tuned local work size, with
+ * space for `dims` values.
+ * @return `CL_TRUE` if a tuned local work size with `dims` dimensions was
+ * found, `CL_FALSE` otherwise.
+ * */
+cl_bool ccl_tuning_db_lookup(const char * key, cl_uint dims, size_t * lws) {
+
+    gchar * group;
+    gchar * value = NULL;
+    gchar ** sizes = NULL;
+    cl_bool found = CL_FALSE;
+
+    group = ccl_tuning_db_group(key);
+
+    g_mutex_lock(&tuning_db_mutex);
+    if (tuning_db != NULL)
+        value = g_key_file_get_string(
+            tuning_db, group, CCL_TUNING_DB_LWS, NULL);
+    g_mutex_unlock(&tuning_db_mutex);
+
+    /* Values are comma-separated sizes, which must be positive. */
+    if (value == NULL) goto finish;
+    sizes = g_strsplit(value, ",", -1);
+    if (g_strv_length(sizes) != dims) goto finish;
+    for (cl_uint i = 0; i < dims; ++i) {
+        lws[i] = (size_t) g_ascii_strtoull(sizes[i], NULL, 10);
+        if (lws[i] == 0) goto finish;
+    }
+    found = CL_TRUE;
+
+finish:
+
+    g_strfreev(sizes);
+    g_free(value);
+    g_free(group);
+    return found;
+}
+
+/**
+ * @internal
+ *
+ * @brief Keep tuned local work size in the tuning database, and on disk if
+ * the tuning database is enabled.
+ *
+ * @protected @memberof ccl_tuning_db
+ *
+ * @param[in] key Key identifying the tuned work size.
+ * @param[in] dims Number of dimensions.
+ * @param[in] lws Tuned local work size.
+ * */
+void ccl_tuning_db_store(const char * key, cl_uint dims, const size_t * lws) {
+
+    gchar * group;
+    GString * value;
+    GKeyFile * disk_db;
+
+    group = ccl_tuning_db_group(key);
+    value = g_string_new(NULL);
+    for (cl_uint i = 0; i < dims; ++i)
+        g_string_append_printf(value, "%s%" G_GSIZE_FORMAT,
+            i > 0 ? "," : "", (gsize) lws[i]);
+
+    g_mutex_lock(&tuning_db_mutex);
+
+    if (tuning_db == NULL) tuning_db = g_key_file_new();
+    g_key_file_set_string(tuning_db, group, CCL_TUNING_DB_LWS, value->str);
+
+    /* Other processes may have tuned other kernels meanwhile, so reload the
+     * file before adding the new entry. Failing to write the file is not an
+     * error, kernels will be tuned again next time. */
+    if (tuning_db_path != NULL) {
+        disk_db = g_key_file_new();
+        g_key_file_load_from_file(
+            disk_db, tuning_db_path, G_KEY_FILE_NONE, NULL);
+        g_key_file_set_string(disk_db, group, CCL_TUNING_DB_LWS, value->str);
+        g_key_file_save_to_file(disk_db, tuning_db_path, NULL);
+        g_key_file_free(disk_db);
+    }
+
+    g_mutex_unlock(&tuning_db_mutex);
+
+    g_string_free(value, TRUE);
+    g_free(group);
+}
+
+/**
+ * @addtogroup CCL_TUNING_DB
+ * @{
+ */
+
+/**
+ * Enable the persistent database of tuned kernel work sizes.
+ *
+ * Tuned work sizes are kept in a `tuning.ini` file within the given
+ * folder, which is created if it doesn't exist. Work sizes already in the
+ * file become available to ::ccl_kernel_autotune_worksizes(). An existing
+ * file which can't be read is ignored and will be overwritten.
+ *
+ * @public @memberof ccl_tuning_db
+ *
+ * @param[in] dir Folder where to keep the tuning database, or `NULL` to
+ * use the `cf4ocl` folder within the user cache folder (e.g.
+ * `$XDG_CACHE_HOME/cf4ocl`).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if the tuning database is enabled, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_tuning_db_enable(const char * dir, CCLErr ** err) {
+
+    /* Make sure err is NULL or it is not set. */
+    g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+    gchar * db_dir;
+    gchar ** groups;
+    GKeyFile * disk_db;
+    gchar * value;
+    cl_bool status;
+
+    /* Determine tuning database folder and make sure it exists. */
+    db_dir = (dir != NULL)
+        ? g_strdup(dir)
+        : g_build_filename(g_get_user_cache_dir(), "cf4ocl", NULL);
+    ccl_if_err_create_goto(*err, CCL_ERROR,
+        g_mkdir_with_parents(db_dir, 0700) != 0,
+        CCL_ERROR_OPENFILE, error_handler,
+        "%s: unable to create tuning database folder '%s' (%s).",
+        CCL_STRD, db_dir, g_strerror(errno));
+
+    g_mutex_lock(&tuning_db_mutex);
+
+    g_free(tuning_db_path);
+    tuning_db_path = g_build_filename(db_dir, CCL_TUNING_DB_FILE, NULL);
+    if (tuning_db == NULL) tuning_db = g_key_file_new();
+
+    /* Add existing work sizes to the ones already in memory. */
+    disk_db = g_key_file_new();
+    if (g_key_file_load_from_file(
+        disk_db, tuning_db_path, G_KEY_FILE_NONE, NULL)) {
+
+        groups = g_key_file_get_groups(disk_db, NULL);
+        for (guint i = 0; groups[i] != NULL; ++i) {
+            value = g_key_file_get_string(
+                disk_db, groups[i], CCL_TUNING_DB_LWS, NULL);
+            if (value != NULL)
+                g_key_file_set_string(
+                    tuning_db, groups[i], CCL_TUNING_DB_LWS, value);
+            g_free(value);
+        }
+        g_strfreev(groups);
+    }
+    g_key_file_free(disk_db);
+
+    g_mutex_unlock(&tuning_db_mutex);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    status = CL_TRUE;
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+    status = CL_FALSE;
+
+finish:
+
+    g_free(db_dir);
+
+    /* Return status. */
+    return status;
+}
+
+/**
+ * Disable the persistent database of tuned kernel work sizes.
+ *
+ * Tuned work sizes are no longer written to disk, and all tuned work sizes
+ * are discarded from memory.
+ *
+ * @public @memberof ccl_tuning_db
+ * */
+CCL_EXPORT
+void ccl_tuning_db_disable() {
+
+    g_mutex_lock(&tuning_db_mutex);
+
+    if (tuning_db != NULL) g_key_file_free(tuning_db);
+    g_free(tuning_db_path);
+    tuning_db = NULL;
+    tuning_db_path = NULL;
+
+    g_mutex_unlock(&tuning_db_mutex);
+}
+
+/** @} */
@@ -0,0 +1,76 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Functions for managing a persistent database of tuned kernel work sizes.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_TUNING_DB_H_
+#define _CCL_TUNING_DB_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+
+/**
+ * @defgroup CCL_TUNING_DB Tuning database
+ *
+ * The tuning database module keeps the local work sizes found by
+ * ::ccl_kernel_autotune_worksizes().
+ *
+ * Tuned work sizes are keyed by kernel name, program (source or binary,
+ * and build options), device (vendor ID, name and driver version) and
+ * global work size. Tuned work sizes are always kept in memory for the
+ * lifetime of the process. When the tuning database is enabled with
+ * ::ccl_tuning_db_enable(), they are also kept on disk, so that
+ * subsequent processes get tuned work sizes without performing any
+ * measurements. The on-disk database can be disabled with
+ * ::ccl_tuning_db_disable().
+ *
+ * _Example:_
+ *
+ * ```c
+ * CCLErr * err = NULL;
+ * size_t rws = 1000000, gws, lws;
+ * ```
+ *
+ * ```c
+ * ccl_tuning_db_enable(NULL, &err);
+ * ccl_kernel_set_args(krnl, buf, ccl_arg_priv(rws, cl_uint), NULL);
+ * ccl_kernel_autotune_worksizes(krnl, cq, 1, &rws, NULL, 0, &gws, &lws,
+ *     &err);
+ * ```
+ *
+ * @{
+ */
+
+/* Enable the persistent database of tuned kernel work sizes. */
+CCL_EXPORT
+cl_bool ccl_tuning_db_enable(const char * dir, CCLErr ** err);
+
+/* Disable the persistent database of tuned kernel work sizes. */
+CCL_EXPORT
+void ccl_tuning_db_disable(void);
+
+/** @} */
+
+#endif
@@ -39,11 +39,15 @@ extern "C" {
 #include <cf4ocl2/ccl_device_query.h>
 #include <cf4ocl2/ccl_device_selector.h>
 #include <cf4ocl2/ccl_device_wrapper.h>
+#include <cf4ocl2/ccl_dispatcher.h>
 #include <cf4ocl2/ccl_errors.h>
 #include <cf4ocl2/ccl_event_wrapper.h>
+#include <cf4ocl2/ccl_graph.h>
 #include <cf4ocl2/ccl_image_wrapper.h>
+#include <cf4ocl2/ccl_info_cache.h>
 #include <cf4ocl2/ccl_kernel_arg.h>
 #include <cf4ocl2/ccl_kernel_wrapper.h>
+#include <cf4ocl2/ccl_launch.h>
 #include <cf4ocl2/ccl_memobj_wrapper.h>
 #include <cf4ocl2/ccl_oclversions.h>
 #include <cf4ocl2/ccl_platforms.h>
@@ -52,6 +56,7 @@ extern "C" {
 #include <cf4ocl2/ccl_program_wrapper.h>
 #include <cf4ocl2/ccl_queue_wrapper.h>
 #include <cf4ocl2/ccl_sampler_wrapper.h>
+#include <cf4ocl2/ccl_tuning_db.h>
 
 #ifdef __cplusplus
 }
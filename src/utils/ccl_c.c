@@ -46,8 +46,11 @@
  * <dt>-d, --device=DEV</dt>
  * <dd>Specify a device on which to perform the task.</dd>
  * <dt>-t, --task=TASK</dt>
- * <dd>0 (Build, default), 1 (Compile) or 2 (Link). Tasks 1 and 2 are only
- * available for platforms with support for OpenCL 1.2 or higher.</dd>
+ * <dd>0 (Build, default), 1 (Compile), 2 (Link) or 3 (Stubs). Tasks 1, 2
+ * and 3 are only available for platforms with support for OpenCL 1.2 or
+ * higher. The Stubs task builds the program and saves a C header with one
+ * typed launch function, named `ccl_stub_<kernel>()`, for each kernel to
+ * the output file.</dd>
  * <dt>-0, --options=OPTIONS</dt>
  * <dd>Compiler/linker options.</dd>
  * <dt>-s, --src=FILE</dt>
@@ -62,7 +65,7 @@
  * <dt>-b, --bin=FILE</dt>
  * <dd>Binary input file. This option can be specified multiple times.</dd>
  * <dt>-o, --output=FILE</dt>
- * <dd>Binary output file.</dd>
+ * <dd>Binary output file, or header output file for the Stubs task.</dd>
  * <dt>-k, --kernel-info=STRING</dt>
  * <dd>Show information about the specified kernel. This option can be
  * specified multiple times.</dd>
@@ -123,7 +126,8 @@
 typedef enum ccl_c_tasks {
     CCL_C_BUILD = 0,
     CCL_C_COMPILE = 1,
-    CCL_C_LINK = 2
+    CCL_C_LINK = 2,
+    CCL_C_STUBS = 3
 } CCLCTasks;
 
 /* Command line arguments and respective default values. */
@@ -147,8 +151,11 @@ static GOptionEntry entries[] = {
     {"device",               'd', 0, G_OPTION_ARG_INT,            &dev_idx,
      "Specify a device on which to perform the task.",            "DEV"},
     {"task",                 't', 0, G_OPTION_ARG_INT,            &task,
-     "0 (Build, default), 1 (Compile) or 2 (Link). Tasks 1 and 2 are only "
-     "available for platforms with support for OpenCL 1.2 or higher.",
+     "0 (Build, default), 1 (Compile), 2 (Link) or 3 (Stubs). Tasks 1, 2 "
+     "and 3 are only available for platforms with support for OpenCL 1.2 or "
+     "higher. The Stubs task builds the program and saves a C header with "
+     "one typed launch function, named ccl_stub_<kernel>(), for each kernel "
+     "to the output file.",
                                                                   "TASK"},
     {"options",              '0', 0, G_OPTION_ARG_STRING,         &options,
      "Compiler/linker options.",                                  "OPTIONS"},
@@ -166,7 +173,8 @@ static GOptionEntry entries[] = {
      "Binary input file. This option can be specified multiple times.",
                                                                   "FILE"},
     {"output",               'o', 0, G_OPTION_ARG_FILENAME,       &output,
-     "Binary output file.",                                       "FILE"},
+     "Binary output file, or header output file for the Stubs task.",
+                                                                  "FILE"},
     {"kernel-info",          'k', 0, G_OPTION_ARG_STRING_ARRAY,   &kernel_names,
      "Show information about the specified kernel. This option can be "
      "specified multiple times.",                                "STRING"},
@@ -342,6 +350,316 @@ finish:
     return;
 }
 
+#ifdef CL_VERSION_1_2
+
+/**
+ * Get the host type of a private kernel argument, given the OpenCL C type
+ * name of the argument.
+ *
+ * @param[in] type_name OpenCL C type name (e.g. `uint` or `float4`).
+ * @return Host type name (e.g. `cl_uint` or `cl_float4`), which should be
+ * freed with g_free(), or `NULL` if the type has no direct host type.
+ * */
+gchar * ccl_c_stub_host_type(const char * type_name) {
+
+    /* OpenCL C scalar types with a host type. */
+    static const char * scalar_types[] = { "char", "uchar", "short",
+        "ushort", "int", "uint", "long", "ulong", "float", "double", NULL };
+
+    for (guint i = 0; scalar_types[i] != NULL; ++i) {
+
+        size_t len = strlen(scalar_types[i]);
+        const char * suffix = type_name + len;
+
+        if (strncmp(type_name, scalar_types[i], len) != 0) continue;
+
+        /* Scalar type, or vector type with a valid number of
+         * components. */
+        if ((*suffix == '\0') || (g_strcmp0(suffix, "2") == 0)
+            || (g_strcmp0(suffix, "3") == 0) || (g_strcmp0(suffix, "4") == 0)
+            || (g_strcmp0(suffix, "8") == 0) || (g_strcmp0(suffix, "16") == 0))
+            return g_strconcat("cl_", type_name, NULL);
+    }
+
+    /* Half-precision scalars are kept in host unsigned shorts. */
+    if (g_strcmp0(type_name, "half") == 0) return g_strdup("cl_half");
+
+    return NULL;
+}
+
+/**
+ * Append the launch function for a kernel to a header.
+ *
+ * @param[in] prg Program containing kernel.
+ * @param[in] kernel Kernel name.
+ * @param[in,out] header Header being generated.
+ * @param[out] err Return location for a CCLErr object.
+ * */
+void ccl_c_stub_append(CCLProgram * prg, const char * kernel,
+    GString * header, CCLErr ** err) {
+
+    /* Kernel wrapper. */
+    CCLKernel * krnl = NULL;
+
+    /* Number of kernel arguments. */
+    cl_uint num_args;
+
+    /* Kernel argument information. */
+    cl_kernel_arg_address_qualifier addr;
+    char * type_name;
+    char * arg_name;
+    gchar * host_type;
+    gchar * name = NULL;
+
+    /* Parameters, their documentation and statements of launch function. */
+    GString * params = g_string_new(NULL);
+    GString * docs = g_string_new(NULL);
+    GString * stmts = g_string_new(NULL);
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Get kernel and its number of arguments. */
+    krnl = ccl_program_get_kernel(prg, kernel, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    num_args = ccl_kernel_get_info_scalar(
+        krnl, CL_KERNEL_NUM_ARGS, cl_uint, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    for (cl_uint i = 0; i < num_args; ++i) {
+
+        /* Get argument information. */
+        addr = ccl_kernel_get_arg_info_scalar(krnl, i,
+            CL_KERNEL_ARG_ADDRESS_QUALIFIER, cl_kernel_arg_address_qualifier,
+            &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        type_name = ccl_kernel_get_arg_info_array(krnl, i,
+            CL_KERNEL_ARG_TYPE_NAME, char, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+        arg_name = ccl_kernel_get_arg_info_array(krnl, i,
+            CL_KERNEL_ARG_NAME, char, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+        g_free(name);
+        name = ((arg_name != NULL) && (*arg_name != '\0'))
+            ? g_strdup(arg_name) : g_strdup_printf("arg%u", i);
+
+        if (g_str_has_prefix(type_name, "image")) {
+
+            /* Image argument. */
+            g_string_append_printf(params, ",\n    CCLImage * %s", name);
+            g_string_append_printf(docs,
+                " * @param[in] %s Image (argument %u).\n", name, i);
+            g_string_append_printf(stmts,
+                "    ccl_kernel_set_arg(ccl_krnl, %u, %s);\n", i, name);
+
+        } else if (g_strcmp0(type_name, "sampler_t") == 0) {
+
+            /* Sampler argument. */
+            g_string_append_printf(params, ",\n    CCLSampler * %s", name);
+            g_string_append_printf(docs,
+                " * @param[in] %s Sampler (argument %u).\n", name, i);
+            g_string_append_printf(stmts,
+                "    ccl_kernel_set_arg(ccl_krnl, %u, %s);\n", i, name);
+
+        } else if ((addr == CL_KERNEL_ARG_ADDRESS_GLOBAL)
+            || (addr == CL_KERNEL_ARG_ADDRESS_CONSTANT)) {
+
+            /* Buffer argument. */
+            g_string_append_printf(params, ",\n    CCLBuffer * %s", name);
+            g_string_append_printf(docs,
+                " * @param[in] %s Buffer with `%s` elements (argument %u).\n",
+                name, type_name, i);
+            g_string_append_printf(stmts,
+                "    ccl_kernel_set_arg(ccl_krnl, %u, %s);\n", i, name);
+
+        } else if (addr == CL_KERNEL_ARG_ADDRESS_LOCAL) {
+
+            /* Local memory argument. */
+            g_string_append_printf(params, ",\n    size_t %s_size", name);
+            g_string_append_printf(docs, " * @param[in] %s_size Size in bytes "
+                "of local memory for `%s` (argument %u).\n", name, name, i);
+            g_string_append_printf(stmts,
+                "    if (!ccl_kernel_set_arg_value(ccl_krnl, %u, %s_size, "
+                "NULL, ccl_err))\n        return NULL;\n", i, name);
+
+        } else if ((host_type = ccl_c_stub_host_type(type_name)) != NULL) {
+
+            /* Private argument with a host type. */
+            g_string_append_printf(params, ",\n    %s %s", host_type, name);
+            g_string_append_printf(docs,
+                " * @param[in] %s Value of `%s` (argument %u).\n",
+                name, type_name, i);
+            g_string_append_printf(stmts,
+                "    if (!ccl_kernel_set_arg_value(ccl_krnl, %u, sizeof(%s), "
+                "&%s, ccl_err))\n        return NULL;\n", i, host_type, name);
+            g_free(host_type);
+
+        } else {
+
+            /* Private argument of other type (e.g. a structure). */
+            g_string_append_printf(params,
+                ",\n    const void * %s, size_t %s_size", name, name);
+            g_string_append_printf(docs,
+                " * @param[in] %s Value of `%s` (argument %u).\n"
+                " * @param[in] %s_size Size in bytes of `%s`.\n",
+                name, type_name, i, name, name);
+            g_string_append_printf(stmts,
+                "    if (!ccl_kernel_set_arg_value(ccl_krnl, %u, %s_size, "
+                "%s, ccl_err))\n        return NULL;\n", i, name, name);
+
+        }
+    }
+
+    /* Append launch function. */
+    g_string_append_printf(header,
+        "/**\n"
+        " * Set the arguments of the `%s` kernel and enqueue it for\n"
+        " * execution.\n"
+        " *\n"
+        " * @param[in] ccl_krnl Wrapper of a `%s` kernel.\n"
+        " * @param[in] ccl_cq Command queue wrapper object.\n"
+        " * @param[in] ccl_work_dim Number of dimensions.\n"
+        " * @param[in] ccl_gwo Global work offset, or `NULL`.\n"
+        " * @param[in] ccl_gws Global work size.\n"
+        " * @param[in] ccl_lws Local work size, or `NULL`.\n"
+        " * @param[in,out] ccl_evt_wait_lst Event wait list, or `NULL`.\n"
+        "%s"
+        " * @param[out] ccl_err Return location for a ::CCLErr object, or\n"
+        " * `NULL` if error reporting is to be ignored.\n"
+        " * @return Event wrapper object that identifies this command.\n"
+        " * */\n"
+        "static inline CCLEvent * ccl_stub_%s(CCLKernel * ccl_krnl,\n"
+        "    CCLQueue * ccl_cq, cl_uint ccl_work_dim, const size_t * ccl_gwo,\n"
+        "    const size_t * ccl_gws, const size_t * ccl_lws,\n"
+        "    CCLEventWaitList * ccl_evt_wait_lst%s,\n"
+        "    CCLErr ** ccl_err) {\n"
+        "\n"
+        "%s"
+        "    return ccl_kernel_enqueue_ndrange(ccl_krnl, ccl_cq, "
+        "ccl_work_dim,\n"
+        "        ccl_gwo, ccl_gws, ccl_lws, ccl_evt_wait_lst, ccl_err);\n"
+        "}\n\n",
+        kernel, kernel, docs->str, kernel, params->str, stmts->str);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Free stuff. */
+    g_free(name);
+    g_string_free(params, TRUE);
+    g_string_free(docs, TRUE);
+    g_string_free(stmts, TRUE);
+
+    /* Return. */
+    return;
+}
+
+#endif
+
+/**
+ * Save a C header with one typed launch function for each kernel in a
+ * program. Launch functions are generated from kernel argument
+ * information, and set kernel arguments directly from typed parameters,
+ * without creating ::CCLArg* objects. They are named `ccl_stub_<kernel>()`,
+ * so that they don't collide with the `ccl_launch_*()` functions of the
+ * cf4ocl library.
+ *
+ * @param[in] prg Program, built with the `-cl-kernel-arg-info` option.
+ * @param[in] file Header output file.
+ * @param[out] err Return location for a CCLErr object.
+ * */
+void ccl_c_stubs_save(CCLProgram * prg, const char * file, CCLErr ** err) {
+
+#ifdef CL_VERSION_1_2
+
+    /* Kernel names. */
+    char * kernels_str;
+    gchar ** kernels = NULL;
+
+    /* Header include guard. */
+    gchar * guard = NULL;
+
+    /* Generated header. */
+    GString * header = g_string_new(NULL);
+
+    /* Internal error handling object. */
+    CCLErr * err_internal = NULL;
+
+    /* Get names of kernels in program. */
+    kernels_str = ccl_program_get_info_array(
+        prg, CL_PROGRAM_KERNEL_NAMES, char, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    kernels = g_strsplit(kernels_str, ";", -1);
+
+    /* Include guard is based on the header file name. */
+    guard = g_path_get_basename(file);
+    for (gchar * c = guard; *c != '\0'; ++c)
+        *c = g_ascii_isalnum(*c) ? g_ascii_toupper(*c) : '_';
+
+    g_string_append_printf(header,
+        "/* Kernel launch functions generated by ccl_c. */\n"
+        "\n"
+        "#ifndef _CCL_LAUNCH_%s_\n"
+        "#define _CCL_LAUNCH_%s_\n"
+        "\n"
+        "#include <cf4ocl2.h>\n"
+        "\n", guard, guard);
+
+    for (guint i = 0; kernels[i] != NULL; ++i) {
+        if (*kernels[i] == '\0') continue;
+        ccl_c_stub_append(prg, kernels[i], header, &err_internal);
+        ccl_if_err_propagate_goto(err, err_internal, error_handler);
+    }
+
+    g_string_append(header, "#endif\n");
+
+    /* Save header. */
+    g_file_set_contents(file, header->str, -1, &err_internal);
+    ccl_if_err_propagate_goto(err, err_internal, error_handler);
+
+    /* If we got here, everything is OK. */
+    g_assert(err == NULL || *err == NULL);
+    goto finish;
+
+error_handler:
+
+    /* If we got here there was an error, verify that it is so. */
+    g_assert(err == NULL || *err != NULL);
+
+finish:
+
+    /* Free stuff. */
+    g_strfreev(kernels);
+    g_free(guard);
+    g_string_free(header, TRUE);
+
+#else
+
+    CCL_UNUSED(prg);
+    CCL_UNUSED(file);
+    ccl_if_err_create_goto(*err, CCL_ERROR, TRUE,
+        CCL_ERROR_UNSUPPORTED_OCL, error_handler,
+        "The 'stubs' task requires cf4ocl to be compiled with support for "
+        "OpenCL >= 1.2.");
+
+error_handler:
+
+#endif
+
+    /* Return. */
+    return;
+}
+
 /**
  * Kernel analyzer main program function.
  *
@@ -392,6 +710,9 @@ int main(int argc, char * argv[]) {
     /* Build log. */
     const char * build_log;
 
+    /* Build options for the stubs task. */
+    gchar * stub_options = NULL;
+
     /* Parse command line options. */
     ccl_c_args_parse(argc, argv, &err);
     ccl_if_err_goto(err, error_handler);
@@ -586,6 +907,44 @@ int main(int argc, char * argv[]) {
 
                 break;
 
+            case CCL_C_STUBS:
+
+                /* Stubs require either one or more source files or one
+                 * binary file, and an output file. */
+                ccl_if_err_create_goto(err, CCL_ERROR,
+                    ((n_src_files > 0) && (n_bin_files > 0))
+                    || (n_bin_files > 1) || (n_src_h_files > 0)
+                    || (n_src_h_names > 0),
+                    CCL_ERROR_ARGS, error_handler,
+                    "The 'stubs' task requires either: 1) one or more "
+                    "source files; or, 2) one binary file.");
+                ccl_if_err_create_goto(err, CCL_ERROR, output == NULL,
+                    CCL_ERROR_ARGS, error_handler,
+                    "The 'stubs' task requires an output file.");
+
+                /* Create program object. */
+                if (n_bin_files == 1) {
+                    prg = ccl_program_new_from_binary_file(
+                        ctx, dev, *bin_files, NULL, &err);
+                } else {
+                    prg = ccl_program_new_from_source_files(
+                        ctx, n_src_files, (const char **) src_files, &err);
+                }
+                ccl_if_err_goto(err, error_handler);
+
+                /* Build program, keeping kernel argument information. */
+                stub_options = g_strconcat(options != NULL ? options : "",
+                    " -cl-kernel-arg-info", NULL);
+                ccl_program_build(prg, stub_options, &err_build);
+
+                /* Only check for errors that are not build/compile/link
+                 * failures. */
+                if (!ccl_c_is_build_error(err_build)) {
+                    ccl_if_err_propagate_goto(&err, err_build, error_handler);
+                }
+
+                break;
+
             default:
                 ccl_if_err_create_goto(err, CCL_ERROR, TRUE,
                     CCL_ERROR_ARGS, error_handler, "Unknown task: %d",
@@ -617,8 +976,15 @@ int main(int argc, char * argv[]) {
         /* Show build status. */
         g_printf("* Build status           : %s\n", build_status_str);
 
-        /* If build successful, save binary? */
-        if (output && prg && (build_status == CL_BUILD_SUCCESS)) {
+        /* If build successful, save launch functions or binary? */
+        if (output && prg && (build_status == CL_BUILD_SUCCESS)
+            && (task == CCL_C_STUBS)) {
+
+            ccl_c_stubs_save(prg, output, &err);
+            ccl_if_err_goto(err, error_handler);
+            g_printf("* Stubs output file      : %s\n", output);
+
+        } else if (output && prg && (build_status == CL_BUILD_SUCCESS)) {
 
             ccl_program_save_binary(prg, dev, output, &err);
             ccl_if_err_goto(err, error_handler);
@@ -722,6 +1088,7 @@ cleanup:
     if (kernel_names) g_strfreev(kernel_names);
     if (bin_files) g_strfreev(bin_files);
     if (options) g_free(options);
+    if (stub_options) g_free(stub_options);
     if (bld_log_out) g_free(bld_log_out);
     if (output) g_free(output);
     if (ctx) ccl_context_destroy(ctx);
@@ -29,6 +29,9 @@
 #include <cf4ocl2.h>
 #include "test.h"
 #include "_ccl_abstract_dev_container_wrapper.h"
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#endif
 
 /**
  * @internal
@@ -145,6 +148,410 @@ static void info_zero_size_test() {
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/**
+ * @internal
+ *
+ * @brief Tests recycling of wrappers and their information tables.
+ * */
+static void recycling_test() {
+
+    /* Test variables. */
+    void * var1, * var2;
+    size_t size = sizeof(CCLWrapper);
+    CCLWrapper * w;
+    CCLWrapperInfo * info;
+    CCLErr * err = NULL;
+
+    /* Create a mock wrapper and add some information to it. */
+    w = ccl_wrapper_new(CCL_NONE, (void *) &var1, size);
+    info = ccl_wrapper_info_new(sizeof(cl_uint));
+    *((cl_uint *) info->value) = 123;
+    ccl_wrapper_add_info(w, CL_CONTEXT_REFERENCE_COUNT, info);
+
+    /* Check that cached information is returned. */
+    g_assert_true(info == ccl_wrapper_get_info(w, NULL,
+        CL_CONTEXT_REFERENCE_COUNT, 0, CCL_INFO_CONTEXT, CL_TRUE, &err));
+    g_assert_no_error(err);
+
+    /* Destroy the mock wrapper. */
+    g_assert_true(ccl_wrapper_unref(w, size, NULL, NULL, NULL));
+    g_assert_true(ccl_wrapper_memcheck());
+
+    /* Create another mock wrapper of the same class, which may reuse the
+     * previous one, and check that it's in a pristine state. */
+    w = ccl_wrapper_new(CCL_NONE, (void *) &var2, size);
+    g_assert_cmpint(ccl_wrapper_ref_count(w), ==, 1);
+    g_assert_true(ccl_wrapper_unwrap(w) == (void *) &var2);
+
+    /* Destroy it. */
+    g_assert_true(ccl_wrapper_unref(w, size, NULL, NULL, NULL));
+
+    /* Confirm that no memory was allocated for wrappers. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/* Number of immutable parameters cached in the info overflow test, more
+ * than fit in the first table of immutable information. */
+#define INFO_OVERFLOW_PARAMS 200
+
+/**
+ * @internal
+ *
+ * @brief Tests that many immutable parameters can be cached, and are then
+ * served from the cache without locking or querying the OpenCL object.
+ * */
+static void info_overflow_test() {
+
+    /* Test variables. */
+    void * var;
+    size_t size = sizeof(CCLWrapper);
+    CCLWrapper * w;
+    CCLWrapperInfo * info;
+    CCLErr * err = NULL;
+    guint64 fast_hits, locked_hits, queries;
+    guint64 fast_hits_after, locked_hits_after, queries_after;
+
+    /* Create a mock device wrapper, since almost all device information
+     * is immutable. */
+    w = ccl_wrapper_new(CCL_DEVICE, (void *) &var, size);
+
+    /* Cache many immutable parameters. */
+    for (cl_uint i = 0; i < INFO_OVERFLOW_PARAMS; ++i) {
+        cl_uint value = 1000 + i;
+        g_assert_true(ccl_wrapper_add_info_immutable(w, 0x8000 + i,
+            CCL_INFO_DEVICE, &value, sizeof(cl_uint)));
+    }
+
+    /* All of them must be served from the cache, even when explicitly not
+     * using it, since the mock object can't be queried. */
+    ccl_wrapper_get_info_counters(
+        CCL_INFO_DEVICE, &fast_hits, &locked_hits, &queries);
+    for (cl_uint i = 0; i < INFO_OVERFLOW_PARAMS; ++i) {
+        info = ccl_wrapper_get_info(w, NULL, 0x8000 + i, 0,
+            CCL_INFO_DEVICE, CL_FALSE, &err);
+        g_assert_no_error(err);
+        g_assert_nonnull(info);
+        g_assert_cmpuint(info->size, ==, sizeof(cl_uint));
+        g_assert_cmpuint(*((cl_uint *) info->value), ==, 1000 + i);
+        g_assert_true(info == ccl_wrapper_lookup_info_immutable(
+            w, 0x8000 + i, CCL_INFO_DEVICE));
+    }
+    ccl_wrapper_get_info_counters(CCL_INFO_DEVICE,
+        &fast_hits_after, &locked_hits_after, &queries_after);
+    g_assert_cmpuint(fast_hits_after, ==, fast_hits + INFO_OVERFLOW_PARAMS);
+    g_assert_cmpuint(locked_hits_after, ==, locked_hits);
+    g_assert_cmpuint(queries_after, ==, queries);
+
+    /* Parameters which were not cached are not found. */
+    g_assert_null(ccl_wrapper_lookup_info_immutable(
+        w, 0x8000 + INFO_OVERFLOW_PARAMS, CCL_INFO_DEVICE));
+
+    /* Destroy the mock wrapper. */
+    g_assert_true(ccl_wrapper_unref(w, size, NULL, NULL, NULL));
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests wrapper runtime statistics.
+ * */
+static void stats_test() {
+
+    /* Test variables. */
+    void * var;
+    size_t size = sizeof(CCLWrapper);
+    CCLWrapper * mock_wrapper;
+    CCLWrapperStats before, during, after;
+    CCLErr * err = NULL;
+
+    ccl_wrapper_stats(&before);
+
+    /* Create a mock wrapper, and wrap the same object again. */
+    mock_wrapper = ccl_wrapper_new(CCL_NONE, (void *) &var, size);
+    g_assert_true(
+        mock_wrapper == ccl_wrapper_new(CCL_NONE, (void *) &var, size));
+
+    /* Only one live wrapper must have been accounted for. */
+    ccl_wrapper_stats(&during);
+    g_assert_cmpuint(during.live[CCL_NONE], ==, before.live[CCL_NONE] + 1);
+    g_assert_cmpuint(
+        during.bytes[CCL_NONE], ==, before.bytes[CCL_NONE] + size);
+
+    /* Destroy the mock wrapper, releasing the mock OpenCL object. */
+    g_assert_false(ccl_wrapper_unref(mock_wrapper, size, NULL, NULL, NULL));
+    g_assert_true(
+        ccl_wrapper_unref(mock_wrapper, size, NULL, mock_cl_release, &err));
+    g_assert_error(err, CCL_OCL_ERROR, CL_OUT_OF_RESOURCES);
+    ccl_err_clear(&err);
+
+    /* Wrapper must no longer be live, and the release call must have been
+     * accounted for. */
+    ccl_wrapper_stats(&after);
+    g_assert_cmpuint(after.live[CCL_NONE], ==, before.live[CCL_NONE]);
+    g_assert_cmpuint(after.bytes[CCL_NONE], ==, before.bytes[CCL_NONE]);
+    g_assert_cmpuint(after.release_calls, ==, before.release_calls + 1);
+    g_assert_cmpuint(after.registry_wait, >=, before.registry_wait);
+
+    /* Confirm that no memory was allocated for wrappers. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests that re-querying small information values, which are kept
+ * inline in the information table, doesn't change values previously
+ * returned for the same or for other parameters.
+ * */
+static void info_inline_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLErr * err = NULL;
+    CCLWrapperInfo * infos[8];
+    cl_uint ref_count;
+
+    /* Get a context. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get the reference count of the OpenCL context, without using the
+     * cache, while increasing it in between queries. */
+    for (guint i = 0; i < G_N_ELEMENTS(infos); ++i) {
+        infos[i] = ccl_context_get_info(ctx, CL_CONTEXT_REFERENCE_COUNT, &err);
+        g_assert_no_error(err);
+        g_assert_cmpuint(infos[i]->size, ==, sizeof(cl_uint));
+        g_assert_cmpint(clRetainContext(ccl_context_unwrap(ctx)),
+            ==, CL_SUCCESS);
+    }
+
+    /* Previously returned values must not have changed. */
+    ref_count = *((cl_uint *) infos[0]->value);
+    for (guint i = 0; i < G_N_ELEMENTS(infos); ++i) {
+        g_assert_cmpuint(infos[i]->size, ==, sizeof(cl_uint));
+        g_assert_cmpuint(*((cl_uint *) infos[i]->value), ==, ref_count + i);
+    }
+
+    /* Restore reference count and destroy context. */
+    for (guint i = 0; i < G_N_ELEMENTS(infos); ++i)
+        g_assert_cmpint(clReleaseContext(ccl_context_unwrap(ctx)),
+            ==, CL_SUCCESS);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/* Number of uncached information queries in the info soak test. */
+#define INFO_SOAK_ITERS 20000
+
+/* Number of queries after which the info soak test releases replaced
+ * information. */
+#define INFO_SOAK_RELEASE 1000
+
+/**
+ * @internal
+ *
+ * @brief Get resident set size of the current process in bytes, or 0 if
+ * not available on this platform.
+ * */
+static gsize info_soak_rss() {
+
+    gsize rss = 0;
+
+#ifdef G_OS_UNIX
+    gchar * statm = NULL;
+
+    if (g_file_get_contents("/proc/self/statm", &statm, NULL, NULL)) {
+        /* Second field is the number of resident pages. */
+        rss = (gsize) g_ascii_strtoull(strchr(statm, ' ') + 1, NULL, 10)
+            * (gsize) sysconf(_SC_PAGESIZE);
+        g_free(statm);
+    }
+#endif
+
+    return rss;
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests that information returned by a long-lived wrapper which
+ * is continuously queried without using the cache remains valid until
+ * explicitly released, and that releasing it keeps memory bounded.
+ * */
+static void info_soak_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLProgram * prg = NULL;
+    CCLErr * err = NULL;
+    CCLWrapperInfo * info;
+    CCLWrapperInfo * info_first = NULL;
+    const char * src = CCL_TEST_PROGRAM_SUM_CONTENT;
+    gsize src_len = strlen(src);
+    gsize rss_start, rss_end, rss_max;
+
+    /* Get a context and create a program, whose source is large enough not
+     * to be kept inline. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    prg = ccl_program_new_from_source(ctx, src, &err);
+    g_assert_no_error(err);
+
+    /* Query the program source over and over, without using the cache. */
+    rss_start = 0;
+    for (guint i = 0; i < INFO_SOAK_ITERS; ++i) {
+
+        info = ccl_program_get_info(prg, CL_PROGRAM_SOURCE, &err);
+        g_assert_no_error(err);
+        g_assert(info != NULL);
+
+        /* Information returned since replaced information was last
+         * released must still be valid. */
+        if (info_first == NULL)
+            info_first = info;
+        g_assert_cmpstr((char *) info_first->value, ==, src);
+
+        /* Periodically release replaced information, which is no longer
+         * being used. */
+        if ((i + 1) % INFO_SOAK_RELEASE == 0) {
+            ccl_wrapper_release_old_info((CCLWrapper *) prg);
+            info_first = NULL;
+        }
+
+        /* Measure memory after warming up. */
+        if (i == INFO_SOAK_ITERS / 10) rss_start = info_soak_rss();
+    }
+    rss_end = info_soak_rss();
+
+    g_test_message("Info soak: RSS went from %" G_GSIZE_FORMAT
+        " to %" G_GSIZE_FORMAT " bytes", rss_start, rss_end);
+
+    /* Memory must remain flat: unbounded growth would take at least one
+     * program source per query after warming up, so allow for less than
+     * half of that. */
+    rss_max = (INFO_SOAK_ITERS - INFO_SOAK_ITERS / 10) * src_len / 2;
+    if ((rss_start > 0) && (rss_end > rss_start))
+        g_assert_cmpuint(rss_end - rss_start, <, rss_max);
+
+    /* Destroy stuff. */
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/* Number of wrap/unwrap iterations performed by each thread in the
+ * registry benchmark. */
+#define REGISTRY_BENCH_ITERS 100000
+
+/* Maximum number of threads in the registry benchmark. */
+#define REGISTRY_BENCH_MAX_THREADS 8
+
+/* Fraction of the single thread throughput which the registry benchmark
+ * must at least reach with more threads, as long as there are enough
+ * processors for them. Wall-clock timings are unreliable on loaded
+ * machines, so this is only checked if the `CCL_TEST_PERF` environment
+ * variable is set. */
+#define REGISTRY_BENCH_MIN_SCALING 0.5
+
+/**
+ * @internal
+ *
+ * @brief Thread function for the registry benchmark. Wraps and releases
+ * fake OpenCL events in the same way ::ccl_queue_produce_event() and
+ * ::ccl_queue_gc() do, without an OpenCL driver in the way.
+ * */
+static gpointer registry_bench_thread(gpointer data) {
+
+    /* Fake OpenCL events are the addresses of elements in this array. */
+    cl_uint * fake_evts = (cl_uint *) data;
+    size_t size = sizeof(CCLWrapper);
+    CCLWrapper * w;
+
+    for (guint i = 0; i < REGISTRY_BENCH_ITERS; ++i) {
+
+        /* Wrap fake event... */
+        w = ccl_wrapper_new(CCL_EVENT, (void *) &fake_evts[i % 16], size);
+        g_assert_nonnull(w);
+
+        /* ...and release it. */
+        ccl_wrapper_unref(w, size, NULL, NULL, NULL);
+    }
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Benchmarks and tests concurrent wrapping and releasing of
+ * OpenCL objects with an increasing number of threads. Since each thread
+ * wraps different objects, throughput must not drop well below the single
+ * thread throughput when more threads are used.
+ * */
+static void registry_concurrency_test() {
+
+    /* Test variables. */
+    GThread * threads[REGISTRY_BENCH_MAX_THREADS];
+    cl_uint fake_evts[REGISTRY_BENCH_MAX_THREADS][16];
+    GTimer * timer = g_timer_new();
+    gdouble elapsed, throughput, throughput_1t = 0;
+    guint num_procs = g_get_num_processors();
+    gboolean check_perf = (g_getenv("CCL_TEST_PERF") != NULL);
+
+    /* Run benchmark with 1, 2, 4, ..., REGISTRY_BENCH_MAX_THREADS threads. */
+    for (guint nt = 1; nt <= REGISTRY_BENCH_MAX_THREADS; nt *= 2) {
+
+        g_timer_start(timer);
+
+        for (guint t = 0; t < nt; ++t)
+            threads[t] = g_thread_new(
+                "registry_bench", registry_bench_thread, fake_evts[t]);
+
+        for (guint t = 0; t < nt; ++t)
+            g_thread_join(threads[t]);
+
+        elapsed = g_timer_elapsed(timer, NULL);
+        throughput = (nt * REGISTRY_BENCH_ITERS) / elapsed;
+
+        g_test_message("Registry: %u thread(s), %.0f wraps/s",
+            nt, throughput);
+
+        /* If requested, check throughput against the single thread
+         * throughput. */
+        if (nt == 1)
+            throughput_1t = throughput;
+        else if (check_perf && (nt <= num_procs))
+            g_assert_cmpfloat(throughput, >=,
+                REGISTRY_BENCH_MIN_SCALING * throughput_1t);
+
+        /* All wrappers must have been released. */
+        g_assert_true(ccl_wrapper_memcheck());
+    }
+
+    g_timer_destroy(timer);
+
+    /* Concurrently wrap the same objects, all threads must get the same
+     * wrapper for each object, which must be destroyed only once. */
+    for (guint t = 0; t < REGISTRY_BENCH_MAX_THREADS; ++t)
+        threads[t] = g_thread_new(
+            "registry_bench", registry_bench_thread, fake_evts[0]);
+
+    for (guint t = 0; t < REGISTRY_BENCH_MAX_THREADS; ++t)
+        g_thread_join(threads[t]);
+
+    /* Confirm that memory allocated by wrappers has been properly freed,
+     * which also releases the now empty registry tables. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -169,5 +576,29 @@ int main(int argc, char ** argv) {
         "/wrappers/abstract/info_zero_size",
         info_zero_size_test);
 
+    g_test_add_func(
+        "/wrappers/abstract/recycling",
+        recycling_test);
+
+    g_test_add_func(
+        "/wrappers/abstract/info-inline",
+        info_inline_test);
+
+    g_test_add_func(
+        "/wrappers/abstract/info-overflow",
+        info_overflow_test);
+
+    g_test_add_func(
+        "/wrappers/abstract/info-soak",
+        info_soak_test);
+
+    g_test_add_func(
+        "/wrappers/abstract/stats",
+        stats_test);
+
+    g_test_add_func(
+        "/wrappers/abstract/registry-concurrency",
+        registry_concurrency_test);
+
     return g_test_run();
 }
@@ -86,6 +86,20 @@ static void create_info_destroy_test() {
     g_assert_cmphex(GPOINTER_TO_SIZE(context), ==,
         GPOINTER_TO_SIZE(ccl_context_unwrap(ctx)));
 
+    /* Check that the OpenCL version of the buffer is the same as the one
+     * of its context, and that it's only determined once. */
+    CCLWrapperStats stats1, stats2;
+    cl_uint ocl_ver = ccl_memobj_get_opencl_version((CCLMemObj *) b, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(ocl_ver, ==, ccl_context_get_opencl_version(ctx, NULL));
+    ccl_wrapper_stats(&stats1);
+    g_assert_cmpuint(ocl_ver, ==,
+        ccl_memobj_get_opencl_version((CCLMemObj *) b, &err));
+    g_assert_no_error(err);
+    ccl_wrapper_stats(&stats2);
+    for (guint i = 0; i < CCL_INFO_END; ++i)
+        g_assert_cmpuint(stats1.info_calls[i], ==, stats2.info_calls[i]);
+
     /* Destroy buffer. */
     ccl_buffer_destroy(b);
 
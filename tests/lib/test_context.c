@@ -30,6 +30,7 @@
 #include <cf4ocl2.h>
 #include <glib/gstdio.h>
 #include "test.h"
+#include "_ccl_abstract_wrapper.h"
 
 static const char * ccl_test_channel_order_string(cl_uint co) {
     switch(co) {
@@ -892,6 +893,61 @@ static void device_container_test() {
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/**
+ * @internal
+ *
+ * @brief Tests prefetching of device information for all devices in a
+ * context.
+ * */
+static void prefetch_device_info_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLErr * err = NULL;
+    char * name;
+    cl_uint compute_units;
+    guint64 queries, queries_after;
+    const cl_uint params[] = { CL_DEVICE_NAME, CL_DEVICE_TYPE,
+        CL_DEVICE_MAX_COMPUTE_UNITS, CL_DEVICE_GLOBAL_MEM_SIZE,
+        CL_DEVICE_MAX_WORK_ITEM_SIZES };
+
+    /* Create some context. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Prefetch device information in parallel. */
+    ccl_context_prefetch_device_info(
+        ctx, params, G_N_ELEMENTS(params), &err);
+    g_assert_no_error(err);
+
+    /* Prefetching again should find everything in the cache. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(ccl_device_prefetch_info(
+        dev, params, G_N_ELEMENTS(params)), ==, G_N_ELEMENTS(params));
+
+    /* Getting prefetched information should not query the device. */
+    ccl_wrapper_get_info_counters(CCL_INFO_DEVICE, NULL, NULL, &queries);
+    name = ccl_device_get_info_array(dev, CL_DEVICE_NAME, char, &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(name);
+    compute_units = ccl_device_get_info_scalar(
+        dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(compute_units, >, 0);
+    ccl_wrapper_get_info_counters(
+        CCL_INFO_DEVICE, NULL, NULL, &queries_after);
+    g_assert_cmpuint(queries_after, ==, queries);
+
+    /* Destroy context. */
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly
+     * freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -920,5 +976,9 @@ int main(int argc, char ** argv) {
         "/wrappers/context/device-container",
         device_container_test);
 
+    g_test_add_func(
+        "/wrappers/context/prefetch-device-info",
+        prefetch_device_info_test);
+
     return g_test_run();
 }
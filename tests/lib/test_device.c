@@ -28,6 +28,7 @@
 
 #include <cf4ocl2.h>
 #include "test.h"
+#include "_ccl_abstract_wrapper.h"
 
 /**
  * @internal
@@ -42,6 +43,8 @@ static void info_test() {
     CCLErr * err = NULL;
     cl_ulong scalar;
     size_t * array;
+    guint64 fast_hits, locked_hits, queries;
+    guint64 fast_hits_after, locked_hits_after, queries_after;
 
     /* Get the test context with the pre-defined device. */
     ctx = ccl_test_context_new(0, &err);
@@ -65,6 +68,22 @@ static void info_test() {
     g_assert_cmpuint(array[1], >=, 1);
     g_assert_cmpuint(array[2], >=, 1);
 
+    /* Get the same immutable information again, which should be served
+     * from the cache without locking or querying the device. */
+    ccl_wrapper_get_info_counters(
+        CCL_INFO_DEVICE, &fast_hits, &locked_hits, &queries);
+    g_assert_true(array == ccl_device_get_info_array(
+        dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t, &err));
+    g_assert_no_error(err);
+    g_assert_cmpuint(scalar, ==, ccl_device_get_info_scalar(
+        dev, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE, cl_ulong, &err));
+    g_assert_no_error(err);
+    ccl_wrapper_get_info_counters(CCL_INFO_DEVICE,
+        &fast_hits_after, &locked_hits_after, &queries_after);
+    g_assert_cmpuint(fast_hits_after, ==, fast_hits + 2);
+    g_assert_cmpuint(locked_hits_after, ==, locked_hits);
+    g_assert_cmpuint(queries_after, ==, queries);
+
     /* Confirm that memory allocated by wrappers has not yet been freed. */
     g_assert_false(ccl_wrapper_memcheck());
 
@@ -0,0 +1,221 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * Test the dispatcher class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+#define CCL_TEST_DISPATCHER_KERNEL_NAME "test_krnl"
+
+#define CCL_TEST_DISPATCHER_KERNEL_CONTENT \
+    "__kernel void " CCL_TEST_DISPATCHER_KERNEL_NAME \
+    "(__global uint * buf, uint inc)\n" \
+    "{\n" \
+    "	int gid = get_global_id(0);\n" \
+    "	buf[gid] = buf[gid] + inc;\n" \
+    "}\n"
+
+#define CCL_TEST_DISPATCHER_BUF_SIZE 64
+#define CCL_TEST_DISPATCHER_PRODUCERS 4
+#define CCL_TEST_DISPATCHER_ITERS 20
+
+/**
+ * @internal
+ *
+ * @brief Data of a producer thread.
+ * */
+typedef struct {
+
+    /** Dispatcher. */
+    CCLDispatcher * dsp;
+    /** Shared kernel. */
+    CCLKernel * krnl;
+    /** Buffer of this producer. */
+    CCLBuffer * buf;
+    /** Increment used by this producer. */
+    cl_uint inc;
+    /** Host data. */
+    cl_uint host[CCL_TEST_DISPATCHER_BUF_SIZE];
+
+} CCLTestProducer;
+
+/**
+ * @internal
+ *
+ * @brief Producer thread: write buffer, increment it several times with the
+ * shared kernel and read it back.
+ * */
+static gpointer producer_thread(gpointer data) {
+
+    CCLTestProducer * prod = (CCLTestProducer *) data;
+    CCLSubmission * sub;
+    CCLErr * err = NULL;
+    size_t gws = CCL_TEST_DISPATCHER_BUF_SIZE;
+    size_t bsize = CCL_TEST_DISPATCHER_BUF_SIZE * sizeof(cl_uint);
+
+    sub = ccl_dispatcher_submit_write(prod->dsp, prod->buf, 0, bsize,
+        prod->host);
+    ccl_submission_destroy(sub);
+
+    for (cl_uint i = 0; i < CCL_TEST_DISPATCHER_ITERS; ++i) {
+        sub = ccl_dispatcher_submit_ndrange(prod->dsp, prod->krnl, 1, NULL,
+            &gws, NULL, prod->buf, ccl_arg_priv(prod->inc, cl_uint), NULL);
+        ccl_submission_destroy(sub);
+    }
+
+    sub = ccl_dispatcher_submit_read(prod->dsp, prod->buf, 0, bsize,
+        prod->host);
+    ccl_submission_wait(sub, &err);
+    g_assert_no_error(err);
+    ccl_submission_destroy(sub);
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Function submitted to the dispatcher, which enqueues a marker.
+ * */
+static CCLEvent * marker_func(CCLQueue * cq, void * data, CCLErr ** err) {
+
+    g_atomic_int_inc((gint *) data);
+    return ccl_enqueue_marker(cq, NULL, err);
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests several producer threads feeding one command queue through
+ * a dispatcher.
+ * */
+static void multi_producer_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLQueue * cq = NULL;
+    CCLDispatcher * dsp = NULL;
+    CCLSubmission * sub = NULL;
+    CCLErr * err = NULL;
+    GThread * threads[CCL_TEST_DISPATCHER_PRODUCERS];
+    CCLTestProducer prods[CCL_TEST_DISPATCHER_PRODUCERS];
+    size_t bsize = CCL_TEST_DISPATCHER_BUF_SIZE * sizeof(cl_uint);
+    gint calls = 0;
+
+    /* Get some context, device and queue. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create program and kernel. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_DISPATCHER_KERNEL_CONTENT, &err);
+    g_assert_no_error(err);
+
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+
+    krnl = ccl_program_get_kernel(
+        prg, CCL_TEST_DISPATCHER_KERNEL_NAME, &err);
+    g_assert_no_error(err);
+
+    /* Create dispatcher with a small ring, so that it fills up. */
+    dsp = ccl_dispatcher_new(cq, 4, &err);
+    g_assert_no_error(err);
+
+    /* Start producers, each with its own buffer. */
+    for (cl_uint p = 0; p < CCL_TEST_DISPATCHER_PRODUCERS; ++p) {
+        prods[p].dsp = dsp;
+        prods[p].krnl = krnl;
+        prods[p].inc = p + 1;
+        for (cl_uint i = 0; i < CCL_TEST_DISPATCHER_BUF_SIZE; ++i)
+            prods[p].host[i] = i;
+        prods[p].buf = ccl_buffer_new(
+            ctx, CL_MEM_READ_WRITE, bsize, NULL, &err);
+        g_assert_no_error(err);
+        threads[p] = g_thread_new(
+            "test_producer", producer_thread, &prods[p]);
+    }
+
+    /* Wait for producers and check results. */
+    for (cl_uint p = 0; p < CCL_TEST_DISPATCHER_PRODUCERS; ++p) {
+        g_thread_join(threads[p]);
+        for (cl_uint i = 0; i < CCL_TEST_DISPATCHER_BUF_SIZE; ++i)
+            g_assert_cmpuint(prods[p].host[i], ==,
+                i + CCL_TEST_DISPATCHER_ITERS * prods[p].inc);
+    }
+
+    /* Submit a function. */
+    sub = ccl_dispatcher_submit_func(dsp, marker_func, &calls);
+    ccl_submission_wait(sub, &err);
+    g_assert_no_error(err);
+    g_assert_cmpint(calls, ==, 1);
+    ccl_submission_destroy(sub);
+
+    /* Destroy dispatcher. */
+    ccl_dispatcher_destroy(dsp);
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    /* Destroy stuff. */
+    for (cl_uint p = 0; p < CCL_TEST_DISPATCHER_PRODUCERS; ++p)
+        ccl_buffer_destroy(prods[p].buf);
+    ccl_queue_destroy(cq);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char ** argv) {
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func(
+        "/dispatcher/multi-producer",
+        multi_producer_test);
+
+    return g_test_run();
+}
@@ -291,6 +291,7 @@ static void event_wait_lists_test() {
     cl_float host_buf2[8];
     CCLEvent * evt_array[2] = { NULL, NULL };
     CCLEventWaitList ewl = NULL;
+    CCLEventWaitListBuf ewl_buf;
     const cl_event * clevent_ptr;
     cl_uint num_evts;
 
@@ -360,6 +361,34 @@ static void event_wait_lists_test() {
     ccl_event_wait_list_clear(&ewl);
     g_assert_true(ewl == NULL);
 
+    /* Use an event wait list with storage on the stack, adding more events
+     * than fit in its inline storage. */
+    ewl = ccl_event_wait_list_init(&ewl_buf);
+    for (cl_uint i = 0; i < CCL_EVENT_WAIT_LIST_INLINE + 4; ++i)
+        ccl_event_wait_list_add(&ewl, evt, NULL);
+    num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+    g_assert_cmpuint(num_evts, ==, CCL_EVENT_WAIT_LIST_INLINE + 4);
+    clevent_ptr = ccl_event_wait_list_get_clevents(ewl_test_aux(&ewl));
+    g_assert_true(clevent_ptr[num_evts - 1] == ccl_event_unwrap(evt));
+
+    /* Wait on events, list should be reset instead of set to NULL. */
+    ccl_event_wait(&ewl, &err);
+    g_assert_no_error(err);
+    g_assert_true(ewl == &ewl_buf);
+    num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+    g_assert_cmpuint(num_evts, ==, 0);
+    clevent_ptr = ccl_event_wait_list_get_clevents(ewl_test_aux(&ewl));
+    g_assert_true(clevent_ptr == NULL);
+
+    /* Reuse list with an enqueue function. */
+    evt = ccl_buffer_enqueue_read(
+        buf, cq1, CL_TRUE, 0, 8 * sizeof(cl_float),
+        host_buf2, ccl_ewl(&ewl, evt, NULL), &err);
+    g_assert_no_error(err);
+    g_assert_true(ewl == &ewl_buf);
+    num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+    g_assert_cmpuint(num_evts, ==, 0);
+
     /* Confirm that memory allocated by wrappers has not yet been freed. */
     g_assert_false(ccl_wrapper_memcheck());
 
@@ -581,6 +610,113 @@ static void callback_test() {
 
 }
 
+#ifdef CL_VERSION_1_1
+
+/**
+ * @internal
+ *
+ * @brief Test host function for event continuations.
+ *
+ * @param[in] exec_status Execution status of the event.
+ * @param[out] user_data Counter to increment.
+ * */
+static void then_fun(cl_int exec_status, void * user_data) {
+
+    /* Confirm event is CL_COMPLETE. */
+    g_assert_cmpint(exec_status, ==, CL_COMPLETE);
+
+    /* Provide evidence that the host function was called. */
+    g_atomic_int_inc((volatile gint *) user_data);
+}
+
+#endif
+
+/**
+ * @internal
+ *
+ * @brief Tests event continuations with ccl_event_then() and
+ * ccl_event_when_all().
+ * */
+static void then_when_all_test() {
+
+#ifndef CL_VERSION_1_1
+
+    g_test_skip(
+        "Test skipped due to lack of OpenCL 1.1 support.");
+
+#else
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf = NULL;
+    CCLEvent * evt = NULL;
+    CCLEvent * f1 = NULL, * f2 = NULL, * f3 = NULL, * fall = NULL;
+    CCLEventWaitList ewl = NULL;
+    CCLErr * err = NULL;
+    cl_uint vector[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    volatile gint count = 0;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(110, &err);
+    g_assert_no_error(err);
+    if (!ctx) return;
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a command queue. */
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a device buffer. */
+    buf = ccl_buffer_new(
+        ctx, CL_MEM_READ_WRITE, 8 * sizeof(cl_uint), NULL, &err);
+    g_assert_no_error(err);
+
+    /* Write something to buffer and get an event. */
+    evt = ccl_buffer_enqueue_write(
+        buf, cq, CL_FALSE, 0, 8 * sizeof(cl_uint), vector, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Run two host functions once the event completes. */
+    f1 = ccl_event_then(evt, then_fun, (void *) &count, &err);
+    g_assert_no_error(err);
+    f2 = ccl_event_then(evt, then_fun, (void *) &count, &err);
+    g_assert_no_error(err);
+
+    /* Chain another host function after the first one. */
+    f3 = ccl_event_then(f1, then_fun, (void *) &count, &err);
+    g_assert_no_error(err);
+
+    /* Combine continuations, wait for them to complete. */
+    fall = ccl_event_when_all(ccl_ewl(&ewl, f2, f3, NULL), &err);
+    g_assert_no_error(err);
+    g_assert_true(ewl == NULL);
+    ccl_event_wait(ccl_ewl(&ewl, fall, NULL), &err);
+    g_assert_no_error(err);
+
+    /* Confirm that all host functions were called. */
+    g_assert_cmpint(g_atomic_int_get(&count), ==, 3);
+
+    /* Release wrappers. */
+    ccl_event_destroy(fall);
+    ccl_event_destroy(f3);
+    ccl_event_destroy(f2);
+    ccl_event_destroy(f1);
+    ccl_buffer_destroy(buf);
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly
+     * freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+
+#endif
+
+}
 
 /**
  * @internal
@@ -614,5 +750,9 @@ int main(int argc, char ** argv) {
         "/wrappers/event/callback",
         callback_test);
 
+    g_test_add_func(
+        "/wrappers/event/then-when-all",
+        then_when_all_test);
+
     return g_test_run();
 }
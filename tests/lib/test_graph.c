@@ -0,0 +1,193 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * Test the command graph class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+#define CCL_TEST_GRAPH_KERNEL_NAME "test_krnl"
+
+#define CCL_TEST_GRAPH_KERNEL_CONTENT \
+    "__kernel void " CCL_TEST_GRAPH_KERNEL_NAME "(__global uint * buf)\n" \
+    "{\n" \
+    "	int gid = get_global_id(0);\n" \
+    "	buf[gid] = buf[gid] + 1;\n" \
+    "}\n"
+
+#define CCL_TEST_GRAPH_BUF_SIZE 16
+
+/**
+ * @internal
+ *
+ * @brief Replay a command graph and wait for it to complete.
+ * */
+static void replay_and_wait(CCLGraph * graph, CCLQueue * cq) {
+
+    CCLErr * err = NULL;
+    CCLEvent * evt = NULL;
+    CCLEventWaitList ewl = NULL;
+
+    evt = ccl_graph_replay(graph, cq, NULL, &err);
+    g_assert_no_error(err);
+    g_assert(evt != NULL);
+
+    ccl_event_wait(ccl_ewl(&ewl, evt, NULL), &err);
+    g_assert_no_error(err);
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests recording a command graph, replaying it several times and
+ * patching it between replays.
+ * */
+static void record_replay_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf1 = NULL;
+    CCLBuffer * buf2 = NULL;
+    CCLGraph * graph = NULL;
+    CCLErr * err = NULL;
+    size_t gws = CCL_TEST_GRAPH_BUF_SIZE;
+    size_t bsize = CCL_TEST_GRAPH_BUF_SIZE * sizeof(cl_uint);
+    cl_uint hin1[CCL_TEST_GRAPH_BUF_SIZE];
+    cl_uint hin2[CCL_TEST_GRAPH_BUF_SIZE];
+    cl_uint hout[CCL_TEST_GRAPH_BUF_SIZE];
+    cl_uint nwrite, nkrnl1, nkrnl2, nread;
+
+    /* Initialize host data. */
+    for (cl_uint i = 0; i < CCL_TEST_GRAPH_BUF_SIZE; ++i) {
+        hin1[i] = i;
+        hin2[i] = 2 * i;
+    }
+
+    /* Get some context, device and queue. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create program, kernel and buffers. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_GRAPH_KERNEL_CONTENT, &err);
+    g_assert_no_error(err);
+
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+
+    krnl = ccl_program_get_kernel(prg, CCL_TEST_GRAPH_KERNEL_NAME, &err);
+    g_assert_no_error(err);
+
+    buf1 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE, bsize, NULL, &err);
+    g_assert_no_error(err);
+
+    buf2 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE, bsize, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Record graph: write, increment twice, read. */
+    graph = ccl_graph_new();
+    nwrite = ccl_graph_write(graph, buf1, 0, bsize, hin1);
+    nkrnl1 = ccl_graph_kernel(graph, krnl, 1, NULL, &gws, NULL, buf1, NULL);
+    nkrnl2 = ccl_graph_kernel(graph, krnl, 1, NULL, &gws, NULL, buf1, NULL);
+    nread = ccl_graph_read(graph, buf1, 0, bsize, hout);
+    ccl_graph_add_dep(graph, nkrnl1, nwrite);
+    ccl_graph_add_dep(graph, nkrnl2, nkrnl1);
+    ccl_graph_add_dep(graph, nread, nkrnl2);
+    g_assert_cmpuint(ccl_graph_get_num_nodes(graph), ==, 4);
+
+    /* Replay graph twice, results should be the same. */
+    for (cl_uint r = 0; r < 2; ++r) {
+        replay_and_wait(graph, cq);
+        for (cl_uint i = 0; i < CCL_TEST_GRAPH_BUF_SIZE; ++i)
+            g_assert_cmpuint(hout[i], ==, i + 2);
+    }
+
+    /* Patch host pointer of the write and replay. */
+    ccl_graph_set_host_ptr(graph, nwrite, hin2);
+    replay_and_wait(graph, cq);
+    for (cl_uint i = 0; i < CCL_TEST_GRAPH_BUF_SIZE; ++i)
+        g_assert_cmpuint(hout[i], ==, 2 * i + 2);
+
+    /* Patch buffers and kernel arguments, and replay. */
+    ccl_graph_set_buffer(graph, nwrite, buf2);
+    ccl_graph_set_buffer(graph, nread, buf2);
+    ccl_graph_set_arg(graph, nkrnl1, 0, buf2);
+    ccl_graph_set_arg(graph, nkrnl2, 0, buf2);
+    ccl_graph_set_host_ptr(graph, nwrite, hin1);
+    replay_and_wait(graph, cq);
+    for (cl_uint i = 0; i < CCL_TEST_GRAPH_BUF_SIZE; ++i)
+        g_assert_cmpuint(hout[i], ==, i + 2);
+
+    /* Replaying an empty graph is an error. */
+    ccl_graph_destroy(graph);
+    graph = ccl_graph_new();
+    g_assert(ccl_graph_replay(graph, cq, NULL, &err) == NULL);
+    g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+    g_clear_error(&err);
+    ccl_graph_destroy(graph);
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    /* Destroy stuff. */
+    ccl_buffer_destroy(buf1);
+    ccl_buffer_destroy(buf2);
+    ccl_queue_destroy(cq);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char ** argv) {
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func(
+        "/graph/record-replay",
+        record_replay_test);
+
+    return g_test_run();
+}
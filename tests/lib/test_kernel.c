@@ -27,6 +27,7 @@
  * */
 
 #include <cf4ocl2.h>
+#include <glib/gstdio.h>
 #include "test.h"
 
 #define CCL_TEST_KERNEL_NAME "test_krnl"
@@ -305,6 +306,94 @@ static void info_workgroup_test() {
 
 }
 
+#define CCL_TEST_KERNEL_LOCAL_NAME "test_krnl_local"
+
+#define CCL_TEST_KERNEL_LOCAL_CONTENT \
+    "__kernel void " CCL_TEST_KERNEL_LOCAL_NAME \
+    "(__global uint * buf, __local uint * loc)\n" \
+    "{\n" \
+    "	uint gid = get_global_id(0);\n" \
+    "	uint lid = get_local_id(0);\n" \
+    "	loc[lid] = buf[gid];\n" \
+    "	barrier(CLK_LOCAL_MEM_FENCE);\n" \
+    "	buf[gid] = loc[get_local_size(0) - lid - 1];\n" \
+    "}\n"
+
+/**
+ * @internal
+ *
+ * @brief Tests that kernel work group information which depends on the
+ * size of local memory arguments is not taken from the cache.
+ * */
+static void info_workgroup_local_mem_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLDevice * dev = NULL;
+    cl_ulong lmem_small, lmem_large;
+    size_t kwgz;
+    size_t small = 16 * sizeof(cl_uint);
+    size_t large = 256 * sizeof(cl_uint);
+    CCLErr * err = NULL;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a new program from source and build it. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_KERNEL_LOCAL_CONTENT, &err);
+    g_assert_no_error(err);
+
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Get kernel wrapper. */
+    krnl = ccl_program_get_kernel(prg, CCL_TEST_KERNEL_LOCAL_NAME, &err);
+    g_assert_no_error(err);
+
+    /* Set a small local memory argument and get local memory use. */
+    ccl_kernel_set_arg_value(krnl, 1, small, NULL, &err);
+    g_assert_no_error(err);
+
+    lmem_small = ccl_kernel_get_workgroup_info_scalar(
+        krnl, dev, CL_KERNEL_LOCAL_MEM_SIZE, cl_ulong, &err);
+    g_assert_no_error(err);
+
+    /* Make the local memory argument larger, local memory use must be
+     * queried again. */
+    ccl_kernel_set_arg_value(krnl, 1, large, NULL, &err);
+    g_assert_no_error(err);
+
+    lmem_large = ccl_kernel_get_workgroup_info_scalar(
+        krnl, dev, CL_KERNEL_LOCAL_MEM_SIZE, cl_ulong, &err);
+    g_assert_no_error(err);
+
+    g_assert_cmpuint(lmem_large, >, lmem_small);
+
+    /* Maximum work-group size must still be available. */
+    kwgz = ccl_kernel_get_workgroup_info_scalar(
+        krnl, dev, CL_KERNEL_WORK_GROUP_SIZE, size_t, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(kwgz, >, 0);
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    /* Destroy stuff. */
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -728,6 +817,7 @@ static void suggest_worksizes_test() {
     CCLErr * err = NULL;
     CCLProgram * prg = NULL;
     CCLKernel * krnl = NULL;
+    size_t rws, gws1, gws2, lws1, lws2;
 
     /* Get the test context with the pre-defined device. */
     ctx = ccl_test_context_new(0, &err);
@@ -754,6 +844,25 @@ static void suggest_worksizes_test() {
     /* Test with non-NULL kernel. */
     suggest_worksizes_aux(dev, krnl);
 
+    /* Repeated requests must give the same work sizes. */
+    rws = 1000;
+    lws1 = 0;
+    ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, &gws1, &lws1, &err);
+    g_assert_no_error(err);
+    lws2 = 0;
+    ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, &gws2, &lws2, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(lws1, ==, lws2);
+    g_assert_cmpuint(gws1, ==, gws2);
+
+    /* The only local work size which divides a large prime real work
+     * size within device limits is 1. */
+    rws = 2147483647;
+    lws1 = 0;
+    ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, NULL, &lws1, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(lws1, ==, 1);
+
     /* Destroy program. */
     ccl_program_destroy(prg);
 
@@ -1306,6 +1415,335 @@ skip:
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/**
+ * @internal
+ *
+ * @brief Tests splitting an NDRange across several command queues.
+ * */
+static void ndrange_multi_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLBuffer * buf = NULL;
+    CCLQueue * queues[3] = { NULL, NULL, NULL };
+    CCLErr * err = NULL;
+    cl_uint hbuf[CCL_TEST_KERNEL_BUF_SIZE * 8];
+    size_t chunks_done[3];
+    size_t gws = CCL_TEST_KERNEL_BUF_SIZE * 8;
+    size_t lws = CCL_TEST_KERNEL_LWS;
+    size_t total_chunks = 0;
+    cl_uint num_devs, num_queues;
+    cl_bool status;
+
+    /* Get a context which supports OpenCL >= 1.1. */
+    ctx = ccl_test_context_new(110, &err);
+    g_assert_no_error(err);
+    if (!ctx) return;
+
+    /* Create two queues for the first device, and one for the second
+     * device, if any. */
+    num_devs = ccl_context_get_num_devices(ctx, &err);
+    g_assert_no_error(err);
+    num_queues = (num_devs > 1) ? 3 : 2;
+    for (cl_uint i = 0; i < num_queues; ++i) {
+        queues[i] = ccl_queue_new(ctx,
+            ccl_context_get_device(ctx, (i < 2) ? 0 : 1, &err), 0, &err);
+        g_assert_no_error(err);
+    }
+
+    /* Create program and kernel. */
+    prg = ccl_program_new_from_source(ctx, CCL_TEST_KERNEL_CONTENT, &err);
+    g_assert_no_error(err);
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+    krnl = ccl_program_get_kernel(prg, CCL_TEST_KERNEL_NAME, &err);
+    g_assert_no_error(err);
+
+    /* Initialize buffer. */
+    for (cl_uint i = 0; i < gws; ++i) hbuf[i] = i;
+    buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        sizeof(hbuf), hbuf, &err);
+    g_assert_no_error(err);
+
+    /* Increment all elements, one work-group per chunk. */
+    ccl_kernel_set_args(krnl, buf, NULL);
+    status = ccl_kernel_enqueue_ndrange_multi(krnl, queues, num_queues, 1,
+        NULL, &gws, &lws, lws, chunks_done, &err);
+    g_assert_no_error(err);
+    g_assert_true(status);
+
+    /* All chunks should have been executed exactly once. */
+    for (cl_uint i = 0; i < num_queues; ++i)
+        total_chunks += chunks_done[i];
+    g_assert_cmpuint(total_chunks, ==, gws / lws);
+
+    ccl_buffer_enqueue_read(buf, queues[0], CL_TRUE, 0, sizeof(hbuf), hbuf,
+        NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < gws; ++i)
+        g_assert_cmpuint(hbuf[i], ==, i + 1);
+
+    /* A chunk size which is not a multiple of the local work size is an
+     * error. */
+    status = ccl_kernel_enqueue_ndrange_multi(krnl, queues, num_queues, 1,
+        NULL, &gws, &lws, lws + 1, NULL, &err);
+    g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+    g_assert_false(status);
+    g_clear_error(&err);
+
+    /* Destroy stuff. */
+    ccl_buffer_destroy(buf);
+    for (cl_uint i = 0; i < num_queues; ++i)
+        ccl_queue_destroy(queues[i]);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+#define CCL_TEST_KERNEL_INC_NAME "test_krnl_inc"
+
+#define CCL_TEST_KERNEL_INC_CONTENT \
+    "__kernel void " CCL_TEST_KERNEL_INC_NAME \
+    "(__global uint * buf, uint inc)\n" \
+    "{\n" \
+    "	int gid = get_global_id(0);\n" \
+    "	buf[gid] = buf[gid] + inc;\n" \
+    "}\n"
+
+/**
+ * @internal
+ *
+ * @brief Tests that kernel executions are correct when kernel arguments are
+ * repeatedly set to the same or to different values.
+ * */
+static void args_redundant_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf1 = NULL;
+    CCLBuffer * buf2 = NULL;
+    CCLErr * err = NULL;
+    cl_uint hbuf[CCL_TEST_KERNEL_BUF_SIZE];
+    size_t gws = CCL_TEST_KERNEL_BUF_SIZE;
+    cl_uint inc;
+
+    /* Get some context, device and queue. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create program and kernel. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_KERNEL_INC_CONTENT, &err);
+    g_assert_no_error(err);
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+    krnl = ccl_program_get_kernel(prg, CCL_TEST_KERNEL_INC_NAME, &err);
+    g_assert_no_error(err);
+
+    /* Create and initialize buffers. */
+    for (cl_uint i = 0; i < CCL_TEST_KERNEL_BUF_SIZE; ++i) hbuf[i] = i;
+    buf1 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        sizeof(hbuf), hbuf, &err);
+    g_assert_no_error(err);
+    buf2 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        sizeof(hbuf), hbuf, &err);
+    g_assert_no_error(err);
+
+    /* Execute kernel twice with the same arguments. */
+    inc = 1;
+    for (cl_uint r = 0; r < 2; ++r) {
+        ccl_kernel_set_args_and_enqueue_ndrange(krnl, cq, 1, NULL, &gws,
+            NULL, NULL, &err, buf1, ccl_arg_priv(inc, cl_uint), NULL);
+        g_assert_no_error(err);
+    }
+
+    /* Change only the buffer argument. */
+    ccl_kernel_set_args_and_enqueue_ndrange(krnl, cq, 1, NULL, &gws,
+        NULL, NULL, &err, buf2, ccl_arg_priv(inc, cl_uint), NULL);
+    g_assert_no_error(err);
+
+    /* Set arguments several times before execution, and change only the
+     * increment with respect to the previous execution. */
+    inc = 5;
+    ccl_kernel_set_arg(krnl, 1, ccl_arg_priv(inc, cl_uint));
+    ccl_kernel_set_args(krnl, buf1, ccl_arg_priv(inc, cl_uint), NULL);
+    ccl_kernel_enqueue_ndrange(krnl, cq, 1, NULL, &gws, NULL, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Check results. */
+    ccl_buffer_enqueue_read(buf1, cq, CL_TRUE, 0, sizeof(hbuf), hbuf,
+        NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_KERNEL_BUF_SIZE; ++i)
+        g_assert_cmpuint(hbuf[i], ==, i + 7);
+
+    ccl_buffer_enqueue_read(buf2, cq, CL_TRUE, 0, sizeof(hbuf), hbuf,
+        NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_KERNEL_BUF_SIZE; ++i)
+        g_assert_cmpuint(hbuf[i], ==, i + 1);
+
+    /* Set increment directly from a value, replacing a pending
+     * argument. */
+    inc = 2;
+    ccl_kernel_set_args(krnl, buf2, ccl_arg_priv(inc, cl_uint), NULL);
+    g_assert_true(ccl_kernel_set_arg_value(
+        krnl, 1, sizeof(cl_uint), &inc, &err));
+    g_assert_no_error(err);
+    ccl_kernel_enqueue_ndrange(krnl, cq, 1, NULL, &gws, NULL, NULL, &err);
+    g_assert_no_error(err);
+
+    ccl_buffer_enqueue_read(buf2, cq, CL_TRUE, 0, sizeof(hbuf), hbuf,
+        NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_KERNEL_BUF_SIZE; ++i)
+        g_assert_cmpuint(hbuf[i], ==, i + 3);
+
+    /* Destroy stuff. */
+    ccl_buffer_destroy(buf1);
+    ccl_buffer_destroy(buf2);
+    ccl_queue_destroy(cq);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests local work size autotuning and the tuning database.
+ * */
+static void autotune_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLProgram * prg = NULL;
+    CCLKernel * krnl = NULL;
+    CCLQueue * cq = NULL;
+    CCLQueue * cq_noprof = NULL;
+    CCLBuffer * buf = NULL;
+    CCLErr * err = NULL;
+    gchar * tmp_dir_name;
+    gchar * db_file;
+    size_t rws = CCL_TEST_KERNEL_BUF_SIZE * 8;
+    size_t gws, lws, lws_db;
+    size_t cands[] = { 3, 1, 2 };
+    cl_uint inc = 1;
+    cl_bool status;
+
+    /* Get a temp. dir. for the tuning database. */
+    tmp_dir_name = g_dir_make_tmp("test_tuning_db_XXXXXX", &err);
+    g_assert_no_error(err);
+    db_file = g_build_filename(tmp_dir_name, "tuning.ini", NULL);
+    g_assert_true(ccl_tuning_db_enable(tmp_dir_name, &err));
+    g_assert_no_error(err);
+
+    /* Get some context, device and queues. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    cq = ccl_queue_new(ctx, dev, CL_QUEUE_PROFILING_ENABLE, &err);
+    g_assert_no_error(err);
+
+    cq_noprof = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create program, kernel and buffer, and set kernel arguments. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_KERNEL_INC_CONTENT, &err);
+    g_assert_no_error(err);
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+    krnl = ccl_program_get_kernel(prg, CCL_TEST_KERNEL_INC_NAME, &err);
+    g_assert_no_error(err);
+
+    buf = ccl_buffer_new(
+        ctx, CL_MEM_READ_WRITE, rws * sizeof(cl_uint), NULL, &err);
+    g_assert_no_error(err);
+
+    ccl_kernel_set_args(krnl, buf, ccl_arg_priv(inc, cl_uint), NULL);
+
+    /* Kernel executions can't be timed without profiling. */
+    status = ccl_kernel_autotune_worksizes(
+        krnl, cq_noprof, 1, &rws, NULL, 0, &gws, &lws, &err);
+    g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+    g_assert_false(status);
+    g_clear_error(&err);
+
+    /* Tune local work size with default candidates. */
+    status = ccl_kernel_autotune_worksizes(
+        krnl, cq, 1, &rws, NULL, 0, &gws, &lws, &err);
+    g_assert_no_error(err);
+    g_assert_true(status);
+    g_assert_cmpuint(lws, >, 0);
+    g_assert_cmpuint(gws, >=, rws);
+    g_assert_cmpuint(gws % lws, ==, 0);
+    g_assert_true(g_file_test(db_file, G_FILE_TEST_EXISTS));
+
+    /* Reload tuning database, as a new process would. The tuned work size
+     * is now obtained without timing, so profiling is not required. */
+    ccl_tuning_db_disable();
+    g_assert_true(ccl_tuning_db_enable(tmp_dir_name, &err));
+    g_assert_no_error(err);
+    status = ccl_kernel_autotune_worksizes(
+        krnl, cq_noprof, 1, &rws, NULL, 0, &gws, &lws_db, &err);
+    g_assert_no_error(err);
+    g_assert_true(status);
+    g_assert_cmpuint(lws_db, ==, lws);
+
+    /* With no valid candidates, tuning fails. */
+    status = ccl_kernel_autotune_worksizes(
+        krnl, cq, 1, &rws, cands, 1, NULL, &lws, &err);
+    g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+    g_assert_false(status);
+    g_clear_error(&err);
+
+    /* Candidates which are not divisors of the real work size are
+     * ignored if the global work size must be equal to it. */
+    status = ccl_kernel_autotune_worksizes(
+        krnl, cq, 1, &rws, cands, G_N_ELEMENTS(cands), NULL, &lws, &err);
+    g_assert_no_error(err);
+    g_assert_true(status);
+    g_assert_true((lws == 1) || (lws == 2));
+
+    /* Destroy stuff. */
+    ccl_buffer_destroy(buf);
+    ccl_queue_destroy(cq);
+    ccl_queue_destroy(cq_noprof);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Remove tuning database. */
+    ccl_tuning_db_disable();
+    g_unlink(db_file);
+    g_rmdir(tmp_dir_name);
+    g_free(db_file);
+    g_free(tmp_dir_name);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -1326,6 +1764,10 @@ int main(int argc, char ** argv) {
         "/wrappers/kernel/info-workgroup",
         info_workgroup_test);
 
+    g_test_add_func(
+        "/wrappers/kernel/info-workgroup-local-mem",
+        info_workgroup_local_mem_test);
+
     g_test_add_func(
         "/wrappers/kernel/info-args",
         info_args_test);
@@ -1346,5 +1788,17 @@ int main(int argc, char ** argv) {
         "/wrappers/kernel/native",
         native_test);
 
+    g_test_add_func(
+        "/wrappers/kernel/ndrange-multi",
+        ndrange_multi_test);
+
+    g_test_add_func(
+        "/wrappers/kernel/args-redundant",
+        args_redundant_test);
+
+    g_test_add_func(
+        "/wrappers/kernel/autotune",
+        autotune_test);
+
     return g_test_run();
 }
@@ -0,0 +1,207 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @internal
+ *
+ * @file
+ * Test the launch handle class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2019
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+#define CCL_TEST_LAUNCH_KERNEL_NAME "test_krnl"
+
+#define CCL_TEST_LAUNCH_KERNEL_CONTENT \
+    "__kernel void " CCL_TEST_LAUNCH_KERNEL_NAME \
+    "(__global uint * buf, uint inc)\n" \
+    "{\n" \
+    "	int gid = get_global_id(0);\n" \
+    "	buf[gid] = buf[gid] + inc;\n" \
+    "}\n"
+
+#define CCL_TEST_LAUNCH_BUF_SIZE 16
+#define CCL_TEST_LAUNCH_ITERS 10
+
+/**
+ * @internal
+ *
+ * @brief Tests creating launch handles, firing them several times while
+ * changing their arguments, checking that each handle keeps its own
+ * arguments, and error handling on creation.
+ * */
+static void fire_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLProgram * prg = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf1 = NULL;
+    CCLBuffer * buf2 = NULL;
+    CCLBuffer * buf3 = NULL;
+    CCLLaunch * lnc = NULL;
+    CCLLaunch * lnc1 = NULL;
+    CCLLaunch * lnc2 = NULL;
+    CCLErr * err = NULL;
+    size_t gws = CCL_TEST_LAUNCH_BUF_SIZE;
+    size_t bsize = CCL_TEST_LAUNCH_BUF_SIZE * sizeof(cl_uint);
+    cl_uint hin[CCL_TEST_LAUNCH_BUF_SIZE];
+    cl_uint hout[CCL_TEST_LAUNCH_BUF_SIZE];
+    cl_uint sum = 0;
+    cl_uint one = 1;
+
+    /* Initialize host data. */
+    for (cl_uint i = 0; i < CCL_TEST_LAUNCH_BUF_SIZE; ++i)
+        hin[i] = i;
+
+    /* Get some context, device and queue. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create program and buffers. */
+    prg = ccl_program_new_from_source(
+        ctx, CCL_TEST_LAUNCH_KERNEL_CONTENT, &err);
+    g_assert_no_error(err);
+
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+
+    buf1 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        bsize, hin, &err);
+    g_assert_no_error(err);
+
+    buf2 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        bsize, hin, &err);
+    g_assert_no_error(err);
+
+    buf3 = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+        bsize, hin, &err);
+    g_assert_no_error(err);
+
+    /* Create two launch handles for the same program kernel, each with its
+     * own kernel. */
+    lnc1 = ccl_launch_new(prg, CCL_TEST_LAUNCH_KERNEL_NAME, cq, 1, NULL,
+        &gws, NULL, &err);
+    g_assert_no_error(err);
+    lnc2 = ccl_launch_new(prg, CCL_TEST_LAUNCH_KERNEL_NAME, cq, 1, NULL,
+        &gws, NULL, &err);
+    g_assert_no_error(err);
+    g_assert(ccl_launch_get_kernel(lnc1) != ccl_launch_get_kernel(lnc2));
+    g_assert(ccl_launch_get_kernel(lnc1) !=
+        ccl_program_get_kernel(prg, CCL_TEST_LAUNCH_KERNEL_NAME, NULL));
+
+    /* Set arguments of both handles before firing any of them. */
+    ccl_launch_set_arg(lnc1, 0, buf1);
+    ccl_launch_set_arg(lnc2, 0, buf2);
+    ccl_launch_set_arg(lnc2, 1, ccl_arg_priv(one, cl_uint));
+
+    /* Fire them alternately several times, changing the increment of the
+     * first handle only. The program kernel, which is used in between,
+     * must not disturb the arguments of the handles either. */
+    for (cl_uint i = 1; i <= CCL_TEST_LAUNCH_ITERS; ++i) {
+        ccl_launch_set_arg_value(lnc1, 1, sizeof(cl_uint), &i, &err);
+        g_assert_no_error(err);
+        ccl_launch_fire(lnc1, NULL, &err);
+        g_assert_no_error(err);
+        ccl_launch_fire(lnc2, NULL, &err);
+        g_assert_no_error(err);
+        ccl_program_enqueue_kernel(prg, CCL_TEST_LAUNCH_KERNEL_NAME, cq, 1,
+            NULL, &gws, NULL, NULL, &err,
+            buf3, ccl_arg_priv(one, cl_uint), NULL);
+        g_assert_no_error(err);
+        sum += i;
+    }
+
+    /* Check results. */
+    ccl_buffer_enqueue_read(buf1, cq, CL_TRUE, 0, bsize, hout, NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_LAUNCH_BUF_SIZE; ++i)
+        g_assert_cmpuint(hout[i], ==, i + sum);
+
+    ccl_buffer_enqueue_read(buf2, cq, CL_TRUE, 0, bsize, hout, NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_LAUNCH_BUF_SIZE; ++i)
+        g_assert_cmpuint(hout[i], ==, i + CCL_TEST_LAUNCH_ITERS);
+
+    ccl_buffer_enqueue_read(buf3, cq, CL_TRUE, 0, bsize, hout, NULL, &err);
+    g_assert_no_error(err);
+    for (cl_uint i = 0; i < CCL_TEST_LAUNCH_BUF_SIZE; ++i)
+        g_assert_cmpuint(hout[i], ==, i + CCL_TEST_LAUNCH_ITERS);
+
+    /* Destroy launch handles. */
+    ccl_launch_destroy(lnc1);
+    ccl_launch_destroy(lnc2);
+
+    /* An invalid number of work dimensions is an error. */
+    lnc = ccl_launch_new(prg, CCL_TEST_LAUNCH_KERNEL_NAME, cq, 4, NULL,
+        &gws, NULL, &err);
+    g_assert(lnc == NULL);
+    g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+    g_clear_error(&err);
+
+    /* A non-existing kernel is an error. */
+    lnc = ccl_launch_new(prg, "this_kernel_does_not_exist", cq, 1, NULL,
+        &gws, NULL, &err);
+    g_assert(lnc == NULL);
+    g_assert(err != NULL);
+    g_clear_error(&err);
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    /* Destroy stuff. */
+    ccl_buffer_destroy(buf1);
+    ccl_buffer_destroy(buf2);
+    ccl_buffer_destroy(buf3);
+    ccl_queue_destroy(cq);
+    ccl_program_destroy(prg);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char ** argv) {
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func(
+        "/launch/fire",
+        fire_test);
+
+    return g_test_run();
+}
@@ -30,6 +30,7 @@
 #include <cf4ocl2.h>
 #include <glib/gstdio.h>
 #include "test.h"
+#include "_ccl_abstract_wrapper.h"
 
 /* Max. length of information string. */
 #define CCL_TEST_PLATFORMS_MAXINFOSTR 200
@@ -707,6 +708,93 @@ static void ref_unref_test() {
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/**
+ * @internal
+ *
+ * @brief Tests the persistent cache of platform and device information.
+ * */
+static void info_cache_test() {
+
+    CCLPlatforms * platfs = NULL;
+    CCLPlatform * p = NULL;
+    CCLDevice * d = NULL;
+    CCLErr * err = NULL;
+    gchar * tmp_dir_name;
+    gchar * cache_file;
+    gchar * dev_name;
+    char * dev_name_cached;
+    guint64 queries_before, queries_after;
+    cl_uint compute_units;
+
+    /* Get a temp. dir. for the info cache. */
+    tmp_dir_name = g_dir_make_tmp("test_info_cache_XXXXXX", &err);
+    g_assert_no_error(err);
+    cache_file = g_build_filename(tmp_dir_name, "info.ini", NULL);
+
+    /* Enable the info cache and get first device of first platform, which
+     * fills the info cache. */
+    g_assert_true(ccl_info_cache_enable(tmp_dir_name, &err));
+    g_assert_no_error(err);
+
+    platfs = ccl_platforms_new(&err);
+    g_assert_no_error(err);
+    p = ccl_platforms_get(platfs, 0);
+    d = ccl_platform_get_device(p, 0, &err);
+    g_assert_no_error(err);
+
+    dev_name = g_strdup(ccl_device_get_info_array(d, CL_DEVICE_NAME, char,
+        &err));
+    g_assert_no_error(err);
+
+    ccl_platforms_destroy(platfs);
+    ccl_info_cache_disable();
+    g_assert_true(ccl_wrapper_memcheck());
+
+    /* Info cache file must now exist. */
+    g_assert_true(g_file_test(cache_file, G_FILE_TEST_EXISTS));
+
+    /* Enable the info cache again and get the same device, whose
+     * information should now be taken from the info cache. */
+    g_assert_true(ccl_info_cache_enable(tmp_dir_name, &err));
+    g_assert_no_error(err);
+
+    platfs = ccl_platforms_new(&err);
+    g_assert_no_error(err);
+    p = ccl_platforms_get(platfs, 0);
+    d = ccl_platform_get_device(p, 0, &err);
+    g_assert_no_error(err);
+
+    ccl_wrapper_get_info_counters(
+        CCL_INFO_DEVICE, NULL, NULL, &queries_before);
+    compute_units = ccl_device_get_info_scalar(
+        d, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+    g_assert_no_error(err);
+    g_assert_cmpuint(compute_units, >, 0);
+    dev_name_cached = ccl_device_get_info_array(d, CL_DEVICE_NAME, char,
+        &err);
+    g_assert_no_error(err);
+    ccl_wrapper_get_info_counters(
+        CCL_INFO_DEVICE, NULL, NULL, &queries_after);
+
+    /* Device must not have been queried, and information must be the
+     * same. */
+    g_assert_cmpuint(queries_after, ==, queries_before);
+    g_assert_cmpstr(dev_name_cached, ==, dev_name);
+
+    ccl_platforms_destroy(platfs);
+    ccl_info_cache_disable();
+
+    /* Remove info cache. */
+    g_unlink(cache_file);
+    g_rmdir(tmp_dir_name);
+    g_free(cache_file);
+    g_free(tmp_dir_name);
+    g_free(dev_name);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -727,5 +815,9 @@ int main(int argc, char ** argv) {
         "/wrappers/platforms/ref-unref",
         ref_unref_test);
 
+    g_test_add_func(
+        "/wrappers/platforms/info-cache",
+        info_cache_test);
+
     return g_test_run();
 }
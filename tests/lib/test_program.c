@@ -809,6 +809,136 @@ static void ref_unref_test() {
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/**
+ * @internal
+ *
+ * @brief Data of a thread in the per-thread kernels and queues test.
+ * */
+typedef struct {
+
+    /** Program. */
+    CCLProgram * prg;
+    /** Pool of command queues. */
+    CCLQueuePool * pool;
+    /** Kernel obtained by the thread. */
+    CCLKernel * krnl;
+    /** Command queue obtained by the thread. */
+    CCLQueue * cq;
+
+} CCLTestPerThread;
+
+/**
+ * @internal
+ *
+ * @brief Get the kernel and command queue of the calling thread twice,
+ * checking that the same objects are returned.
+ * */
+static gpointer per_thread_func(gpointer data) {
+
+    CCLTestPerThread * td = (CCLTestPerThread *) data;
+    CCLErr * err = NULL;
+
+    td->krnl = ccl_program_get_kernel_for_thread(
+        td->prg, CCL_TEST_PROGRAM_SUM, &err);
+    g_assert_no_error(err);
+    g_assert(ccl_program_get_kernel_for_thread(
+        td->prg, CCL_TEST_PROGRAM_SUM, &err) == td->krnl);
+    g_assert_no_error(err);
+
+    td->cq = ccl_queue_pool_get(td->pool, NULL, &err);
+    g_assert_no_error(err);
+    g_assert(ccl_queue_pool_get(td->pool, NULL, &err) == td->cq);
+    g_assert_no_error(err);
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Test per-thread kernel wrappers and pools of command queues.
+ * */
+static void per_thread_test() {
+
+    CCLContext * ctx = NULL;
+    CCLErr * err = NULL;
+    CCLProgram * prg = NULL;
+    CCLQueuePool * pool = NULL;
+    CCLTestPerThread td[2];
+    GThread * thread = NULL;
+    CCLWrapperStats stats;
+    guint num_caches;
+
+    const char * src = CCL_TEST_PROGRAM_SUM_CONTENT;
+
+    /* Get initial number of thread-local caches. */
+    ccl_wrapper_stats(&stats);
+    num_caches = stats.thread_caches;
+
+    /* Get some context. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Create and build program. */
+    prg = ccl_program_new_from_source(ctx, src, &err);
+    g_assert_no_error(err);
+    ccl_program_build(prg, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Create pool of command queues. */
+    pool = ccl_queue_pool_new(ctx, 0);
+
+    /* Get kernels and queues in this thread and in another thread. */
+    for (guint i = 0; i < 2; ++i) {
+        td[i].prg = prg;
+        td[i].pool = pool;
+    }
+    thread = g_thread_new("test_per_thread", per_thread_func, &td[0]);
+    g_thread_join(thread);
+    per_thread_func(&td[1]);
+
+    /* Each thread should have its own kernel and queue. */
+    g_assert(td[0].krnl != td[1].krnl);
+    g_assert(td[0].cq != td[1].cq);
+
+    /* Per-thread kernels are not the program's shared kernel. */
+    g_assert(ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err)
+        != td[1].krnl);
+    g_assert_no_error(err);
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    /* Destroy stuff, releasing per-thread kernels and queues. */
+    ccl_queue_pool_destroy(pool);
+    ccl_program_destroy(prg);
+
+    /* Thread-local caches of both threads should have been released. */
+    ccl_wrapper_stats(&stats);
+    g_assert_cmpuint(stats.thread_caches, ==, num_caches);
+
+    /* Create and destroy many pools in this thread, checking
+     * that their thread-local caches don't accumulate. */
+    for (guint i = 0; i < 100; ++i) {
+        pool = ccl_queue_pool_new(ctx, 0);
+        ccl_queue_pool_get(pool, NULL, &err);
+        g_assert_no_error(err);
+        ccl_wrapper_stats(&stats);
+        g_assert_cmpuint(stats.thread_caches, ==, num_caches + 1);
+        ccl_queue_pool_destroy(pool);
+        ccl_wrapper_stats(&stats);
+        g_assert_cmpuint(stats.thread_caches, ==, num_caches);
+    }
+
+    /* Confirm that memory allocated by wrappers has not yet been freed. */
+    g_assert_false(ccl_wrapper_memcheck());
+
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 #ifdef CL_VERSION_1_2
 
 static const char * src_head[] = {
@@ -1004,6 +1134,10 @@ int main(int argc, char ** argv) {
         "/wrappers/program/ref-unref",
         ref_unref_test);
 
+    g_test_add_func(
+        "/wrappers/program/per-thread",
+        per_thread_test);
+
     g_test_add_func(
         "/wrappers/program/compile-link",
         compile_link_test);
@@ -336,6 +336,443 @@ static void barrier_marker_test() {
     g_assert_true(ccl_wrapper_memcheck());
 }
 
+/* Number of events produced in the event log test, enough to span
+ * several chunks of the queue event log. */
+#define CCL_TEST_QUEUE_EVT_LOG_SIZE 600
+
+/**
+ * @internal
+ *
+ * @brief Tests that queue events are iterated in the order they were
+ * produced, that producing an already associated event doesn't duplicate
+ * it, and that events are released by ::ccl_queue_gc().
+ * */
+static void event_log_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLEvent * evt = NULL;
+    CCLEvent * evts[CCL_TEST_QUEUE_EVT_LOG_SIZE];
+    CCLErr * err = NULL;
+    guint i;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a command queue. */
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Enqueue markers, keeping the produced events. */
+    for (i = 0; i < CCL_TEST_QUEUE_EVT_LOG_SIZE; ++i) {
+        evts[i] = ccl_enqueue_marker(cq, NULL, &err);
+        g_assert_no_error(err);
+    }
+
+    /* Produce an event which is already associated with the queue. */
+    g_assert_true(evts[0] ==
+        ccl_queue_produce_event(cq, ccl_event_unwrap(evts[0])));
+    g_assert_cmpint(ccl_wrapper_ref_count((CCLWrapper *) evts[0]), ==, 1);
+
+    /* Check that events are iterated once, in the order they were
+     * produced. */
+    ccl_queue_iter_event_init(cq);
+    for (i = 0; (evt = ccl_queue_iter_event_next(cq)) != NULL; ++i) {
+        g_assert_cmpuint(i, <, CCL_TEST_QUEUE_EVT_LOG_SIZE);
+        g_assert_true(evt == evts[i]);
+    }
+    g_assert_cmpuint(i, ==, CCL_TEST_QUEUE_EVT_LOG_SIZE);
+
+    /* Wait for all events to complete. */
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+
+    /* Release events and check that the event log is empty. */
+    ccl_queue_gc(cq);
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == NULL);
+
+    /* The event log must still work after events are released. */
+    evt = ccl_enqueue_marker(cq, NULL, &err);
+    g_assert_no_error(err);
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == evt);
+    g_assert_true(ccl_queue_iter_event_next(cq) == NULL);
+
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+
+    /* Release wrappers. */
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests the event retention policies of command queues.
+ * */
+static void event_retention_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLEvent * evt = NULL;
+    CCLEvent * last = NULL;
+    CCLProf * prof = NULL;
+    CCLErr * err = NULL;
+    guint i, n;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a command queue with profiling enabled. */
+    cq = ccl_queue_new(ctx, dev, CL_QUEUE_PROFILING_ENABLE, &err);
+    g_assert_no_error(err);
+
+    /* Keep only the last 10 events. */
+    ccl_queue_set_event_retention(cq, CCL_QUEUE_EVTS_KEEP_LAST, 10);
+    for (i = 0; i < CCL_TEST_QUEUE_EVT_LOG_SIZE; ++i) {
+        last = ccl_enqueue_marker(cq, NULL, &err);
+        g_assert_no_error(err);
+    }
+
+    /* Check that only the last 10 events are kept, and that the last
+     * produced event is the last one to be iterated. */
+    ccl_queue_iter_event_init(cq);
+    for (n = 0; (evt = ccl_queue_iter_event_next(cq)) != NULL; ++n)
+        if (n == 9) g_assert_true(evt == last);
+    g_assert_cmpuint(n, ==, 10);
+
+    /* Release completed events on flush and finish, checking for them
+     * every 50 events. */
+    ccl_queue_set_event_retention(
+        cq, CCL_QUEUE_EVTS_RELEASE_COMPLETED, 50);
+    for (i = 0; i < CCL_TEST_QUEUE_EVT_LOG_SIZE; ++i) {
+        ccl_enqueue_marker(cq, NULL, &err);
+        g_assert_no_error(err);
+    }
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+
+    /* After finish, the event log should be empty. */
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == NULL);
+
+    /* Hand completed events to a profiler before releasing them. */
+    prof = ccl_prof_new();
+    ccl_prof_add_queue(prof, "retention", cq);
+    ccl_queue_set_event_retention(
+        cq, CCL_QUEUE_EVTS_PROFILE_COMPLETED, 0);
+    for (i = 0; i < 10; ++i) {
+        evt = ccl_enqueue_marker(cq, NULL, &err);
+        g_assert_no_error(err);
+        ccl_event_set_name(evt, "MARKER");
+    }
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == NULL);
+
+    /* Profiling calculations should take released events into account,
+     * as long as they have profiling information. */
+    ccl_prof_calc(prof, &err);
+    g_assert_no_error(err);
+    ccl_prof_destroy(prof);
+
+    /* Restore default policy. */
+    ccl_queue_set_event_retention(cq, CCL_QUEUE_EVTS_KEEP_ALL, 0);
+
+    /* Release wrappers. */
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests the event-less mode of command queues.
+ * */
+static void event_less_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf = NULL;
+    CCLEvent * evt = NULL;
+    CCLErr * err = NULL;
+    cl_int hbuf_in[16], hbuf_out[16];
+    guint i;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a command queue and a buffer. */
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+    buf = ccl_buffer_new(
+        ctx, CL_MEM_READ_WRITE, sizeof(hbuf_in), NULL, &err);
+    g_assert_no_error(err);
+
+    /* Enable event-less mode. */
+    g_assert_true(!ccl_queue_is_event_less(cq));
+    ccl_queue_set_event_less(cq, CL_TRUE);
+    g_assert_true(ccl_queue_is_event_less(cq));
+
+    /* Write and read buffer, no events should be produced. */
+    for (i = 0; i < 16; ++i) hbuf_in[i] = (cl_int) i;
+    evt = ccl_buffer_enqueue_write(
+        buf, cq, CL_TRUE, 0, sizeof(hbuf_in), hbuf_in, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt == NULL);
+    evt = ccl_buffer_enqueue_read(
+        buf, cq, CL_TRUE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt == NULL);
+    for (i = 0; i < 16; ++i) g_assert_cmpint(hbuf_out[i], ==, hbuf_in[i]);
+
+    /* The event log should be empty. */
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == NULL);
+
+    /* Markers should still produce events. */
+    evt = ccl_enqueue_marker(cq, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt != NULL);
+    ccl_queue_iter_event_init(cq);
+    g_assert_true(ccl_queue_iter_event_next(cq) == evt);
+
+    /* Disable event-less mode, events should be produced again. */
+    ccl_queue_set_event_less(cq, CL_FALSE);
+    evt = ccl_buffer_enqueue_read(
+        buf, cq, CL_TRUE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt != NULL);
+
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+
+    /* Release wrappers. */
+    ccl_buffer_destroy(buf);
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests the flush policy of command queues.
+ * */
+static void flush_policy_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLErr * err = NULL;
+    CCLQueueFlushStats stats;
+    cl_ulong flushes = 0;
+    guint i;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Create a command queue. */
+    cq = ccl_queue_new(ctx, dev, 0, &err);
+    g_assert_no_error(err);
+
+    /* Without a flush policy, statistics are zero. */
+    ccl_queue_get_flush_stats(cq, &stats);
+    g_assert_cmpuint(stats.by_count + stats.by_client, ==, 0);
+
+    /* Flush every 4 commands. */
+    ccl_queue_set_flush_policy(cq, 4, 0, 0);
+    for (i = 0; i < 10; ++i) {
+        ccl_enqueue_marker(cq, NULL, &err);
+        g_assert_no_error(err);
+    }
+    ccl_queue_get_flush_stats(cq, &stats);
+    g_assert_cmpuint(stats.by_count, ==, 2);
+    g_assert_cmpuint(stats.commands, ==, 8);
+
+    /* Flushing the queue submits the remaining commands. */
+    ccl_queue_flush(cq, &err);
+    g_assert_no_error(err);
+    ccl_queue_get_flush_stats(cq, &stats);
+    g_assert_cmpuint(stats.by_client, ==, 1);
+    g_assert_cmpuint(stats.commands, ==, 10);
+
+    /* Flush commands pending for more than one millisecond. */
+    ccl_queue_set_flush_policy(cq, 0, 1000, 0);
+    ccl_enqueue_marker(cq, NULL, &err);
+    g_assert_no_error(err);
+    for (i = 0; (i < 100) && (stats.by_time == 0); ++i) {
+        g_usleep(10000);
+        ccl_queue_get_flush_stats(cq, &stats);
+    }
+    g_assert_cmpuint(stats.by_time, ==, 1);
+    g_assert_cmpuint(stats.commands, ==, 11);
+
+    /* Each flush of pending commands is in the latency histogram. */
+    for (i = 0; i < CCL_QUEUE_FLUSH_LATENCY_BINS; ++i)
+        flushes += stats.latency[i];
+    g_assert_cmpuint(flushes, ==, 4);
+
+    /* Disable flush policy, statistics are kept. */
+    ccl_queue_set_flush_policy(cq, 0, 0, 0);
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+    ccl_queue_get_flush_stats(cq, &stats);
+    g_assert_cmpuint(stats.by_client, ==, 2);
+
+    /* Release wrappers. */
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
+/**
+ * @internal
+ *
+ * @brief Tests automatic hazard tracking in command queues.
+ * */
+static void hazard_tracking_test() {
+
+    /* Test variables. */
+    CCLContext * ctx = NULL;
+    CCLDevice * dev = NULL;
+    CCLQueue * cq = NULL;
+    CCLBuffer * buf1 = NULL;
+    CCLBuffer * buf2 = NULL;
+    CCLEvent * evt = NULL;
+    CCLErr * err = NULL;
+    cl_command_queue_properties qprops;
+    cl_int hbuf_in1[16], hbuf_in2[16], hbuf_out[16];
+    guint i;
+
+    /* Get the test context with the pre-defined device. */
+    ctx = ccl_test_context_new(0, &err);
+    g_assert_no_error(err);
+
+    /* Get first device in context. */
+    dev = ccl_context_get_device(ctx, 0, &err);
+    g_assert_no_error(err);
+
+    /* Use an out-of-order command queue if the device supports it. */
+    qprops = ccl_device_get_info_scalar(
+        dev, CL_DEVICE_QUEUE_ON_HOST_PROPERTIES,
+        cl_command_queue_properties, &err);
+    g_assert_no_error(err);
+    cq = ccl_queue_new(ctx, dev,
+        qprops & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &err);
+    g_assert_no_error(err);
+
+    /* Create buffers. */
+    buf1 = ccl_buffer_new(
+        ctx, CL_MEM_READ_WRITE, sizeof(hbuf_out), NULL, &err);
+    g_assert_no_error(err);
+    buf2 = ccl_buffer_new(
+        ctx, CL_MEM_READ_WRITE, sizeof(hbuf_out), NULL, &err);
+    g_assert_no_error(err);
+
+    /* Enable hazard tracking. */
+    g_assert_true(!ccl_queue_has_hazard_tracking(cq));
+    ccl_queue_set_hazard_tracking(cq, CL_TRUE);
+    g_assert_true(ccl_queue_has_hazard_tracking(cq));
+
+    /* Initialize host data. */
+    for (i = 0; i < 16; ++i) {
+        hbuf_in1[i] = (cl_int) i;
+        hbuf_in2[i] = (cl_int) (100 + i);
+    }
+
+    /* Write first buffer, copy it to the second buffer and overwrite the
+     * first buffer, without explicit event wait lists. The copy must wait
+     * for the first write (read-after-write), and the second write must
+     * wait for the copy (write-after-read). */
+    ccl_buffer_enqueue_write(
+        buf1, cq, CL_FALSE, 0, sizeof(hbuf_in1), hbuf_in1, NULL, &err);
+    g_assert_no_error(err);
+    ccl_buffer_enqueue_copy(
+        buf1, buf2, cq, 0, 0, sizeof(hbuf_in1), NULL, &err);
+    g_assert_no_error(err);
+    ccl_buffer_enqueue_write(
+        buf1, cq, CL_FALSE, 0, sizeof(hbuf_in2), hbuf_in2, NULL, &err);
+    g_assert_no_error(err);
+
+    /* Read buffers, which must wait for the respective writes. */
+    ccl_buffer_enqueue_read(
+        buf2, cq, CL_TRUE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    for (i = 0; i < 16; ++i) g_assert_cmpint(hbuf_out[i], ==, hbuf_in1[i]);
+    ccl_buffer_enqueue_read(
+        buf1, cq, CL_TRUE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    for (i = 0; i < 16; ++i) g_assert_cmpint(hbuf_out[i], ==, hbuf_in2[i]);
+
+    /* Event-less mode has no effect while hazards are tracked. */
+    ccl_queue_set_event_less(cq, CL_TRUE);
+    evt = ccl_buffer_enqueue_read(
+        buf1, cq, CL_FALSE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt != NULL);
+
+    ccl_queue_finish(cq, &err);
+    g_assert_no_error(err);
+
+    /* Disable hazard tracking, event-less mode is effective again. */
+    ccl_queue_set_hazard_tracking(cq, CL_FALSE);
+    g_assert_true(!ccl_queue_has_hazard_tracking(cq));
+    evt = ccl_buffer_enqueue_read(
+        buf1, cq, CL_TRUE, 0, sizeof(hbuf_out), hbuf_out, NULL, &err);
+    g_assert_no_error(err);
+    g_assert_true(evt == NULL);
+
+    /* Release wrappers. */
+    ccl_buffer_destroy(buf1);
+    ccl_buffer_destroy(buf2);
+    ccl_queue_destroy(cq);
+    ccl_context_destroy(ctx);
+
+    /* Confirm that memory allocated by wrappers has been properly freed. */
+    g_assert_true(ccl_wrapper_memcheck());
+}
+
 /**
  * @internal
  *
@@ -555,6 +992,26 @@ int main(int argc, char ** argv) {
         "/wrappers/queue/barrier-marker",
         barrier_marker_test);
 
+    g_test_add_func(
+        "/wrappers/queue/event-log",
+        event_log_test);
+
+    g_test_add_func(
+        "/wrappers/queue/event-retention",
+        event_retention_test);
+
+    g_test_add_func(
+        "/wrappers/queue/event-less",
+        event_less_test);
+
+    g_test_add_func(
+        "/wrappers/queue/flush-policy",
+        flush_policy_test);
+
+    g_test_add_func(
+        "/wrappers/queue/hazard-tracking",
+        hazard_tracking_test);
+
     g_test_add_func(
         "/wrappers/queue/mult-ooo",
         mult_ooo_test);
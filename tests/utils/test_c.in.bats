@@ -21,6 +21,10 @@ setup() {
     # ccl_devinfo binary
     CCL_C_DEVINFO="@CMAKE_BINARY_DIR@/src/utils/ccl_devinfo"
 
+    # C compiler and flags for compiling code which uses generated stubs
+    CCL_C_CC="@CMAKE_C_COMPILER@"
+    CCL_C_CFLAGS="-std=c99 -Wall -Wextra -Werror @CCL_C_STUB_INCLUDES@"
+
     # How many devices?
     CCL_C_NDEVS=`${CCL_C_DEVINFO} | grep -c "\[ Device #"`
 
@@ -1191,3 +1195,62 @@ teardown() {
     [ "$status" -ne 0 ]
 
 }
+
+# ############### #
+# Test stubs task #
+# ############### #
+
+# Test generation of launch functions.
+@test "Stubs with one source file" {
+
+    # Skip if OpenCL < 1.2
+    if [[ ${CCL_C_SKIP} -eq 1 ]]
+    then
+        skip "${CCL_C_SKIP_MSG}"
+    fi
+
+    run ${CCL_C_COM} -t 3 -s ${CCL_C_K_SUM} -o ${CCL_C_TMP_BIN}1 \
+        -d ${CCL_TEST_DEVICE_INDEX}
+
+    # Check output
+    [[ "$output" =~  "Device" ]]
+    [[ "$output" =~  "Build status" ]]
+    [[ "$output" =~  "Success" ]]
+    [[ "$output" =~  "Stubs output file" ]]
+    [[ "$output" =~  "${CCL_C_TMP_BIN}1" ]]
+
+    # There should be no problems
+    [ "$status" -eq 0 ]
+
+    # Check generated launch function
+    grep -q "ccl_stub_${CCL_C_K_SUM_NAME}" ${CCL_C_TMP_BIN}1
+    grep -q "CCLBuffer \* c" ${CCL_C_TMP_BIN}1
+    grep -q "cl_uint d" ${CCL_C_TMP_BIN}1
+
+    # Generated header must compile, and its launch function must be
+    # callable with the kernel's typed arguments
+    ${CCL_C_CC} ${CCL_C_CFLAGS} -x c -c -o ${CCL_C_TMP_BIN}2 - <<EOF
+#include "${CCL_C_TMP_BIN}1"
+CCLEvent * test_stub(CCLKernel * krnl, CCLQueue * cq, CCLBuffer * a,
+    CCLBuffer * b, CCLBuffer * c, CCLErr ** err) {
+    size_t gws = 16;
+    return ccl_stub_${CCL_C_K_SUM_NAME}(
+        krnl, cq, 1, NULL, &gws, NULL, NULL, a, b, c, 1, err);
+}
+EOF
+
+}
+
+# Test stubs task without output file.
+@test "Stubs without output file" {
+
+    run ${CCL_C_COM} -t 3 -s ${CCL_C_K_SUM} -d ${CCL_TEST_DEVICE_INDEX}
+
+    # Check output
+    [[ "$output" =~  "Error" ]]
+    [[ "$output" =~  "requires an output file" ]]
+
+    # Error due to missing output file
+    [ "$status" -ne 0 ]
+
+}